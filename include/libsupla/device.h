@@ -52,6 +52,22 @@ typedef enum {
     SUPLA_DEV_STATE_ONLINE,
 } supla_dev_state_t;
 
+/**
+ * @brief SUPLA cloud connection buffer and queue sizes, 0 keeps the library
+ * default
+ */
+struct supla_dev_buffers {
+    unsigned int io_size;          /**< most bytes read or written at once */
+    unsigned int buffer_min_size;  /**< input and output buffer kept allocated */
+    unsigned int buffer_max_size;  /**< input and output buffer limit */
+    unsigned int queue_slab_size;  /**< packet queue memory kept allocated */
+    unsigned int max_data_size;    /**< largest packet payload */
+    unsigned short in_queue_size;  /**< received packets waiting for processing */
+    unsigned short out_queue_size; /**< packets waiting for sending */
+    char autosize;                 /**< derive sizes left at 0 from the channels */
+    char lean;                     /**< free buffers while idle and share scratch memory */
+};
+
 struct manufacturer_data {
     _supla_int16_t manufacturer_id;
     _supla_int16_t product_id;
@@ -134,6 +150,30 @@ typedef int (*on_restart_from_server_callback_t)(supla_dev_t *dev);
  */
 supla_dev_t *supla_dev_create(const char *dev_name, const char *soft_ver);
 
+/**
+ * @brief Create SUPLA device instance taking its memory from given allocator
+ *
+ * The device, its channel table, protocol buffers and queues come from the allocator.
+ * Channels and the TLS library keep using the default allocator.
+ *
+ * @param[in] dev_name SUPLA device name. Name "SUPLA device" will be set if dev_name is NULL
+ * @param[in] soft_ver Software version. Version "libsupla #version" will be set if soft_ver is NULL
+ * @param[in] allocator allocator outliving the device, NULL for the default one
+ * @return SUPLA device instance or NULL if failed
+ */
+supla_dev_t *supla_dev_create_with_allocator(const char *dev_name, const char *soft_ver,
+                                             const supla_allocator_t *allocator);
+
+/**
+ * @brief Set allocator used by the library when no device allocator is given
+ *
+ * Must be called before any device or channel is created, the allocator must stay valid
+ * as long as the library is used. NULL restores the C library allocator.
+ *
+ * @param[in] allocator default allocator
+ */
+void supla_set_default_allocator(const supla_allocator_t *allocator);
+
 /**
  * @brief Free SUPLA device instance and all internal allocated resources
  *
@@ -197,6 +237,18 @@ const char *supla_dev_state_str(supla_dev_state_t state);
  */
 int supla_dev_set_activity_timeout(supla_dev_t *dev, int sec);
 
+/**
+ * @brief Set SUPLA device buffer and queue sizes, applied on the next connection
+ *
+ * With autosize set, sizes left at 0 follow the channel count and whether
+ * any channel sends extended values.
+ *
+ * @param[in] dev SUPLA device instance
+ * @param[in] buffers buffer and queue sizes
+ * @return SUPLA_RESULT_TRUE on success
+ */
+int supla_dev_set_buffers(supla_dev_t *dev, const struct supla_dev_buffers *buffers);
+
 /**
  * @brief Get SUPLA device activity timeout
  *
@@ -342,6 +394,17 @@ int supla_dev_set_config(supla_dev_t *dev, const struct supla_config *config);
  */
 int supla_dev_get_config(supla_dev_t *dev, struct supla_config *config);
 
+/**
+ * @brief Get SUPLA server the device connects to, the config server or one
+ * of its fallback servers
+ *
+ * @param[in] dev SUPLA device instance
+ * @param[out] name server name buffer
+ * @param[in] len server name buffer length
+ * @return SUPLA_RESULT_TRUE on success
+ */
+int supla_dev_get_server(const supla_dev_t *dev, char *name, size_t len);
+
 /**
  * @brief enable SUPLA device device-level notification
  *
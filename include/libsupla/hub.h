@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2022 <qb4.dev@gmail.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef SUPLA_HUB_H_
+#define SUPLA_HUB_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "device.h"
+
+/**
+ * @brief Runtime driving many SUPLA devices from a few event loop threads.
+ *
+ * Each loop thread waits on the cloud sockets of its devices, on their next
+ * ping or register timeout and on channel value changes, and calls
+ * supla_dev_iterate() only for devices which have something to do. Devices
+ * added to a hub must not be iterated by the application.
+ *
+ * Typical program flow
+ * @code{c}
+ *
+ * supla_hub_t *hub = supla_hub_create(0);
+ *
+ * for (i = 0; i < dev_count; i++) {
+ *    supla_dev_set_config(devs[i], &configs[i]);
+ *    supla_hub_add_device(hub, devs[i]);
+ *    supla_dev_start(devs[i]);
+ * }
+ *
+ * while(!app_quit){
+ *    supla_channel_set_value(temp_channel, &value, sizeof(value));
+ *    sleep(10);
+ * }
+ *
+ * supla_hub_free(hub);
+ * @endcode
+ *
+ * Available on Linux only (epoll). With SUPLA_HUB_FLAG_IO_URING the loops do
+ * cloud socket reads and writes through io_uring instead: data sent by all
+ * devices ticked in one loop pass goes out with a single system call and TLS
+ * is done on memory buffers. Connections are still opened with blocking
+ * connect and handshake, and the hub closes them when the device is removed.
+ * Loops fall back to epoll socket I/O when io_uring is not available.
+ */
+typedef struct supla_hub supla_hub_t;
+
+/* cloud socket I/O through io_uring, see supla_hub_create_with_flags() */
+#define SUPLA_HUB_FLAG_IO_URING 0x0001
+
+struct supla_hub_stats {
+    int loops;
+    int devices;
+    int online_devices;
+    uint64_t iterations;    /* supla_dev_iterate() calls */
+    uint64_t socket_events; /* cloud socket readiness events */
+    uint64_t timer_events;  /* expired device deadlines */
+    uint64_t dirty_events;  /* wakeups after channel or state changes */
+    uint64_t loop_wakeups;  /* event loop passes */
+    uint64_t io_submits;    /* io_uring submissions */
+    uint64_t io_ops;        /* io_uring socket reads and writes */
+};
+
+/**
+ * @brief Create hub and start its event loop threads
+ *
+ * @param[in] loop_count number of event loop threads, 0 starts one per online CPU
+ * @return hub instance or NULL if failed
+ */
+supla_hub_t *supla_hub_create(int loop_count);
+
+/**
+ * @brief Create hub with SUPLA_HUB_FLAG_* options and start its event loop threads
+ *
+ * @param[in] loop_count number of event loop threads, 0 starts one per online CPU
+ * @param[in] flags SUPLA_HUB_FLAG_* bits
+ * @return hub instance or NULL if failed
+ */
+supla_hub_t *supla_hub_create_with_flags(int loop_count, int flags);
+
+/**
+ * @brief Stop event loop threads and free hub. Added devices are detached
+ * but not freed, only io_uring connections are closed
+ *
+ * @param[in] hub hub instance
+ * @return SUPLA_RESULT_TRUE on success
+ */
+int supla_hub_free(supla_hub_t *hub);
+
+/**
+ * @brief Add device to the least loaded event loop. Device may be added to one
+ * hub at a time
+ *
+ * @param[in] hub hub instance
+ * @param[in] dev SUPLA device instance
+ * @return SUPLA_RESULT_TRUE on success, SUPLA_RESULT_FALSE if device is already
+ * added or out of memory
+ */
+int supla_hub_add_device(supla_hub_t *hub, supla_dev_t *dev);
+
+/**
+ * @brief Remove device from hub. After return the device is not iterated by
+ * the hub anymore and may be freed, but not from its own callbacks. A device
+ * connected through io_uring is disconnected and connects again when iterated
+ *
+ * @param[in] hub hub instance
+ * @param[in] dev SUPLA device instance
+ * @return SUPLA_RESULT_TRUE on success, SUPLA_RESULT_FALSE if device was not added
+ */
+int supla_hub_remove_device(supla_hub_t *hub, supla_dev_t *dev);
+
+/**
+ * @brief Get hub counters summed over all event loops
+ *
+ * @param[in] hub hub instance
+ * @param[out] stats hub counters
+ * @return SUPLA_RESULT_TRUE on success
+ */
+int supla_hub_get_stats(const supla_hub_t *hub, struct supla_hub_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SUPLA_HUB_H_ */
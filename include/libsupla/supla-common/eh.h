@@ -0,0 +1,110 @@
+/*
+ Copyright (C) AC SOFTWARE SP. Z O.O.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+#ifndef EH_H_
+#define EH_H_
+
+#if !defined(ESP8266) && !defined(__AVR__) && !defined(_WIN32) && \
+    !defined(ESP32) && !defined(ARDUINO) && !defined(SUPLA_DEVICE)
+#include <sys/select.h>
+#endif
+
+#if !defined(__AVR__) && !defined(_WIN32)
+#include <sys/time.h>
+#endif
+
+#ifdef __AVR__
+#include "proto.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EH_EVENT_READ 0x1
+#define EH_EVENT_WRITE 0x2
+// Reported only, hangup or error on the fd
+#define EH_EVENT_ERROR 0x4
+
+struct _TEventHandlerFd;
+
+typedef struct {
+  int nfds;
+
+#ifndef _WIN32
+
+#ifdef __linux__
+  int epoll_fd;
+  int fd1;
+  // Armed by eh_wait() for timeouts finer than a millisecond
+  int wait_timer_fd;
+
+  // Registered fds with callbacks, indexed by fd
+  struct _TEventHandlerFd **fds;
+  int fds_size;
+  // Unregistered while eh_wait() dispatches, freed when it returns
+  struct _TEventHandlerFd *released;
+#else
+  int fd1[2];
+#endif
+
+  int fd2;
+  int fd3;
+
+  // Set by eh_raise_event() until eh_wait() consumes the wakeup
+  char pending;
+
+  struct timeval tv;
+
+#endif
+} TEventHandler;
+
+typedef void (*_func_eh_fd_callback)(TEventHandler *eh, int fd,
+                                     unsigned int events, void *user_data);
+typedef void (*_func_eh_timer_callback)(TEventHandler *eh, int timer,
+                                        void *user_data);
+
+TEventHandler *eh_init(void);
+void eh_add_fd(TEventHandler *eh, int fd);
+// Wakes up eh_wait(). Calls made before eh_wait() consumes the wakeup cost
+// no syscall.
+void eh_raise_event(TEventHandler *eh);
+// Registered fd and timer callbacks are called from here
+int eh_wait(TEventHandler *eh, int usec);
+void eh_free(TEventHandler *eh);
+
+// Linux only, the other platforms return 0. Must be called from the thread
+// running eh_wait(), callbacks may register and unregister any fd.
+// events is a mask of EH_EVENT_READ and EH_EVENT_WRITE.
+char eh_register_fd(TEventHandler *eh, int fd, unsigned int events,
+                    _func_eh_fd_callback callback, void *user_data);
+char eh_modify_fd(TEventHandler *eh, int fd, unsigned int events);
+// Does not close fd
+char eh_unregister_fd(TEventHandler *eh, int fd);
+
+// timerfd based timer, first run after delay_ms, then every interval_ms or
+// once if interval_ms is 0. Returns the timer id, -1 on failure. Every timer,
+// including a one-shot one that already ran, has to be stopped to release it.
+int eh_timer_start(TEventHandler *eh, int delay_ms, int interval_ms,
+                   _func_eh_timer_callback callback, void *user_data);
+char eh_timer_stop(TEventHandler *eh, int timer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EH_H_ */
@@ -0,0 +1,39 @@
+/*
+ Copyright (C) AC SOFTWARE SP. Z O.O.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef IPCSOCKET_H_
+#define IPCSOCKET_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IPC_SAUTH_KEY_SIZE 16
+
+extern char *ipc_sauth_key;
+
+void *ipcsocket_init(const char *address);
+void ipcsocket_close(void *ipc);
+void ipcsocket_free(void *ipc);
+int ipcsocket_accept(void *ipc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IPCSOCKET_H_ */
@@ -0,0 +1,67 @@
+/*
+ Copyright (C) AC SOFTWARE SP. Z O.O.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef SAFEHASH_H_
+#define SAFEHASH_H_
+
+#include <stdint.h>
+
+#include "safearray.h"
+
+// Keyed companion of safe_array. Items are spread over independently locked
+// shards, each holding a dense item array and an open addressing index, so
+// add, find and remove by key are O(1) and only lock one shard.
+//
+// safe_hash_lock() takes every shard lock, after which safe_hash_get() can be
+// used to iterate the same way as safe_array_get(). Removing an item moves
+// the last item of its shard into its place, as safe_array_delete() does.
+
+#define SAFE_HASH_DEFAULT_SHARDS 16
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// shard_count is rounded up to a power of two, 0 selects the default
+void *safe_hash_init(int shard_count);
+void safe_hash_free(void *hash);
+void safe_hash_lock(void *hash);
+void safe_hash_unlock(void *hash);
+int safe_hash_count(void *hash);
+// Returns 1 if added, 0 if the key is already present and -1 on error
+int safe_hash_add(void *hash, uint64_t key, void *ptr);
+void *safe_hash_find(void *hash, uint64_t key);
+// Returns the removed item or NULL
+void *safe_hash_remove(void *hash, uint64_t key);
+void *safe_hash_get(void *hash, int idx);
+void safe_hash_clean(void *hash, _func_sa_cnd del_cnd);
+void *safe_hash_findcnd(void *hash, _func_sa_cnd_param find_cnd,
+                        void *user_param);
+
+#define safe_hash_add_ptr(hash, ptr) \
+  safe_hash_add(hash, (uint64_t)(uintptr_t)(ptr), ptr)
+#define safe_hash_find_ptr(hash, ptr) \
+  safe_hash_find(hash, (uint64_t)(uintptr_t)(ptr))
+#define safe_hash_remove_ptr(hash, ptr) \
+  safe_hash_remove(hash, (uint64_t)(uintptr_t)(ptr))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SAFEHASH_H_ */
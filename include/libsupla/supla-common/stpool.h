@@ -0,0 +1,59 @@
+/*
+ Copyright (C) AC SOFTWARE SP. Z O.O.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef STPOOL_H_
+#define STPOOL_H_
+
+// Fixed size worker pool. Every worker owns a task queue, idle workers steal
+// from the others. Delayed and periodic tasks are kept in a timer heap and
+// handed to the workers when due. A periodic task is rescheduled interval_ms
+// after its previous run finished, so it never runs twice at the same time.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*_func_stpool_task)(void *user_data);
+
+// worker_count <= 0 starts one worker per online CPU
+void *stpool_init(int worker_count);
+int stpool_worker_count(void *pool);
+
+// Return 0 on failure or when the pool is being freed
+char stpool_submit(void *pool, _func_stpool_task task, void *user_data);
+// Return a task id for stpool_cancel(), 0 on failure
+int stpool_submit_delayed(void *pool, _func_stpool_task task,
+                          void *user_data, int delay_ms);
+int stpool_submit_periodic(void *pool, _func_stpool_task task,
+                           void *user_data, int delay_ms, int interval_ms);
+// Returns 1 if the task will not run again. A run in progress is not waited
+// for.
+char stpool_cancel(void *pool, int task_id);
+
+// Waits until every submitted task has finished, including pending delayed
+// ones. Periodic tasks are not waited for.
+void stpool_drain(void *pool);
+// Cancels delayed and periodic tasks, runs the already queued ones and joins
+// the workers
+void stpool_free(void *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STPOOL_H_ */
@@ -0,0 +1,81 @@
+/*
+ Copyright (C) AC SOFTWARE SP. Z O.O.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef supla_socket_H_
+#define supla_socket_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <sys/types.h>
+
+typedef void supla_socket;
+typedef void supla_socket_data;
+
+supla_socket_data *ssocket_server_init(const char cert[], const char key[],
+                                       int port, unsigned char secure);
+void ssocket_ssl_new(void *_ssd, void *_supla_socket);
+char ssocket_accept(void *_ssd, unsigned int *ipv4, void **_supla_socket);
+char ssocket_accept_ssl(void *_ssd, void *_supla_socket);
+supla_socket_data *ssocket_client_init(const char host[], int port,
+                                       unsigned char secure);
+unsigned char ssocket_client_connect(void *ssd, const char *state_file,
+                                     int *err, int conn_timeout_ms);
+
+char ssocket_openlistener(void *_ssd);
+
+int ssocket_read(void *_ssd, void *supla_socket, void *buf, int count);
+int ssocket_write(void *_ssd, void *supla_socket, const void *buf, int count);
+
+int ssocket_get_fd(void *ssd);
+char ssocket_is_secure(void *_ssd);
+// SSL object of a connected TLS client, NULL otherwise
+void *ssocket_get_ssl(void *_ssd);
+// Decrypted bytes the SSL object holds, readable without the socket being
+// readable. 0 for plain connections.
+int ssocket_client_pending(void *_ssd);
+
+#define SSOCKET_KTLS_SEND 0x1
+#define SSOCKET_KTLS_RECV 0x2
+
+// Asks for kernel TLS offload on the next ssocket_client_connect(), used only
+// where OpenSSL and the kernel support it for the negotiated cipher
+void ssocket_client_set_ktls(void *_ssd, char enable);
+// For processes holding many connections. The client uses a context shared
+// with other lean clients, and TLS record buffers are freed while idle. Call
+// before ssocket_client_connect().
+void ssocket_client_set_lean(void *_ssd, char enable);
+// SSOCKET_KTLS_* directions the kernel encrypts for the current connection
+int ssocket_get_ktls(void *_ssd);
+
+void ssocket_supla_socket_close(void *supla_socket);
+void ssocket_supla_socket__close(void *_ssd);
+void ssocket_supla_socket_free(void *_supla_socket);
+int ssocket_supla_socket_getsfd(void *_supla_socket);
+void ssocket_close(void *ssd);
+void ssocket_free(void *ssd);
+void ssocket_ssl_error_log(void);
+int ssocket_get_last_accept_errno(void);
+long int ssocket_get_last_accept_error_time_sec(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* supla_socket_H_ */
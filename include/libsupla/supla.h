@@ -18,6 +18,40 @@
 #include "supla-common/log.h"
 #include "supla-common/lck.h"
 #include "supla-common/srpc.h"
+#include "supla-common/salloc.h"
+
+/*
+ * Memory hooks, see supla-common/salloc.h. Tags passed to them are the
+ * SALLOC_TAG_* of the protocol layer or one of the libsupla parts below.
+ */
+typedef TSAllocator supla_allocator_t;
+
+#define SUPLA_ALLOC_TAG_DEVICE (SALLOC_TAG_USER + 0)
+#define SUPLA_ALLOC_TAG_CHANNEL (SALLOC_TAG_USER + 1)
+
+/*
+ * Cloud socket tuning applied after connect, zero keeps the system default.
+ * user_timeout_ms and keepalive let the kernel drop a half-open connection
+ * long before the activity timeout ping does.
+ */
+struct supla_tcp_options {
+    char nodelay;               /* TCP_NODELAY, send small frames at once */
+    int user_timeout_ms;        /* TCP_USER_TIMEOUT for unacknowledged data */
+    int keepalive_idle_sec;     /* enables keepalive probes after idle time */
+    int keepalive_interval_sec; /* TCP_KEEPINTVL */
+    int keepalive_count;        /* TCP_KEEPCNT */
+    int sndbuf;                 /* SO_SNDBUF bytes */
+    int rcvbuf;                 /* SO_RCVBUF bytes */
+    int notsent_lowat;          /* TCP_NOTSENT_LOWAT bytes */
+};
+
+#define SUPLA_CONFIG_FALLBACK_SERVERS 3
+
+/* additional cloud endpoint, port 0 uses the config port */
+struct supla_server {
+    char name[SUPLA_SERVER_NAME_MAXSIZE];
+    int port;
+};
 
 struct supla_config {
     char guid[SUPLA_GUID_SIZE];
@@ -26,6 +60,16 @@ struct supla_config {
     char server[SUPLA_SERVER_NAME_MAXSIZE];
     int port;
     char ssl;
+    char ktls; /* with ssl, let the Linux kernel encrypt records if it can */
+    struct supla_tcp_options tcp;
+    /*
+     * With fallback servers the fastest one to connect is picked first and
+     * the device moves to the next fastest after failover_after consecutive
+     * failures (0: 3). standby keeps a connection to that server ready.
+     */
+    struct supla_server fallback[SUPLA_CONFIG_FALLBACK_SERVERS];
+    int failover_after;
+    char standby;
 };
 
 #endif /* LIBSUPLA_SUPLA_H_ */
@@ -29,8 +29,6 @@ struct supla_channel {
     supla_value_t *supla_val;
     supla_extended_value_t *supla_extval;
     supla_action_trigger_t *action_trigger;
-
-    STAILQ_ENTRY(supla_channel) channels; //other channels queued
 };
 
 /**
@@ -38,13 +36,19 @@ struct supla_channel {
  */
 TDS_SuplaDeviceChannel_E supla_channel_to_register_struct(supla_channel_t *ch);
 
+/**
+ * @brief  largest extended value the channel may send, 0 if it has none
+ */
+unsigned int supla_channel_max_extval_size(supla_channel_t *ch);
+
 /**
  * @brief  sync channel data with server
  *
  * @param[in] srpc srpc object
  * @param[in] ch given channel
+ * @return SUPLA_RESULT_FALSE if some data is still left to sync
  */
-void supla_channel_sync(void *srpc, supla_channel_t *ch);
+int supla_channel_sync(void *srpc, supla_channel_t *ch);
 
 #ifdef __cplusplus
 }
@@ -9,18 +9,62 @@
 #include <errno.h>
 
 #include "channel-priv.h"
+#include "port/net.h"
+#include "device-priv.h"
+
+/* channels take turns on a fixed set of locks instead of allocating one each */
+#define SUPLA_CHANNEL_LOCKS 64
+
+static void *supla_channel_locks[SUPLA_CHANNEL_LOCKS];
+
+/* a channel never holds its lock while taking another channel lock, so channels sharing one cannot deadlock */
+static void *supla_channel_lck_get(void)
+{
+    static unsigned int next;
+    unsigned int idx = __atomic_fetch_add(&next, 1, __ATOMIC_RELAXED) % SUPLA_CHANNEL_LOCKS;
+    void *lck = __atomic_load_n(&supla_channel_locks[idx], __ATOMIC_ACQUIRE);
+    void *expected = NULL;
+
+    if (lck)
+        return lck;
+
+    lck = lck_init();
+    if (lck && !__atomic_compare_exchange_n(&supla_channel_locks[idx], &expected, lck, false, __ATOMIC_ACQ_REL,
+                                            __ATOMIC_ACQUIRE)) {
+        lck_free(lck);
+        lck = expected;
+    }
+    return lck;
+}
+
+/* a channel and its value state are one allocation, only the part its type uses is set up */
+struct supla_channel_block {
+    struct supla_channel ch;
+    union {
+        struct {
+            supla_value_t val;
+            supla_extended_value_t extval;
+        } v;
+        supla_action_trigger_t at;
+    } state;
+};
 
 supla_channel_t *supla_channel_create(const supla_channel_config_t *config)
 {
     assert(NULL != config);
 
-    supla_channel_t *ch = calloc(1, sizeof(supla_channel_t));
-    if (!ch)
+    struct supla_channel_block *blk;
+    supla_channel_t *ch;
+
+    blk = salloc_calloc(NULL, 1, sizeof(struct supla_channel_block), SUPLA_ALLOC_TAG_CHANNEL);
+    if (!blk)
         return NULL;
 
+    ch = &blk->ch;
+
     //TODO verify channel config: type and functions
 
-    ch->lck = lck_init();
+    ch->lck = supla_channel_lck_get();
     ch->config = *config;
 
     /* set SUPLA_CHANNEL_FLAG_CHANNELSTATE if on_get_state callback function is set*/
@@ -72,31 +116,21 @@ supla_channel_t *supla_channel_create(const supla_channel_config_t *config)
     case SUPLA_CHANNELTYPE_VALVE_PERCENTAGE:
     case SUPLA_CHANNELTYPE_GENERAL_PURPOSE_MEASUREMENT:
     case SUPLA_CHANNELTYPE_ENGINE:
-        ch->supla_val = malloc(sizeof(supla_value_t));
-        if (ch->supla_val == NULL)
-            goto malloc_failed;
+        ch->supla_val = &blk->state.v.val;
         supla_val_init(ch->supla_val, ch->config.sync_values_onchange);
         break;
     case SUPLA_CHANNELTYPE_RELAY:
     case SUPLA_CHANNELTYPE_ELECTRICITY_METER:
     case SUPLA_CHANNELTYPE_IMPULSE_COUNTER:
     case SUPLA_CHANNELTYPE_THERMOSTAT:
-        ch->supla_val = malloc(sizeof(supla_value_t));
-        if (ch->supla_val == NULL)
-            goto malloc_failed;
+        ch->supla_val = &blk->state.v.val;
         supla_val_init(ch->supla_val, ch->config.sync_values_onchange);
 
-        ch->supla_extval = malloc(sizeof(supla_extended_value_t));
-        if (ch->supla_extval == NULL)
-            goto malloc_failed;
-
+        ch->supla_extval = &blk->state.v.extval;
         supla_extval_init(ch->supla_extval, ch->config.sync_values_onchange);
         break;
     case SUPLA_CHANNELTYPE_ACTIONTRIGGER:
-        ch->action_trigger = malloc(sizeof(supla_action_trigger_t));
-        if (ch->action_trigger == NULL)
-            goto malloc_failed;
-
+        ch->action_trigger = &blk->state.at;
         supla_action_trigger_init(ch->action_trigger);
         ch->action_trigger->properties.disablesLocalOperation = ch->config.action_trigger_conflicts;
         ch->action_trigger->properties.relatedChannelNumber = ch->number;
@@ -105,31 +139,14 @@ supla_channel_t *supla_channel_create(const supla_channel_config_t *config)
         break;
     }
     return ch;
-
-malloc_failed:
-    lck_free(ch->lck);
-    supla_val_free(ch->supla_val);
-    free(ch->supla_val);
-
-    supla_extval_free(ch->supla_extval);
-    free(ch->supla_extval);
-
-    supla_action_trigger_free(ch->action_trigger);
-    free(ch->action_trigger);
-
-    free(ch);
-    return NULL;
 }
 
 int supla_channel_free(supla_channel_t *ch)
 {
     assert(NULL != ch);
 
-    lck_free(ch->lck);
-    free(ch->supla_val);
-    free(ch->supla_extval);
-    free(ch->action_trigger);
-    free(ch);
+    supla_extval_free(ch->supla_extval);
+    salloc_free(NULL, ch, SUPLA_ALLOC_TAG_CHANNEL); /* first member of its block */
     return SUPLA_RESULT_TRUE;
 }
 
@@ -224,11 +241,17 @@ int supla_channel_get_active_function(supla_channel_t *ch, int *function)
 int supla_channel_set_value(supla_channel_t *ch, void *value, size_t len)
 {
     assert(NULL != ch);
-    int rc;
+    int rc, number;
+    supla_dev_t *dev;
 
     lck_lock(ch->lck);
     rc = supla_val_set(ch->supla_val, value, len);
+    /* wake up the iterating side only if there is something to sync */
+    dev = (rc == SUPLA_RESULT_TRUE && !ch->supla_val->sync) ? ch->dev : NULL;
+    number = ch->number;
     lck_unlock(ch->lck);
+
+    supla_dev_set_pending(dev, number);
     return rc;
 }
 
@@ -325,11 +348,17 @@ int supla_channel_set_thermostat_value(supla_channel_t *ch, TThermostat_Value *t
 int supla_channel_set_extval(supla_channel_t *ch, TSuplaChannelExtendedValue *extval)
 {
     assert(NULL != ch);
-    int rc;
+    int rc, number;
+    supla_dev_t *dev;
 
     lck_lock(ch->lck);
     rc = supla_extval_set(ch->supla_extval, extval);
+    /* wake up the iterating side only if there is something to sync */
+    dev = (rc == SUPLA_RESULT_TRUE && !ch->supla_extval->sync) ? ch->dev : NULL;
+    number = ch->number;
     lck_unlock(ch->lck);
+
+    supla_dev_set_pending(dev, number);
     return rc;
 }
 
@@ -381,7 +410,8 @@ int supla_channel_set_thermostat_extvalue(supla_channel_t *ch, TThermostat_Exten
 int supla_channel_emit_action(supla_channel_t *ch, const _supla_int_t action)
 {
     assert(NULL != ch);
-    int rc;
+    int rc, number;
+    supla_dev_t *dev;
 
     if (ch->config.type != SUPLA_CHANNELTYPE_ACTIONTRIGGER) {
         supla_log(LOG_ERR, "ch[%d] cannot emit action: bad channel type", ch->number);
@@ -390,7 +420,12 @@ int supla_channel_emit_action(supla_channel_t *ch, const _supla_int_t action)
 
     lck_lock(ch->lck);
     rc = supla_action_trigger_emit(ch->action_trigger, ch->number, action);
+    /* wake up the iterating side only if there is something to sync */
+    dev = (rc == SUPLA_RESULT_TRUE && !ch->action_trigger->sync) ? ch->dev : NULL;
+    number = ch->number;
     lck_unlock(ch->lck);
+
+    supla_dev_set_pending(dev, number);
     return rc;
 }
 
@@ -401,6 +436,10 @@ TDS_SuplaDeviceChannel_E supla_channel_to_register_struct(supla_channel_t *ch)
     TDS_SuplaDeviceChannel_E reg_channel;
     int rel_num = 0;
 
+    /* type and related channel are fixed at creation, take its lock before ours */
+    if (ch->config.type == SUPLA_CHANNELTYPE_ACTIONTRIGGER && ch->config.action_trigger_related_channel)
+        rel_num = supla_channel_get_assigned_number(*ch->config.action_trigger_related_channel) + 1;
+
     lck_lock(ch->lck);
     reg_channel.Number = ch->number;
     reg_channel.Type = ch->config.type;
@@ -412,10 +451,8 @@ TDS_SuplaDeviceChannel_E supla_channel_to_register_struct(supla_channel_t *ch)
     reg_channel.SubDeviceId = ch->config.subdevice_id;
 
     if (ch->config.type == SUPLA_CHANNELTYPE_ACTIONTRIGGER) {
-        if (ch->config.action_trigger_related_channel) {
-            rel_num = supla_channel_get_assigned_number(*ch->config.action_trigger_related_channel) + 1;
+        if (ch->config.action_trigger_related_channel)
             ch->action_trigger->properties.relatedChannelNumber = rel_num;
-        }
 
         reg_channel.ActionTriggerCaps = ch->config.action_trigger_caps;
         reg_channel.actionTriggerProperties = ch->action_trigger->properties;
@@ -428,6 +465,14 @@ TDS_SuplaDeviceChannel_E supla_channel_to_register_struct(supla_channel_t *ch)
     return reg_channel;
 }
 
+/* supla_channel_set_extval() takes any extended value, not only the typed ones */
+unsigned int supla_channel_max_extval_size(supla_channel_t *ch)
+{
+    assert(NULL != ch);
+
+    return ch->supla_extval ? SUPLA_CHANNELEXTENDEDVALUE_SIZE : 0;
+}
+
 int supla_channel_set_active_function(supla_channel_t *ch, int function)
 {
     assert(NULL != ch);
@@ -444,22 +489,31 @@ int supla_channel_set_active_function(supla_channel_t *ch, int function)
     return rc;
 }
 
-void supla_channel_sync(void *srpc, supla_channel_t *ch)
+int supla_channel_sync(void *srpc, supla_channel_t *ch)
 {
     assert(NULL != ch);
+    int rc = SUPLA_RESULT_TRUE;
+
+    /* keep values pending until the connection drains what is already sent */
+    if (srpc_output_congested(srpc))
+        return SUPLA_RESULT_FALSE;
 
     lck_lock(ch->lck);
     if (ch->supla_val && !ch->supla_val->sync) {
         supla_log(LOG_DEBUG, "sync channel[%d] val ", ch->number);
         ch->supla_val->sync = srpc_ds_async_channel_value_changed_c(srpc, ch->number, ch->supla_val->data.value,
                                                                     ch->config.offline, ch->config.value_validity_time);
+        if (!ch->supla_val->sync)
+            rc = SUPLA_RESULT_FALSE;
     }
 
     if (ch->supla_extval && !ch->supla_extval->sync) {
         supla_log(LOG_DEBUG, "sync channel[%d] extval", ch->number);
 
         ch->supla_extval->sync =
-            srpc_ds_async_channel_extendedvalue_changed(srpc, ch->number, &ch->supla_extval->extval);
+            srpc_ds_async_channel_extendedvalue_changed(srpc, ch->number, ch->supla_extval->extval);
+        if (!ch->supla_extval->sync)
+            rc = SUPLA_RESULT_FALSE;
     }
 
     if (ch->action_trigger && !ch->action_trigger->sync) {
@@ -467,6 +521,9 @@ void supla_channel_sync(void *srpc, supla_channel_t *ch)
                   ch->action_trigger->at.ActionTrigger);
 
         ch->action_trigger->sync = srpc_ds_async_action_trigger(srpc, &ch->action_trigger->at);
+        if (!ch->action_trigger->sync)
+            rc = SUPLA_RESULT_FALSE;
     }
     lck_unlock(ch->lck);
+    return rc;
 }
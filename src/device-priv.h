@@ -12,10 +12,30 @@ extern "C" {
 #endif
 
 #include <assert.h>
+#include <stdbool.h>
 #include <libsupla/device.h>
 
+#include "port/net.h"
+
 #include "../include/libsupla/push-notification.h"
 
+/* notifies whoever drives supla_dev_iterate() that the device has new work */
+struct supla_dev_waker {
+    void (*wakeup)(struct supla_dev_waker *waker, supla_dev_t *dev);
+};
+
+#define SUPLA_DEV_SERVERS (1 + SUPLA_CONFIG_FALLBACK_SERVERS)
+#define SUPLA_DEV_SERVER_BACKOFF_MSEC 60000
+
+#define SUPLA_DEV_PENDING_WORDS ((SUPLA_CHANNELMAXCOUNT + 63) / 64)
+
+/* connection history of a configured cloud server */
+struct supla_server_health {
+    uint32_t connect_msec; /* smoothed connect and handshake time, 0 if not known */
+    uint16_t failures;     /* consecutive, cleared on register */
+    uint64_t retry_msec;   /* degraded server is skipped until then */
+};
+
 /* device private data */
 struct supla_dev {
     char name[SUPLA_DEVICE_NAME_MAXSIZE];
@@ -29,6 +49,16 @@ struct supla_dev {
 
     supla_link_t cloud_link;
     void *srpc;
+
+    struct supla_dev_buffers buffers;
+    bool srpc_resize; /* buffers or channels changed, new srpc on the next connection */
+
+    struct supla_server_health servers[SUPLA_DEV_SERVERS];
+    int server; /* index of the server in use, 0 is supla_config.server */
+    supla_link_t standby_link;
+    int standby_server;
+    uint64_t standby_retry_msec;
+    struct supla_dev_connector *connector; /* connect in progress on another thread, NULL if none */
     void *lck;
 
     on_change_state_callback_t on_state_change;
@@ -50,9 +80,70 @@ struct supla_dev {
     time_t connection_uptime;
     unsigned char connection_reset_cause;
 
-    STAILQ_HEAD(qhead, supla_channel) channels;
+    /* device, channel table and srpc memory, NULL: default allocator */
+    const supla_allocator_t *allocator;
+
+    /* channels by number, grown on add */
+    supla_channel_t **channels;
+    int channel_count;
+    int channel_cap;
+
+    /* one bit per channel number with data left to sync, set from any thread */
+    uint64_t pending[SUPLA_DEV_PENDING_WORDS];
+
+    /* set while the device is driven by a hub */
+    struct supla_dev_waker *waker;
+    void *hub_entry;
 };
 
+/**
+ * @brief  call the device waker, if any, after changes that need an iteration
+ */
+void supla_dev_wakeup(supla_dev_t *dev);
+
+/**
+ * @brief  mark channel data for the next sync and wake up the device, dev may be NULL
+ */
+void supla_dev_set_pending(supla_dev_t *dev, int number);
+
+/**
+ * @brief  cloud connection socket descriptor, -1 if not connected
+ */
+int supla_dev_get_fd(supla_dev_t *dev);
+
+/**
+ * @brief  monotonic time in milliseconds when supla_dev_iterate() has to run
+ * again if no socket event or wakeup comes first, 0 when only those matter.
+ * Work no event reports, buffered input or unsynced channel data, makes it now.
+ */
+uint64_t supla_dev_next_iterate_msec(supla_dev_t *dev);
+
+/**
+ * @brief  true if srpc output waits for the socket to become writable
+ */
+bool supla_dev_output_pending(supla_dev_t *dev);
+
+/**
+ * @brief  close the cloud connection, the next iteration connects again
+ */
+void supla_dev_drop_connection(supla_dev_t *dev);
+
+/**
+ * @brief  count a failed connection to server idx, after failover_after of
+ * them in a row it is skipped for SUPLA_DEV_SERVER_BACKOFF_MSEC from now_msec
+ */
+void supla_dev_server_failed(supla_dev_t *dev, int idx, uint64_t now_msec);
+
+/**
+ * @brief  server to connect to next, the current one unless it is degraded
+ */
+int supla_dev_server_select(supla_dev_t *dev, uint64_t now_msec);
+
+/**
+ * @brief  fastest usable server other than skip, -1 if there is none
+ */
+int supla_dev_server_best(const supla_dev_t *dev, int skip, uint64_t now_msec);
+
 #ifdef __cplusplus
 }
 #endif
@@ -22,6 +22,360 @@ static int supla_dev_write(void *buf, int count, void *dcd)
     return supla_cloud_send(dev->cloud_link, buf, count);
 }
 
+static int supla_dev_writev(const TsrpcIoVec *iov, int iovcnt, void *dcd)
+{
+    supla_dev_t *dev = dcd;
+    return supla_cloud_sendv(dev->cloud_link, iov, iovcnt);
+}
+
+/* user timeout and keepalive expire with ETIMEDOUT, the rest is a broken link */
+static unsigned char supla_dev_reset_cause_from_error(int error)
+{
+    switch (error) {
+    case ETIMEDOUT:
+        return SUPLA_LASTCONNECTIONRESETCAUSE_ACTIVITY_TIMEOUT;
+    case ENETDOWN:
+    case ENETUNREACH:
+    case EHOSTUNREACH:
+        return SUPLA_LASTCONNECTIONRESETCAUSE_WIFI_CONNECTION_LOST;
+    default:
+        return SUPLA_LASTCONNECTIONRESETCAUSE_SERVER_CONNECTION_LOST;
+    }
+}
+
+#define SUPLA_DEV_FAILOVER_AFTER 3
+#define SUPLA_DEV_STANDBY_RETRY_MSEC 30000
+
+/* index 0 is the config server, an empty name marks an unused fallback slot */
+static const char *supla_dev_server_name(const supla_dev_t *dev, int idx)
+{
+    return idx ? dev->supla_config.fallback[idx - 1].name : dev->supla_config.server;
+}
+
+static int supla_dev_server_port(const supla_dev_t *dev, int idx)
+{
+    const struct supla_config *cfg = &dev->supla_config;
+
+    if (idx && cfg->fallback[idx - 1].port)
+        return cfg->fallback[idx - 1].port;
+    return cfg->port ? cfg->port : cfg->ssl ? 2016 : 2015;
+}
+
+static int supla_dev_failover_after(const supla_dev_t *dev)
+{
+    return dev->supla_config.failover_after > 0 ? dev->supla_config.failover_after : SUPLA_DEV_FAILOVER_AFTER;
+}
+
+static bool supla_dev_server_usable(const supla_dev_t *dev, int idx, uint64_t now_msec)
+{
+    const struct supla_server_health *health = &dev->servers[idx];
+
+    if (!supla_dev_server_name(dev, idx)[0])
+        return false;
+    return health->failures < supla_dev_failover_after(dev) || now_msec >= health->retry_msec;
+}
+
+/* a known connect time beats an unknown one, equal ones keep the config order */
+static bool supla_dev_server_faster(const supla_dev_t *dev, int a, int b)
+{
+    uint32_t a_msec = dev->servers[a].connect_msec;
+    uint32_t b_msec = dev->servers[b].connect_msec;
+
+    return a_msec && (!b_msec || a_msec < b_msec);
+}
+
+/* fastest usable server other than skip, -1 if there is none */
+int supla_dev_server_best(const supla_dev_t *dev, int skip, uint64_t now_msec)
+{
+    int best = -1;
+
+    for (int i = 0; i < SUPLA_DEV_SERVERS; i++) {
+        if (i == skip || !supla_dev_server_usable(dev, i, now_msec))
+            continue;
+        if (best == -1 || supla_dev_server_faster(dev, i, best))
+            best = i;
+    }
+    return best;
+}
+
+/* the current server is kept until it fails over, then the fastest other one takes over */
+int supla_dev_server_select(supla_dev_t *dev, uint64_t now_msec)
+{
+    int best;
+
+    if (supla_dev_server_usable(dev, dev->server, now_msec))
+        return dev->server;
+
+    best = supla_dev_server_best(dev, dev->server, now_msec);
+    if (best == -1) {
+        /* all of them are degraded, the one waiting longest goes first */
+        for (int i = 0; i < SUPLA_DEV_SERVERS; i++) {
+            if (supla_dev_server_name(dev, i)[0] &&
+                (best == -1 || dev->servers[i].retry_msec < dev->servers[best].retry_msec))
+                best = i;
+        }
+        if (best == -1)
+            return dev->server;
+    }
+
+    if (best != dev->server) {
+        supla_log(LOG_WARNING, "dev %s failover from %s:%d to %s:%d", dev->name, supla_dev_server_name(dev, dev->server),
+                  supla_dev_server_port(dev, dev->server), supla_dev_server_name(dev, best),
+                  supla_dev_server_port(dev, best));
+        dev->server = best;
+    }
+    return best;
+}
+
+void supla_dev_server_failed(supla_dev_t *dev, int idx, uint64_t now_msec)
+{
+    struct supla_server_health *health = &dev->servers[idx];
+
+    if (++health->failures < supla_dev_failover_after(dev))
+        return;
+
+    if (health->failures == supla_dev_failover_after(dev))
+        supla_log(LOG_WARNING, "dev %s server %s:%d degraded", dev->name, supla_dev_server_name(dev, idx),
+                  supla_dev_server_port(dev, idx));
+    health->retry_msec = now_msec + SUPLA_DEV_SERVER_BACKOFF_MSEC;
+}
+
+/*
+ * Cloud connect running off the iterating thread, it blocks for the TCP
+ * connect and the TLS handshake of every server it tries.
+ */
+struct supla_dev_connector {
+    supla_dev_t *dev;
+    void *job;
+    bool standby; /* the link becomes the standby connection */
+    bool discard; /* the config changed meanwhile */
+    bool done;
+    unsigned char ssl;
+    char dev_name[SUPLA_DEVICE_NAME_MAXSIZE];
+    struct supla_tcp_options tcp;
+    struct {
+        char name[SUPLA_SERVER_NAME_MAXSIZE]; /* empty if not tried */
+        int port;
+        supla_link_t link;
+        uint32_t msec; /* connect time including the TLS handshake, 0 if it failed */
+    } servers[SUPLA_DEV_SERVERS];
+};
+
+/* works on copies, of the device only the waker is used */
+static void supla_dev_connector_run(void *arg)
+{
+    struct supla_dev_connector *c = arg;
+    uint64_t start_msec;
+
+    for (int i = 0; i < SUPLA_DEV_SERVERS; i++) {
+        if (!c->servers[i].name[0])
+            continue;
+
+        supla_log(LOG_INFO, "dev %s init %s connection with: %s:%d", c->dev_name, c->ssl ? "encrypted" : "",
+                  c->servers[i].name, c->servers[i].port);
+
+        start_msec = supla_time_getmonotonictime_milliseconds();
+        if (!supla_cloud_connect(&c->servers[i].link, c->servers[i].name, c->servers[i].port, c->ssl)) {
+            supla_cloud_disconnect(&c->servers[i].link);
+            continue;
+        }
+        c->servers[i].msec = supla_time_getmonotonictime_milliseconds() - start_msec + 1;
+        supla_cloud_set_tcp_options(c->servers[i].link, &c->tcp);
+    }
+
+    __atomic_store_n(&c->done, true, __ATOMIC_RELEASE);
+    supla_dev_wakeup(c->dev);
+}
+
+/* connects to server idx, or to all of them with idx -1 */
+static int supla_dev_connector_start(supla_dev_t *dev, unsigned char ssl, int idx, bool standby)
+{
+    struct supla_dev_connector *c;
+
+    c = salloc_calloc(dev->allocator, 1, sizeof(struct supla_dev_connector), SUPLA_ALLOC_TAG_DEVICE);
+    if (!c)
+        return SUPLA_RESULT_FALSE;
+
+    c->dev = dev;
+    c->standby = standby;
+    c->ssl = ssl;
+    c->tcp = dev->supla_config.tcp;
+    snprintf(c->dev_name, SUPLA_DEVICE_NAME_MAXSIZE, "%s", dev->name);
+    for (int i = 0; i < SUPLA_DEV_SERVERS; i++) {
+        if (idx != -1 && idx != i)
+            continue;
+        snprintf(c->servers[i].name, SUPLA_SERVER_NAME_MAXSIZE, "%s", supla_dev_server_name(dev, i));
+        c->servers[i].port = supla_dev_server_port(dev, i);
+    }
+
+    /* set first, ports without threads run the job right away */
+    dev->connector = c;
+    if (!supla_job_start(&c->job, supla_dev_connector_run, c)) {
+        dev->connector = NULL;
+        salloc_free(dev->allocator, c, SUPLA_ALLOC_TAG_DEVICE);
+        return SUPLA_RESULT_FALSE;
+    }
+    return SUPLA_RESULT_TRUE;
+}
+
+/*
+ * Updates the server health with the outcome of a finished connect and hands
+ * out the link to the fastest server, NULL if none connected. False while the
+ * connect is still running.
+ */
+static bool supla_dev_connector_finish(supla_dev_t *dev, supla_link_t *link, int *server)
+{
+    struct supla_dev_connector *c = dev->connector;
+    uint64_t now_msec = supla_time_getmonotonictime_milliseconds();
+    struct supla_server_health *health;
+    uint32_t msec;
+    int best = -1;
+
+    if (!__atomic_load_n(&c->done, __ATOMIC_ACQUIRE))
+        return false;
+
+    supla_job_join(c->job);
+    dev->connector = NULL;
+
+    for (int i = 0; i < SUPLA_DEV_SERVERS && !c->discard; i++) {
+        if (!c->servers[i].name[0])
+            continue;
+
+        msec = c->servers[i].msec;
+        if (!msec) {
+            supla_dev_server_failed(dev, i, now_msec);
+            continue;
+        }
+
+        health = &dev->servers[i];
+        health->connect_msec = health->connect_msec ? (3 * health->connect_msec + msec) / 4 : msec;
+        if (best == -1 || supla_dev_server_faster(dev, i, best))
+            best = i;
+    }
+
+    for (int i = 0; i < SUPLA_DEV_SERVERS; i++) {
+        if (i != best)
+            supla_cloud_disconnect(&c->servers[i].link);
+    }
+
+    *link = best != -1 ? c->servers[best].link : NULL;
+    *server = best;
+    /* joins the io_uring ring of the hub loop iterating the device */
+    supla_cloud_attach(*link);
+
+    salloc_free(dev->allocator, c, SUPLA_ALLOC_TAG_DEVICE);
+    return true;
+}
+
+/* waits for a connect in progress and drops whatever it made */
+static void supla_dev_connector_cancel(supla_dev_t *dev)
+{
+    supla_link_t link;
+    int server;
+
+    if (!dev->connector)
+        return;
+
+    dev->connector->discard = true;
+    supla_job_join(dev->connector->job);
+    dev->connector->job = NULL;
+    supla_dev_connector_finish(dev, &link, &server);
+}
+
+/* an idle connection which was not registered yet has nothing to read */
+static bool supla_dev_link_idle(supla_link_t link)
+{
+    char c;
+
+    return supla_cloud_recv(link, &c, 1) == -1;
+}
+
+/* SUPLA_RESULT_TRUE once connected, -1 while connecting */
+static int supla_dev_cloud_connect(supla_dev_t *dev, unsigned char ssl)
+{
+    uint64_t now_msec = supla_time_getmonotonictime_milliseconds();
+    supla_link_t link;
+    bool standby, discard;
+    int idx;
+
+    if (dev->connector) {
+        standby = dev->connector->standby;
+        discard = dev->connector->discard;
+        if (!supla_dev_connector_finish(dev, &link, &idx))
+            return -1;
+
+        if (!standby && !discard) {
+            if (!link)
+                return SUPLA_RESULT_FALSE;
+            dev->cloud_link = link;
+            dev->server = idx;
+            return SUPLA_RESULT_TRUE;
+        }
+        /* a standby connect which finished after the connection was lost */
+        if (link) {
+            dev->standby_link = link;
+            dev->standby_server = idx;
+        }
+    }
+
+    /* until some server connected once, try them all and keep the fastest */
+    for (idx = 0; idx < SUPLA_DEV_SERVERS; idx++) {
+        if (dev->servers[idx].connect_msec)
+            break;
+    }
+    if (idx == SUPLA_DEV_SERVERS)
+        return supla_dev_connector_start(dev, ssl, -1, false) ? -1 : SUPLA_RESULT_FALSE;
+
+    idx = supla_dev_server_select(dev, now_msec);
+    if (dev->standby_link && dev->standby_server == idx) {
+        if (supla_dev_link_idle(dev->standby_link)) {
+            supla_log(LOG_INFO, "dev %s using standby connection with %s:%d", dev->name, supla_dev_server_name(dev, idx),
+                      supla_dev_server_port(dev, idx));
+            dev->cloud_link = dev->standby_link;
+            dev->standby_link = NULL;
+            return SUPLA_RESULT_TRUE;
+        }
+        supla_cloud_disconnect(&dev->standby_link);
+    }
+    return supla_dev_connector_start(dev, ssl, idx, false) ? -1 : SUPLA_RESULT_FALSE;
+}
+
+/* keeps a connection to the server the device would fail over to */
+static void supla_dev_standby_iterate(supla_dev_t *dev, unsigned char ssl)
+{
+    uint64_t now_msec = supla_time_getmonotonictime_milliseconds();
+    supla_link_t link;
+    bool discard;
+    int idx;
+
+    if (dev->connector) {
+        discard = dev->connector->discard;
+        if (!supla_dev_connector_finish(dev, &link, &idx))
+            return;
+
+        if (link) {
+            dev->standby_link = link;
+            dev->standby_server = idx;
+        } else if (!discard) {
+            dev->standby_retry_msec = now_msec + SUPLA_DEV_STANDBY_RETRY_MSEC;
+        }
+        return;
+    }
+
+    if (dev->standby_link && !supla_dev_link_idle(dev->standby_link)) {
+        supla_log(LOG_DEBUG, "dev %s standby connection closed", dev->name);
+        supla_cloud_disconnect(&dev->standby_link);
+        dev->standby_retry_msec = now_msec + SUPLA_DEV_STANDBY_RETRY_MSEC;
+    }
+
+    if (!dev->supla_config.standby || dev->standby_link || now_msec < dev->standby_retry_msec)
+        return;
+
+    idx = supla_dev_server_best(dev, dev->server, now_msec);
+    if (idx == -1 || !supla_dev_connector_start(dev, ssl, idx, true))
+        dev->standby_retry_msec = now_msec + SUPLA_DEV_STANDBY_RETRY_MSEC;
+}
+
 static inline void supla_dev_set_iterate_delay_msec(supla_dev_t *dev, uint64_t msec)
 {
     dev->wait_iterate_msec = msec;
@@ -114,6 +468,7 @@ static void supla_connection_on_register_result(supla_dev_t *dev, TSD_SuplaRegis
             srpc_dcs_async_set_activity_timeout(dev->srpc, &timeout);
         }
         gettimeofday(&dev->register_time, NULL);
+        dev->servers[dev->server].failures = 0;
         supla_dev_set_state(dev, SUPLA_DEV_STATE_REGISTERED);
     } break;
 
@@ -426,12 +781,60 @@ static int supla_connection_ping(supla_dev_t *dev)
     return SUPLA_RESULT_TRUE;
 }
 
+static void *supla_dev_srpc_init(supla_dev_t *dev)
+{
+    TsrpcParams srpc_params;
+    supla_channel_t *ch;
+    unsigned int extval_size = 0;
+    int n;
+
+    srpc_params_init(&srpc_params);
+
+    srpc_params.data_read = supla_dev_read;
+    srpc_params.data_write = supla_dev_write;
+    srpc_params.data_writev = supla_dev_writev;
+    srpc_params.out_coalesce = 1;
+    srpc_params.rd_views = 1;
+    srpc_params.on_remote_call_received = supla_dev_on_remote_call_received;
+    srpc_params.user_params = dev;
+
+    srpc_params.buffer_size = dev->buffers.io_size;
+    srpc_params.proto_buffer_min_size = dev->buffers.buffer_min_size;
+    srpc_params.proto_buffer_max_size = dev->buffers.buffer_max_size;
+    srpc_params.queue_slab_size = dev->buffers.queue_slab_size;
+    srpc_params.max_data_size = dev->buffers.max_data_size;
+    srpc_params.in_queue_size = dev->buffers.in_queue_size;
+    srpc_params.out_queue_size = dev->buffers.out_queue_size;
+    srpc_params.shared_scratch = dev->buffers.lean;
+    srpc_params.release_idle = dev->buffers.lean;
+    srpc_params.allocator = dev->allocator;
+
+    if (dev->buffers.autosize) {
+        for (n = 0; n < dev->channel_count; n++) {
+            ch = dev->channels[n];
+            if (supla_channel_max_extval_size(ch) > extval_size)
+                extval_size = supla_channel_max_extval_size(ch);
+        }
+        srpc_params_autosize(&srpc_params, dev->channel_count, extval_size);
+    }
+
+    return srpc_init(&srpc_params);
+}
+
 supla_dev_t *supla_dev_create(const char *dev_name, const char *soft_ver)
 {
-    supla_dev_t *dev = calloc(1, sizeof(supla_dev_t));
+    return supla_dev_create_with_allocator(dev_name, soft_ver, NULL);
+}
+
+supla_dev_t *supla_dev_create_with_allocator(const char *dev_name, const char *soft_ver,
+                                             const supla_allocator_t *allocator)
+{
+    supla_dev_t *dev = salloc_calloc(allocator, 1, sizeof(supla_dev_t), SUPLA_ALLOC_TAG_DEVICE);
     if (!dev)
         return NULL;
 
+    dev->allocator = allocator;
+
     if (dev_name)
         strncpy(dev->name, dev_name, SUPLA_DEVICE_NAME_MAXSIZE - 1);
     else
@@ -445,37 +848,33 @@ supla_dev_t *supla_dev_create(const char *dev_name, const char *soft_ver)
     dev->state = SUPLA_DEV_STATE_IDLE;
     dev->activity_timeout = 120;
 
-    TsrpcParams srpc_params;
-    srpc_params_init(&srpc_params);
-
-    srpc_params.data_read = supla_dev_read;
-    srpc_params.data_write = supla_dev_write;
-    srpc_params.on_remote_call_received = supla_dev_on_remote_call_received;
-    srpc_params.user_params = dev;
-
-    dev->srpc = srpc_init(&srpc_params);
+    dev->srpc = supla_dev_srpc_init(dev);
     dev->lck = lck_init();
 
     gettimeofday(&dev->init_time, NULL);
-    STAILQ_INIT(&dev->channels);
     return dev;
 }
 
+void supla_set_default_allocator(const supla_allocator_t *allocator)
+{
+    salloc_set_default(allocator);
+}
+
 int supla_dev_free(supla_dev_t *dev)
 {
     assert(NULL != dev);
-    supla_channel_t *ch;
+    int n;
 
+    supla_dev_connector_cancel(dev);
     supla_cloud_disconnect(&dev->cloud_link);
+    supla_cloud_disconnect(&dev->standby_link);
     srpc_free(dev->srpc);
     lck_free(dev->lck);
 
-    while (!STAILQ_EMPTY(&dev->channels)) {
-        ch = STAILQ_FIRST(&dev->channels);
-        STAILQ_REMOVE_HEAD(&dev->channels, channels);
-        supla_channel_free(ch);
-    }
-    free(dev);
+    for (n = 0; n < dev->channel_count; n++)
+        supla_channel_free(dev->channels[n]);
+    salloc_free(dev->allocator, dev->channels, SUPLA_ALLOC_TAG_DEVICE);
+    salloc_free(dev->allocator, dev, SUPLA_ALLOC_TAG_DEVICE);
     return SUPLA_RESULT_TRUE;
 }
 
@@ -560,6 +959,19 @@ int supla_dev_set_activity_timeout(supla_dev_t *dev, int sec)
     return SUPLA_RESULT_TRUE;
 }
 
+int supla_dev_set_buffers(supla_dev_t *dev, const struct supla_dev_buffers *buffers)
+{
+    assert(NULL != dev);
+    assert(NULL != buffers);
+
+    lck_lock(dev->lck);
+    dev->buffers = *buffers;
+    dev->srpc_resize = true;
+    lck_unlock(dev->lck);
+
+    return SUPLA_RESULT_TRUE;
+}
+
 int supla_dev_get_activity_timeout(const supla_dev_t *dev, int *sec)
 {
     assert(NULL != dev);
@@ -692,15 +1104,29 @@ int supla_dev_add_channel(supla_dev_t *dev, supla_channel_t *ch)
 {
     assert(NULL != dev);
     assert(NULL != ch);
-    int channel_count;
+    supla_channel_t **channels;
+    int channel_count, cap;
 
-    channel_count = supla_dev_get_channel_count(dev);
+    lck_lock(dev->lck);
+    channel_count = dev->channel_count;
     if (channel_count + 1 >= SUPLA_CHANNELMAXCOUNT) {
         supla_log(LOG_ERR, "dev %s cannot add channel: channel max count reached", dev->name);
+        lck_unlock(dev->lck);
         return SUPLA_RESULT_FALSE;
     }
 
-    lck_lock(dev->lck);
+    if (channel_count == dev->channel_cap) {
+        cap = dev->channel_cap ? dev->channel_cap * 2 : 8;
+        channels = salloc_realloc(dev->allocator, dev->channels, cap * sizeof(supla_channel_t *),
+                                  SUPLA_ALLOC_TAG_DEVICE);
+        if (!channels) {
+            lck_unlock(dev->lck);
+            return SUPLA_RESULT_FALSE;
+        }
+        dev->channels = channels;
+        dev->channel_cap = cap;
+    }
+
     lck_lock(ch->lck);
     if (ch->config.type == SUPLA_CHANNELTYPE_ACTIONTRIGGER)
         supla_log(LOG_DEBUG, "dev %s ch[%d]add new action trigger", dev->name, channel_count);
@@ -709,11 +1135,16 @@ int supla_dev_add_channel(supla_dev_t *dev, supla_channel_t *ch)
 
     ch->dev = dev;
     ch->number = channel_count;
-    STAILQ_INSERT_TAIL(&dev->channels, ch, channels);
+    dev->channels[dev->channel_count++] = ch;
+    if (dev->buffers.autosize)
+        dev->srpc_resize = true;
 
     lck_unlock(ch->lck);
     lck_unlock(dev->lck);
 
+    /* values set before the channel was added are sent once online */
+    supla_dev_set_pending(dev, channel_count);
+
     if (ch->config.on_channel_init)
         ch->config.on_channel_init(ch);
     return SUPLA_RESULT_TRUE;
@@ -723,14 +1154,10 @@ int supla_dev_get_channel_count(const supla_dev_t *dev)
 {
     assert(NULL != dev);
 
-    supla_channel_t *ch;
-    int n = 0;
+    int n;
 
     lck_lock(dev->lck);
-    STAILQ_FOREACH(ch, &dev->channels, channels)
-    {
-        n++;
-    }
+    n = dev->channel_count;
     lck_unlock(dev->lck);
     return n;
 }
@@ -739,14 +1166,11 @@ supla_channel_t *supla_dev_get_channel_by_num(const supla_dev_t *dev, int num)
 {
     assert(NULL != dev);
 
-    supla_channel_t *ch, *out = NULL;
+    supla_channel_t *out = NULL;
 
     lck_lock(dev->lck);
-    STAILQ_FOREACH(ch, &dev->channels, channels)
-    {
-        if (supla_channel_get_assigned_number(ch) == num)
-            out = ch;
-    }
+    if (num >= 0 && num < dev->channel_count)
+        out = dev->channels[num];
     lck_unlock(dev->lck);
     return out;
 }
@@ -771,6 +1195,12 @@ int supla_dev_set_config(supla_dev_t *dev, const struct supla_config *config)
 
     lck_lock(dev->lck);
     dev->supla_config = *config;
+    memset(dev->servers, 0, sizeof(dev->servers));
+    dev->server = 0;
+    supla_cloud_disconnect(&dev->standby_link);
+    dev->standby_retry_msec = 0;
+    if (dev->connector)
+        dev->connector->discard = true;
     lck_unlock(dev->lck);
 
     return SUPLA_RESULT_TRUE;
@@ -788,6 +1218,20 @@ int supla_dev_get_config(supla_dev_t *dev, struct supla_config *config)
     return SUPLA_RESULT_TRUE;
 }
 
+int supla_dev_get_server(const supla_dev_t *dev, char *name, size_t len)
+{
+    assert(NULL != dev);
+    assert(NULL != name);
+    assert(0 != len);
+
+    lck_lock(dev->lck);
+    strncpy(name, supla_dev_server_name(dev, dev->server), len - 1);
+    name[len - 1] = 0;
+    lck_unlock(dev->lck);
+
+    return SUPLA_RESULT_TRUE;
+}
+
 int supla_dev_enable_notifications(supla_dev_t *dev, const unsigned char server_managed_fields)
 {
     assert(NULL != dev);
@@ -818,13 +1262,14 @@ int supla_dev_send_notification(supla_dev_t *dev, int ctx, const char *title, co
     supla_channel_t *ch;
     TDS_PushNotification notification = {};
     bool enabled = false;
+    int rc, n;
 
     lck_lock(dev->lck);
     if (ctx == -1) {
         enabled = dev->push_notification.enabled;
     } else {
-        STAILQ_FOREACH(ch, &dev->channels, channels)
-        {
+        for (n = 0; n < dev->channel_count; n++) {
+            ch = dev->channels[n];
             if (ctx == supla_channel_get_assigned_number(ch) && ch->config.push_notification.enabled)
                 enabled = true;
         }
@@ -855,11 +1300,14 @@ int supla_dev_send_notification(supla_dev_t *dev, int ctx, const char *title, co
         notification.SoundId = -1;
     else
         notification.SoundId = sound_id;
-    lck_unlock(dev->lck);
 
     supla_log(LOG_DEBUG, "dev %s notify: %s: %s", dev->name, title, message);
 
-    return srpc_ds_async_send_push_notification(dev->srpc, &notification);
+    /* under dev->lck, supla_dev_iterate() replaces dev->srpc when the buffers change */
+    rc = srpc_ds_async_send_push_notification(dev->srpc, &notification);
+    lck_unlock(dev->lck);
+    supla_dev_wakeup(dev);
+    return rc;
 }
 
 int supla_dev_start(supla_dev_t *dev)
@@ -876,6 +1324,7 @@ int supla_dev_start(supla_dev_t *dev)
     supla_dev_set_state(dev, SUPLA_DEV_STATE_INIT);
     lck_unlock(dev->lck);
 
+    supla_dev_wakeup(dev);
     return SUPLA_RESULT_TRUE;
 }
 
@@ -887,6 +1336,7 @@ int supla_dev_stop(supla_dev_t *dev)
     supla_dev_set_state(dev, SUPLA_DEV_STATE_IDLE);
     lck_unlock(dev->lck);
 
+    supla_dev_wakeup(dev);
     return SUPLA_RESULT_TRUE;
 }
 
@@ -899,21 +1349,17 @@ static TDS_SuplaDeviceChannel_E get_channel_data_callback(void *dev, int ch_num)
 static int supla_dev_register(supla_dev_t *dev)
 {
     TDS_SuplaRegisterDeviceHeader reg_dev_hdr = { 0 };
-    supla_channel_t *ch;
 
     strncpy(reg_dev_hdr.Email, dev->supla_config.email, SUPLA_EMAIL_MAXSIZE);
     strncpy(reg_dev_hdr.AuthKey, dev->supla_config.auth_key, SUPLA_AUTHKEY_SIZE);
     strncpy(reg_dev_hdr.GUID, dev->supla_config.guid, SUPLA_GUID_SIZE);
     strncpy(reg_dev_hdr.Name, dev->name, SUPLA_DEVICE_NAME_MAXSIZE);
     strncpy(reg_dev_hdr.SoftVer, dev->soft_ver, SUPLA_SOFTVER_MAXSIZE);
-    strncpy(reg_dev_hdr.ServerName, dev->supla_config.server, SUPLA_SERVER_NAME_MAXSIZE);
+    strncpy(reg_dev_hdr.ServerName, supla_dev_server_name(dev, dev->server), SUPLA_SERVER_NAME_MAXSIZE);
     reg_dev_hdr.Flags = dev->flags;
     reg_dev_hdr.ManufacturerID = dev->mfr_data.manufacturer_id;
     reg_dev_hdr.ProductID = dev->mfr_data.product_id;
-    STAILQ_FOREACH(ch, &dev->channels, channels)
-    {
-        reg_dev_hdr.channel_count++;
-    }
+    reg_dev_hdr.channel_count = dev->channel_count;
     supla_log(LOG_INFO, "dev %s register...", dev->name);
     gettimeofday(&dev->register_time, NULL);
     return srpc_ds_async_registerdevice_in_chunks_g(dev->srpc, &reg_dev_hdr, get_channel_data_callback, dev);
@@ -931,9 +1377,10 @@ static int supla_dev_set_channel_captions(supla_dev_t *dev)
 {
     supla_channel_t *ch;
     TDCS_SetCaption req = {};
+    int n;
 
-    STAILQ_FOREACH(ch, &dev->channels, channels)
-    {
+    for (n = 0; n < dev->channel_count; n++) {
+        ch = dev->channels[n];
         if (ch->config.default_caption) {
             req.ChannelNumber = supla_channel_get_assigned_number(ch);
             strncpy(req.Caption, ch->config.default_caption, SUPLA_CAPTION_MAXSIZE - 1);
@@ -954,9 +1401,10 @@ static int supla_dev_sync_channel_configurations(supla_dev_t *dev)
     supla_channel_t *ch;
     TDS_GetChannelConfigRequest req = {};
     TSDS_SetChannelConfig set_req = {};
+    int n;
 
-    STAILQ_FOREACH(ch, &dev->channels, channels)
-    {
+    for (n = 0; n < dev->channel_count; n++) {
+        ch = dev->channels[n];
         if (ch->config.on_config_recv) {
             req.ChannelNumber = supla_channel_get_assigned_number(ch);
             req.ConfigType = SUPLA_CONFIG_TYPE_DEFAULT;
@@ -985,6 +1433,7 @@ static int supla_dev_register_push_notifications(supla_dev_t *dev)
 {
     supla_channel_t *ch;
     TDS_RegisterPushNotification pn_reg = {};
+    int n;
 
     if (dev->push_notification.enabled) {
         pn_reg.Context = -1; //Device context
@@ -992,8 +1441,8 @@ static int supla_dev_register_push_notifications(supla_dev_t *dev)
         supla_log(LOG_DEBUG, "dev %s register device PUSH notification", dev->name);
         srpc_ds_async_register_push_notification(dev->srpc, &pn_reg);
     }
-    STAILQ_FOREACH(ch, &dev->channels, channels)
-    {
+    for (n = 0; n < dev->channel_count; n++) {
+        ch = dev->channels[n];
         if (ch->config.push_notification.enabled) {
             memset(&pn_reg, 0, sizeof(TDS_RegisterPushNotification));
             pn_reg.Context = supla_channel_get_assigned_number(ch);
@@ -1005,13 +1454,39 @@ static int supla_dev_register_push_notifications(supla_dev_t *dev)
     return 0;
 }
 
-static void supla_dev_sync_channels_data(supla_dev_t *dev)
+/* channel data waits for supla_dev_sync_channels_data() */
+static bool supla_dev_sync_pending(supla_dev_t *dev)
 {
-    supla_channel_t *ch;
+    for (int word = 0; word < SUPLA_DEV_PENDING_WORDS; word++) {
+        if (__atomic_load_n(&dev->pending[word], __ATOMIC_RELAXED))
+            return true;
+    }
+    return false;
+}
 
-    STAILQ_FOREACH(ch, &dev->channels, channels)
-    {
-        supla_channel_sync(dev->srpc, ch);
+/* only channels marked pending are visited, an idle device reads a couple of words per tick */
+static void supla_dev_sync_channels_data(supla_dev_t *dev)
+{
+    uint64_t pending;
+    int word, n;
+
+    for (word = 0; word < SUPLA_DEV_PENDING_WORDS; word++) {
+        if (!__atomic_load_n(&dev->pending[word], __ATOMIC_RELAXED))
+            continue;
+
+        pending = __atomic_exchange_n(&dev->pending[word], 0, __ATOMIC_ACQ_REL);
+        while (pending) {
+            n = word * 64 + __builtin_ctzll(pending);
+            pending &= pending - 1;
+
+            /*
+             * Not sent yet, e.g. the connection is congested. No wakeup, the
+             * output draining makes supla_dev_next_iterate_msec() ask for the
+             * next tick.
+             */
+            if (n < dev->channel_count && supla_channel_sync(dev->srpc, dev->channels[n]) != SUPLA_RESULT_TRUE)
+                __atomic_fetch_or(&dev->pending[word], 1ULL << (n % 64), __ATOMIC_RELAXED);
+        }
     }
 }
 
@@ -1019,7 +1494,13 @@ static int supla_dev_iterate_tick(supla_dev_t *dev)
 {
     struct timeval sys_time;
     struct supla_config *cloud_cfg = &dev->supla_config;
-    int port = cloud_cfg->port ? cloud_cfg->port : cloud_cfg->ssl ? 2016 : 2015;
+    unsigned char ssl = cloud_cfg->ssl ? 1 : 0;
+    int result;
+
+    if (ssl && cloud_cfg->ktls)
+        ssl |= SUPLA_CLOUD_SSL_KTLS;
+    if (ssl && dev->buffers.lean)
+        ssl |= SUPLA_CLOUD_SSL_LEAN;
     uint64_t sys_time_msec = supla_time_getmonotonictime_milliseconds();
     gettimeofday(&sys_time, NULL);
 
@@ -1041,11 +1522,23 @@ static int supla_dev_iterate_tick(supla_dev_t *dev)
         memset(&dev->last_ping, 0, sizeof(dev->last_ping));
         memset(&dev->last_resp, 0, sizeof(dev->last_resp));
 
-        supla_log(LOG_INFO, "dev %s init %s connection with: %s:%d", dev->name, cloud_cfg->ssl ? "encrypted" : "",
-                  cloud_cfg->server, port);
-
         supla_cloud_disconnect(&dev->cloud_link);
-        if (supla_cloud_connect(&dev->cloud_link, cloud_cfg->server, port, cloud_cfg->ssl)) {
+        srpc_reset(dev->srpc);
+        if (dev->srpc_resize) {
+            void *srpc = supla_dev_srpc_init(dev);
+
+            /* keeps the old sizes if there is no memory for the new ones */
+            if (srpc) {
+                srpc_free(dev->srpc);
+                dev->srpc = srpc;
+                dev->srpc_resize = false;
+            }
+        }
+        result = supla_dev_cloud_connect(dev, ssl);
+        /* the connect wakes the device up once it is done */
+        if (result == -1)
+            return 0;
+        if (result) {
             supla_log(LOG_INFO, "dev %s connected to server", dev->name);
             if (!supla_dev_register(dev)) {
                 supla_log(LOG_ERR, "dev %s supla_dev_register failed!", dev->name);
@@ -1053,7 +1546,10 @@ static int supla_dev_iterate_tick(supla_dev_t *dev)
             }
             supla_dev_set_state(dev, SUPLA_DEV_STATE_CONNECTED);
         } else {
-            supla_dev_set_iterate_delay_msec(dev, 5000);
+            /* no need to wait when another server is there to fail over to */
+            if (supla_dev_server_usable(dev, dev->server, sys_time_msec) ||
+                supla_dev_server_best(dev, dev->server, sys_time_msec) == -1)
+                supla_dev_set_iterate_delay_msec(dev, 5000);
             return SUPLA_RESULT_FALSE;
         }
         break;
@@ -1061,6 +1557,7 @@ static int supla_dev_iterate_tick(supla_dev_t *dev)
     case SUPLA_DEV_STATE_CONNECTED:
         if (difftime(sys_time.tv_sec, dev->register_time.tv_sec) > 10) {
             supla_log(LOG_ERR, "dev %s register failed: server not responded!", dev->name);
+            supla_dev_server_failed(dev, dev->server, sys_time_msec);
             supla_dev_set_connection_reset_cause(dev, SUPLA_LASTCONNECTIONRESETCAUSE_SERVER_CONNECTION_LOST);
             supla_dev_set_state(dev, SUPLA_DEV_STATE_INIT);
         }
@@ -1078,19 +1575,27 @@ static int supla_dev_iterate_tick(supla_dev_t *dev)
     case SUPLA_DEV_STATE_ONLINE:
         dev->connection_uptime = difftime(sys_time.tv_sec, dev->register_time.tv_sec);
         if (supla_connection_ping(dev) == SUPLA_RESULT_FALSE) {
+            supla_dev_server_failed(dev, dev->server, sys_time_msec);
             supla_dev_set_connection_reset_cause(dev, SUPLA_LASTCONNECTIONRESETCAUSE_ACTIVITY_TIMEOUT);
             supla_dev_set_state(dev, SUPLA_DEV_STATE_INIT);
             return SUPLA_RESULT_FALSE;
         }
         supla_dev_sync_channels_data(dev);
+        supla_dev_standby_iterate(dev, ssl);
         break;
     default:
         break;
     }
 
     if (srpc_iterate(dev->srpc) == SUPLA_RESULT_FALSE) {
-        supla_log(LOG_ERR, "srpc_iterate failed");
-        supla_dev_set_connection_reset_cause(dev, SUPLA_LASTCONNECTIONRESETCAUSE_SERVER_CONNECTION_LOST);
+        int error = supla_cloud_get_error(dev->cloud_link);
+
+        if (error)
+            supla_log(LOG_ERR, "dev %s connection lost: %s", dev->name, strerror(error));
+        else
+            supla_log(LOG_ERR, "srpc_iterate failed");
+        supla_dev_server_failed(dev, dev->server, sys_time_msec);
+        supla_dev_set_connection_reset_cause(dev, supla_dev_reset_cause_from_error(error));
         supla_dev_set_state(dev, SUPLA_DEV_STATE_INIT);
         supla_dev_set_iterate_delay_msec(dev, 5000);
         return SUPLA_RESULT_FALSE;
@@ -1109,6 +1614,134 @@ int supla_dev_iterate(supla_dev_t *dev)
     return result;
 }
 
+void supla_dev_set_pending(supla_dev_t *dev, int number)
+{
+    if (!dev || number < 0 || number >= SUPLA_CHANNELMAXCOUNT)
+        return;
+
+    __atomic_fetch_or(&dev->pending[number / 64], 1ULL << (number % 64), __ATOMIC_RELEASE);
+    supla_dev_wakeup(dev);
+}
+
+void supla_dev_wakeup(supla_dev_t *dev)
+{
+    struct supla_dev_waker *waker;
+
+    if (!dev)
+        return;
+
+    waker = __atomic_load_n(&dev->waker, __ATOMIC_ACQUIRE);
+    if (waker)
+        waker->wakeup(waker, dev);
+}
+
+int supla_dev_get_fd(supla_dev_t *dev)
+{
+    assert(NULL != dev);
+    int fd;
+
+    lck_lock(dev->lck);
+    fd = dev->cloud_link ? supla_cloud_get_fd(dev->cloud_link) : -1;
+    lck_unlock(dev->lck);
+    return fd;
+}
+
+bool supla_dev_output_pending(supla_dev_t *dev)
+{
+    assert(NULL != dev);
+    bool pending;
+
+    lck_lock(dev->lck);
+    pending = srpc_output_dataexists(dev->srpc);
+    lck_unlock(dev->lck);
+    return pending;
+}
+
+void supla_dev_drop_connection(supla_dev_t *dev)
+{
+    assert(NULL != dev);
+
+    lck_lock(dev->lck);
+    supla_cloud_disconnect(&dev->cloud_link);
+    supla_cloud_disconnect(&dev->standby_link);
+    srpc_reset(dev->srpc);
+    if (dev->state == SUPLA_DEV_STATE_CONNECTED || dev->state == SUPLA_DEV_STATE_REGISTERED ||
+        dev->state == SUPLA_DEV_STATE_ONLINE)
+        supla_dev_set_state(dev, SUPLA_DEV_STATE_INIT);
+    lck_unlock(dev->lck);
+}
+
+/* msec from now until the wall clock second deadline starts */
+static uint64_t supla_dev_msec_until(const struct timeval *now, time_t deadline)
+{
+    if (deadline <= now->tv_sec)
+        return 0;
+    return (uint64_t)(deadline - now->tv_sec) * 1000 - now->tv_usec / 1000;
+}
+
+uint64_t supla_dev_next_iterate_msec(supla_dev_t *dev)
+{
+    assert(NULL != dev);
+    struct timeval now;
+    uint64_t now_msec = supla_time_getmonotonictime_milliseconds();
+    uint64_t next = 0;
+    time_t ping, resp;
+
+    lck_lock(dev->lck);
+    gettimeofday(&now, NULL);
+
+    switch (dev->state) {
+    case SUPLA_DEV_STATE_INIT:
+        /* a connect in progress wakes the device up once it is done */
+        if (!dev->connector)
+            next = now_msec;
+        break;
+    case SUPLA_DEV_STATE_REGISTERED:
+        next = now_msec;
+        break;
+    case SUPLA_DEV_STATE_CONNECTED:
+        /* register timeout, see supla_dev_iterate_tick() */
+        next = now_msec + supla_dev_msec_until(&now, dev->register_time.tv_sec + 11);
+        break;
+    case SUPLA_DEV_STATE_ONLINE:
+        if (dev->activity_timeout == 0)
+            break;
+        /* ping and ping timeout, see supla_connection_ping() */
+        ping = dev->last_ping.tv_sec + dev->activity_timeout - 5;
+        resp = dev->last_resp.tv_sec + dev->activity_timeout + 10;
+        next = now_msec + supla_dev_msec_until(&now, ping < resp ? ping : resp);
+        break;
+    default:
+        break;
+    }
+
+    /*
+     * srpc_iterate() runs only in these states. Data already read from the
+     * socket, complete packets or what the link holds, raises no event.
+     */
+    if ((dev->state == SUPLA_DEV_STATE_CONNECTED || dev->state == SUPLA_DEV_STATE_ONLINE) &&
+        (srpc_iterate_pending(dev->srpc) || supla_cloud_pending(dev->cloud_link) > 0))
+        next = now_msec;
+
+    /*
+     * Channel data left unsynced while the output was congested, the tick
+     * which drained the output raises nothing else. A congested output waits
+     * for the socket to become writable instead.
+     */
+    if (dev->state == SUPLA_DEV_STATE_ONLINE && supla_dev_sync_pending(dev) && !srpc_output_congested(dev->srpc))
+        next = now_msec;
+
+    /* in INIT or a standby connect, see supla_dev_standby_iterate() */
+    if (dev->connector && __atomic_load_n(&dev->connector->done, __ATOMIC_ACQUIRE))
+        next = now_msec;
+
+    if (next && dev->wait_iterate_msec && next < dev->iterate_time_msec + dev->wait_iterate_msec)
+        next = dev->iterate_time_msec + dev->wait_iterate_msec;
+
+    lck_unlock(dev->lck);
+    return next;
+}
+
 int supla_dev_enter_config_mode(supla_dev_t *dev)
 {
     assert(NULL != dev);
@@ -1116,6 +1749,8 @@ int supla_dev_enter_config_mode(supla_dev_t *dev)
     lck_lock(dev->lck);
     supla_dev_set_state(dev, SUPLA_DEV_STATE_CONFIG);
     lck_unlock(dev->lck);
+
+    supla_dev_wakeup(dev);
     return SUPLA_RESULT_TRUE;
 }
 
@@ -1132,5 +1767,7 @@ int supla_dev_exit_config_mode(supla_dev_t *dev)
     lck_lock(dev->lck);
     supla_dev_set_state(dev, SUPLA_DEV_STATE_IDLE);
     lck_unlock(dev->lck);
+
+    supla_dev_wakeup(dev);
     return SUPLA_RESULT_TRUE;
 }
@@ -0,0 +1,584 @@
+/*
+ * Copyright (c) 2022 <qb4.dev@gmail.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/queue.h>
+
+#include <libsupla/hub.h>
+
+#include "port/util.h"
+#include "port/net.h"
+#include "port/uring.h"
+#include "device-priv.h"
+#include "supla-common/twheel.h"
+
+#define HUB_MAX_EVENTS 64
+/* iterations in a row for a device which still has work to do */
+#define HUB_ITERATE_BURST 8
+#define HUB_URING_ENTRIES 256
+
+struct hub_loop;
+
+struct hub_entry {
+    supla_dev_t *dev;
+    struct hub_loop *loop;
+
+    int fd; /* registered in epoll, -1 if none */
+    uint32_t events;
+    TWheelTimer timer; /* next supla_dev_iterate() deadline */
+
+    bool dirty;
+    bool ready;
+    bool removed;
+    bool online;
+
+    struct hub_entry *dirty_next; /* also links removed entries */
+    struct hub_entry *ready_next;
+    LIST_ENTRY(hub_entry) entries;
+};
+
+struct hub_loop {
+    struct supla_dev_waker waker; /* must be first */
+    pthread_t thread;
+    bool started;
+    bool stop;
+
+    int epoll_fd;
+    int event_fd;
+    struct supla_uring *ring; /* cloud socket I/O of the devices, if enabled */
+
+    /* held by the loop thread while it processes events */
+    void *lck;
+    LIST_HEAD(, hub_entry) entries;
+    void *timers;
+    struct hub_entry *zombies;
+
+    /* guards dirty list and dev->hub_entry */
+    void *dirty_lck;
+    struct hub_entry *dirty;
+
+    int device_count;
+    int online_count;
+    uint64_t iterations;
+    uint64_t socket_events;
+    uint64_t timer_events;
+    uint64_t dirty_events;
+    uint64_t loop_wakeups;
+    uint64_t io_submits;
+    uint64_t io_ops;
+};
+
+struct supla_hub {
+    void *lck;
+    int loop_count;
+    struct hub_loop *loops;
+};
+
+#define hub_stat_add(var, val) __atomic_add_fetch(&(var), val, __ATOMIC_RELAXED)
+#define hub_stat_get(var) __atomic_load_n(&(var), __ATOMIC_RELAXED)
+
+static void hub_loop_signal(struct hub_loop *loop)
+{
+    uint64_t one = 1;
+
+    if (write(loop->event_fd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+        supla_log(LOG_ERR, "hub eventfd write failed: %s", strerror(errno));
+}
+
+/* called by supla_dev_wakeup() from any thread */
+static void hub_loop_wakeup(struct supla_dev_waker *waker, supla_dev_t *dev)
+{
+    struct hub_loop *loop = (struct hub_loop *)waker;
+    struct hub_entry *e;
+    bool signal = false;
+
+    lck_lock(loop->dirty_lck);
+    e = dev->hub_entry;
+    if (e && !e->dirty) {
+        e->dirty = true;
+        e->dirty_next = loop->dirty;
+        signal = loop->dirty == NULL;
+        loop->dirty = e;
+    }
+    lck_unlock(loop->dirty_lck);
+
+    /* loop takes the whole dirty list at once, signal it only once */
+    if (signal)
+        hub_loop_signal(loop);
+}
+
+static void hub_entry_set_ready(struct hub_entry **ready, struct hub_entry *e)
+{
+    if (e->ready || e->removed)
+        return;
+
+    e->ready = true;
+    e->ready_next = *ready;
+    *ready = e;
+}
+
+static void hub_entry_unwatch(struct hub_loop *loop, struct hub_entry *e)
+{
+    /* fails if the socket is already closed, epoll dropped it then */
+    if (e->fd >= 0)
+        epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, e->fd, NULL);
+    e->fd = -1;
+}
+
+/* keeps epoll registration in line with the device connection */
+static void hub_entry_watch(struct hub_loop *loop, struct hub_entry *e, supla_dev_state_t state, bool reconnected)
+{
+    struct epoll_event ev = {};
+    int fd = -1;
+    int op;
+
+    /* socket of a failed connection stays open until the next connect */
+    if (state == SUPLA_DEV_STATE_CONNECTED || state == SUPLA_DEV_STATE_REGISTERED ||
+        state == SUPLA_DEV_STATE_ONLINE)
+        fd = supla_dev_get_fd(e->dev);
+
+    if (e->fd >= 0 && (fd != e->fd || reconnected))
+        hub_entry_unwatch(loop, e);
+
+    if (fd < 0)
+        return;
+
+    ev.events = EPOLLIN;
+    if (supla_dev_output_pending(e->dev))
+        ev.events |= EPOLLOUT;
+    ev.data.ptr = e;
+
+    if (e->fd == fd && e->events == ev.events)
+        return;
+
+    op = e->fd == fd ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if (epoll_ctl(loop->epoll_fd, op, fd, &ev) != 0) {
+        supla_log(LOG_ERR, "dev %s epoll_ctl failed: %s", e->dev->name, strerror(errno));
+        return;
+    }
+    e->fd = fd;
+    e->events = ev.events;
+}
+
+static void hub_entry_tick(struct hub_loop *loop, struct hub_entry *e)
+{
+    supla_dev_state_t state;
+    uint64_t now = supla_time_getmonotonictime_milliseconds();
+    uint64_t next;
+    bool reconnected = false;
+    bool online;
+    int burst = 0;
+
+    /* a connection made now joins the loop ring */
+    supla_uring_set_current(loop->ring, e);
+
+    for (;;) {
+        /* supla_dev_iterate() opens a new connection only in INIT state */
+        supla_dev_get_state(e->dev, &state);
+        if (state == SUPLA_DEV_STATE_INIT)
+            reconnected = true;
+
+        supla_dev_iterate(e->dev);
+        hub_stat_add(loop->iterations, 1);
+
+        /* removed from a device callback */
+        if (e->removed) {
+            supla_uring_set_current(NULL, NULL);
+            return;
+        }
+
+        next = supla_dev_next_iterate_msec(e->dev);
+        if (!next || next > now || ++burst >= HUB_ITERATE_BURST)
+            break;
+    }
+    supla_uring_set_current(NULL, NULL);
+
+    supla_dev_get_state(e->dev, &state);
+    hub_entry_watch(loop, e, state, reconnected);
+    if (next)
+        twheel_schedule(loop->timers, &e->timer, next);
+    else
+        twheel_cancel(loop->timers, &e->timer);
+
+    online = state == SUPLA_DEV_STATE_ONLINE;
+    if (online != e->online) {
+        e->online = online;
+        hub_stat_add(loop->online_count, online ? 1 : -1);
+    }
+}
+
+static void hub_timer_expired(TWheelTimer *timer, void *ready)
+{
+    hub_entry_set_ready(ready, timer->user_data);
+}
+
+static void hub_uring_ready(void *owner, void *ready)
+{
+    struct hub_entry *e = owner;
+
+    hub_entry_set_ready(ready, e);
+    hub_stat_add(e->loop->socket_events, 1);
+}
+
+/* ring links are not polled, the hub has to close them itself */
+static void hub_entry_drop_uring(struct hub_loop *loop, struct hub_entry *e)
+{
+    if (loop->ring && supla_cloud_get_uring(e->dev->cloud_link) == loop->ring)
+        supla_dev_drop_connection(e->dev);
+}
+
+/* one submission for the socket I/O of every device ticked in this pass */
+static void hub_loop_flush(struct hub_loop *loop)
+{
+    struct supla_uring_stats stats;
+
+    supla_uring_flush(loop->ring);
+    supla_uring_get_stats(loop->ring, &stats);
+    __atomic_store_n(&loop->io_submits, stats.submits, __ATOMIC_RELAXED);
+    __atomic_store_n(&loop->io_ops, stats.ops, __ATOMIC_RELAXED);
+}
+
+static void *hub_loop_thread(void *arg)
+{
+    struct hub_loop *loop = arg;
+    struct epoll_event events[HUB_MAX_EVENTS];
+    struct hub_entry *ready, *e;
+    uint64_t now, count;
+    int timeout, n, i;
+
+    for (;;) {
+        lck_lock(loop->lck);
+        timeout = twheel_next_timeout(loop->timers, supla_time_getmonotonictime_milliseconds());
+        lck_unlock(loop->lck);
+
+        n = epoll_wait(loop->epoll_fd, events, HUB_MAX_EVENTS, timeout);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            supla_log(LOG_ERR, "hub epoll_wait failed: %s", strerror(errno));
+            break;
+        }
+
+        lck_lock(loop->lck);
+        if (__atomic_load_n(&loop->stop, __ATOMIC_ACQUIRE)) {
+            lck_unlock(loop->lck);
+            break;
+        }
+        hub_stat_add(loop->loop_wakeups, 1);
+
+        ready = NULL;
+        for (i = 0; i < n; i++) {
+            if (!events[i].data.ptr) {
+                if (read(loop->event_fd, &count, sizeof(count)) < 0 && errno != EAGAIN)
+                    supla_log(LOG_ERR, "hub eventfd read failed: %s", strerror(errno));
+                continue;
+            }
+            if (events[i].data.ptr == &loop->ring) {
+                supla_uring_reap(loop->ring, hub_uring_ready, &ready);
+                continue;
+            }
+            /* entry removed after epoll_wait returned is still allocated */
+            hub_entry_set_ready(&ready, events[i].data.ptr);
+            hub_stat_add(loop->socket_events, 1);
+        }
+
+        lck_lock(loop->dirty_lck);
+        while ((e = loop->dirty)) {
+            loop->dirty = e->dirty_next;
+            e->dirty = false;
+            hub_entry_set_ready(&ready, e);
+            hub_stat_add(loop->dirty_events, 1);
+        }
+        lck_unlock(loop->dirty_lck);
+
+        now = supla_time_getmonotonictime_milliseconds();
+        n = twheel_advance(loop->timers, now, hub_timer_expired, &ready);
+        hub_stat_add(loop->timer_events, n);
+
+        while ((e = ready)) {
+            ready = e->ready_next;
+            e->ready = false;
+            if (!e->removed)
+                hub_entry_tick(loop, e);
+        }
+
+        if (loop->ring)
+            hub_loop_flush(loop);
+
+        while ((e = loop->zombies)) {
+            loop->zombies = e->dirty_next;
+            free(e);
+        }
+        lck_unlock(loop->lck);
+    }
+    return NULL;
+}
+
+static void hub_loop_detach(struct hub_loop *loop, struct hub_entry *e)
+{
+    lck_lock(loop->dirty_lck);
+    __atomic_store_n(&e->dev->waker, NULL, __ATOMIC_RELEASE);
+    e->dev->hub_entry = NULL;
+    if (e->dirty) {
+        struct hub_entry **p = &loop->dirty;
+
+        while (*p != e)
+            p = &(*p)->dirty_next;
+        *p = e->dirty_next;
+        e->dirty = false;
+    }
+    lck_unlock(loop->dirty_lck);
+}
+
+static int hub_loop_init(struct hub_loop *loop, int flags)
+{
+    struct epoll_event ev = {};
+
+    loop->waker.wakeup = hub_loop_wakeup;
+    loop->epoll_fd = -1;
+    loop->event_fd = -1;
+    LIST_INIT(&loop->entries);
+
+    loop->lck = lck_init();
+    loop->dirty_lck = lck_init();
+    loop->timers = twheel_init(supla_time_getmonotonictime_milliseconds());
+    if (!loop->lck || !loop->dirty_lck || !loop->timers)
+        return SUPLA_RESULT_FALSE;
+
+    loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    loop->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (loop->epoll_fd < 0 || loop->event_fd < 0) {
+        supla_log(LOG_ERR, "hub loop init failed: %s", strerror(errno));
+        return SUPLA_RESULT_FALSE;
+    }
+
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+    if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, loop->event_fd, &ev) != 0)
+        return SUPLA_RESULT_FALSE;
+
+    if (flags & SUPLA_HUB_FLAG_IO_URING) {
+        loop->ring = supla_uring_create(HUB_URING_ENTRIES);
+        if (!loop->ring)
+            supla_log(LOG_WARNING, "hub loop falls back to epoll socket I/O");
+    }
+    if (loop->ring) {
+        ev.events = EPOLLIN;
+        ev.data.ptr = &loop->ring;
+        if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, supla_uring_get_fd(loop->ring), &ev) != 0)
+            return SUPLA_RESULT_FALSE;
+    }
+
+    if (pthread_create(&loop->thread, NULL, hub_loop_thread, loop) != 0)
+        return SUPLA_RESULT_FALSE;
+
+    loop->started = true;
+    return SUPLA_RESULT_TRUE;
+}
+
+static void hub_loop_free(struct hub_loop *loop)
+{
+    struct hub_entry *e;
+
+    if (loop->started) {
+        __atomic_store_n(&loop->stop, true, __ATOMIC_RELEASE);
+        hub_loop_signal(loop);
+        pthread_join(loop->thread, NULL);
+    }
+
+    while ((e = LIST_FIRST(&loop->entries))) {
+        LIST_REMOVE(e, entries);
+        hub_loop_detach(loop, e);
+        hub_entry_drop_uring(loop, e);
+        free(e);
+    }
+    while ((e = loop->zombies)) {
+        loop->zombies = e->dirty_next;
+        free(e);
+    }
+    /* waits for the socket operations of the dropped connections */
+    if (loop->ring)
+        supla_uring_free(loop->ring);
+    if (loop->timers)
+        twheel_free(loop->timers);
+
+    if (loop->event_fd >= 0)
+        close(loop->event_fd);
+    if (loop->epoll_fd >= 0)
+        close(loop->epoll_fd);
+    if (loop->dirty_lck)
+        lck_free(loop->dirty_lck);
+    if (loop->lck)
+        lck_free(loop->lck);
+}
+
+supla_hub_t *supla_hub_create(int loop_count)
+{
+    return supla_hub_create_with_flags(loop_count, 0);
+}
+
+supla_hub_t *supla_hub_create_with_flags(int loop_count, int flags)
+{
+    supla_hub_t *hub;
+    int i;
+
+    if (loop_count <= 0)
+        loop_count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (loop_count <= 0)
+        loop_count = 1;
+
+    hub = calloc(1, sizeof(supla_hub_t));
+    if (!hub)
+        return NULL;
+
+    hub->loops = calloc(loop_count, sizeof(struct hub_loop));
+    hub->lck = lck_init();
+    if (!hub->loops || !hub->lck) {
+        free(hub->loops);
+        free(hub);
+        return NULL;
+    }
+
+    for (i = 0; i < loop_count; i++) {
+        hub->loop_count++;
+        if (hub_loop_init(&hub->loops[i], flags) != SUPLA_RESULT_TRUE) {
+            supla_hub_free(hub);
+            return NULL;
+        }
+    }
+    return hub;
+}
+
+int supla_hub_free(supla_hub_t *hub)
+{
+    assert(NULL != hub);
+    int i;
+
+    for (i = 0; i < hub->loop_count; i++)
+        hub_loop_free(&hub->loops[i]);
+
+    lck_free(hub->lck);
+    free(hub->loops);
+    free(hub);
+    return SUPLA_RESULT_TRUE;
+}
+
+int supla_hub_add_device(supla_hub_t *hub, supla_dev_t *dev)
+{
+    assert(NULL != hub);
+    assert(NULL != dev);
+    struct hub_loop *loop;
+    struct hub_entry *e;
+    int i;
+
+    lck_lock(hub->lck);
+    if (__atomic_load_n(&dev->waker, __ATOMIC_ACQUIRE)) {
+        lck_unlock(hub->lck);
+        return SUPLA_RESULT_FALSE;
+    }
+
+    loop = &hub->loops[0];
+    for (i = 1; i < hub->loop_count; i++) {
+        if (hub->loops[i].device_count < loop->device_count)
+            loop = &hub->loops[i];
+    }
+
+    e = calloc(1, sizeof(struct hub_entry));
+    if (!e) {
+        lck_unlock(hub->lck);
+        return SUPLA_RESULT_FALSE;
+    }
+    e->dev = dev;
+    e->loop = loop;
+    e->fd = -1;
+    twheel_timer_init(&e->timer, e);
+
+    lck_lock(loop->lck);
+    LIST_INSERT_HEAD(&loop->entries, e, entries);
+    hub_stat_add(loop->device_count, 1);
+
+    lck_lock(loop->dirty_lck);
+    dev->hub_entry = e;
+    __atomic_store_n(&dev->waker, &loop->waker, __ATOMIC_RELEASE);
+    lck_unlock(loop->dirty_lck);
+    lck_unlock(loop->lck);
+
+    /* first tick registers socket and deadline */
+    supla_dev_wakeup(dev);
+
+    lck_unlock(hub->lck);
+    return SUPLA_RESULT_TRUE;
+}
+
+int supla_hub_remove_device(supla_hub_t *hub, supla_dev_t *dev)
+{
+    assert(NULL != hub);
+    assert(NULL != dev);
+    struct hub_loop *loop = NULL;
+    struct hub_entry *e;
+    int i;
+
+    lck_lock(hub->lck);
+    for (i = 0; i < hub->loop_count; i++) {
+        if (__atomic_load_n(&dev->waker, __ATOMIC_ACQUIRE) == &hub->loops[i].waker)
+            loop = &hub->loops[i];
+    }
+    if (!loop) {
+        lck_unlock(hub->lck);
+        return SUPLA_RESULT_FALSE;
+    }
+
+    /* waits for the device tick in progress */
+    lck_lock(loop->lck);
+    e = dev->hub_entry;
+    hub_loop_detach(loop, e);
+    twheel_cancel(loop->timers, &e->timer);
+    hub_entry_unwatch(loop, e);
+    hub_entry_drop_uring(loop, e);
+    if (e->online)
+        hub_stat_add(loop->online_count, -1);
+    LIST_REMOVE(e, entries);
+    hub_stat_add(loop->device_count, -1);
+
+    /* pending epoll events may still point to it, loop frees it */
+    e->removed = true;
+    e->dirty_next = loop->zombies;
+    loop->zombies = e;
+    lck_unlock(loop->lck);
+
+    lck_unlock(hub->lck);
+    return SUPLA_RESULT_TRUE;
+}
+
+int supla_hub_get_stats(const supla_hub_t *hub, struct supla_hub_stats *stats)
+{
+    assert(NULL != hub);
+    assert(NULL != stats);
+    struct hub_loop *loop;
+    int i;
+
+    memset(stats, 0, sizeof(*stats));
+    stats->loops = hub->loop_count;
+
+    for (i = 0; i < hub->loop_count; i++) {
+        loop = &hub->loops[i];
+        stats->devices += hub_stat_get(loop->device_count);
+        stats->online_devices += hub_stat_get(loop->online_count);
+        stats->iterations += hub_stat_get(loop->iterations);
+        stats->socket_events += hub_stat_get(loop->socket_events);
+        stats->timer_events += hub_stat_get(loop->timer_events);
+        stats->dirty_events += hub_stat_get(loop->dirty_events);
+        stats->loop_wakeups += hub_stat_get(loop->loop_wakeups);
+        stats->io_submits += hub_stat_get(loop->io_submits);
+        stats->io_ops += hub_stat_get(loop->io_ops);
+    }
+    return SUPLA_RESULT_TRUE;
+}
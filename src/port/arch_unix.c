@@ -4,8 +4,11 @@
  * SPDX-License-Identifier: LGPL-2.1-or-later
  */
 
+#include <pthread.h>
+
 #include "util.h"
 #include "net.h"
+#include "uring.h"
 
 #if (LIBSUPLA_ARCH == LIBSUPLA_ARCH_UNIX)
 
@@ -16,114 +19,432 @@ uint64_t supla_time_getmonotonictime_milliseconds(void)
     return (uint64_t)((current_time.tv_sec * 1000) + (current_time.tv_nsec / 1000000));
 }
 
+struct supla_job {
+    pthread_t thread;
+    supla_job_fn_t fn;
+    void *arg;
+};
+
+static void *supla_job_thread(void *arg)
+{
+    struct supla_job *job = arg;
+
+    job->fn(job->arg);
+    return NULL;
+}
+
+int supla_job_start(void **job, supla_job_fn_t fn, void *arg)
+{
+    struct supla_job *j = malloc(sizeof(struct supla_job));
+
+    *job = NULL;
+    if (!j)
+        return SUPLA_RESULT_FALSE;
+
+    j->fn = fn;
+    j->arg = arg;
+    if (pthread_create(&j->thread, NULL, supla_job_thread, j) != 0) {
+        supla_log(LOG_ERR, "job thread create failed");
+        free(j);
+        return SUPLA_RESULT_FALSE;
+    }
+    *job = j;
+    return SUPLA_RESULT_TRUE;
+}
+
+void supla_job_join(void *job)
+{
+    struct supla_job *j = job;
+
+    if (!j)
+        return;
+    pthread_join(j->thread, NULL);
+    free(j);
+}
+
+#define SUPLA_CLOUD_SENDV_IOV_MAX 64
+/* per address, IPv6 and IPv4 candidates are raced */
+#define SUPLA_CLOUD_CONNECT_TIMEOUT_MS 500
+
+/* errno of a failed socket call which means the connection is gone, 0 otherwise */
+static int supla_cloud_hard_error(void)
+{
+    if (errno == 0 || errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+        return 0;
+    return errno;
+}
+
+static int supla_cloud_apply_tcp_options(int fd, const struct supla_tcp_options *opts)
+{
+    int rc = 0;
+    int on = 1;
+
+    if (fd < 0 || !opts)
+        return EINVAL;
+
+    if (opts->nodelay && setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)))
+        rc = errno;
+#ifdef TCP_USER_TIMEOUT
+    if (opts->user_timeout_ms > 0 &&
+        setsockopt(fd, IPPROTO_TCP, TCP_USER_TIMEOUT, &opts->user_timeout_ms, sizeof(int)))
+        rc = errno;
+#endif
+    if (opts->keepalive_idle_sec > 0) {
+        if (setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on)) ||
+            setsockopt(fd, IPPROTO_TCP, TCP_KEEPIDLE, &opts->keepalive_idle_sec, sizeof(int)))
+            rc = errno;
+        if (opts->keepalive_interval_sec > 0 &&
+            setsockopt(fd, IPPROTO_TCP, TCP_KEEPINTVL, &opts->keepalive_interval_sec, sizeof(int)))
+            rc = errno;
+        if (opts->keepalive_count > 0 &&
+            setsockopt(fd, IPPROTO_TCP, TCP_KEEPCNT, &opts->keepalive_count, sizeof(int)))
+            rc = errno;
+    }
+    if (opts->sndbuf > 0 && setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &opts->sndbuf, sizeof(int)))
+        rc = errno;
+    if (opts->rcvbuf > 0 && setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &opts->rcvbuf, sizeof(int)))
+        rc = errno;
+#ifdef TCP_NOTSENT_LOWAT
+    if (opts->notsent_lowat > 0 &&
+        setsockopt(fd, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &opts->notsent_lowat, sizeof(int)))
+        rc = errno;
+#endif
+
+    if (rc)
+        supla_log(LOG_WARNING, "cloud socket options: %s", strerror(rc));
+    return rc;
+}
+
+/* connections made from a hub loop running io_uring join its ring */
+static struct supla_uring_link *supla_cloud_attach_uring(int fd, void *ssl)
+{
+    struct supla_uring *ring;
+    void *owner;
+
+    ring = supla_uring_get_current(&owner);
+    if (!ring || fd < 0)
+        return NULL;
+    return supla_uring_link_attach(ring, owner, fd, ssl);
+}
+
+/* ring links only copy to the send buffer, no need to gather */
+static int supla_cloud_uring_sendv(struct supla_uring_link *uring, const TsrpcIoVec *iov, int iovcnt)
+{
+    int total = 0;
+    int rc;
+
+    for (int i = 0; i < iovcnt; i++) {
+        if (iov[i].count <= 0)
+            continue;
+
+        rc = supla_uring_link_send(uring, iov[i].buf, iov[i].count);
+        if (rc <= 0)
+            return total ? total : rc;
+        total += rc;
+        if (rc < iov[i].count)
+            break;
+    }
+    return total;
+}
+
 #ifndef NOSSL
 #include "../supla-common/supla-socket.h"
 
+typedef struct {
+    void *ssd;
+    struct supla_uring_link *uring;
+    int error;
+} cloud_link_t;
+
 int supla_cloud_connect(supla_link_t *link, const char *host, int port, unsigned char ssl)
 {
-    *link = ssocket_client_init(host, port, ssl);
-    return ssocket_client_connect(*link, NULL, NULL, 500);
+    cloud_link_t *cl = calloc(1, sizeof(cloud_link_t));
+
+    *link = cl;
+    if (!cl)
+        return SUPLA_RESULT_FALSE;
+
+    cl->ssd = ssocket_client_init(host, port, ssl ? 1 : 0);
+    if (ssl & SUPLA_CLOUD_SSL_KTLS)
+        ssocket_client_set_ktls(cl->ssd, 1);
+    if (ssl & SUPLA_CLOUD_SSL_LEAN)
+        ssocket_client_set_lean(cl->ssd, 1);
+    if (!ssocket_client_connect(cl->ssd, NULL, NULL, SUPLA_CLOUD_CONNECT_TIMEOUT_MS))
+        return SUPLA_RESULT_FALSE;
+
+    supla_cloud_attach(cl);
+    return SUPLA_RESULT_TRUE;
+}
+
+void supla_cloud_attach(supla_link_t link)
+{
+    cloud_link_t *cl = link;
+
+    /* the kernel encrypts what is written to a kTLS socket, keep it off the ring */
+    if (!cl || cl->uring || !cl->ssd || ssocket_get_ktls(cl->ssd))
+        return;
+    cl->uring = supla_cloud_attach_uring(ssocket_get_fd(cl->ssd), ssocket_get_ssl(cl->ssd));
+}
+
+/* plain ssocket links pass recv() errors through, report hard ones as a closed link */
+static int supla_cloud_ssocket_result(cloud_link_t *cl, int rc)
+{
+    int error;
+
+    if (rc > 0)
+        return rc;
+
+    error = supla_cloud_hard_error();
+    if (error && !cl->error)
+        cl->error = error;
+    return error ? 0 : rc;
 }
 
 int supla_cloud_send(supla_link_t link, void *buf, int count)
 {
-    return ssocket_write(link, NULL, buf, count);
+    cloud_link_t *cl = link;
+
+    if (cl->uring)
+        return supla_uring_link_send(cl->uring, buf, count);
+    errno = 0;
+    return supla_cloud_ssocket_result(cl, ssocket_write(cl->ssd, NULL, buf, count));
+}
+
+/* buffers go out as records of their own, no copy to gather them */
+int supla_cloud_sendv(supla_link_t link, const TsrpcIoVec *iov, int iovcnt)
+{
+    cloud_link_t *cl = link;
+    int total = 0;
+    int rc;
+
+    if (cl->uring)
+        return supla_cloud_uring_sendv(cl->uring, iov, iovcnt);
+
+    for (int i = 0; i < iovcnt; i++) {
+        if (iov[i].count <= 0)
+            continue;
+
+        rc = supla_cloud_send(link, (void *)iov[i].buf, iov[i].count);
+        if (rc <= 0)
+            return total ? total : rc;
+        total += rc;
+        if (rc < iov[i].count)
+            break;
+    }
+    return total;
 }
 
 int supla_cloud_recv(supla_link_t link, void *buf, int count)
 {
-    return ssocket_read(link, NULL, buf, count);
+    cloud_link_t *cl = link;
+
+    if (cl->uring)
+        return supla_uring_link_recv(cl->uring, buf, count);
+    errno = 0;
+    return supla_cloud_ssocket_result(cl, ssocket_read(cl->ssd, NULL, buf, count));
+}
+
+static void supla_cloud_free(void *ctx)
+{
+    cloud_link_t *cl = ctx;
+
+    ssocket_free(cl->ssd);
+    free(cl);
 }
 
 int supla_cloud_disconnect(supla_link_t *link)
 {
+    cloud_link_t *cl;
+
     if (!link)
         return EINVAL;
 
-    ssocket_free(*link);
+    cl = *link;
     *link = 0;
+    if (!cl)
+        return 0;
+
+    /* the ring frees the link once its socket operations are done */
+    if (cl->uring)
+        supla_uring_link_close(cl->uring, supla_cloud_free, cl);
+    else
+        supla_cloud_free(cl);
     return 0;
 }
 
+int supla_cloud_get_fd(supla_link_t link)
+{
+    cloud_link_t *cl = link;
+
+    /* ring links have no readiness to poll */
+    if (!cl || cl->uring || !cl->ssd)
+        return -1;
+    return ssocket_get_fd(cl->ssd);
+}
+
+int supla_cloud_pending(supla_link_t link)
+{
+    cloud_link_t *cl = link;
+
+    if (!cl)
+        return 0;
+    if (cl->uring)
+        return supla_uring_link_pending(cl->uring);
+    return cl->ssd ? ssocket_client_pending(cl->ssd) : 0;
+}
+
+struct supla_uring *supla_cloud_get_uring(supla_link_t link)
+{
+    cloud_link_t *cl = link;
+
+    return cl && cl->uring ? supla_uring_link_get_ring(cl->uring) : NULL;
+}
+
+int supla_cloud_set_tcp_options(supla_link_t link, const struct supla_tcp_options *opts)
+{
+    cloud_link_t *cl = link;
+
+    if (!cl || !cl->ssd)
+        return EINVAL;
+    return supla_cloud_apply_tcp_options(ssocket_get_fd(cl->ssd), opts);
+}
+
+int supla_cloud_get_error(supla_link_t link)
+{
+    cloud_link_t *cl = link;
+
+    if (!cl)
+        return 0;
+    if (cl->uring)
+        return supla_uring_link_get_error(cl->uring);
+    return cl->error;
+}
+
 #else
+#include "../supla-common/sconnect.h"
 
 typedef struct {
     int sfd;
+    struct supla_uring_link *uring;
+    int error;
 } socket_data_t;
 
-int supla_cloud_connect(supla_link_t *link, const char *host, int port, unsigned char ssl)
+/* hard errors close the link, the errno is kept for supla_cloud_get_error() */
+static int supla_cloud_socket_result(socket_data_t *ssd, int rc)
 {
-    struct addrinfo hints;
-    struct addrinfo *result, *rp = NULL;
-    int rc;
+    int error;
 
+    if (rc >= 0)
+        return rc;
+
+    error = supla_cloud_hard_error();
+    if (!error)
+        return -1;
+    if (!ssd->error)
+        ssd->error = error;
+    return 0;
+}
+
+int supla_cloud_connect(supla_link_t *link, const char *host, int port, unsigned char ssl)
+{
     socket_data_t *ssd = malloc(sizeof(socket_data_t));
+
+    *link = NULL;
     if (!ssd)
         return SUPLA_RESULT_FALSE;
 
     memset(ssd, 0, sizeof(socket_data_t));
-    ssd->sfd = -1;
+    ssd->sfd = sconnect_open(host, port, SUPLA_CLOUD_CONNECT_TIMEOUT_MS, NULL);
+    if (ssd->sfd == -1) {
+        supla_log(LOG_ERR, "Can't connect to host %s", host);
+        free(ssd);
+        return SUPLA_RESULT_FALSE;
+    }
 
     *link = ssd;
+    supla_cloud_attach(ssd);
+    return SUPLA_RESULT_TRUE;
+}
 
-    memset(&hints, 0, sizeof(hints));
-    hints.ai_family = AF_UNSPEC;
-    hints.ai_socktype = SOCK_STREAM;
-    hints.ai_flags = AI_NUMERICSERV;
+void supla_cloud_attach(supla_link_t link)
+{
+    socket_data_t *ssd = link;
 
-    // Address resolution.
-    rc = getaddrinfo(host, NULL, &hints, &result);
-    if (rc != 0) {
-        free(ssd);
-        return rc;
-    }
+    if (ssd && !ssd->uring)
+        ssd->uring = supla_cloud_attach_uring(ssd->sfd, NULL);
+}
 
-    for (rp = result; rp != NULL; rp = rp->ai_next) {
-        ssd->sfd = socket(rp->ai_family, rp->ai_socktype, rp->ai_protocol);
-        if (ssd->sfd == -1)
-            continue;
+int supla_cloud_send(supla_link_t link, void *buf, int count)
+{
+    socket_data_t *ssd = link;
+    int rc;
 
-        switch (rp->ai_family) {
-        case AF_INET6:
-            ((struct sockaddr_in6 *)(rp->ai_addr))->sin6_port = htons(port);
-            break;
-        case AF_INET:
-            ((struct sockaddr_in *)(rp->ai_addr))->sin_port = htons(port);
-            break;
-        default:
-            free(ssd);
-            return SUPLA_RESULT_FALSE;
-        }
+    if (ssd->uring)
+        return supla_uring_link_send(ssd->uring, buf, count);
 
-        // Attempt to connect.
-        rc = connect(ssd->sfd, rp->ai_addr, rp->ai_addrlen);
-        if (rc != -1) {
-            freeaddrinfo(result);
-            return SUPLA_RESULT_TRUE;
-        } else {
-            if (errno == EINPROGRESS) {
-                freeaddrinfo(result);
-                return SUPLA_RESULT_TRUE;
-            } else {
-                close(ssd->sfd);
-            }
-        }
-    }
-    freeaddrinfo(result);
-    free(ssd);
-    return SUPLA_RESULT_FALSE;
+    rc = send(ssd->sfd, buf, count, MSG_NOSIGNAL | MSG_DONTWAIT);
+    return supla_cloud_socket_result(ssd, rc);
 }
 
-int supla_cloud_send(supla_link_t link, void *buf, int count)
+int supla_cloud_sendv(supla_link_t link, const TsrpcIoVec *iov, int iovcnt)
 {
     socket_data_t *ssd = link;
-    return send(ssd->sfd, buf, count, MSG_NOSIGNAL);
+    struct iovec vec[SUPLA_CLOUD_SENDV_IOV_MAX];
+    struct msghdr msg;
+    int total = 0;
+    int i = 0;
+
+    if (ssd->uring)
+        return supla_cloud_uring_sendv(ssd->uring, iov, iovcnt);
+
+    while (i < iovcnt) {
+        int n = 0;
+        int len = 0;
+        int rc;
+
+        for (; i < iovcnt && n < SUPLA_CLOUD_SENDV_IOV_MAX; i++) {
+            if (iov[i].count <= 0)
+                continue;
+            vec[n].iov_base = (void *)iov[i].buf;
+            vec[n].iov_len = iov[i].count;
+            len += iov[i].count;
+            n++;
+        }
+        if (n == 0)
+            break;
+
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = vec;
+        msg.msg_iovlen = n;
+
+        rc = sendmsg(ssd->sfd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (rc < 0) {
+            rc = supla_cloud_socket_result(ssd, rc);
+            return total ? total : rc;
+        }
+        total += rc;
+        if (rc < len)
+            break;
+    }
+    return total;
 }
 
 int supla_cloud_recv(supla_link_t link, void *buf, int count)
 {
     socket_data_t *socket_data = link;
-    return recv(socket_data->sfd, buf, count, MSG_DONTWAIT);
+
+    if (socket_data->uring)
+        return supla_uring_link_recv(socket_data->uring, buf, count);
+    return supla_cloud_socket_result(socket_data, recv(socket_data->sfd, buf, count, MSG_DONTWAIT));
+}
+
+static void supla_cloud_free(void *ctx)
+{
+    socket_data_t *ssd = ctx;
+
+    if (ssd->sfd != -1)
+        close(ssd->sfd);
+    free(ssd);
 }
 
 int supla_cloud_disconnect(supla_link_t *link)
@@ -135,14 +456,65 @@ int supla_cloud_disconnect(supla_link_t *link)
     if (!ssd)
         return EINVAL;
 
-    if (ssd->sfd != -1) {
-        shutdown(ssd->sfd, SHUT_RDWR);
-        close(ssd->sfd);
+    *link = NULL;
+
+    /* the ring frees the link once its socket operations are done */
+    if (ssd->uring) {
+        supla_uring_link_close(ssd->uring, supla_cloud_free, ssd);
+        return 0;
     }
-    free(ssd);
+
+    if (ssd->sfd != -1)
+        shutdown(ssd->sfd, SHUT_RDWR);
+    supla_cloud_free(ssd);
     return 0;
 }
 
+int supla_cloud_get_fd(supla_link_t link)
+{
+    socket_data_t *ssd = link;
+
+    /* ring links have no readiness to poll */
+    if (!ssd || ssd->uring)
+        return -1;
+    return ssd->sfd;
+}
+
+/* data a ring link received and no completion is going to report */
+int supla_cloud_pending(supla_link_t link)
+{
+    socket_data_t *ssd = link;
+
+    return ssd && ssd->uring ? supla_uring_link_pending(ssd->uring) : 0;
+}
+
+struct supla_uring *supla_cloud_get_uring(supla_link_t link)
+{
+    socket_data_t *ssd = link;
+
+    return ssd && ssd->uring ? supla_uring_link_get_ring(ssd->uring) : NULL;
+}
+
+int supla_cloud_set_tcp_options(supla_link_t link, const struct supla_tcp_options *opts)
+{
+    socket_data_t *ssd = link;
+
+    if (!ssd)
+        return EINVAL;
+    return supla_cloud_apply_tcp_options(ssd->sfd, opts);
+}
+
+int supla_cloud_get_error(supla_link_t link)
+{
+    socket_data_t *ssd = link;
+
+    if (!ssd)
+        return 0;
+    if (ssd->uring)
+        return supla_uring_link_get_error(ssd->uring);
+    return ssd->error;
+}
+
 #endif //NOSSL
 
 #endif
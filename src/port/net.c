@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2022 <qb4.dev@gmail.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+/* defaults for the optional parts of a port, the port overrides what it supports */
+
+#include "net.h"
+#include "util.h"
+
+/* ports without vectored send: one supla_cloud_send() per buffer */
+__attribute__((weak)) int supla_cloud_sendv(supla_link_t link, const TsrpcIoVec *iov, int iovcnt)
+{
+    int rc, total = 0;
+
+    for (int i = 0; i < iovcnt; i++) {
+        if (iov[i].count <= 0)
+            continue;
+        rc = supla_cloud_send(link, (void *)iov[i].buf, iov[i].count);
+        if (rc < 0)
+            return total ? total : rc;
+        total += rc;
+        if (rc < iov[i].count)
+            break;
+    }
+    return total;
+}
+
+/* ports without pollable sockets */
+__attribute__((weak)) int supla_cloud_get_fd(supla_link_t link)
+{
+    return -1;
+}
+
+/* ports without socket options */
+__attribute__((weak)) int supla_cloud_set_tcp_options(supla_link_t link, const struct supla_tcp_options *opts)
+{
+    return 0;
+}
+
+/* ports not tracking socket errors */
+__attribute__((weak)) int supla_cloud_get_error(supla_link_t link)
+{
+    return 0;
+}
+
+/* ports handing received data straight to the caller */
+__attribute__((weak)) int supla_cloud_pending(supla_link_t link)
+{
+    return 0;
+}
+
+/* ports without io_uring */
+__attribute__((weak)) void supla_cloud_attach(supla_link_t link)
+{
+}
+
+/* ports without threads run jobs in place */
+__attribute__((weak)) int supla_job_start(void **job, supla_job_fn_t fn, void *arg)
+{
+    *job = NULL;
+    fn(arg);
+    return SUPLA_RESULT_TRUE;
+}
+
+__attribute__((weak)) void supla_job_join(void *job)
+{
+}
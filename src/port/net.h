@@ -11,9 +11,35 @@
 
 typedef void *supla_link_t;
 
+/* supla_cloud_connect() ssl flag asking for kernel TLS offload */
+#define SUPLA_CLOUD_SSL_KTLS 0x02
+/* supla_cloud_connect() ssl flag trading CPU for per connection memory */
+#define SUPLA_CLOUD_SSL_LEAN 0x04
+
+/*
+ * supla_cloud_send() and supla_cloud_sendv() return the number of bytes
+ * accepted (may be less than requested), -1 when the link can't take more
+ * data right now and 0 when the connection is lost.
+ */
 int supla_cloud_connect(supla_link_t *link, const char *host, int port, unsigned char ssl);
 int supla_cloud_send(supla_link_t link, void *buf, int count);
+int supla_cloud_sendv(supla_link_t link, const TsrpcIoVec *iov, int iovcnt);
 int supla_cloud_recv(supla_link_t link, void *buf, int count);
 int supla_cloud_disconnect(supla_link_t *link);
+/* socket descriptor of the link for readiness polling, -1 if there is none */
+int supla_cloud_get_fd(supla_link_t link);
+int supla_cloud_set_tcp_options(supla_link_t link, const struct supla_tcp_options *opts);
+/* errno which broke the connection, 0 if unknown or closed by the peer */
+int supla_cloud_get_error(supla_link_t link);
+/*
+ * moves a link connected on another thread to the io_uring ring of the
+ * calling thread, if it has one, see supla_uring_set_current()
+ */
+void supla_cloud_attach(supla_link_t link);
+/*
+ * received data held by the link itself (decrypted TLS records), which no
+ * readiness event reports; > 0 means supla_cloud_recv() won't come back empty
+ */
+int supla_cloud_pending(supla_link_t link);
 
 #endif /* SRC_PORT_NET_H_ */
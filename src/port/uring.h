@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2022 <qb4.dev@gmail.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef SRC_PORT_URING_H_
+#define SRC_PORT_URING_H_
+
+#include "net.h"
+
+/*
+ * Batched cloud socket I/O on Linux io_uring.
+ *
+ * A ring serves many cloud links from one thread. Links keep a receive and a
+ * send buffer, supla_uring_link_recv() and supla_uring_link_send() only copy
+ * from and to them, socket reads and writes of all links are queued and
+ * submitted with a single system call by supla_uring_flush(). TLS links move
+ * their SSL object to memory BIOs after the handshake, so records are
+ * encrypted and decrypted in place while the ring does the socket I/O.
+ *
+ * A ring and its links are not thread safe, all calls for one ring have to
+ * come from one thread or be serialized by the caller.
+ */
+
+struct supla_uring;
+struct supla_uring_link;
+
+/* called from supla_uring_reap() for links which have new data, lost the
+ * connection or have send buffer space again */
+typedef void (*supla_uring_ready_cb)(void *owner, void *arg);
+/* called once a closed link has no socket operation in flight */
+typedef void (*supla_uring_release_cb)(void *ctx);
+
+struct supla_uring_stats {
+    uint64_t submits; /* io_uring_enter() calls */
+    uint64_t ops;     /* socket reads and writes */
+};
+
+/* NULL if io_uring is not available on this system */
+struct supla_uring *supla_uring_create(unsigned entries);
+/* waits for the operations of closed links, all links have to be closed */
+void supla_uring_free(struct supla_uring *ring);
+/* eventfd readable when completions are waiting for supla_uring_reap() */
+int supla_uring_get_fd(struct supla_uring *ring);
+int supla_uring_reap(struct supla_uring *ring, supla_uring_ready_cb cb, void *arg);
+int supla_uring_flush(struct supla_uring *ring);
+void supla_uring_get_stats(struct supla_uring *ring, struct supla_uring_stats *stats);
+
+/*
+ * Ring and owner for cloud connections made by the calling thread, NULL ring
+ * restores plain sockets. Used by supla_cloud_connect().
+ */
+void supla_uring_set_current(struct supla_uring *ring, void *owner);
+struct supla_uring *supla_uring_get_current(void **owner);
+
+/* takes over a connected socket, ssl is the SSL object of a TLS link */
+struct supla_uring_link *supla_uring_link_attach(struct supla_uring *ring, void *owner, int fd, void *ssl);
+/* same return values as supla_cloud_send() and supla_cloud_recv() */
+int supla_uring_link_send(struct supla_uring_link *link, const void *buf, int count);
+int supla_uring_link_recv(struct supla_uring_link *link, void *buf, int count);
+/* > 0 when received data waits for supla_uring_link_recv() without a completion to report it */
+int supla_uring_link_pending(struct supla_uring_link *link);
+/* shuts the socket down, release is called when the socket may be closed */
+void supla_uring_link_close(struct supla_uring_link *link, supla_uring_release_cb release, void *ctx);
+struct supla_uring *supla_uring_link_get_ring(struct supla_uring_link *link);
+/* errno of the operation which failed the link, 0 if none did */
+int supla_uring_link_get_error(struct supla_uring_link *link);
+
+/* ring of a cloud link, NULL for a plain socket link */
+struct supla_uring *supla_cloud_get_uring(supla_link_t link);
+
+#endif /* SRC_PORT_URING_H_ */
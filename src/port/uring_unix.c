@@ -0,0 +1,738 @@
+/*
+ * Copyright (c) 2022 <qb4.dev@gmail.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "util.h"
+#include "uring.h"
+
+#if (LIBSUPLA_ARCH == LIBSUPLA_ARCH_UNIX) && defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+/* IORING_OP_SEND and IORING_OP_RECV came with the same kernel release */
+#if defined(IORING_FEAT_FAST_POLL)
+#define SUPLA_URING_AVAILABLE
+#endif
+#endif
+#endif
+
+static __thread struct supla_uring *uring_current;
+static __thread void *uring_current_owner;
+
+void supla_uring_set_current(struct supla_uring *ring, void *owner)
+{
+    uring_current = ring;
+    uring_current_owner = ring ? owner : NULL;
+}
+
+struct supla_uring *supla_uring_get_current(void **owner)
+{
+    if (owner)
+        *owner = uring_current_owner;
+    return uring_current;
+}
+
+#ifdef SUPLA_URING_AVAILABLE
+
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#ifndef NOSSL
+#include <openssl/bio.h>
+#include <openssl/ssl.h>
+#endif
+
+#define URING_RX_SIZE 4096
+#define URING_TX_SIZE 16384
+/* decrypted side of a TLS link may hold this much before reads stop */
+#define URING_TLS_RX_LIMIT (4 * URING_RX_SIZE)
+
+/* operation type in the low bits of the user_data link pointer */
+#define URING_OP_RECV 0
+#define URING_OP_SEND 1
+#define URING_OP_MASK 1
+
+struct supla_uring_link {
+    struct supla_uring *ring;
+    void *owner;
+    int fd;
+
+    void *ssl;
+    void *rbio; /* network side of a TLS link */
+    void *wbio;
+    int rbio_drained; /* rbio level when SSL_read() last wanted more */
+
+    char rx[URING_RX_SIZE];
+    int rx_start;
+    int rx_end;
+    char tx[URING_TX_SIZE];
+    int tx_len;
+
+    bool recv_inflight;
+    bool send_inflight;
+    bool eof;
+    int error; /* errno of a failed operation */
+    bool closed;
+    bool dirty; /* has operations to queue on the next flush */
+
+    supla_uring_release_cb release;
+    void *release_ctx;
+    struct supla_uring_link *dirty_next;
+};
+
+struct supla_uring {
+    int ring_fd;
+    int event_fd;
+
+    void *sq_ptr;
+    size_t sq_len;
+    void *cq_ptr;
+    size_t cq_len;
+    struct io_uring_sqe *sqes;
+    size_t sqes_len;
+
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned sq_entries;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_cqe *cqes;
+
+    struct supla_uring_link *dirty;
+    int links;
+
+    uint64_t submits;
+    uint64_t ops;
+};
+
+static int uring_setup(unsigned entries, struct io_uring_params *p)
+{
+    return syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+    return syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int uring_register(int fd, unsigned opcode, void *arg, unsigned nr_args)
+{
+    return syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+static void uring_unmap(struct supla_uring *ring)
+{
+    if (ring->sqes)
+        munmap(ring->sqes, ring->sqes_len);
+    if (ring->cq_ptr && ring->cq_ptr != ring->sq_ptr)
+        munmap(ring->cq_ptr, ring->cq_len);
+    if (ring->sq_ptr)
+        munmap(ring->sq_ptr, ring->sq_len);
+}
+
+static int uring_map(struct supla_uring *ring, struct io_uring_params *p)
+{
+    void *ptr;
+
+    ring->sq_len = p->sq_off.array + p->sq_entries * sizeof(unsigned);
+    ring->cq_len = p->cq_off.cqes + p->cq_entries * sizeof(struct io_uring_cqe);
+    if (p->features & IORING_FEAT_SINGLE_MMAP) {
+        if (ring->cq_len > ring->sq_len)
+            ring->sq_len = ring->cq_len;
+        ring->cq_len = ring->sq_len;
+    }
+
+    ptr = mmap(NULL, ring->sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ring_fd,
+               IORING_OFF_SQ_RING);
+    if (ptr == MAP_FAILED)
+        return SUPLA_RESULT_FALSE;
+    ring->sq_ptr = ptr;
+
+    if (p->features & IORING_FEAT_SINGLE_MMAP) {
+        ring->cq_ptr = ring->sq_ptr;
+    } else {
+        ptr = mmap(NULL, ring->cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ring_fd,
+                   IORING_OFF_CQ_RING);
+        if (ptr == MAP_FAILED)
+            return SUPLA_RESULT_FALSE;
+        ring->cq_ptr = ptr;
+    }
+
+    ring->sqes_len = p->sq_entries * sizeof(struct io_uring_sqe);
+    ptr = mmap(NULL, ring->sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ring_fd,
+               IORING_OFF_SQES);
+    if (ptr == MAP_FAILED)
+        return SUPLA_RESULT_FALSE;
+    ring->sqes = ptr;
+
+    ring->sq_head = (unsigned *)((char *)ring->sq_ptr + p->sq_off.head);
+    ring->sq_tail = (unsigned *)((char *)ring->sq_ptr + p->sq_off.tail);
+    ring->sq_mask = (unsigned *)((char *)ring->sq_ptr + p->sq_off.ring_mask);
+    ring->sq_array = (unsigned *)((char *)ring->sq_ptr + p->sq_off.array);
+    ring->sq_entries = p->sq_entries;
+    ring->cq_head = (unsigned *)((char *)ring->cq_ptr + p->cq_off.head);
+    ring->cq_tail = (unsigned *)((char *)ring->cq_ptr + p->cq_off.tail);
+    ring->cq_mask = (unsigned *)((char *)ring->cq_ptr + p->cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)((char *)ring->cq_ptr + p->cq_off.cqes);
+    return SUPLA_RESULT_TRUE;
+}
+
+struct supla_uring *supla_uring_create(unsigned entries)
+{
+    struct supla_uring *ring;
+    struct io_uring_params p;
+
+    ring = calloc(1, sizeof(struct supla_uring));
+    if (!ring)
+        return NULL;
+
+    ring->event_fd = -1;
+    memset(&p, 0, sizeof(p));
+    ring->ring_fd = uring_setup(entries, &p);
+    if (ring->ring_fd < 0) {
+        supla_log(LOG_INFO, "io_uring not available: %s", strerror(errno));
+        free(ring);
+        return NULL;
+    }
+
+    /*
+     * Dropped completions would leave a link waiting forever, and without
+     * fast poll every idle socket read would block a kernel worker thread.
+     */
+    if (!(p.features & IORING_FEAT_NODROP) || !(p.features & IORING_FEAT_FAST_POLL)) {
+        supla_log(LOG_INFO, "io_uring: kernel lacks required features");
+        goto fail;
+    }
+
+    if (uring_map(ring, &p) != SUPLA_RESULT_TRUE)
+        goto fail;
+
+    ring->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (ring->event_fd < 0 || uring_register(ring->ring_fd, IORING_REGISTER_EVENTFD, &ring->event_fd, 1) != 0)
+        goto fail;
+
+    return ring;
+
+fail:
+    supla_log(LOG_ERR, "io_uring init failed: %s", strerror(errno));
+    uring_unmap(ring);
+    if (ring->event_fd >= 0)
+        close(ring->event_fd);
+    close(ring->ring_fd);
+    free(ring);
+    return NULL;
+}
+
+int supla_uring_get_fd(struct supla_uring *ring)
+{
+    return ring->event_fd;
+}
+
+void supla_uring_get_stats(struct supla_uring *ring, struct supla_uring_stats *stats)
+{
+    stats->submits = ring->submits;
+    stats->ops = ring->ops;
+}
+
+static unsigned uring_unsubmitted(struct supla_uring *ring)
+{
+    return *ring->sq_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+}
+
+static int uring_submit(struct supla_uring *ring)
+{
+    unsigned to_submit = uring_unsubmitted(ring);
+    int rc;
+
+    if (!to_submit)
+        return 0;
+
+    ring->submits++;
+    rc = uring_enter(ring->ring_fd, to_submit, 0, 0);
+    /* EBUSY and EAGAIN leave the entries queued for the next flush */
+    if (rc < 0 && errno != EBUSY && errno != EAGAIN && errno != EINTR)
+        supla_log(LOG_ERR, "io_uring_enter failed: %s", strerror(errno));
+    return rc;
+}
+
+static struct io_uring_sqe *uring_get_sqe(struct supla_uring *ring)
+{
+    struct io_uring_sqe *sqe;
+    unsigned tail = *ring->sq_tail;
+    unsigned idx;
+
+    if (uring_unsubmitted(ring) >= ring->sq_entries) {
+        uring_submit(ring);
+        if (uring_unsubmitted(ring) >= ring->sq_entries)
+            return NULL;
+    }
+
+    idx = tail & *ring->sq_mask;
+    sqe = &ring->sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    ring->sq_array[idx] = idx;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ring->ops++;
+    return sqe;
+}
+
+static void uring_link_set_dirty(struct supla_uring_link *link)
+{
+    if (link->dirty)
+        return;
+
+    link->dirty = true;
+    link->dirty_next = link->ring->dirty;
+    link->ring->dirty = link;
+}
+
+static bool uring_link_idle(struct supla_uring_link *link)
+{
+    return !link->recv_inflight && !link->send_inflight && !link->dirty;
+}
+
+static void uring_link_release(struct supla_uring_link *link)
+{
+    link->ring->links--;
+    if (link->release)
+        link->release(link->release_ctx);
+    free(link);
+}
+
+#ifndef NOSSL
+/* moves TLS records produced by SSL_write() and SSL_read() to the send buffer */
+static void uring_link_drain_wbio(struct supla_uring_link *link)
+{
+    int n;
+
+    if (!link->wbio || link->tx_len == URING_TX_SIZE)
+        return;
+
+    n = BIO_read(link->wbio, link->tx + link->tx_len, URING_TX_SIZE - link->tx_len);
+    if (n > 0)
+        link->tx_len += n;
+}
+
+static int uring_link_wbio_pending(struct supla_uring_link *link)
+{
+    return link->wbio ? BIO_ctrl_pending(link->wbio) : 0;
+}
+
+static int uring_link_rbio_pending(struct supla_uring_link *link)
+{
+    return link->rbio ? BIO_ctrl_pending(link->rbio) : 0;
+}
+#else
+#define uring_link_drain_wbio(link)
+#define uring_link_wbio_pending(link) 0
+#define uring_link_rbio_pending(link) 0
+#endif
+
+static void uring_link_queue(struct supla_uring_link *link)
+{
+    struct io_uring_sqe *sqe;
+    int space;
+
+    uring_link_drain_wbio(link);
+
+    if (!link->recv_inflight && !link->eof && !link->error) {
+        if (link->rbio) {
+            /* TLS records are handed to the rbio as they arrive */
+            space = uring_link_rbio_pending(link) < URING_TLS_RX_LIMIT ? URING_RX_SIZE : 0;
+            link->rx_start = link->rx_end = 0;
+        } else {
+            if (link->rx_start == link->rx_end)
+                link->rx_start = link->rx_end = 0;
+            space = URING_RX_SIZE - link->rx_end;
+        }
+
+        if (space > 0) {
+            sqe = uring_get_sqe(link->ring);
+            if (!sqe)
+                goto retry;
+            sqe->opcode = IORING_OP_RECV;
+            sqe->fd = link->fd;
+            sqe->addr = (uintptr_t)(link->rx + link->rx_end);
+            sqe->len = space;
+            sqe->user_data = (uintptr_t)link | URING_OP_RECV;
+            link->recv_inflight = true;
+        }
+    }
+
+    /* appended data waits for the write in flight, offsets stay valid */
+    if (!link->send_inflight && link->tx_len && !link->error) {
+        sqe = uring_get_sqe(link->ring);
+        if (!sqe)
+            goto retry;
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = link->fd;
+        sqe->addr = (uintptr_t)link->tx;
+        sqe->len = link->tx_len;
+        sqe->msg_flags = MSG_NOSIGNAL;
+        sqe->user_data = (uintptr_t)link | URING_OP_SEND;
+        link->send_inflight = true;
+    }
+    return;
+
+retry:
+    uring_link_set_dirty(link);
+}
+
+int supla_uring_flush(struct supla_uring *ring)
+{
+    struct supla_uring_link *link, *next;
+
+    link = ring->dirty;
+    ring->dirty = NULL;
+
+    for (; link; link = next) {
+        next = link->dirty_next;
+        link->dirty = false;
+
+        if (link->closed) {
+            if (uring_link_idle(link))
+                uring_link_release(link);
+            continue;
+        }
+        uring_link_queue(link);
+    }
+
+    return uring_submit(ring);
+}
+
+static void uring_link_complete(struct supla_uring_link *link, int op, int res)
+{
+    if (op == URING_OP_RECV) {
+        link->recv_inflight = false;
+        if (res > 0) {
+#ifndef NOSSL
+            if (link->rbio)
+                BIO_write(link->rbio, link->rx, res);
+            else
+#endif
+                link->rx_end += res;
+        } else if (res == 0) {
+            link->eof = true;
+        } else if (res != -EAGAIN && res != -EINTR && res != -ECANCELED) {
+            link->error = -res;
+        }
+    } else {
+        link->send_inflight = false;
+        if (res > 0) {
+            link->tx_len -= res;
+            memmove(link->tx, link->tx + res, link->tx_len);
+        } else if (res != -EAGAIN && res != -EINTR) {
+            link->error = -res;
+        }
+    }
+
+    if (!link->closed)
+        uring_link_set_dirty(link);
+}
+
+int supla_uring_reap(struct supla_uring *ring, supla_uring_ready_cb cb, void *arg)
+{
+    struct supla_uring_link *link;
+    struct io_uring_cqe *cqe;
+    unsigned head, tail;
+    uint64_t count;
+    int result = 0;
+
+    if (read(ring->event_fd, &count, sizeof(count)) < 0 && errno != EAGAIN)
+        supla_log(LOG_ERR, "io_uring eventfd read failed: %s", strerror(errno));
+
+    head = *ring->cq_head;
+    tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+
+    for (; head != tail; head++) {
+        cqe = &ring->cqes[head & *ring->cq_mask];
+        link = (struct supla_uring_link *)(uintptr_t)(cqe->user_data & ~(uint64_t)URING_OP_MASK);
+
+        uring_link_complete(link, cqe->user_data & URING_OP_MASK, cqe->res);
+        result++;
+
+        if (link->closed) {
+            if (uring_link_idle(link))
+                uring_link_release(link);
+        } else if (cb && link->owner) {
+            cb(link->owner, arg);
+        }
+    }
+
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+    return result;
+}
+
+void supla_uring_free(struct supla_uring *ring)
+{
+    if (!ring)
+        return;
+
+    supla_uring_flush(ring);
+
+    /* kernel writes to buffers of operations in flight until they complete */
+    while (ring->links > 0) {
+        if (uring_enter(ring->ring_fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+            supla_log(LOG_ERR, "io_uring wait failed: %s", strerror(errno));
+            break;
+        }
+        supla_uring_reap(ring, NULL, NULL);
+        supla_uring_flush(ring);
+    }
+
+    uring_unmap(ring);
+    close(ring->event_fd);
+    close(ring->ring_fd);
+    free(ring);
+}
+
+struct supla_uring_link *supla_uring_link_attach(struct supla_uring *ring, void *owner, int fd, void *ssl)
+{
+    struct supla_uring_link *link;
+    int flags;
+
+    link = calloc(1, sizeof(struct supla_uring_link));
+    if (!link)
+        return NULL;
+
+    link->ring = ring;
+    link->owner = owner;
+    link->fd = fd;
+
+#ifndef NOSSL
+    if (ssl) {
+        BIO *rbio = BIO_new(BIO_s_mem());
+        BIO *wbio = BIO_new(BIO_s_mem());
+
+        if (!rbio || !wbio) {
+            BIO_free(rbio);
+            BIO_free(wbio);
+            free(link);
+            return NULL;
+        }
+        /* empty rbio means "no data yet", not end of stream */
+        BIO_set_mem_eof_return(rbio, -1);
+        /* frees the socket BIO, the handshake left no data buffered in it */
+        SSL_set_bio(ssl, rbio, wbio);
+        link->ssl = ssl;
+        link->rbio = rbio;
+        link->wbio = wbio;
+    }
+#else
+    (void)ssl;
+#endif
+
+    /* non-blocking sockets complete with EAGAIN instead of being polled */
+    flags = fcntl(fd, F_GETFL);
+    if (flags != -1 && (flags & O_NONBLOCK))
+        fcntl(fd, F_SETFL, flags & ~O_NONBLOCK);
+
+    ring->links++;
+    uring_link_set_dirty(link);
+    return link;
+}
+
+struct supla_uring *supla_uring_link_get_ring(struct supla_uring_link *link)
+{
+    return link->ring;
+}
+
+int supla_uring_link_get_error(struct supla_uring_link *link)
+{
+    return link->error;
+}
+
+int supla_uring_link_send(struct supla_uring_link *link, const void *buf, int count)
+{
+    int n;
+
+    if (link->error || link->closed)
+        return 0;
+    if (count <= 0)
+        return -1;
+
+#ifndef NOSSL
+    if (link->ssl) {
+        int err;
+
+        if (link->tx_len + uring_link_wbio_pending(link) >= URING_TX_SIZE)
+            return -1;
+
+        n = SSL_write(link->ssl, buf, count);
+        if (n <= 0) {
+            err = SSL_get_error(link->ssl, n);
+            return err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE ? -1 : 0;
+        }
+        uring_link_set_dirty(link);
+        return n;
+    }
+#endif
+
+    n = URING_TX_SIZE - link->tx_len;
+    if (n <= 0)
+        return -1;
+    if (n > count)
+        n = count;
+
+    memcpy(link->tx + link->tx_len, buf, n);
+    link->tx_len += n;
+    uring_link_set_dirty(link);
+    return n;
+}
+
+int supla_uring_link_recv(struct supla_uring_link *link, void *buf, int count)
+{
+    int n;
+
+    if (link->closed)
+        return 0;
+
+#ifndef NOSSL
+    if (link->ssl) {
+        int err;
+
+        n = SSL_read(link->ssl, buf, count);
+        /* reads may produce records to send, and free rbio space */
+        if (uring_link_wbio_pending(link) || !link->recv_inflight)
+            uring_link_set_dirty(link);
+        if (n > 0) {
+            link->rbio_drained = -1;
+            return n;
+        }
+
+        err = SSL_get_error(link->ssl, n);
+        if (err == SSL_ERROR_WANT_READ)
+            link->rbio_drained = uring_link_rbio_pending(link);
+        if (err == SSL_ERROR_WANT_READ && !link->eof && !link->error)
+            return -1;
+        return 0;
+    }
+#endif
+
+    n = link->rx_end - link->rx_start;
+    if (n == 0) {
+        if (link->eof || link->error)
+            return 0;
+        return -1;
+    }
+    if (n > count)
+        n = count;
+
+    memcpy(buf, link->rx + link->rx_start, n);
+    link->rx_start += n;
+    if (!link->recv_inflight)
+        uring_link_set_dirty(link);
+    return n;
+}
+
+/*
+ * Received data already reported by a completion and left unread. For TLS
+ * links anything added to the rbio since SSL_read() last ran dry counts, a
+ * partial record costs one read which finds nothing.
+ */
+int supla_uring_link_pending(struct supla_uring_link *link)
+{
+    if (link->closed)
+        return 0;
+
+#ifndef NOSSL
+    if (link->ssl) {
+        if (SSL_pending(link->ssl) > 0)
+            return 1;
+        return uring_link_rbio_pending(link) != link->rbio_drained;
+    }
+#endif
+
+    return link->rx_end - link->rx_start;
+}
+
+void supla_uring_link_close(struct supla_uring_link *link, supla_uring_release_cb release, void *ctx)
+{
+    link->closed = true;
+    link->owner = NULL;
+    link->release = release;
+    link->release_ctx = ctx;
+
+    if (uring_link_idle(link)) {
+        uring_link_release(link);
+        return;
+    }
+
+    /* completes the operations in flight */
+    shutdown(link->fd, SHUT_RDWR);
+}
+
+#else /* SUPLA_URING_AVAILABLE */
+
+struct supla_uring *supla_uring_create(unsigned entries)
+{
+    supla_log(LOG_INFO, "io_uring not supported by this build");
+    return NULL;
+}
+
+void supla_uring_free(struct supla_uring *ring)
+{
+}
+
+int supla_uring_get_fd(struct supla_uring *ring)
+{
+    return -1;
+}
+
+int supla_uring_reap(struct supla_uring *ring, supla_uring_ready_cb cb, void *arg)
+{
+    return 0;
+}
+
+int supla_uring_flush(struct supla_uring *ring)
+{
+    return 0;
+}
+
+void supla_uring_get_stats(struct supla_uring *ring, struct supla_uring_stats *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+}
+
+struct supla_uring_link *supla_uring_link_attach(struct supla_uring *ring, void *owner, int fd, void *ssl)
+{
+    return NULL;
+}
+
+int supla_uring_link_send(struct supla_uring_link *link, const void *buf, int count)
+{
+    return 0;
+}
+
+int supla_uring_link_recv(struct supla_uring_link *link, void *buf, int count)
+{
+    return 0;
+}
+
+int supla_uring_link_pending(struct supla_uring_link *link)
+{
+    return 0;
+}
+
+void supla_uring_link_close(struct supla_uring_link *link, supla_uring_release_cb release, void *ctx)
+{
+    if (release)
+        release(ctx);
+}
+
+struct supla_uring *supla_uring_link_get_ring(struct supla_uring_link *link)
+{
+    return NULL;
+}
+
+int supla_uring_link_get_error(struct supla_uring_link *link)
+{
+    return 0;
+}
+
+#endif /* SUPLA_URING_AVAILABLE */
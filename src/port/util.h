@@ -11,4 +11,15 @@
 
 uint64_t supla_time_getmonotonictime_milliseconds(void);
 
+typedef void (*supla_job_fn_t)(void *arg);
+
+/*
+ * Runs fn(arg) on a thread of its own, *job is the handle for
+ * supla_job_join(). Ports without threads run fn in place and set *job to
+ * NULL.
+ */
+int supla_job_start(void **job, supla_job_fn_t fn, void *arg);
+/* waits for fn to return and frees the handle, NULL is ignored */
+void supla_job_join(void *job);
+
 #endif /* SRC_PORT_UTIL_H_ */
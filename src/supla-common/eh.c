@@ -38,6 +38,19 @@
 
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+#define EH_MAX_EVENTS 64
+
+typedef struct _TEventHandlerFd {
+  // -1 once unregistered
+  int fd;
+  _func_eh_fd_callback callback;
+  // Set for eh_timer_start() timers, callback then reads the timerfd
+  _func_eh_timer_callback timer_callback;
+  void *user_data;
+  struct _TEventHandlerFd *next_released;
+} TEventHandlerFd;
 #endif
 
 TEventHandler *eh_init(void) {
@@ -57,6 +70,7 @@ TEventHandler *eh_init(void) {
     eh->fd3 = -1;
 
 #ifdef __linux__
+    eh->wait_timer_fd = -1;
 
 #ifdef __ANDROID__
     eh->epoll_fd = epoll_create(1);
@@ -68,7 +82,7 @@ TEventHandler *eh_init(void) {
     eh->nfds = eh->fd1 + 1;
 
     if (eh->epoll_fd != -1) {
-      evnt.data.fd = eh->fd1;
+      evnt.data.ptr = NULL;
       evnt.events = EPOLLIN | EPOLLET;
 
       if (epoll_ctl(eh->epoll_fd, EPOLL_CTL_ADD, eh->fd1, &evnt) == -1) {
@@ -77,6 +91,22 @@ TEventHandler *eh_init(void) {
       }
     }
 
+    if (eh->epoll_fd != -1) {
+      eh->wait_timer_fd =
+          timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+      // Edge triggered, an expiry that nobody waited for is reported once
+      evnt.data.ptr = &eh->wait_timer_fd;
+      evnt.events = EPOLLIN | EPOLLET;
+
+      if (eh->wait_timer_fd != -1 &&
+          epoll_ctl(eh->epoll_fd, EPOLL_CTL_ADD, eh->wait_timer_fd, &evnt) ==
+              -1) {
+        close(eh->wait_timer_fd);
+        eh->wait_timer_fd = -1;
+      }
+    }
+
 #else
     pipe(eh->fd1);
 
@@ -112,7 +142,7 @@ void eh_add_fd(TEventHandler *eh, int fd) {
 #ifdef __linux__
       if (eh->epoll_fd != -1) {
         evnt.events = EPOLLIN;
-        evnt.data.fd = fd;
+        evnt.data.ptr = NULL;
 
         if (epoll_ctl(eh->epoll_fd, EPOLL_CTL_ADD, fd, &evnt) == -1) {
           close(eh->epoll_fd);
@@ -130,6 +160,11 @@ void eh_add_fd(TEventHandler *eh, int fd) {
 void eh_raise_event(TEventHandler *eh) {
   if (eh == 0) return;
 
+#ifndef _WIN32
+  // A wakeup is already on its way
+  if (__atomic_exchange_n(&eh->pending, 1, __ATOMIC_SEQ_CST)) return;
+#endif
+
 #ifdef __linux__
 
   uint64_t u = 1;
@@ -146,6 +181,210 @@ void eh_raise_event(TEventHandler *eh) {
 #endif
 }
 
+#ifdef __linux__
+static unsigned int eh_epoll_events(unsigned int events) {
+  return ((events & EH_EVENT_READ) ? EPOLLIN : 0) |
+         ((events & EH_EVENT_WRITE) ? EPOLLOUT : 0);
+}
+
+static void eh_free_released(TEventHandler *eh) {
+  TEventHandlerFd *item;
+
+  while ((item = eh->released) != 0) {
+    eh->released = item->next_released;
+    free(item);
+  }
+}
+
+// Calls the callbacks of registered fds. Returns the number of events
+// without the internal wait timer, as eh_wait() did before callbacks.
+static int eh_dispatch(TEventHandler *eh, struct epoll_event *events,
+                       int count, char *timer_armed) {
+  TEventHandlerFd *item;
+  unsigned int ev;
+  int result = 0;
+  int a;
+
+  for (a = 0; a < count; a++) {
+    if (events[a].data.ptr == &eh->wait_timer_fd) {
+      *timer_armed = 0;
+      continue;
+    }
+
+    result++;
+    item = (TEventHandlerFd *)events[a].data.ptr;
+
+    // Legacy fds and the wakeup eventfd have no callback
+    if (item == 0 || item->fd == -1) continue;
+
+    ev = ((events[a].events & EPOLLIN) ? EH_EVENT_READ : 0) |
+         ((events[a].events & EPOLLOUT) ? EH_EVENT_WRITE : 0) |
+         ((events[a].events & (EPOLLERR | EPOLLHUP)) ? EH_EVENT_ERROR : 0);
+
+    item->callback(eh, item->fd, ev, item->user_data);
+  }
+
+  eh_free_released(eh);
+  return result;
+}
+
+static TEventHandlerFd *eh_register(TEventHandler *eh, int fd,
+                                    unsigned int events,
+                                    _func_eh_fd_callback callback,
+                                    void *user_data) {
+  struct epoll_event evnt = {0};
+  TEventHandlerFd *item;
+
+  if (eh == 0 || eh->epoll_fd == -1 || fd < 0 || callback == 0) return 0;
+
+  if (fd < eh->fds_size && eh->fds[fd] != 0) return 0;
+
+  if (fd >= eh->fds_size) {
+    int size = eh->fds_size ? eh->fds_size : 64;
+    TEventHandlerFd **fds;
+
+    while (size <= fd) size *= 2;
+
+    fds = realloc(eh->fds, sizeof(TEventHandlerFd *) * size);
+    if (fds == 0) return 0;
+
+    memset(&fds[eh->fds_size], 0,
+           sizeof(TEventHandlerFd *) * (size - eh->fds_size));
+    eh->fds = fds;
+    eh->fds_size = size;
+  }
+
+  item = calloc(1, sizeof(TEventHandlerFd));
+  if (item == 0) return 0;
+
+  item->fd = fd;
+  item->callback = callback;
+  item->user_data = user_data;
+
+  evnt.events = eh_epoll_events(events);
+  evnt.data.ptr = item;
+
+  if (epoll_ctl(eh->epoll_fd, EPOLL_CTL_ADD, fd, &evnt) == -1) {
+    free(item);
+    return 0;
+  }
+
+  eh->fds[fd] = item;
+  return item;
+}
+
+static void eh_timer_fired(TEventHandler *eh, int fd, unsigned int events,
+                           void *user_data) {
+  TEventHandlerFd *item = eh->fds[fd];
+  uint64_t u;
+
+  if (read(fd, &u, sizeof(uint64_t)) == sizeof(uint64_t)) {
+    item->timer_callback(eh, fd, user_data);
+  }
+}
+#endif /*__linux__*/
+
+char eh_register_fd(TEventHandler *eh, int fd, unsigned int events,
+                    _func_eh_fd_callback callback, void *user_data) {
+#ifdef __linux__
+  return eh_register(eh, fd, events, callback, user_data) != 0 ? 1 : 0;
+#else
+  return 0;
+#endif
+}
+
+char eh_modify_fd(TEventHandler *eh, int fd, unsigned int events) {
+#ifdef __linux__
+  struct epoll_event evnt = {0};
+
+  if (eh == 0 || fd < 0 || fd >= eh->fds_size || eh->fds[fd] == 0) return 0;
+
+  evnt.events = eh_epoll_events(events);
+  evnt.data.ptr = eh->fds[fd];
+
+  return epoll_ctl(eh->epoll_fd, EPOLL_CTL_MOD, fd, &evnt) == 0 ? 1 : 0;
+#else
+  return 0;
+#endif
+}
+
+char eh_unregister_fd(TEventHandler *eh, int fd) {
+#ifdef __linux__
+  TEventHandlerFd *item;
+
+  if (eh == 0 || fd < 0 || fd >= eh->fds_size || eh->fds[fd] == 0) return 0;
+
+  item = eh->fds[fd];
+  eh->fds[fd] = 0;
+
+  // Fails when fd is already closed, epoll forgot it then
+  epoll_ctl(eh->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+
+  // Pending events of this eh_wait() may still point to it
+  item->fd = -1;
+  item->next_released = eh->released;
+  eh->released = item;
+
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+int eh_timer_start(TEventHandler *eh, int delay_ms, int interval_ms,
+                   _func_eh_timer_callback callback, void *user_data) {
+#ifdef __linux__
+  struct itimerspec its = {0};
+  TEventHandlerFd *item;
+  int fd;
+
+  if (eh == 0 || callback == 0 || delay_ms < 0 || interval_ms < 0) return -1;
+
+  fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (fd == -1) return -1;
+
+  item = eh_register(eh, fd, EH_EVENT_READ, eh_timer_fired, user_data);
+  if (item == 0) {
+    close(fd);
+    return -1;
+  }
+
+  item->timer_callback = callback;
+
+  its.it_value.tv_sec = delay_ms / 1000;
+  its.it_value.tv_nsec = (delay_ms % 1000) * 1000000;
+  // Zero would disarm it
+  if (delay_ms == 0) its.it_value.tv_nsec = 1;
+  its.it_interval.tv_sec = interval_ms / 1000;
+  its.it_interval.tv_nsec = (interval_ms % 1000) * 1000000;
+
+  if (timerfd_settime(fd, 0, &its, NULL) == -1) {
+    eh_unregister_fd(eh, fd);
+    close(fd);
+    return -1;
+  }
+
+  return fd;
+#else
+  return -1;
+#endif
+}
+
+char eh_timer_stop(TEventHandler *eh, int timer) {
+#ifdef __linux__
+  if (eh == 0 || timer < 0 || timer >= eh->fds_size || eh->fds[timer] == 0 ||
+      eh->fds[timer]->timer_callback == 0) {
+    return 0;
+  }
+
+  eh_unregister_fd(eh, timer);
+  close(timer);
+  return 1;
+#else
+  return 0;
+#endif
+}
+
 int eh_wait(TEventHandler *eh, int usec) {
 #ifdef _WIN32
   SleepEx(usec, TRUE);  // usec mean msec
@@ -155,7 +394,10 @@ int eh_wait(TEventHandler *eh, int usec) {
 
 #ifdef __linux__
   uint64_t u;
-  struct epoll_event events[10];
+  struct epoll_event events[EH_MAX_EVENTS];
+  struct itimerspec its = {0};
+  char timer_armed = 0;
+  int timeout_ms = usec / 1000;
 #else
   char u;
 #endif
@@ -209,13 +451,39 @@ int eh_wait(TEventHandler *eh, int usec) {
     if (eh->epoll_fd == -1) {
       result = select(eh->nfds, &rfds, NULL, NULL, &eh->tv);
     } else {
-      result = epoll_wait(eh->epoll_fd, events, 10, usec / 1000);
+      if (usec > 0 && usec % 1000) {
+        if (eh->wait_timer_fd != -1) {
+          its.it_value.tv_sec = eh->tv.tv_sec;
+          its.it_value.tv_nsec = eh->tv.tv_usec * 1000;
+          timer_armed =
+              timerfd_settime(eh->wait_timer_fd, 0, &its, NULL) == 0 ? 1 : 0;
+        }
+        // Never round a short wait down to a busy poll
+        timeout_ms = timer_armed ? -1 : timeout_ms + 1;
+      }
+
+      result = epoll_wait(eh->epoll_fd, events, EH_MAX_EVENTS, timeout_ms);
+
+      if (result > 0) {
+        result = eh_dispatch(eh, events, result, &timer_armed);
+      }
+
+      if (timer_armed) {
+        // Woken up by something else, disarm
+        its.it_value.tv_sec = 0;
+        its.it_value.tv_nsec = 0;
+        timerfd_settime(eh->wait_timer_fd, 0, &its, NULL);
+      }
     }
 
 #else
     result = select(eh->nfds, &rfds, NULL, NULL, &eh->tv);
 #endif
 
+    if (result > 0) {
+      __atomic_store_n(&eh->pending, 0, __ATOMIC_SEQ_CST);
+    }
+
     if (result > 0
 #ifdef __linux__
         && eh->fd1 != -1) {
@@ -241,6 +509,23 @@ void eh_free(TEventHandler *eh) {
   if (eh != 0) {
 #ifdef __linux__
 
+    int fd;
+
+    for (fd = 0; fd < eh->fds_size; fd++) {
+      if (eh->fds[fd] == 0) continue;
+
+      if (eh->fds[fd]->timer_callback) {
+        eh_timer_stop(eh, fd);
+      } else {
+        eh_unregister_fd(eh, fd);
+      }
+    }
+
+    eh_free_released(eh);
+    free(eh->fds);
+
+    if (eh->wait_timer_fd != -1) close(eh->wait_timer_fd);
+
     if (eh->fd1 != -1) close(eh->fd1);
 
     if (eh->epoll_fd != -1) close(eh->epoll_fd);
@@ -24,6 +24,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "salloc.h"
+
 #if defined(_WIN32)
 #include <Windows.h>
 #include <wchar.h>
@@ -82,7 +84,7 @@ char LOG_ICACHE_FLASH supla_log_string(char **buffer, int *size, va_list va,
 
   if (*size == 0) {
     *size = strnlen(__fmt, 10240) + 10;
-    *buffer = (char *)malloc(*size);
+    *buffer = (char *)salloc_malloc(NULL, *size, SALLOC_TAG_LOG);
   }
 
   if (*buffer == NULL) {
@@ -102,8 +104,9 @@ char LOG_ICACHE_FLASH supla_log_string(char **buffer, int *size, va_list va,
     else             /* glibc 2.0 */
       (*size) *= 2;  /* twice the old size */
 
-    if ((nb = (char *)realloc(*buffer, *size)) == NULL) {
-      free(*buffer);
+    if ((nb = (char *)salloc_realloc(NULL, *buffer, *size, SALLOC_TAG_LOG)) ==
+        NULL) {
+      salloc_free(NULL, *buffer, SALLOC_TAG_LOG);
       *buffer = NULL;
       *size = 0;
     } else {
@@ -291,7 +294,7 @@ void LOG_ICACHE_FLASH supla_log(int __pri, const char *__fmt, ...) {
   if (buffer == NULL) return;
 
   supla_vlog(__pri, buffer);
-  free(buffer);
+  salloc_free(NULL, buffer, SALLOC_TAG_LOG);
 }
 
 void LOG_ICACHE_FLASH supla_write_state_file(const char *file, int __pri,
@@ -337,5 +340,5 @@ void LOG_ICACHE_FLASH supla_write_state_file(const char *file, int __pri,
   }
 #endif
 
-  free(buffer);
+  salloc_free(NULL, buffer, SALLOC_TAG_LOG);
 }
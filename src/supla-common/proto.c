@@ -21,6 +21,7 @@
 #include "proto.h"
 
 #include <errno.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -60,39 +61,76 @@
 #define BUFFER_MAX_SIZE 131072
 #endif /*BUFFER_MAX_SIZE*/
 
+// Capacity an empty buffer falls back to. Anything above it is released only
+// once the buffer drains, so bursts don't cause realloc churn. Follows the
+// minimum size, so idle connections hold no more than they did before.
+#ifndef BUFFER_KEEP_SIZE
+#define BUFFER_KEEP_SIZE BUFFER_MIN_SIZE
+#endif /*BUFFER_KEEP_SIZE*/
+
+#define BUFFER_FIRST_SIZE 64
+
 char sproto_tag[SUPLA_TAG_SIZE] = {'S', 'U', 'P', 'L', 'A'};
 
+// Ring of data_size bytes starting at head. The size is zero or a power of
+// two, so positions wrap with a mask.
 typedef struct {
-  unsigned char begin_tag;
   unsigned _supla_int_t size;
+  unsigned _supla_int_t head;
   unsigned _supla_int_t data_size;
 
+  // BUFFER_MIN_SIZE, BUFFER_MAX_SIZE and BUFFER_KEEP_SIZE unless set by
+  // sproto_set_buffer_size
+  unsigned _supla_int_t min_size;
+  unsigned _supla_int_t max_size;
+  unsigned _supla_int_t keep_size;
+  // Free the buffer whenever it drains instead of keeping keep_size
+  unsigned char release_idle;
+
+  const TSAllocator *allocator;
   char *buffer;
-} TSuplaProtoInBuffer;
+} TSuplaProtoRing;
 
-#ifndef SPROTO_WITHOUT_OUT_BUFFER
 typedef struct {
-  unsigned _supla_int_t size;
-  unsigned _supla_int_t data_size;
+  unsigned char begin_tag;
+  unsigned char resync;
+  // Set after a resync until the next valid packet
+  unsigned char resyncing;
+  unsigned _supla_int_t resync_count;
+  TSuplaProtoRing ring;
+} TSuplaProtoInBuffer;
 
-  char *buffer;
-} TSuplaProtoOutBuffer;
+#ifndef SPROTO_WITHOUT_OUT_BUFFER
+typedef TSuplaProtoRing TSuplaProtoOutBuffer;
 #endif
 
 typedef struct {
+  const TSAllocator *allocator;
   unsigned _supla_int_t next_rr_id;
   unsigned char version;
+  // Largest data_size accepted from the peer
+  unsigned _supla_int_t max_data_size;
   TSuplaProtoInBuffer in;
 #ifndef SPROTO_WITHOUT_OUT_BUFFER
   TSuplaProtoOutBuffer out;
 #endif
 } TSuplaProtoData;
 
-void *sproto_init(void) {
-  TSuplaProtoData *spd = malloc(sizeof(TSuplaProtoData));
+void *sproto_init(void) { return sproto_init_with_allocator(NULL); }
+
+void *sproto_init_with_allocator(const TSAllocator *allocator) {
+  TSuplaProtoData *spd =
+      salloc_malloc(allocator, sizeof(TSuplaProtoData), SALLOC_TAG_PROTO);
   if (spd) {
     memset(spd, 0, sizeof(TSuplaProtoData));
+    spd->allocator = allocator;
+    spd->in.ring.allocator = allocator;
+#ifndef SPROTO_WITHOUT_OUT_BUFFER
+    spd->out.allocator = allocator;
+#endif
     spd->version = SUPLA_PROTO_VERSION;
+    sproto_set_buffer_size(spd, 0, 0);
+    sproto_set_max_data_size(spd, 0);
     return (spd);
   }
 
@@ -102,60 +140,184 @@ void *sproto_init(void) {
 void sproto_free(void *spd_ptr) {
   TSuplaProtoData *spd = (TSuplaProtoData *)spd_ptr;
   if (spd != NULL) {
-    if (spd->in.buffer != NULL) free(spd->in.buffer);
+    salloc_free(spd->allocator, spd->in.ring.buffer, SALLOC_TAG_PROTO);
 #ifndef SPROTO_WITHOUT_OUT_BUFFER
-    if (spd->out.buffer != NULL) free(spd->out.buffer);
+    salloc_free(spd->allocator, spd->out.buffer, SALLOC_TAG_PROTO);
 #endif
 
-    free(spd);
+    salloc_free(spd->allocator, spd, SALLOC_TAG_PROTO);
   }
 }
 
-unsigned char PROTO_ICACHE_FLASH sproto_buffer_append(
-    void *spd_ptr, char **buffer, unsigned _supla_int_t *buffer_size,
-    unsigned _supla_int_t *buffer_data_size, char *data,
-    unsigned _supla_int_t data_size) {
-  (void)(spd_ptr);
-  unsigned _supla_int_t size = *buffer_size;
+void PROTO_ICACHE_FLASH sproto_ring_set_size(TSuplaProtoRing *ring,
+                                             unsigned _supla_int_t min_size,
+                                             unsigned _supla_int_t max_size) {
+  ring->min_size = min_size ? min_size : BUFFER_MIN_SIZE;
+  ring->max_size = max_size ? max_size : BUFFER_MAX_SIZE;
+  ring->keep_size = min_size ? min_size : BUFFER_KEEP_SIZE;
+}
+
+char PROTO_ICACHE_FLASH sproto_ring_reserve(TSuplaProtoRing *ring,
+                                            unsigned _supla_int_t size) {
+  unsigned _supla_int_t needed = ring->data_size + size;
+  unsigned _supla_int_t new_size = ring->size;
 
-  if (size < BUFFER_MIN_SIZE) {
-    size = BUFFER_MIN_SIZE;
+  if (size >= ring->max_size || needed >= ring->max_size) {
+    return (SUPLA_RESULT_BUFFER_OVERFLOW);
   }
 
-  if (data_size > size - (*buffer_data_size)) {
-    size += data_size - (size - (*buffer_data_size));
+  if (needed <= ring->size) return (SUPLA_RESULT_TRUE);
+
+  if (new_size == 0) {
+    new_size = BUFFER_FIRST_SIZE;
+    while (new_size < ring->min_size) new_size <<= 1;
   }
 
-  if (size >= BUFFER_MAX_SIZE) return (SUPLA_RESULT_BUFFER_OVERFLOW);
+  while (new_size < needed) new_size <<= 1;
 
-  if (size != (*buffer_size)) {
-    char *new_buffer = (char *)realloc(*buffer, size);
+  char *new_buffer = (char *)salloc_realloc(ring->allocator, ring->buffer,
+                                            new_size, SALLOC_TAG_PROTO);
+  if (new_buffer == NULL) return (SUPLA_RESULT_FALSE);
 
-    if (size > 0 && new_buffer == NULL) {
-      return (SUPLA_RESULT_FALSE);
+  // The wrapped part continues right after the old end. The new size is at
+  // least twice the old one, so it always fits.
+  if (ring->head + ring->data_size > ring->size) {
+    memcpy(&new_buffer[ring->size], new_buffer,
+           ring->head + ring->data_size - ring->size);
+  }
+
+  ring->buffer = new_buffer;
+  ring->size = new_size;
+
+  return (SUPLA_RESULT_TRUE);
+}
+
+void PROTO_ICACHE_FLASH sproto_ring_read(TSuplaProtoRing *ring,
+                                         unsigned _supla_int_t offset,
+                                         char *data,
+                                         unsigned _supla_int_t size) {
+  unsigned _supla_int_t pos = (ring->head + offset) & (ring->size - 1);
+  unsigned _supla_int_t part = ring->size - pos;
+
+  if (part > size) part = size;
+
+  memcpy(data, &ring->buffer[pos], part);
+  if (size > part) memcpy(&data[part], ring->buffer, size - part);
+}
+
+char PROTO_ICACHE_FLASH sproto_ring_write(TSuplaProtoRing *ring, char *data,
+                                          unsigned _supla_int_t size) {
+  char result = sproto_ring_reserve(ring, size);
+  if (result != SUPLA_RESULT_TRUE || size == 0) return result;
+
+  unsigned _supla_int_t pos =
+      (ring->head + ring->data_size) & (ring->size - 1);
+  unsigned _supla_int_t part = ring->size - pos;
+
+  if (part > size) part = size;
+
+  memcpy(&ring->buffer[pos], data, part);
+  if (size > part) memcpy(ring->buffer, &data[part], size - part);
+
+  ring->data_size += size;
+  return (SUPLA_RESULT_TRUE);
+}
+
+unsigned _supla_int_t PROTO_ICACHE_FLASH
+sproto_ring_read_span(TSuplaProtoRing *ring, char **data) {
+  unsigned _supla_int_t size = ring->size - ring->head;
+
+  *data = &ring->buffer[ring->head];
+  return ring->data_size < size ? ring->data_size : size;
+}
+
+unsigned _supla_int_t PROTO_ICACHE_FLASH
+sproto_ring_write_span(TSuplaProtoRing *ring, char **data) {
+  unsigned _supla_int_t pos;
+
+  if (ring->data_size >= ring->size) {
+    *data = NULL;
+    return 0;
+  }
+
+  pos = (ring->head + ring->data_size) & (ring->size - 1);
+  *data = &ring->buffer[pos];
+
+  return pos >= ring->head ? ring->size - pos : ring->head - pos;
+}
+
+// Called on an empty ring
+void PROTO_ICACHE_FLASH sproto_ring_shrink(TSuplaProtoRing *ring) {
+  ring->head = 0;
+
+  if (ring->release_idle) {
+    if (ring->buffer != NULL) {
+      salloc_free(ring->allocator, ring->buffer, SALLOC_TAG_PROTO);
+      ring->buffer = NULL;
     }
+    ring->size = 0;
+    return;
+  }
 
-#if !defined(ESP8266) && !defined(ESP32) && !defined(ARDUINO) && \
-    !defined(SUPLA_DEVICE)
-    if (errno == ENOMEM) return (SUPLA_RESULT_FALSE);
-#endif
+  if (ring->size > ring->keep_size) {
+    unsigned _supla_int_t new_size = BUFFER_FIRST_SIZE;
+    while (new_size < ring->keep_size) new_size <<= 1;
 
-    *buffer = new_buffer;
+    if (new_size < ring->size) {
+      char *new_buffer = (char *)salloc_realloc(ring->allocator, ring->buffer,
+                                                new_size, SALLOC_TAG_PROTO);
+      if (new_buffer != NULL) {
+        ring->buffer = new_buffer;
+        ring->size = new_size;
+      }
+    }
   }
+}
 
-  memcpy(&(*buffer)[(*buffer_data_size)], data, data_size);
+void PROTO_ICACHE_FLASH sproto_ring_consume(TSuplaProtoRing *ring,
+                                            unsigned _supla_int_t size) {
+  if (size > ring->data_size) size = ring->data_size;
 
-  (*buffer_size) = size;
-  (*buffer_data_size) += data_size;
+  ring->data_size -= size;
 
-  return (SUPLA_RESULT_TRUE);
+  if (ring->data_size > 0) {
+    ring->head = (ring->head + size) & (ring->size - 1);
+    return;
+  }
+
+  sproto_ring_shrink(ring);
 }
 
 char PROTO_ICACHE_FLASH sproto_in_buffer_append(
     void *spd_ptr, char *data, unsigned _supla_int_t data_size) {
   TSuplaProtoData *spd = (TSuplaProtoData *)spd_ptr;
-  return sproto_buffer_append(spd_ptr, &spd->in.buffer, &spd->in.size,
-                              &spd->in.data_size, data, data_size);
+  return sproto_ring_write(&spd->in.ring, data, data_size);
+}
+
+// Makes room for at least min_size bytes and returns the contiguous free
+// space at the end of the input buffer. Data written there becomes part of
+// the buffer after sproto_in_buffer_commit.
+unsigned _supla_int_t PROTO_ICACHE_FLASH sproto_in_buffer_write_span(
+    void *spd_ptr, unsigned _supla_int_t min_size, char **data) {
+  TSuplaProtoData *spd = (TSuplaProtoData *)spd_ptr;
+
+  if (sproto_ring_reserve(&spd->in.ring, min_size) != SUPLA_RESULT_TRUE) {
+    *data = NULL;
+    return 0;
+  }
+
+  return sproto_ring_write_span(&spd->in.ring, data);
+}
+
+void PROTO_ICACHE_FLASH sproto_in_buffer_commit(void *spd_ptr,
+                                                unsigned _supla_int_t size) {
+  TSuplaProtoData *spd = (TSuplaProtoData *)spd_ptr;
+  spd->in.ring.data_size += size;
+
+  // Space reserved for a read which brought nothing
+  if (spd->in.ring.data_size == 0 && spd->in.ring.release_idle) {
+    sproto_ring_shrink(&spd->in.ring);
+  }
 }
 
 #ifndef SPROTO_WITHOUT_OUT_BUFFER
@@ -165,58 +327,78 @@ char PROTO_ICACHE_FLASH sproto_out_buffer_append(void *spd_ptr,
   unsigned _supla_int_t sdp_size = sizeof(TSuplaDataPacket);
   unsigned _supla_int_t packet_size =
       sdp_size - SUPLA_MAX_DATA_SIZE + sdp->data_size;
+  char result;
 
   if (packet_size > sdp_size) return SUPLA_RESULT_DATA_TOO_LARGE;
 
-  if (SUPLA_RESULT_TRUE ==
-      sproto_buffer_append(spd_ptr, &spd->out.buffer, &spd->out.size,
-                           &spd->out.data_size, (char *)sdp, packet_size)) {
-    return sproto_buffer_append(spd_ptr, &spd->out.buffer, &spd->out.size,
-                                &spd->out.data_size, sproto_tag,
-                                SUPLA_TAG_SIZE);
-  }
+  result = sproto_ring_reserve(&spd->out, packet_size + SUPLA_TAG_SIZE);
+  if (result != SUPLA_RESULT_TRUE) return result;
 
-  return (SUPLA_RESULT_FALSE);
+  sproto_ring_write(&spd->out, (char *)sdp, packet_size);
+  return sproto_ring_write(&spd->out, sproto_tag, SUPLA_TAG_SIZE);
 }
 
-unsigned _supla_int_t PROTO_ICACHE_FLASH sproto_pop_out_data(
-    void *spd_ptr, char *buffer, unsigned _supla_int_t buffer_size) {
-  unsigned _supla_int_t a;
-  unsigned _supla_int_t b;
-
+// Returns a contiguous place for size bytes at the end of the output buffer,
+// or NULL if there is none. The bytes become part of the output only after
+// sproto_out_buffer_commit.
+char *PROTO_ICACHE_FLASH sproto_out_buffer_reserve(void *spd_ptr,
+                                                   unsigned _supla_int_t size) {
   TSuplaProtoData *spd = (TSuplaProtoData *)spd_ptr;
+  char *data = NULL;
 
-  if (spd->out.data_size <= 0 || buffer_size == 0 || buffer == NULL) return (0);
+  if (sproto_ring_reserve(&spd->out, size) != SUPLA_RESULT_TRUE ||
+      sproto_ring_write_span(&spd->out, &data) < size) {
+    return NULL;
+  }
 
-  if (spd->out.data_size < buffer_size) buffer_size = spd->out.data_size;
+  return data;
+}
+
+void PROTO_ICACHE_FLASH sproto_out_buffer_commit(void *spd_ptr,
+                                                 unsigned _supla_int_t size) {
+  TSuplaProtoData *spd = (TSuplaProtoData *)spd_ptr;
+  spd->out.data_size += size;
+}
 
-  memcpy(buffer, spd->out.buffer, buffer_size);
+char PROTO_ICACHE_FLASH sproto_out_buffer_append_data(
+    void *spd_ptr, char *data, unsigned _supla_int_t data_size) {
+  TSuplaProtoData *spd = (TSuplaProtoData *)spd_ptr;
+  return sproto_ring_write(&spd->out, data, data_size);
+}
 
-  b = 0;
+// Returns the first contiguous part of the pending output without removing
+// it. The pointer stays valid until the next append or consume.
+unsigned _supla_int_t PROTO_ICACHE_FLASH sproto_out_data_peek(void *spd_ptr,
+                                                             char **data) {
+  TSuplaProtoData *spd = (TSuplaProtoData *)spd_ptr;
+  return sproto_ring_read_span(&spd->out, data);
+}
 
-  for (a = buffer_size; a < spd->out.data_size; a++) {
-    spd->out.buffer[b] = spd->out.buffer[a];
-    b++;
-  }
+unsigned _supla_int_t PROTO_ICACHE_FLASH
+sproto_out_data_peek_wrapped(void *spd_ptr, char **data) {
+  TSuplaProtoData *spd = (TSuplaProtoData *)spd_ptr;
+  unsigned _supla_int_t size = sproto_ring_read_span(&spd->out, data);
+
+  *data = spd->out.buffer;
+  return spd->out.data_size - size;
+}
 
-  spd->out.data_size -= buffer_size;
+void PROTO_ICACHE_FLASH sproto_out_data_consume(void *spd_ptr,
+                                                unsigned _supla_int_t size) {
+  TSuplaProtoData *spd = (TSuplaProtoData *)spd_ptr;
+  sproto_ring_consume(&spd->out, size);
+}
 
-  if (spd->out.data_size < spd->out.size) {
-    b = spd->out.size;
+unsigned _supla_int_t PROTO_ICACHE_FLASH sproto_pop_out_data(
+    void *spd_ptr, char *buffer, unsigned _supla_int_t buffer_size) {
+  TSuplaProtoData *spd = (TSuplaProtoData *)spd_ptr;
 
-    spd->out.size = spd->out.data_size;
-    if (spd->out.size < BUFFER_MIN_SIZE) spd->out.size = BUFFER_MIN_SIZE;
+  if (spd->out.data_size <= 0 || buffer_size == 0 || buffer == NULL) return (0);
 
-    if (b != spd->out.size) {
-      char *new_out_buffer = (char *)realloc(spd->out.buffer, spd->out.size);
+  if (spd->out.data_size < buffer_size) buffer_size = spd->out.data_size;
 
-      if (new_out_buffer == NULL && spd->out.size > 0) {
-        spd->out.size = b;
-      } else {
-        spd->out.buffer = new_out_buffer;
-      }
-    }
-  }
+  sproto_ring_read(&spd->out, 0, buffer, buffer_size);
+  sproto_ring_consume(&spd->out, buffer_size);
 
   return (buffer_size);
 }
@@ -233,99 +415,202 @@ char PROTO_ICACHE_FLASH sproto_out_dataexists(void *spd_ptr) {
 }
 
 char PROTO_ICACHE_FLASH sproto_in_dataexists(void *spd_ptr) {
-  return ((TSuplaProtoData *)spd_ptr)->in.data_size > 0 ? SUPLA_RESULT_TRUE
-                                                        : SUPLA_RESULT_FALSE;
+  return ((TSuplaProtoData *)spd_ptr)->in.ring.data_size > 0
+             ? SUPLA_RESULT_TRUE
+             : SUPLA_RESULT_FALSE;
 }
 
 void PROTO_ICACHE_FLASH sproto_shrink_in_buffer(TSuplaProtoInBuffer *in,
                                                 unsigned _supla_int_t size) {
-  unsigned _supla_int_t old_size = in->size;
-  unsigned _supla_int_t a, b;
-
   in->begin_tag = 0;
+  sproto_ring_consume(&in->ring, size);
+}
+
+// Drops the bad data at the front of the input buffer up to the next
+// candidate begin tag. A tag cut off by the end of the buffered data is kept
+// so that the next read can complete it.
+void PROTO_ICACHE_FLASH sproto_in_resync(TSuplaProtoInBuffer *in) {
+  TSuplaProtoRing *ring = &in->ring;
+  unsigned _supla_int_t offset = 1;
+  unsigned _supla_int_t pos, span;
+  char tag[SUPLA_TAG_SIZE];
+  char *found;
+
+  while (offset < ring->data_size) {
+    pos = (ring->head + offset) & (ring->size - 1);
+    span = ring->size - pos;
+    if (span > ring->data_size - offset) span = ring->data_size - offset;
+
+    found = (char *)memchr(&ring->buffer[pos], sproto_tag[0], span);
+    if (found == NULL) {
+      offset += span;
+      continue;
+    }
 
-  if (size > in->data_size) size = in->data_size;
+    offset += found - &ring->buffer[pos];
+    span = ring->data_size - offset;
+    if (span > SUPLA_TAG_SIZE) span = SUPLA_TAG_SIZE;
 
-  b = 0;
+    sproto_ring_read(ring, offset, tag, span);
+    if (memcmp(tag, sproto_tag, span) == 0) break;
 
-  for (a = size; a < in->data_size; a++) {
-    in->buffer[b] = in->buffer[a];
-    b++;
+    offset++;
   }
 
-  in->data_size -= size;
+  sproto_shrink_in_buffer(in, offset);
+  in->resyncing = 1;
+  in->resync_count++;
+}
 
-  if (in->data_size < in->size) {
-    in->size = in->data_size;
+// Returns 1 when the caller may look for the next packet, 0 when the whole
+// buffer was dropped.
+char PROTO_ICACHE_FLASH sproto_in_discard(TSuplaProtoInBuffer *in) {
+  if (in->resync) {
+    sproto_in_resync(in);
+    return 1;
+  }
 
-    if (in->size < BUFFER_MIN_SIZE) in->size = BUFFER_MIN_SIZE;
+  sproto_shrink_in_buffer(in, in->ring.data_size);
+  return 0;
+}
 
-    if (old_size != in->size) {
-      char *new_in_buffer = (char *)realloc(in->buffer, in->size);
+// Validates the packet at the front of the input buffer without removing it.
+// On success packet_size is set to the size of the header and the used part
+// of the data field, so the caller can provide exactly that much space for
+// sproto_pop_in_sdp. In resync mode corrupted data is skipped instead of
+// being reported.
+char PROTO_ICACHE_FLASH sproto_in_sdp_check(void *spd_ptr,
+                                            unsigned _supla_int_t *packet_size,
+                                            unsigned char *version) {
+  const unsigned _supla_int_t header_size =
+      sizeof(TSuplaDataPacket) - SUPLA_MAX_DATA_SIZE;
+  unsigned _supla_int_t data_size;
+  char tag[SUPLA_TAG_SIZE];
 
-      if (new_in_buffer == NULL && in->size > 0) {
-        in->size = old_size;
+  TSuplaProtoData *spd = (TSuplaProtoData *)spd_ptr;
+  TSuplaProtoRing *in = &spd->in.ring;
+
+  for (;;) {
+    if (spd->in.begin_tag == 0 && in->data_size >= SUPLA_TAG_SIZE) {
+      sproto_ring_read(in, 0, tag, SUPLA_TAG_SIZE);
+      if (memcmp(tag, sproto_tag, SUPLA_TAG_SIZE) == 0) {
+        spd->in.begin_tag = 1;
+      } else if (sproto_in_discard(&spd->in)) {
+        continue;
       } else {
-        in->buffer = new_in_buffer;
+        return SUPLA_RESULT_DATA_ERROR;
       }
     }
+
+    if (spd->in.begin_tag != 1 ||
+        (in->data_size - SUPLA_TAG_SIZE) < header_size) {
+      return (SUPLA_RESULT_FALSE);
+    }
+
+    sproto_ring_read(in, offsetof(TSuplaDataPacket, version), (char *)version,
+                     sizeof(*version));
+    sproto_ring_read(in, offsetof(TSuplaDataPacket, data_size),
+                     (char *)&data_size, sizeof(data_size));
+
+    if (*version > SUPLA_PROTO_VERSION || *version < SUPLA_PROTO_VERSION_MIN) {
+      // Right after a resync this is more likely noise than a peer
+      // speaking an unsupported version.
+      if (spd->in.resyncing) {
+        sproto_in_resync(&spd->in);
+        continue;
+      }
+
+      sproto_shrink_in_buffer(&spd->in, in->data_size);
+      return SUPLA_RESULT_VERSION_ERROR;
+    }
+
+    if (data_size > spd->max_data_size) {
+      if (sproto_in_discard(&spd->in)) continue;
+      return SUPLA_RESULT_DATA_ERROR;
+    }
+
+    if ((header_size + data_size + SUPLA_TAG_SIZE) > in->data_size)
+      return SUPLA_RESULT_FALSE;
+
+    sproto_ring_read(in, header_size + data_size, tag, SUPLA_TAG_SIZE);
+
+    if (memcmp(tag, sproto_tag, SUPLA_TAG_SIZE) != 0) {
+      if (sproto_in_discard(&spd->in)) continue;
+      return SUPLA_RESULT_DATA_ERROR;
+    }
+
+    spd->in.resyncing = 0;
+    *packet_size = header_size + data_size;
+    return (SUPLA_RESULT_TRUE);
   }
 }
 
+// Only the header and the used part of sdp->data are written.
 char PROTO_ICACHE_FLASH sproto_pop_in_sdp(void *spd_ptr,
                                           TSuplaDataPacket *sdp) {
-  unsigned _supla_int_t header_size;
-  TSuplaDataPacket *_sdp;
-
   TSuplaProtoData *spd = (TSuplaProtoData *)spd_ptr;
-
-  if (spd->in.begin_tag == 0 && spd->in.data_size >= SUPLA_TAG_SIZE) {
-    if (memcmp(spd->in.buffer, sproto_tag, SUPLA_TAG_SIZE) == 0) {
-      spd->in.begin_tag = 1;
-    } else {
-      sproto_shrink_in_buffer(&spd->in, spd->in.data_size);
-      return SUPLA_RESULT_DATA_ERROR;
-    }
+  unsigned _supla_int_t packet_size = 0;
+  unsigned char version = 0;
+  char result = sproto_in_sdp_check(spd_ptr, &packet_size, &version);
+
+  if (result == (char)SUPLA_RESULT_VERSION_ERROR) {
+    sdp->version = version;
+  } else if (result == SUPLA_RESULT_TRUE) {
+    sproto_ring_read(&spd->in.ring, 0, (char *)sdp, packet_size);
+    sproto_shrink_in_buffer(&spd->in, packet_size + SUPLA_TAG_SIZE);
   }
 
-  if (spd->in.begin_tag == 1) {
-    header_size = sizeof(TSuplaDataPacket) - SUPLA_MAX_DATA_SIZE;
-    if ((spd->in.data_size - SUPLA_TAG_SIZE) >= header_size) {
-      _sdp = (TSuplaDataPacket *)spd->in.buffer;
+  return result;
+}
 
-      if (_sdp->version > SUPLA_PROTO_VERSION ||
-          _sdp->version < SUPLA_PROTO_VERSION_MIN) {
-        sdp->version = _sdp->version;
-        sproto_shrink_in_buffer(&spd->in, spd->in.data_size);
+void PROTO_ICACHE_FLASH sproto_set_in_resync(void *spd_ptr,
+                                             unsigned char resync) {
+  ((TSuplaProtoData *)spd_ptr)->in.resync = resync ? 1 : 0;
+}
 
-        return SUPLA_RESULT_VERSION_ERROR;
-      }
+void PROTO_ICACHE_FLASH sproto_set_buffer_size(void *spd_ptr,
+                                               unsigned _supla_int_t min_size,
+                                               unsigned _supla_int_t max_size) {
+  TSuplaProtoData *spd = (TSuplaProtoData *)spd_ptr;
 
-      if ((header_size + _sdp->data_size) > sizeof(TSuplaDataPacket)) {
-        sproto_shrink_in_buffer(&spd->in, spd->in.data_size);
-        return SUPLA_RESULT_DATA_ERROR;
-      }
+  sproto_ring_set_size(&spd->in.ring, min_size, max_size);
+#ifndef SPROTO_WITHOUT_OUT_BUFFER
+  sproto_ring_set_size(&spd->out, min_size, max_size);
+#endif
+}
+
+void PROTO_ICACHE_FLASH sproto_set_release_idle(void *spd_ptr,
+                                                unsigned char release) {
+  TSuplaProtoData *spd = (TSuplaProtoData *)spd_ptr;
 
-      if ((header_size + _sdp->data_size + SUPLA_TAG_SIZE) > spd->in.data_size)
-        return SUPLA_RESULT_FALSE;
+  spd->in.ring.release_idle = release ? 1 : 0;
+#ifndef SPROTO_WITHOUT_OUT_BUFFER
+  spd->out.release_idle = release ? 1 : 0;
+#endif
+}
 
-      if (header_size + _sdp->data_size >= spd->in.size ||
-          memcmp(&spd->in.buffer[header_size + _sdp->data_size], sproto_tag,
-                 SUPLA_TAG_SIZE) != 0) {
-        sproto_shrink_in_buffer(&spd->in, spd->in.data_size);
+void PROTO_ICACHE_FLASH sproto_set_max_data_size(
+    void *spd_ptr, unsigned _supla_int_t max_data_size) {
+  if (max_data_size == 0 || max_data_size > SUPLA_MAX_DATA_SIZE) {
+    max_data_size = SUPLA_MAX_DATA_SIZE;
+  }
 
-        return SUPLA_RESULT_DATA_ERROR;
-      }
+  ((TSuplaProtoData *)spd_ptr)->max_data_size = max_data_size;
+}
 
-      memcpy(sdp, spd->in.buffer, header_size + _sdp->data_size);
-      sproto_shrink_in_buffer(&spd->in,
-                              header_size + _sdp->data_size + SUPLA_TAG_SIZE);
+unsigned _supla_int_t PROTO_ICACHE_FLASH
+sproto_in_resync_count(void *spd_ptr) {
+  return ((TSuplaProtoData *)spd_ptr)->in.resync_count;
+}
 
-      return (SUPLA_RESULT_TRUE);
-    }
-  }
+void PROTO_ICACHE_FLASH sproto_reset_buffers(void *spd_ptr) {
+  TSuplaProtoData *spd = (TSuplaProtoData *)spd_ptr;
 
-  return (SUPLA_RESULT_FALSE);
+  sproto_shrink_in_buffer(&spd->in, spd->in.ring.data_size);
+  spd->in.resyncing = 0;
+#ifndef SPROTO_WITHOUT_OUT_BUFFER
+  sproto_out_data_consume(spd_ptr, spd->out.data_size);
+#endif /*SPROTO_WITHOUT_OUT_BUFFER*/
 }
 
 void PROTO_ICACHE_FLASH sproto_set_version(void *spd_ptr,
@@ -355,15 +640,52 @@ void sproto_sdp_init(void *spd_ptr, TSuplaDataPacket *sdp) {
   sdp->version = spd->version;
 }
 
+// Fills in only the header, the data field is left for the caller.
+void PROTO_ICACHE_FLASH sproto_sdp_init_header(void *spd_ptr,
+                                               TSuplaDataPacket *sdp,
+                                               unsigned _supla_int_t call_id,
+                                               unsigned _supla_int_t data_size) {
+  TSuplaProtoData *spd = (TSuplaProtoData *)spd_ptr;
+
+  memcpy(sdp->tag, sproto_tag, SUPLA_TAG_SIZE);
+
+  spd->next_rr_id++;
+
+  if (spd->next_rr_id == 0) spd->next_rr_id++;
+
+  sdp->rr_id = spd->next_rr_id;
+  sdp->version = spd->version;
+  sdp->call_id = call_id;
+  sdp->data_size = data_size;
+}
+
+// A packet may outlive its sproto instance, so it carries the allocator
+typedef struct {
+  const TSAllocator *allocator;
+  TSuplaDataPacket sdp;
+} TSuplaDataPacketBlock;
+
 TSuplaDataPacket *PROTO_ICACHE_FLASH sproto_sdp_malloc(void *spd_ptr) {
-  TSuplaDataPacket *result = malloc(sizeof(TSuplaDataPacket));
+  const TSAllocator *allocator = ((TSuplaProtoData *)spd_ptr)->allocator;
+  TSuplaDataPacketBlock *block = (TSuplaDataPacketBlock *)salloc_malloc(
+      allocator, sizeof(TSuplaDataPacketBlock), SALLOC_TAG_PROTO);
 
-  if (result) sproto_sdp_init(spd_ptr, result);
+  if (block == NULL) return NULL;
 
-  return result;
+  block->allocator = allocator;
+  sproto_sdp_init(spd_ptr, &block->sdp);
+  return &block->sdp;
 }
 
-void PROTO_ICACHE_FLASH sproto_sdp_free(TSuplaDataPacket *sdp) { free(sdp); }
+void PROTO_ICACHE_FLASH sproto_sdp_free(TSuplaDataPacket *sdp) {
+  TSuplaDataPacketBlock *block;
+
+  if (sdp == NULL) return;
+
+  block = (TSuplaDataPacketBlock *)((char *)sdp -
+                                    offsetof(TSuplaDataPacketBlock, sdp));
+  salloc_free(block->allocator, block, SALLOC_TAG_PROTO);
+}
 
 char PROTO_ICACHE_FLASH sproto_set_data(TSuplaDataPacket *sdp, char *data,
                                         unsigned _supla_int_t data_size,
@@ -387,8 +709,8 @@ void PROTO_ICACHE_FLASH sproto_log_summary(void *spd_ptr) {
   TSuplaProtoData *spd = (TSuplaProtoData *)spd_ptr;
 
   supla_log(LOG_DEBUG, "BUFFER IN");
-  supla_log(LOG_DEBUG, "         size: %i", spd->in.size);
-  supla_log(LOG_DEBUG, "    data_size: %i", spd->in.data_size);
+  supla_log(LOG_DEBUG, "         size: %i", spd->in.ring.size);
+  supla_log(LOG_DEBUG, "    data_size: %i", spd->in.ring.data_size);
   supla_log(LOG_DEBUG, "    begin_tag: %i", spd->in.begin_tag);
 #ifndef SPROTO_WITHOUT_OUT_BUFFER
   supla_log(LOG_DEBUG, "BUFFER OUT");
@@ -399,23 +721,25 @@ void PROTO_ICACHE_FLASH sproto_log_summary(void *spd_ptr) {
 
 void PROTO_ICACHE_FLASH sproto_buffer_dump(void *spd_ptr, unsigned char in) {
   _supla_int_t a;
-  char *buffer = NULL;
-  _supla_int_t size = 0;
+  char c;
+  TSuplaProtoRing *ring = NULL;
 
   TSuplaProtoData *spd = (TSuplaProtoData *)spd_ptr;
 
   if (in != 0) {
-    buffer = spd->in.buffer;
-    size = spd->in.data_size;
+    ring = &spd->in.ring;
 #ifndef SPROTO_WITHOUT_OUT_BUFFER
   } else {
-    buffer = spd->out.buffer;
-    size = spd->out.data_size;
+    ring = &spd->out;
 #endif /*SPROTO_WITHOUT_OUT_BUFFER*/
   }
 
-  for (a = 0; a < size; a++)
-    supla_log(LOG_DEBUG, "%c [%i]", buffer[a], buffer[a]);
+  if (ring == NULL) return;
+
+  for (a = 0; a < ring->data_size; a++) {
+    sproto_ring_read(ring, a, &c, 1);
+    supla_log(LOG_DEBUG, "%c [%i]", c, c);
+  }
 }
 
 void PROTO_ICACHE_FLASH sproto_set_null_terminated_string(
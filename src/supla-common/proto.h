@@ -19,6 +19,8 @@
 #ifndef supla_proto_H_
 #define supla_proto_H_
 
+#include "salloc.h"
+
 #ifdef _WIN32
 // *** WINDOWS ***
 
@@ -3895,25 +3897,73 @@ typedef struct {
 #pragma pack(pop)
 
 void *PROTO_ICACHE_FLASH sproto_init(void);
+// Buffers of the returned instance come from allocator, NULL: the default
+void *PROTO_ICACHE_FLASH
+sproto_init_with_allocator(const TSAllocator *allocator);
 void PROTO_ICACHE_FLASH sproto_free(void *spd_ptr);
 
 #ifndef SPROTO_WITHOUT_OUT_BUFFER
 char PROTO_ICACHE_FLASH sproto_out_buffer_append(void *spd_ptr,
                                                  TSuplaDataPacket *sdp);
+char PROTO_ICACHE_FLASH sproto_out_buffer_append_data(
+    void *spd_ptr, char *data, unsigned _supla_int_t data_size);
+char *PROTO_ICACHE_FLASH sproto_out_buffer_reserve(void *spd_ptr,
+                                                   unsigned _supla_int_t size);
+void PROTO_ICACHE_FLASH sproto_out_buffer_commit(void *spd_ptr,
+                                                 unsigned _supla_int_t size);
 unsigned _supla_int_t sproto_pop_out_data(void *spd_ptr, char *buffer,
                                           unsigned _supla_int_t buffer_size);
+unsigned _supla_int_t PROTO_ICACHE_FLASH sproto_out_data_peek(void *spd_ptr,
+                                                             char **data);
+// The part of the output following the sproto_out_data_peek span from the
+// start of the buffer, 0 unless the data wraps around
+unsigned _supla_int_t PROTO_ICACHE_FLASH
+sproto_out_data_peek_wrapped(void *spd_ptr, char **data);
+void PROTO_ICACHE_FLASH sproto_out_data_consume(void *spd_ptr,
+                                                unsigned _supla_int_t size);
 #endif /*SPROTO_WITHOUT_OUT_BUFFER*/
 char PROTO_ICACHE_FLASH sproto_out_dataexists(void *spd_ptr);
 char PROTO_ICACHE_FLASH sproto_in_buffer_append(
     void *spd_ptr, char *data, unsigned _supla_int_t data_size);
-
+unsigned _supla_int_t PROTO_ICACHE_FLASH sproto_in_buffer_write_span(
+    void *spd_ptr, unsigned _supla_int_t min_size, char **data);
+void PROTO_ICACHE_FLASH sproto_in_buffer_commit(void *spd_ptr,
+                                                unsigned _supla_int_t size);
+
+char PROTO_ICACHE_FLASH sproto_in_sdp_check(void *spd_ptr,
+                                            unsigned _supla_int_t *packet_size,
+                                            unsigned char *version);
 char PROTO_ICACHE_FLASH sproto_pop_in_sdp(void *spd_ptr, TSuplaDataPacket *sdp);
 char PROTO_ICACHE_FLASH sproto_in_dataexists(void *spd_ptr);
+// In resync mode a corrupted packet is skipped up to the next begin tag
+// instead of dropping all buffered input.
+void PROTO_ICACHE_FLASH sproto_set_in_resync(void *spd_ptr,
+                                             unsigned char resync);
+unsigned _supla_int_t PROTO_ICACHE_FLASH
+sproto_in_resync_count(void *spd_ptr);
+// Bounds of the input and output buffers, 0 selects the build defaults
+// (BUFFER_MIN_SIZE, BUFFER_MAX_SIZE). A buffer which grew above min_size
+// shrinks back once it drains.
+void PROTO_ICACHE_FLASH sproto_set_buffer_size(void *spd_ptr,
+                                               unsigned _supla_int_t min_size,
+                                               unsigned _supla_int_t max_size);
+// When set, the input and output buffers are freed as soon as they drain, so
+// an idle connection holds none
+void PROTO_ICACHE_FLASH sproto_set_release_idle(void *spd_ptr,
+                                                unsigned char release);
+// Incoming packets with more data are rejected, 0 selects SUPLA_MAX_DATA_SIZE
+void PROTO_ICACHE_FLASH sproto_set_max_data_size(
+    void *spd_ptr, unsigned _supla_int_t max_data_size);
+void PROTO_ICACHE_FLASH sproto_reset_buffers(void *spd_ptr);
 
 unsigned char PROTO_ICACHE_FLASH sproto_get_version(void *spd_ptr);
 void PROTO_ICACHE_FLASH sproto_set_version(void *spd_ptr,
                                            unsigned char version);
 void PROTO_ICACHE_FLASH sproto_sdp_init(void *spd_ptr, TSuplaDataPacket *sdp);
+void PROTO_ICACHE_FLASH sproto_sdp_init_header(void *spd_ptr,
+                                               TSuplaDataPacket *sdp,
+                                               unsigned _supla_int_t call_id,
+                                               unsigned _supla_int_t data_size);
 char PROTO_ICACHE_FLASH sproto_set_data(TSuplaDataPacket *sdp, char *data,
                                         unsigned _supla_int_t data_size,
                                         unsigned _supla_int_t call_id);
@@ -0,0 +1,368 @@
+/*
+ Copyright (C) AC SOFTWARE SP. Z O.O.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "safehash.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "lck.h"
+
+#define SAFE_HASH_MIN_SLOTS 16
+
+typedef struct {
+  uint64_t key;
+  void *ptr;
+} TSafeHashItem;
+
+typedef struct {
+  void *lck;
+
+  int count;
+  int capacity;
+  TSafeHashItem *items;
+
+  // Item index + 1, zero marks an empty slot
+  int *slots;
+  unsigned int slot_mask;
+} TSafeHashShard;
+
+typedef struct {
+  unsigned int shard_mask;
+  TSafeHashShard *shards;
+} TSafeHash;
+
+static uint64_t safe_hash_mix(uint64_t key) {
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53ULL;
+  key ^= key >> 33;
+  return key;
+}
+
+static TSafeHashShard *safe_hash_shard(TSafeHash *hash, uint64_t h) {
+  // The low bits pick the slot, so take the shard from the high ones
+  return &hash->shards[(h >> 40) & hash->shard_mask];
+}
+
+void *safe_hash_init(int shard_count) {
+  unsigned int n = 1;
+  unsigned int a;
+
+  if (shard_count <= 0) shard_count = SAFE_HASH_DEFAULT_SHARDS;
+  while (n < (unsigned int)shard_count && n < 1024) n <<= 1;
+
+  TSafeHash *hash = malloc(sizeof(TSafeHash));
+  if (hash == NULL) return NULL;
+
+  hash->shards = calloc(n, sizeof(TSafeHashShard));
+  if (hash->shards == NULL) {
+    free(hash);
+    return NULL;
+  }
+
+  hash->shard_mask = n - 1;
+  for (a = 0; a < n; a++) hash->shards[a].lck = lck_init();
+
+  return hash;
+}
+
+void safe_hash_free(void *_hash) {
+  TSafeHash *hash = (TSafeHash *)_hash;
+  unsigned int a;
+
+  assert(_hash != 0);
+
+  for (a = 0; a <= hash->shard_mask; a++) {
+    lck_free(hash->shards[a].lck);
+    free(hash->shards[a].items);
+    free(hash->shards[a].slots);
+  }
+
+  free(hash->shards);
+  free(hash);
+}
+
+void safe_hash_lock(void *_hash) {
+  TSafeHash *hash = (TSafeHash *)_hash;
+  unsigned int a;
+
+  assert(_hash != 0);
+
+  // Always in ascending order, single shard operations never hold two locks
+  for (a = 0; a <= hash->shard_mask; a++) lck_lock(hash->shards[a].lck);
+}
+
+void safe_hash_unlock(void *_hash) {
+  TSafeHash *hash = (TSafeHash *)_hash;
+  unsigned int a;
+
+  assert(_hash != 0);
+
+  for (a = hash->shard_mask + 1; a > 0; a--) {
+    lck_unlock(hash->shards[a - 1].lck);
+  }
+}
+
+int safe_hash_count(void *_hash) {
+  TSafeHash *hash = (TSafeHash *)_hash;
+  int result = 0;
+  unsigned int a;
+
+  assert(_hash != 0);
+
+  safe_hash_lock(_hash);
+  for (a = 0; a <= hash->shard_mask; a++) result += hash->shards[a].count;
+  safe_hash_unlock(_hash);
+
+  return result;
+}
+
+// Returns the slot holding key, or -1 with *empty set to the slot where it
+// would be inserted
+static int safe_hash_lookup(TSafeHashShard *shard, uint64_t key, uint64_t h,
+                            unsigned int *empty) {
+  unsigned int i;
+
+  if (shard->slots == NULL) return -1;
+
+  for (i = h & shard->slot_mask; shard->slots[i];
+       i = (i + 1) & shard->slot_mask) {
+    if (shard->items[shard->slots[i] - 1].key == key) return i;
+  }
+
+  if (empty) *empty = i;
+  return -1;
+}
+
+static char safe_hash_rehash(TSafeHashShard *shard, unsigned int slot_count) {
+  int *slots = calloc(slot_count, sizeof(int));
+  unsigned int i;
+  int a;
+
+  if (slots == NULL) return 0;
+
+  free(shard->slots);
+  shard->slots = slots;
+  shard->slot_mask = slot_count - 1;
+
+  for (a = 0; a < shard->count; a++) {
+    i = safe_hash_mix(shard->items[a].key) & shard->slot_mask;
+    while (slots[i]) i = (i + 1) & shard->slot_mask;
+    slots[i] = a + 1;
+  }
+
+  return 1;
+}
+
+static char safe_hash_reserve(TSafeHashShard *shard) {
+  if (shard->count == shard->capacity) {
+    int capacity = shard->capacity ? shard->capacity * 2 : 8;
+    TSafeHashItem *items =
+        realloc(shard->items, sizeof(TSafeHashItem) * capacity);
+
+    if (items == NULL) return 0;
+
+    shard->items = items;
+    shard->capacity = capacity;
+  }
+
+  // Keep the load factor under 3/4
+  if (shard->slots == NULL ||
+      (unsigned int)(shard->count + 1) * 4 > (shard->slot_mask + 1) * 3) {
+    return safe_hash_rehash(shard, shard->slots == NULL
+                                       ? SAFE_HASH_MIN_SLOTS
+                                       : (shard->slot_mask + 1) * 2);
+  }
+
+  return 1;
+}
+
+// Empties slot i with backward shift deletion, then moves the last item into
+// the freed position of the dense array
+static void *safe_hash_delete_slot(TSafeHashShard *shard, unsigned int i) {
+  unsigned int mask = shard->slot_mask;
+  unsigned int j, home;
+  int idx = shard->slots[i] - 1;
+  int last = shard->count - 1;
+  void *result = shard->items[idx].ptr;
+
+  for (j = (i + 1) & mask; shard->slots[j]; j = (j + 1) & mask) {
+    home = safe_hash_mix(shard->items[shard->slots[j] - 1].key) & mask;
+    if (((j - home) & mask) >= ((j - i) & mask)) {
+      shard->slots[i] = shard->slots[j];
+      i = j;
+    }
+  }
+  shard->slots[i] = 0;
+
+  if (idx != last) {
+    shard->items[idx] = shard->items[last];
+    for (j = safe_hash_mix(shard->items[idx].key) & mask;
+         shard->slots[j] != last + 1; j = (j + 1) & mask) {
+    }
+    shard->slots[j] = idx + 1;
+  }
+
+  shard->count--;
+  return result;
+}
+
+int safe_hash_add(void *_hash, uint64_t key, void *ptr) {
+  uint64_t h = safe_hash_mix(key);
+  TSafeHashShard *shard;
+  unsigned int empty = 0;
+
+  assert(_hash != 0);
+
+  if (ptr == 0) return -1;
+
+  shard = safe_hash_shard((TSafeHash *)_hash, h);
+  lck_lock(shard->lck);
+
+  if (safe_hash_lookup(shard, key, h, NULL) != -1) {
+    return lck_unlock_r(shard->lck, 0);
+  }
+
+  if (!safe_hash_reserve(shard)) {
+    return lck_unlock_r(shard->lck, -1);
+  }
+
+  safe_hash_lookup(shard, key, h, &empty);
+  shard->items[shard->count].key = key;
+  shard->items[shard->count].ptr = ptr;
+  shard->count++;
+  shard->slots[empty] = shard->count;
+
+  return lck_unlock_r(shard->lck, 1);
+}
+
+void *safe_hash_find(void *_hash, uint64_t key) {
+  uint64_t h = safe_hash_mix(key);
+  TSafeHashShard *shard;
+  void *result = NULL;
+  int i;
+
+  assert(_hash != 0);
+
+  shard = safe_hash_shard((TSafeHash *)_hash, h);
+  lck_lock(shard->lck);
+
+  i = safe_hash_lookup(shard, key, h, NULL);
+  if (i != -1) result = shard->items[shard->slots[i] - 1].ptr;
+
+  lck_unlock(shard->lck);
+
+  return result;
+}
+
+void *safe_hash_remove(void *_hash, uint64_t key) {
+  uint64_t h = safe_hash_mix(key);
+  TSafeHashShard *shard;
+  void *result = NULL;
+  int i;
+
+  assert(_hash != 0);
+
+  shard = safe_hash_shard((TSafeHash *)_hash, h);
+  lck_lock(shard->lck);
+
+  i = safe_hash_lookup(shard, key, h, NULL);
+  if (i != -1) result = safe_hash_delete_slot(shard, i);
+
+  lck_unlock(shard->lck);
+
+  return result;
+}
+
+void *safe_hash_get(void *_hash, int idx) {
+  TSafeHash *hash = (TSafeHash *)_hash;
+  void *result = NULL;
+  unsigned int a;
+
+  assert(_hash != 0);
+
+  if (idx < 0) return 0;
+
+  safe_hash_lock(_hash);
+
+  for (a = 0; a <= hash->shard_mask; a++) {
+    if (idx < hash->shards[a].count) {
+      result = hash->shards[a].items[idx].ptr;
+      break;
+    }
+    idx -= hash->shards[a].count;
+  }
+
+  safe_hash_unlock(_hash);
+
+  return result;
+}
+
+void safe_hash_clean(void *_hash, _func_sa_cnd del_cnd) {
+  TSafeHash *hash = (TSafeHash *)_hash;
+  TSafeHashShard *shard;
+  unsigned int a;
+  int idx;
+
+  assert(_hash != 0);
+
+  safe_hash_lock(_hash);
+
+  for (a = 0; a <= hash->shard_mask; a++) {
+    shard = &hash->shards[a];
+    idx = 0;
+    while (idx < shard->count) {
+      if (del_cnd(shard->items[idx].ptr) == 1) {
+        uint64_t key = shard->items[idx].key;
+        safe_hash_delete_slot(
+            shard, safe_hash_lookup(shard, key, safe_hash_mix(key), NULL));
+      } else {
+        idx++;
+      }
+    }
+  }
+
+  safe_hash_unlock(_hash);
+}
+
+void *safe_hash_findcnd(void *_hash, _func_sa_cnd_param find_cnd,
+                        void *user_param) {
+  TSafeHash *hash = (TSafeHash *)_hash;
+  void *result = NULL;
+  unsigned int a;
+  int idx;
+
+  assert(_hash != 0);
+
+  safe_hash_lock(_hash);
+
+  for (a = 0; a <= hash->shard_mask && result == NULL; a++) {
+    for (idx = 0; idx < hash->shards[a].count; idx++) {
+      if (find_cnd(hash->shards[a].items[idx].ptr, user_param) == 1) {
+        result = hash->shards[a].items[idx].ptr;
+        break;
+      }
+    }
+  }
+
+  safe_hash_unlock(_hash);
+
+  return result;
+}
@@ -0,0 +1,74 @@
+/*
+ Copyright (C) AC SOFTWARE SP. Z O.O.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "salloc.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const TSAllocator *salloc_default;
+
+void salloc_set_default(const TSAllocator *allocator) {
+  __atomic_store_n(&salloc_default, allocator, __ATOMIC_RELEASE);
+}
+
+const TSAllocator *salloc_get_default(void) {
+  return __atomic_load_n(&salloc_default, __ATOMIC_ACQUIRE);
+}
+
+static const TSAllocator *salloc_resolve(const TSAllocator *allocator) {
+  return allocator ? allocator : salloc_get_default();
+}
+
+void *salloc_malloc(const TSAllocator *allocator, size_t size, int tag) {
+  allocator = salloc_resolve(allocator);
+  return allocator ? allocator->alloc(allocator->ctx, size, tag)
+                   : malloc(size);
+}
+
+void *salloc_calloc(const TSAllocator *allocator, size_t nmemb, size_t size,
+                    int tag) {
+  void *ptr;
+
+  allocator = salloc_resolve(allocator);
+  if (!allocator) return calloc(nmemb, size);
+
+  if (size && nmemb > SIZE_MAX / size) return NULL;
+
+  ptr = allocator->alloc(allocator->ctx, nmemb * size, tag);
+  if (ptr) memset(ptr, 0, nmemb * size);
+  return ptr;
+}
+
+void *salloc_realloc(const TSAllocator *allocator, void *ptr, size_t size,
+                     int tag) {
+  allocator = salloc_resolve(allocator);
+  return allocator ? allocator->resize(allocator->ctx, ptr, size, tag)
+                   : realloc(ptr, size);
+}
+
+void salloc_free(const TSAllocator *allocator, void *ptr, int tag) {
+  if (ptr == NULL) return;
+
+  allocator = salloc_resolve(allocator);
+  if (allocator)
+    allocator->release(allocator->ctx, ptr, tag);
+  else
+    free(ptr);
+}
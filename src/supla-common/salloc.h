@@ -0,0 +1,68 @@
+/*
+ Copyright (C) AC SOFTWARE SP. Z O.O.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef SALLOC_H_
+#define SALLOC_H_
+
+#include <stddef.h>
+
+// Pluggable allocator. Every hook gets the allocator context and a tag naming
+// the subsystem asking for memory, so applications can back them with pools,
+// count bytes per subsystem or enforce budgets. Memory always goes back to
+// the allocator it came from, with the tag it was allocated with.
+//
+// A NULL allocator stands for the process default set by
+// salloc_set_default(), which falls back to the C library. The default should
+// be set before anything is allocated and must outlive everything allocated
+// through it.
+
+#define SALLOC_TAG_OTHER 0
+#define SALLOC_TAG_PROTO 1
+#define SALLOC_TAG_SRPC 2
+#define SALLOC_TAG_LOG 3
+// First tag free for users of the library
+#define SALLOC_TAG_USER 16
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  // malloc and realloc semantics, realloc gets NULL ptr for new blocks
+  void *(*alloc)(void *ctx, size_t size, int tag);
+  void *(*resize)(void *ctx, void *ptr, size_t size, int tag);
+  // Never called with NULL
+  void (*release)(void *ctx, void *ptr, int tag);
+  void *ctx;
+} TSAllocator;
+
+void salloc_set_default(const TSAllocator *allocator);
+const TSAllocator *salloc_get_default(void);
+
+void *salloc_malloc(const TSAllocator *allocator, size_t size, int tag);
+void *salloc_calloc(const TSAllocator *allocator, size_t nmemb, size_t size,
+                    int tag);
+void *salloc_realloc(const TSAllocator *allocator, void *ptr, size_t size,
+                     int tag);
+void salloc_free(const TSAllocator *allocator, void *ptr, int tag);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SALLOC_H_ */
@@ -0,0 +1,250 @@
+/*
+ Copyright (C) AC SOFTWARE SP. Z O.O.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "sconnect.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "proto.h"
+
+#define SCONNECT_CACHE_SIZE 16
+
+// Direct mapped host:port key (high half) and family (low half). Entries are
+// single words, so loops of different threads need no lock.
+static uint64_t sconnect_cache[SCONNECT_CACHE_SIZE];
+
+typedef struct {
+  int fd;
+  int family;
+  uint64_t started_at;
+} TSConnectAttempt;
+
+static uint64_t sconnect_now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// FNV-1a, never 0 so empty slots do not match
+static uint32_t sconnect_key(const char *host, int port) {
+  uint32_t hash = 2166136261u;
+
+  for (; host && *host; host++) {
+    hash ^= (unsigned char)*host;
+    hash *= 16777619u;
+  }
+  hash ^= (uint32_t)port;
+  hash *= 16777619u;
+  return hash ? hash : 1;
+}
+
+int sconnect_get_family(const char *host, int port) {
+  uint32_t key = sconnect_key(host, port);
+  uint64_t entry = __atomic_load_n(&sconnect_cache[key % SCONNECT_CACHE_SIZE],
+                                   __ATOMIC_RELAXED);
+
+  return (entry >> 32) == key ? (int)(uint32_t)entry : AF_UNSPEC;
+}
+
+void sconnect_set_family(const char *host, int port, int family) {
+  uint32_t key = sconnect_key(host, port);
+
+  __atomic_store_n(&sconnect_cache[key % SCONNECT_CACHE_SIZE],
+                   ((uint64_t)key << 32) | (uint32_t)family, __ATOMIC_RELAXED);
+}
+
+// Alternates families starting with the preferred one, RFC 8305 section 4
+static int sconnect_order(const struct addrinfo *candidates, int family,
+                          const struct addrinfo **order) {
+  const struct addrinfo *first[SCONNECT_MAX_ATTEMPTS];
+  const struct addrinfo *second[SCONNECT_MAX_ATTEMPTS];
+  const struct addrinfo *ai;
+  int first_count = 0, second_count = 0;
+  int count = 0, a, b;
+
+  if (family == AF_UNSPEC) family = AF_INET6;
+
+  for (ai = candidates; ai; ai = ai->ai_next) {
+    if (ai->ai_family != AF_INET && ai->ai_family != AF_INET6) continue;
+
+    if (ai->ai_family == family) {
+      if (first_count < SCONNECT_MAX_ATTEMPTS) first[first_count++] = ai;
+    } else if (second_count < SCONNECT_MAX_ATTEMPTS) {
+      second[second_count++] = ai;
+    }
+  }
+
+  for (a = 0, b = 0;
+       count < SCONNECT_MAX_ATTEMPTS && (a < first_count || b < second_count);) {
+    if (a < first_count) order[count++] = first[a++];
+    if (b < second_count && count < SCONNECT_MAX_ATTEMPTS)
+      order[count++] = second[b++];
+  }
+
+  return count;
+}
+
+// Returns 1 when connected at once, 0 when in progress, -1 on failure
+static int sconnect_start(const struct addrinfo *ai, TSConnectAttempt *attempt,
+                          uint64_t now) {
+  int fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+  int flags;
+
+  if (fd == -1) return -1;
+
+  flags = fcntl(fd, F_GETFL, 0);
+  fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+
+  attempt->fd = fd;
+  attempt->family = ai->ai_family;
+  attempt->started_at = now;
+
+  if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) return 1;
+  if (errno == EINPROGRESS || errno == EWOULDBLOCK) return 0;
+
+  close(fd);
+  return -1;
+}
+
+static char sconnect_succeeded(int fd) {
+  int error = 0;
+  socklen_t len = sizeof(error);
+
+  return getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len) == 0 &&
+         error == 0;
+}
+
+int sconnect_race(const struct addrinfo *candidates, int family,
+                  int timeout_ms, int *winner_family) {
+  const struct addrinfo *order[SCONNECT_MAX_ATTEMPTS];
+  TSConnectAttempt attempts[SCONNECT_MAX_ATTEMPTS];
+  struct pollfd pfd[SCONNECT_MAX_ATTEMPTS];
+  int count = sconnect_order(candidates, family, order);
+  int active = 0, next = 0, winner = -1;
+  int timeout, rc, a;
+  uint64_t now = sconnect_now_ms();
+  uint64_t next_start_at = now;
+  int64_t left;
+
+  while (winner == -1 && (active > 0 || next < count)) {
+    // Start the next candidate when its delay passed or nothing is running
+    if (next < count && (active == 0 || now >= next_start_at)) {
+      rc = sconnect_start(order[next++], &attempts[active], now);
+      if (rc == 1) {
+        winner = active++;
+        break;
+      }
+      if (rc == 0) {
+        active++;
+        next_start_at = now + SCONNECT_ATTEMPT_DELAY_MS;
+      } else {
+        next_start_at = now;
+      }
+      continue;
+    }
+
+    timeout = -1;
+    if (next < count) timeout = next_start_at - now;
+    if (timeout_ms > 0) {
+      for (a = 0; a < active; a++) {
+        left = (int64_t)(attempts[a].started_at + timeout_ms) - (int64_t)now;
+        if (left < 0) left = 0;
+        if (timeout == -1 || left < timeout) timeout = left;
+      }
+    }
+
+    for (a = 0; a < active; a++) {
+      pfd[a].fd = attempts[a].fd;
+      pfd[a].events = POLLOUT;
+      pfd[a].revents = 0;
+    }
+
+    rc = poll(pfd, active, timeout);
+    if (rc < 0 && errno != EINTR) break;
+    now = sconnect_now_ms();
+
+    for (a = 0; a < active; a++) {
+      if (pfd[a].revents && sconnect_succeeded(attempts[a].fd)) {
+        winner = a;
+        break;
+      }
+
+      if (pfd[a].revents ||
+          (timeout_ms > 0 && now >= attempts[a].started_at + timeout_ms)) {
+        // Failed or timed out, the next candidate does not wait for the delay
+        close(attempts[a].fd);
+        attempts[a] = attempts[active - 1];
+        pfd[a] = pfd[active - 1];
+        active--;
+        a--;
+        next_start_at = now;
+      }
+    }
+  }
+
+  for (a = 0; a < active; a++) {
+    if (a != winner) close(attempts[a].fd);
+  }
+
+  if (winner == -1) return -1;
+
+  fcntl(attempts[winner].fd, F_SETFL,
+        fcntl(attempts[winner].fd, F_GETFL, 0) & ~O_NONBLOCK);
+
+  if (winner_family) *winner_family = attempts[winner].family;
+  return attempts[winner].fd;
+}
+
+int sconnect_open(const char *host, int port, int timeout_ms, int *err) {
+  struct addrinfo hints, *res = NULL;
+  char service[15];
+  int family = AF_UNSPEC;
+  int fd;
+
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_flags = AI_NUMERICSERV;
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+
+  snprintf(service, sizeof(service), "%i", port);
+
+  if (getaddrinfo(host ? host : "", service, &hints, &res) != 0) {
+    if (err) *err = SUPLA_RESULT_HOST_NOT_FOUND;
+    return -1;
+  }
+
+  fd = sconnect_race(res, sconnect_get_family(host, port), timeout_ms,
+                     &family);
+  freeaddrinfo(res);
+
+  if (fd == -1) {
+    if (err) *err = SUPLA_RESULT_CANT_CONNECT_TO_HOST;
+    return -1;
+  }
+
+  sconnect_set_family(host, port, family);
+  return fd;
+}
@@ -0,0 +1,55 @@
+/*
+ Copyright (C) AC SOFTWARE SP. Z O.O.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef SCONNECT_H_
+#define SCONNECT_H_
+
+// Dual stack client connect with RFC 8305 (Happy Eyeballs) address racing.
+// Candidates of both families are tried alternately, a new attempt starts
+// every SCONNECT_ATTEMPT_DELAY_MS or as soon as the previous one fails, and
+// the first socket to connect wins. The family which won last time for a
+// host and port is tried first on the next connect.
+
+#include <netdb.h>
+
+#define SCONNECT_ATTEMPT_DELAY_MS 250
+#define SCONNECT_MAX_ATTEMPTS 8
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// AF_UNSPEC when no connection to host:port succeeded yet
+int sconnect_get_family(const char *host, int port);
+void sconnect_set_family(const char *host, int port, int family);
+
+// Races the candidates, family goes first (AF_UNSPEC: IPv6). Every attempt
+// may take up to timeout_ms, <= 0 leaves it to the system. Returns the
+// connected socket in blocking mode or -1, winner_family may be NULL.
+int sconnect_race(const struct addrinfo *candidates, int family,
+                  int timeout_ms, int *winner_family);
+
+// Resolves host and races its addresses. On failure returns -1 and sets err
+// to SUPLA_RESULT_HOST_NOT_FOUND or SUPLA_RESULT_CANT_CONNECT_TO_HOST.
+int sconnect_open(const char *host, int port, int timeout_ms, int *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SCONNECT_H_ */
@@ -33,6 +33,7 @@
 #define SRPC_BUFFER_SIZE 256
 #define SRPC_QUEUE_SIZE 2
 #define SRPC_QUEUE_MIN_ALLOC_COUNT 2
+#define SRPC_WITHOUT_CALL_TABLE
 
 #if !defined(ESP32)
 #include <mem.h>
@@ -54,6 +55,7 @@
 #define SRPC_BUFFER_SIZE 32
 #define SRPC_QUEUE_SIZE 1
 #define SRPC_QUEUE_MIN_ALLOC_COUNT 1
+#define SRPC_WITHOUT_CALL_TABLE
 #define __EH_DISABLED
 
 // OTHER SUPLA_DEVICE
@@ -65,6 +67,9 @@
 // other not releated to supla-device
 #else
 #include <assert.h>
+#if defined(__GNUC__) && !defined(SRPC_THREAD_LOCAL)
+#define SRPC_THREAD_LOCAL __thread
+#endif
 #endif
 
 // ALL targets
@@ -80,18 +85,71 @@
 #define SRPC_QUEUE_MIN_ALLOC_COUNT 0
 #endif /*SRPC_QUEUE_MIN_ALLOC_COUNT*/
 
+// Size of the packet slab allocated up front for each queue. The slab grows
+// on demand and shrinks back to this size whenever the queue drains.
+#ifndef SRPC_QUEUE_SLAB_SIZE
+#if SRPC_QUEUE_MIN_ALLOC_COUNT > 0
+#define SRPC_QUEUE_SLAB_SIZE \
+  (SRPC_QUEUE_MIN_ALLOC_COUNT * sizeof(TSuplaDataPacket))
+#else
+#define SRPC_QUEUE_SLAB_SIZE 2048
+#endif /*SRPC_QUEUE_MIN_ALLOC_COUNT > 0*/
+#endif /*SRPC_QUEUE_SLAB_SIZE*/
+
+#define SRPC_QUEUE_MAX_DEPTH 255
+
+// Where the packet between srpc_async_reserve and srpc_async_commit lives
+#define SRPC_RESERVED_NONE 0
+#define SRPC_RESERVED_SDP 1
+#define SRPC_RESERVED_OUT_QUEUE 2
+#define SRPC_RESERVED_OUT_BUFFER 3
+
+#define SRPC_PACKET_HEADER_SIZE \
+  (sizeof(TSuplaDataPacket) - SUPLA_MAX_DATA_SIZE)
+
+// Packet data srpc_params_autosize never goes below, enough for the
+// configuration packets a server sends to a device
+#ifndef SRPC_AUTOSIZE_MIN_DATA_SIZE
+#define SRPC_AUTOSIZE_MIN_DATA_SIZE 600
+#endif /*SRPC_AUTOSIZE_MIN_DATA_SIZE*/
+
+#ifndef SRPC_REGISTER_CHUNK_COUNT
+#define SRPC_REGISTER_CHUNK_COUNT 8
+#endif /*SRPC_REGISTER_CHUNK_COUNT*/
+
+typedef struct {
+  unsigned _supla_int_t offset;
+  unsigned _supla_int_t size;
+  // handed out as a view by srpc_getdata, released on the next call
+  unsigned char held;
+} Tsrpc_QueueItem;
+
+// Packets are stored back to back in a single slab, each one taking only its
+// header and the used part of the data field. The item array keeps them in
+// FIFO order.
 typedef struct {
   unsigned char item_count;
-  unsigned char alloc_count;
+  unsigned char depth;
+
+  Tsrpc_QueueItem *item;
+
+  char *slab;
+  unsigned _supla_int_t slab_size;
+  unsigned _supla_int_t slab_used;
+  // allocated up front, the slab shrinks back to it whenever the queue drains.
+  // 0 - the item array and slab exist only while packets are queued
+  unsigned _supla_int_t slab_keep_size;
 
-  TSuplaDataPacket *item[SRPC_QUEUE_SIZE];
+  const TSAllocator *allocator;
 } Tsrpc_Queue;
 
 typedef struct {
   void *proto;
   TsrpcParams params;
 
-  TSuplaDataPacket sdp;
+  // Scratch packet allocated right behind this struct, NULL when the thread
+  // scratch is used instead
+  TSuplaDataPacket *sdp;
 
 #ifndef SRPC_WITHOUT_IN_QUEUE
   Tsrpc_Queue in_queue;
@@ -99,26 +157,126 @@ typedef struct {
 
 #ifndef SRPC_WITHOUT_OUT_QUEUE
   Tsrpc_Queue out_queue;
+  // the transport did not take everything offered during the last write
+  unsigned char out_congested;
 #endif /*SRPC_WITHOUT_OUT_QUEUE*/
 
+  TSuplaDataPacket *reserved_sdp;
+  unsigned char reserved_in;
+
+  // Free space the input buffer must offer before each read. A whole packet
+  // fits in a single read unless buffer_size is smaller.
+  unsigned _supla_int_t read_min_size;
+
   void *lck;
 } Tsrpc;
 
-void SRPC_ICACHE_FLASH srpc_get_scene_pack(Tsrpc *srpc, TsrpcReceivedData *rd);
-void SRPC_ICACHE_FLASH srpc_get_scene_state_pack(Tsrpc *srpc,
+void SRPC_ICACHE_FLASH srpc_queue_init(Tsrpc_Queue *queue, unsigned short depth,
+                                       unsigned _supla_int_t slab_size,
+                                       unsigned char release_idle,
+                                       const TSAllocator *allocator);
+void SRPC_ICACHE_FLASH srpc_get_scene_pack(TSuplaDataPacket *sdp,
+                                           TsrpcReceivedData *rd);
+void SRPC_ICACHE_FLASH srpc_get_scene_state_pack(TSuplaDataPacket *sdp,
                                                  TsrpcReceivedData *rd);
 
+#ifdef SRPC_THREAD_LOCAL
+// Shared by the instances with shared_scratch iterated on the same thread.
+// The packet is never kept past the call which filled it.
+static SRPC_THREAD_LOCAL TSuplaDataPacket srpc_thread_sdp;
+#endif /*SRPC_THREAD_LOCAL*/
+
+static TSuplaDataPacket *srpc_sdp(Tsrpc *srpc) {
+#ifdef SRPC_THREAD_LOCAL
+  if (srpc->sdp == NULL) return &srpc_thread_sdp;
+#endif /*SRPC_THREAD_LOCAL*/
+  return srpc->sdp;
+}
+
 void SRPC_ICACHE_FLASH srpc_params_init(TsrpcParams *params) {
   memset(params, 0, sizeof(TsrpcParams));
 }
 
+static unsigned _supla_int_t srpc_pow2_above(unsigned _supla_int_t size) {
+  unsigned _supla_int_t result = 64;
+
+  while (result < size) {
+    result <<= 1;
+  }
+  return result;
+}
+
+void SRPC_ICACHE_FLASH srpc_params_autosize(
+    TsrpcParams *params, unsigned short channel_count,
+    unsigned _supla_int_t max_extended_value_size) {
+  unsigned _supla_int_t data_size = SRPC_AUTOSIZE_MIN_DATA_SIZE;
+  unsigned _supla_int_t packet_size;
+  unsigned _supla_int_t register_size;
+  unsigned _supla_int_t value_size;
+
+  if (max_extended_value_size > 0) {
+    value_size = sizeof(TDS_SuplaDeviceChannelExtendedValue) -
+                 SUPLA_CHANNELEXTENDEDVALUE_SIZE + max_extended_value_size;
+    if (data_size < value_size) {
+      data_size = value_size;
+    }
+  }
+  if (data_size > SUPLA_MAX_DATA_SIZE) {
+    data_size = SUPLA_MAX_DATA_SIZE;
+  }
+
+  packet_size = SRPC_PACKET_HEADER_SIZE + data_size + SUPLA_TAG_SIZE;
+  // Registration goes out as one packet with every channel
+  register_size = SRPC_PACKET_HEADER_SIZE +
+                  sizeof(TDS_SuplaRegisterDeviceHeader) +
+                  channel_count * sizeof(TDS_SuplaDeviceChannel_E) +
+                  SUPLA_TAG_SIZE;
+
+  if (params->max_data_size == 0) {
+    params->max_data_size = data_size;
+  }
+  if (params->buffer_size == 0) {
+    params->buffer_size = srpc_pow2_above(packet_size);
+  }
+  if (params->proto_buffer_min_size == 0) {
+    params->proto_buffer_min_size = srpc_pow2_above(packet_size);
+  }
+  if (params->proto_buffer_max_size == 0) {
+    // room for a packet still being read behind a complete one
+    params->proto_buffer_max_size = srpc_pow2_above(
+        2 * (packet_size > register_size ? packet_size : register_size) + 1);
+  }
+  // Every channel may have a value change waiting
+  if (params->out_queue_size == 0) {
+    params->out_queue_size =
+        channel_count + 2 < SRPC_QUEUE_SIZE ? SRPC_QUEUE_SIZE : channel_count + 2;
+  }
+  if (params->queue_slab_size == 0) {
+    params->queue_slab_size =
+        srpc_pow2_above(channel_count * (SRPC_PACKET_HEADER_SIZE +
+                                         sizeof(TDS_SuplaDeviceChannelValue_C)));
+  }
+}
+
 void *SRPC_ICACHE_FLASH srpc_init(TsrpcParams *params) {
-  Tsrpc *srpc = (Tsrpc *)malloc(sizeof(Tsrpc));
+  unsigned _supla_int_t sdp_size = sizeof(TSuplaDataPacket);
+  Tsrpc *srpc;
+
+#ifdef SRPC_THREAD_LOCAL
+  if (params != NULL && params->shared_scratch) {
+    sdp_size = 0;
+  }
+#endif /*SRPC_THREAD_LOCAL*/
 
+  srpc = (Tsrpc *)salloc_malloc(params ? params->allocator : NULL,
+                                sizeof(Tsrpc) + sdp_size, SALLOC_TAG_SRPC);
   if (srpc == NULL) return NULL;
 
-  memset(srpc, 0, sizeof(Tsrpc));
-  srpc->proto = sproto_init();
+  memset(srpc, 0, sizeof(Tsrpc) + sdp_size);
+  if (sdp_size > 0) {
+    srpc->sdp = (TSuplaDataPacket *)&srpc[1];
+  }
+  srpc->proto = sproto_init_with_allocator(params ? params->allocator : NULL);
 
 #ifndef ESP8266
 #ifndef ESP32
@@ -133,6 +291,42 @@ void *SRPC_ICACHE_FLASH srpc_init(TsrpcParams *params) {
 #endif
 
   memcpy(&srpc->params, params, sizeof(TsrpcParams));
+  if (srpc->params.buffer_size == 0) {
+    srpc->params.buffer_size = SRPC_BUFFER_SIZE;
+  }
+  if (srpc->params.max_data_size == 0 ||
+      srpc->params.max_data_size > SUPLA_MAX_DATA_SIZE) {
+    srpc->params.max_data_size = SUPLA_MAX_DATA_SIZE;
+  }
+
+  srpc->read_min_size = SRPC_PACKET_HEADER_SIZE + srpc->params.max_data_size +
+                        SUPLA_TAG_SIZE;
+  if (srpc->read_min_size > srpc->params.buffer_size) {
+    srpc->read_min_size = srpc->params.buffer_size;
+  }
+  // The input buffer has to take a read while holding part of a packet
+  if (srpc->params.proto_buffer_max_size &&
+      srpc->read_min_size >= srpc->params.proto_buffer_max_size / 2) {
+    srpc->read_min_size = srpc->params.proto_buffer_max_size / 2;
+  }
+
+  sproto_set_in_resync(srpc->proto, srpc->params.in_resync);
+  sproto_set_buffer_size(srpc->proto, srpc->params.proto_buffer_min_size,
+                         srpc->params.proto_buffer_max_size);
+  sproto_set_max_data_size(srpc->proto, srpc->params.max_data_size);
+  sproto_set_release_idle(srpc->proto, srpc->params.release_idle);
+
+#ifndef SRPC_WITHOUT_IN_QUEUE
+  srpc_queue_init(&srpc->in_queue, srpc->params.in_queue_size,
+                  srpc->params.queue_slab_size, srpc->params.release_idle,
+                  srpc->params.allocator);
+#endif /*SRPC_WITHOUT_IN_QUEUE*/
+
+#ifndef SRPC_WITHOUT_OUT_QUEUE
+  srpc_queue_init(&srpc->out_queue, srpc->params.out_queue_size,
+                  srpc->params.queue_slab_size, srpc->params.release_idle,
+                  srpc->params.allocator);
+#endif /*SRPC_WITHOUT_OUT_QUEUE*/
 
   srpc->lck = lck_init();
 
@@ -147,16 +341,43 @@ void SRPC_ICACHE_FLASH srpc_unlock(void *_srpc) {
   lck_unlock(((Tsrpc *)_srpc)->lck);
 }
 
+_supla_int_t SRPC_ICACHE_FLASH srpc_data_writev(Tsrpc *srpc,
+                                               const TsrpcIoVec *iov,
+                                               _supla_int_t iovcnt) {
+  _supla_int_t a, result, total = 0;
+
+  if (srpc->params.data_writev) {
+    return srpc->params.data_writev(iov, iovcnt, srpc->params.user_params);
+  }
+
+  for (a = 0; a < iovcnt; a++) {
+    if (iov[a].count <= 0) continue;
+
+    result = srpc->params.data_write((void *)iov[a].buf, iov[a].count,
+                                     srpc->params.user_params);
+    if (result < 0) return total > 0 ? total : result;
+
+    total += result;
+    if (result < iov[a].count) break;
+  }
+
+  return total;
+}
+
 void SRPC_ICACHE_FLASH srpc_queue_free(Tsrpc_Queue *queue) {
-  _supla_int_t a;
-  for (a = 0; a < SRPC_QUEUE_SIZE; a++) {
-    if (queue->item[a] != NULL) {
-      free(queue->item[a]);
-    }
+  if (queue->item != NULL) {
+    salloc_free(queue->allocator, queue->item, SALLOC_TAG_SRPC);
+    queue->item = NULL;
+  }
+
+  if (queue->slab != NULL) {
+    salloc_free(queue->allocator, queue->slab, SALLOC_TAG_SRPC);
+    queue->slab = NULL;
   }
 
   queue->item_count = 0;
-  queue->alloc_count = 0;
+  queue->slab_size = 0;
+  queue->slab_used = 0;
 }
 
 void SRPC_ICACHE_FLASH srpc_free(void *_srpc) {
@@ -174,62 +395,231 @@ void SRPC_ICACHE_FLASH srpc_free(void *_srpc) {
 #endif /*SRPC_WITHOUT_OUT_QUEUE*/
     lck_free(srpc->lck);
 
-    free(srpc);
+    salloc_free(srpc->params.allocator, srpc, SALLOC_TAG_SRPC);
   }
 }
 
-char SRPC_ICACHE_FLASH srpc_queue_push(Tsrpc_Queue *queue,
-                                       TSuplaDataPacket *sdp) {
-  if (queue->item_count >= SRPC_QUEUE_SIZE) {
-    return SUPLA_RESULT_FALSE;
+void SRPC_ICACHE_FLASH srpc_queue_init(Tsrpc_Queue *queue, unsigned short depth,
+                                       unsigned _supla_int_t slab_size,
+                                       unsigned char release_idle,
+                                       const TSAllocator *allocator) {
+  if (depth == 0) {
+    depth = SRPC_QUEUE_SIZE;
+  } else if (depth > SRPC_QUEUE_MAX_DEPTH) {
+    depth = SRPC_QUEUE_MAX_DEPTH;
   }
 
-  if (queue->item[queue->item_count] == NULL) {
-    queue->item[queue->item_count] =
-        (TSuplaDataPacket *)malloc(sizeof(TSuplaDataPacket));
+  memset(queue, 0, sizeof(Tsrpc_Queue));
+  queue->depth = depth;
+  queue->allocator = allocator;
+  if (release_idle) {
+    return;
   }
 
-  if (queue->item[queue->item_count] == NULL) {
+  queue->item = (Tsrpc_QueueItem *)salloc_malloc(
+      allocator, queue->depth * sizeof(Tsrpc_QueueItem), SALLOC_TAG_SRPC);
+  queue->slab_keep_size = slab_size ? slab_size : SRPC_QUEUE_SLAB_SIZE;
+  queue->slab =
+      (char *)salloc_malloc(allocator, queue->slab_keep_size, SALLOC_TAG_SRPC);
+  if (queue->slab != NULL) {
+    queue->slab_size = queue->slab_keep_size;
+  }
+}
+
+void SRPC_ICACHE_FLASH srpc_queue_compact(Tsrpc_Queue *queue) {
+  _supla_int_t a;
+  unsigned _supla_int_t offset = 0;
+
+  // Items are kept in slab order, so moving them down one by one never
+  // overwrites a packet that has not been moved yet.
+  for (a = 0; a < queue->item_count; a++) {
+    if (queue->item[a].offset != offset) {
+      memmove(&queue->slab[offset], &queue->slab[queue->item[a].offset],
+              queue->item[a].size);
+      queue->item[a].offset = offset;
+    }
+    offset += queue->item[a].size;
+  }
+
+  queue->slab_used = offset;
+}
+
+char SRPC_ICACHE_FLASH srpc_queue_reserve(Tsrpc_Queue *queue,
+                                          unsigned _supla_int_t size) {
+  unsigned _supla_int_t new_size;
+  char *slab;
+
+  if (queue->slab_used + size <= queue->slab_size) {
+    return SUPLA_RESULT_TRUE;
+  }
+
+  srpc_queue_compact(queue);
+
+  if (queue->slab_used + size <= queue->slab_size) {
+    return SUPLA_RESULT_TRUE;
+  }
+
+  new_size = queue->slab_size > 0 ? queue->slab_size : queue->slab_keep_size;
+  if (new_size == 0) {
+    new_size = srpc_pow2_above(size);
+  }
+  while (new_size < queue->slab_used + size) {
+    new_size *= 2;
+  }
+
+  slab = (char *)salloc_realloc(queue->allocator, queue->slab, new_size,
+                                SALLOC_TAG_SRPC);
+  if (slab == NULL) {
     return SUPLA_RESULT_FALSE;
-  } else {
-    queue->alloc_count++;
   }
 
-  memcpy(queue->item[queue->item_count], sdp, sizeof(TSuplaDataPacket));
+  queue->slab = slab;
+  queue->slab_size = new_size;
+  return SUPLA_RESULT_TRUE;
+}
+
+// Returns the place for the next packet of the given size without adding it
+// to the queue. Only the first size bytes of the packet may be written.
+TSuplaDataPacket *SRPC_ICACHE_FLASH
+srpc_queue_reserve_item(Tsrpc_Queue *queue, unsigned _supla_int_t size) {
+  if (queue->item == NULL) {
+    queue->item = (Tsrpc_QueueItem *)salloc_malloc(
+        queue->allocator, queue->depth * sizeof(Tsrpc_QueueItem),
+        SALLOC_TAG_SRPC);
+  }
+
+  if (queue->item == NULL || queue->item_count >= queue->depth) {
+    return NULL;
+  }
+
+  if (srpc_queue_reserve(queue, size) != SUPLA_RESULT_TRUE) {
+    return NULL;
+  }
+
+  return (TSuplaDataPacket *)&queue->slab[queue->slab_used];
+}
+
+// Adds the packet placed by srpc_queue_reserve_item
+void SRPC_ICACHE_FLASH srpc_queue_commit_item(Tsrpc_Queue *queue,
+                                              unsigned _supla_int_t size) {
+  queue->item[queue->item_count].offset = queue->slab_used;
+  queue->item[queue->item_count].size = size;
+  queue->item[queue->item_count].held = 0;
+  queue->slab_used += size;
   queue->item_count++;
+}
 
-  return SUPLA_RESULT_TRUE;
+TSuplaDataPacket *SRPC_ICACHE_FLASH
+srpc_queue_alloc(Tsrpc_Queue *queue, unsigned _supla_int_t size) {
+  TSuplaDataPacket *sdp = srpc_queue_reserve_item(queue, size);
+
+  if (sdp != NULL) {
+    srpc_queue_commit_item(queue, size);
+  }
+
+  return sdp;
 }
 
-char SRPC_ICACHE_FLASH srpc_queue_pop(Tsrpc_Queue *queue, TSuplaDataPacket *sdp,
-                                      unsigned _supla_int_t rr_id) {
-  _supla_int_t a, b;
+char SRPC_ICACHE_FLASH srpc_queue_push(Tsrpc_Queue *queue,
+                                       TSuplaDataPacket *sdp) {
+  unsigned _supla_int_t size = SRPC_PACKET_HEADER_SIZE + SUPLA_MAX_DATA_SIZE;
+  TSuplaDataPacket *item;
 
-  for (a = 0; a < queue->item_count; a++)
-    if (rr_id == 0 || queue->item[a]->rr_id == rr_id) {
-      memcpy(sdp, queue->item[a], sizeof(TSuplaDataPacket));
+  if (sdp->data_size < SUPLA_MAX_DATA_SIZE) {
+    size -= SUPLA_MAX_DATA_SIZE - sdp->data_size;
+  }
 
-      if (queue->alloc_count > SRPC_QUEUE_MIN_ALLOC_COUNT) {
-        queue->alloc_count--;
-        free(queue->item[a]);
-        queue->item[a] = NULL;
-      }
+  item = srpc_queue_alloc(queue, size);
+  if (item == NULL) {
+    return SUPLA_RESULT_FALSE;
+  }
 
-      TSuplaDataPacket *item = queue->item[a];
+  memcpy(item, sdp, size);
+  return SUPLA_RESULT_TRUE;
+}
 
-      for (b = a; b < queue->item_count - 1; b++) {
-        queue->item[b] = queue->item[b + 1];
-      }
+void SRPC_ICACHE_FLASH srpc_queue_remove(Tsrpc_Queue *queue, _supla_int_t a) {
+  // Space freed in the middle of the slab is reclaimed by the next
+  // compaction, only the tail can be given back right away.
+  if (queue->item[a].offset + queue->item[a].size == queue->slab_used) {
+    queue->slab_used = queue->item[a].offset;
+  }
 
-      queue->item_count--;
-      queue->item[queue->item_count] = item;
+  queue->item_count--;
+  if (a < queue->item_count) {
+    memmove(&queue->item[a], &queue->item[a + 1],
+            (queue->item_count - a) * sizeof(Tsrpc_QueueItem));
+  }
 
+  if (queue->item_count == 0) {
+    queue->slab_used = 0;
+    if (queue->slab_keep_size == 0) {
+      srpc_queue_free(queue);
+    } else if (queue->slab_size > queue->slab_keep_size) {
+      char *slab = (char *)salloc_realloc(queue->allocator, queue->slab,
+                                          queue->slab_keep_size,
+                                          SALLOC_TAG_SRPC);
+      if (slab != NULL) {
+        queue->slab = slab;
+        queue->slab_size = queue->slab_keep_size;
+      }
+    }
+  }
+}
+
+char SRPC_ICACHE_FLASH srpc_queue_pop(Tsrpc_Queue *queue, TSuplaDataPacket *sdp,
+                                      unsigned _supla_int_t rr_id) {
+  _supla_int_t a;
+  TSuplaDataPacket *item;
+
+  for (a = 0; a < queue->item_count; a++) {
+    if (queue->item[a].held) continue;
+    item = (TSuplaDataPacket *)&queue->slab[queue->item[a].offset];
+    if (rr_id == 0 || item->rr_id == rr_id) {
+      memcpy(sdp, item, queue->item[a].size);
+      srpc_queue_remove(queue, a);
       return SUPLA_RESULT_TRUE;
     }
+  }
 
   return SUPLA_RESULT_FALSE;
 }
 
+// Like srpc_queue_pop but leaves the packet in place and returns a pointer to
+// it. The packet stays valid until srpc_queue_release.
+TSuplaDataPacket *SRPC_ICACHE_FLASH
+srpc_queue_hold(Tsrpc_Queue *queue, unsigned _supla_int_t rr_id) {
+  _supla_int_t a;
+  TSuplaDataPacket *item;
+
+  for (a = 0; a < queue->item_count; a++) {
+    if (queue->item[a].held) continue;
+    item = (TSuplaDataPacket *)&queue->slab[queue->item[a].offset];
+    if (rr_id == 0 || item->rr_id == rr_id) {
+      queue->item[a].held = 1;
+      return item;
+    }
+  }
+
+  return NULL;
+}
+
+void SRPC_ICACHE_FLASH srpc_queue_release(Tsrpc_Queue *queue) {
+  _supla_int_t a;
+
+  for (a = queue->item_count - 1; a >= 0; a--) {
+    if (queue->item[a].held) {
+      srpc_queue_remove(queue, a);
+    }
+  }
+}
+
+void SRPC_ICACHE_FLASH srpc_queue_clear(Tsrpc_Queue *queue) {
+  while (queue->item_count > 0) {
+    srpc_queue_remove(queue, queue->item_count - 1);
+  }
+}
+
 char SRPC_ICACHE_FLASH srpc_in_queue_pop(Tsrpc *srpc, TSuplaDataPacket *sdp,
                                          unsigned _supla_int_t rr_id) {
   (void)(srpc);
@@ -242,27 +632,27 @@ char SRPC_ICACHE_FLASH srpc_in_queue_pop(Tsrpc *srpc, TSuplaDataPacket *sdp,
 #endif /*SRPC_WITHOUT_IN_QUEUE*/
 }
 
-#ifndef SRPC_WITHOUT_IN_QUEUE
-char SRPC_ICACHE_FLASH srpc_in_queue_push(Tsrpc *srpc, TSuplaDataPacket *sdp) {
-  return srpc_queue_push(&srpc->in_queue, sdp);
-}
-#endif /*SRPC_WITHOUT_IN_QUEUE*/
-
 char SRPC_ICACHE_FLASH srpc_out_queue_push(Tsrpc *srpc, TSuplaDataPacket *sdp) {
 #ifdef SRPC_WITHOUT_OUT_QUEUE
   unsigned _supla_int_t data_size = sizeof(TSuplaDataPacket);
   if (sdp->data_size < SUPLA_MAX_DATA_SIZE) {
     data_size -= SUPLA_MAX_DATA_SIZE - sdp->data_size;
   }
+  if (srpc->params.data_writev) {
+    TsrpcIoVec iov[2] = {{sdp, data_size}, {sproto_tag, SUPLA_TAG_SIZE}};
+    srpc->params.data_writev(iov, 2, srpc->params.user_params);
+    return 1;
+  }
 #ifndef PACKET_INTEGRITY_BUFFER_DISABLED
-  char *buff = malloc(data_size + SUPLA_TAG_SIZE);
+  char *buff = salloc_malloc(srpc->params.allocator,
+                             data_size + SUPLA_TAG_SIZE, SALLOC_TAG_SRPC);
   if (buff) {
     memcpy(buff, sdp, data_size);
     memcpy(&buff[data_size], sproto_tag, SUPLA_TAG_SIZE);
 
     srpc->params.data_write(buff, data_size + SUPLA_TAG_SIZE,
                             srpc->params.user_params);
-    free(buff);
+    salloc_free(srpc->params.allocator, buff, SALLOC_TAG_SRPC);
   }
 #else
   srpc->params.data_write((char *)sdp, data_size, srpc->params.user_params);
@@ -290,6 +680,116 @@ unsigned char SRPC_ICACHE_FLASH srpc_out_queue_item_count(void *srpc) {
 #endif /*SRPC_WITHOUT_OUT_QUEUE*/
 }
 
+char SRPC_ICACHE_FLASH srpc_iterate_pending(void *_srpc) {
+  Tsrpc *srpc = (Tsrpc *)_srpc;
+  unsigned _supla_int_t packet_size = 0;
+  unsigned char version = 0;
+  char result = SUPLA_RESULT_FALSE;
+
+  lck_lock(srpc->lck);
+
+  // A version error is pending too, the next iteration reports it
+  if (sproto_in_sdp_check(srpc->proto, &packet_size, &version) !=
+      SUPLA_RESULT_FALSE) {
+    result = SUPLA_RESULT_TRUE;
+  }
+#ifndef SRPC_WITHOUT_OUT_QUEUE
+  else if (!srpc->out_congested && srpc_out_queue_item_count(srpc) > 0) {
+    result = SUPLA_RESULT_TRUE;
+  }
+#endif /*SRPC_WITHOUT_OUT_QUEUE*/
+
+  return lck_unlock_r(srpc->lck, result);
+}
+
+char SRPC_ICACHE_FLASH srpc_output_congested(void *_srpc) {
+#ifdef SRPC_WITHOUT_OUT_QUEUE
+  (void)(_srpc);
+  return SUPLA_RESULT_FALSE;
+#else
+  int result = SUPLA_RESULT_FALSE;
+  Tsrpc *srpc = (Tsrpc *)_srpc;
+  lck_lock(srpc->lck);
+  result = srpc->out_congested ? SUPLA_RESULT_TRUE : SUPLA_RESULT_FALSE;
+  return lck_unlock_r(srpc->lck, result);
+#endif /*SRPC_WITHOUT_OUT_QUEUE*/
+}
+
+void SRPC_ICACHE_FLASH srpc_reset(void *_srpc) {
+  Tsrpc *srpc = (Tsrpc *)_srpc;
+  lck_lock(srpc->lck);
+
+  sproto_reset_buffers(srpc->proto);
+
+#ifndef SRPC_WITHOUT_IN_QUEUE
+  srpc_queue_clear(&srpc->in_queue);
+#endif /*SRPC_WITHOUT_IN_QUEUE*/
+
+#ifndef SRPC_WITHOUT_OUT_QUEUE
+  srpc_queue_clear(&srpc->out_queue);
+  srpc->out_congested = 0;
+#endif /*SRPC_WITHOUT_OUT_QUEUE*/
+
+  lck_unlock(srpc->lck);
+}
+
+#ifndef SRPC_WITHOUT_OUT_QUEUE
+// Offers the output buffer to data_write, or both parts of a wrapped buffer
+// at once to data_writev. Whatever the transport does not accept (short
+// write, EAGAIN, SSL_ERROR_WANT_WRITE) stays in the buffer and is offered
+// again, starting from the same byte, on the next iteration.
+void SRPC_ICACHE_FLASH srpc_out_buffer_flush(Tsrpc *srpc, unsigned char all) {
+  TsrpcIoVec iov[2];
+  char *data = NULL;
+  char *wrapped = NULL;
+  _supla_int_t data_size = 0;
+  _supla_int_t wrapped_size = 0;
+  _supla_int_t result = 0;
+
+  srpc->out_congested = 0;
+
+  while ((data_size = sproto_out_data_peek(srpc->proto, &data)) > 0) {
+    if (data_size > (_supla_int_t)srpc->params.buffer_size) {
+      data_size = srpc->params.buffer_size;
+    }
+
+    wrapped_size = 0;
+    if (srpc->params.data_writev &&
+        data_size < (_supla_int_t)srpc->params.buffer_size) {
+      wrapped_size = sproto_out_data_peek_wrapped(srpc->proto, &wrapped);
+      if (wrapped_size > (_supla_int_t)srpc->params.buffer_size - data_size) {
+        wrapped_size = srpc->params.buffer_size - data_size;
+      }
+    }
+
+    if (wrapped_size > 0) {
+      iov[0].buf = data;
+      iov[0].count = data_size;
+      iov[1].buf = wrapped;
+      iov[1].count = wrapped_size;
+      data_size += wrapped_size;
+      result = srpc->params.data_writev(iov, 2, srpc->params.user_params);
+    } else {
+      result =
+          srpc->params.data_write(data, data_size, srpc->params.user_params);
+    }
+
+    if (result > 0) {
+      sproto_out_data_consume(srpc->proto, result);
+    }
+
+    if (result < data_size) {
+      srpc->out_congested = 1;
+      break;
+    }
+
+    if (!all) {
+      break;
+    }
+  }
+}
+#endif /*SRPC_WITHOUT_OUT_QUEUE*/
+
 char SRPC_ICACHE_FLASH srpc_input_dataexists(void *_srpc) {
   int result = SUPLA_RESULT_FALSE;
   Tsrpc *srpc = (Tsrpc *)_srpc;
@@ -306,66 +806,100 @@ char SRPC_ICACHE_FLASH srpc_output_dataexists(void *_srpc) {
   return lck_unlock_r(srpc->lck, result);
 }
 
+// Reads from the transport straight into the free space of the input buffer.
+// data_size receives the data_read result.
+char SRPC_ICACHE_FLASH srpc_in_buffer_read(Tsrpc *srpc,
+                                           _supla_int_t *data_size) {
+  char *data = NULL;
+  unsigned _supla_int_t size = sproto_in_buffer_write_span(
+      srpc->proto, srpc->read_min_size, &data);
+
+  if (size == 0) {
+    *data_size = 0;
+    return SUPLA_RESULT_BUFFER_OVERFLOW;
+  }
+
+  if (size > srpc->params.buffer_size) {
+    size = srpc->params.buffer_size;
+  }
+
+  *data_size = srpc->params.data_read(data, size, srpc->params.user_params);
+
+  if (*data_size > (_supla_int_t)size) {
+    return SUPLA_RESULT_BUFFER_OVERFLOW;
+  }
+
+  // A read bringing nothing lets a release_idle buffer go
+  sproto_in_buffer_commit(srpc->proto, *data_size > 0 ? *data_size : 0);
+
+  return SUPLA_RESULT_TRUE;
+}
+
 char SRPC_ICACHE_FLASH srpc_iterate(void *_srpc) {
   Tsrpc *srpc = (Tsrpc *)_srpc;
-  char data_buffer[SRPC_BUFFER_SIZE];
+  TSuplaDataPacket *sdp = srpc_sdp(srpc);
+  _supla_int_t data_size = 0;
   char result;
-  unsigned char version;
+  unsigned char version = 0;
+#ifndef SRPC_WITHOUT_IN_QUEUE
+  unsigned _supla_int_t packet_size = 0;
+#endif /*SRPC_WITHOUT_IN_QUEUE*/
 #ifndef __EH_DISABLED
   unsigned char raise_event = 0;
 #endif /*__EH_DISABLED*/
 
   // --------- IN ---------------
   lck_lock(srpc->lck);
-  _supla_int_t data_size = srpc->params.data_read(data_buffer, SRPC_BUFFER_SIZE,
-                                                  srpc->params.user_params);
 
-  if (data_size == 0) {
+#ifndef SRPC_WITHOUT_IN_QUEUE
+  // Views handed out by srpc_getdata expire here
+  srpc_queue_release(&srpc->in_queue);
+#endif /*SRPC_WITHOUT_IN_QUEUE*/
+
+  if (SUPLA_RESULT_TRUE != (result = srpc_in_buffer_read(srpc, &data_size))) {
+    supla_log(LOG_DEBUG, "sproto_in_buffer_write_span: %i", result);
     return lck_unlock_r(srpc->lck, SUPLA_RESULT_FALSE);
   }
 
-  if (data_size > 0 &&
-      SUPLA_RESULT_TRUE != (result = sproto_in_buffer_append(
-                                srpc->proto, data_buffer, data_size))) {
-    supla_log(LOG_DEBUG, "sproto_in_buffer_append: %i, datasize: %i", result,
-              data_size);
+  if (data_size == 0) {
     return lck_unlock_r(srpc->lck, SUPLA_RESULT_FALSE);
   }
 
+#ifdef SRPC_WITHOUT_IN_QUEUE
+  result = sproto_pop_in_sdp(srpc->proto, sdp);
+  version = sdp->version;
+#else
+  // The packet is moved from the input buffer directly into its queue slot
   if (SUPLA_RESULT_TRUE ==
-      (result = sproto_pop_in_sdp(srpc->proto, &srpc->sdp))) {
+      (result = sproto_in_sdp_check(srpc->proto, &packet_size, &version))) {
+    sdp = srpc_queue_alloc(&srpc->in_queue, packet_size);
+    if (sdp == NULL) {
+      supla_log(LOG_DEBUG, "ssrpc_in_queue_push error");
+      return lck_unlock_r(srpc->lck, SUPLA_RESULT_FALSE);
+    }
+    sproto_pop_in_sdp(srpc->proto, sdp);
+  }
+#endif /*SRPC_WITHOUT_IN_QUEUE*/
+
+  if (SUPLA_RESULT_TRUE == result) {
 #ifndef __EH_DISABLED
     raise_event = sproto_in_dataexists(srpc->proto) == 1 ? 1 : 0;
 #endif /*__EH_DISABLED*/
 
-#ifdef SRPC_WITHOUT_IN_QUEUE
     if (srpc->params.on_remote_call_received) {
+      unsigned _supla_int_t rr_id = sdp->rr_id;
+      unsigned _supla_int_t call_id = sdp->call_id;
+      version = sdp->version;
+
       lck_unlock(srpc->lck);
-      srpc->params.on_remote_call_received(
-          srpc, srpc->sdp.rr_id, srpc->sdp.call_id, srpc->params.user_params,
-          srpc->sdp.version);
+      srpc->params.on_remote_call_received(srpc, rr_id, call_id,
+                                           srpc->params.user_params, version);
       lck_lock(srpc->lck);
     }
-#else
-    if (SUPLA_RESULT_TRUE == srpc_in_queue_push(srpc, &srpc->sdp)) {
-      if (srpc->params.on_remote_call_received) {
-        lck_unlock(srpc->lck);
-        srpc->params.on_remote_call_received(
-            srpc, srpc->sdp.rr_id, srpc->sdp.call_id, srpc->params.user_params,
-            srpc->sdp.version);
-        lck_lock(srpc->lck);
-      }
-
-    } else {
-      supla_log(LOG_DEBUG, "ssrpc_in_queue_push error");
-      return lck_unlock_r(srpc->lck, SUPLA_RESULT_FALSE);
-    }
-#endif /*SRPC_WITHOUT_IN_QUEUE*/
 
   } else if (result != SUPLA_RESULT_FALSE) {
     if (result == (char)SUPLA_RESULT_VERSION_ERROR) {
       if (srpc->params.on_version_error) {
-        version = srpc->sdp.version;
         lck_unlock(srpc->lck);
 
         srpc->params.on_version_error(srpc, version, srpc->params.user_params);
@@ -380,19 +914,31 @@ char SRPC_ICACHE_FLASH srpc_iterate(void *_srpc) {
 
   // --------- OUT ---------------
 #ifndef SRPC_WITHOUT_OUT_QUEUE
-  if (srpc_out_queue_pop(srpc, &srpc->sdp, 0) == SUPLA_RESULT_TRUE &&
-      SUPLA_RESULT_TRUE !=
-          (result = sproto_out_buffer_append(srpc->proto, &srpc->sdp)) &&
-      result != SUPLA_RESULT_FALSE) {
-    supla_log(LOG_DEBUG, "sproto_out_buffer_append error: %i", result);
-    return lck_unlock_r(srpc->lck, SUPLA_RESULT_FALSE);
+  // While the transport is congested new packets wait in the queue, so the
+  // output buffer only holds bytes that are already on their way.
+  if (!srpc->out_congested) {
+    sdp = srpc_sdp(srpc);
+    if (srpc->params.out_coalesce) {
+      // Everything produced since the previous iteration leaves in as few
+      // writes (and TLS records) as the buffer size allows.
+      while (srpc_out_queue_pop(srpc, sdp, 0) == SUPLA_RESULT_TRUE) {
+        if (SUPLA_RESULT_TRUE !=
+                (result = sproto_out_buffer_append(srpc->proto, sdp)) &&
+            result != SUPLA_RESULT_FALSE) {
+          supla_log(LOG_DEBUG, "sproto_out_buffer_append error: %i", result);
+          return lck_unlock_r(srpc->lck, SUPLA_RESULT_FALSE);
+        }
+      }
+    } else if (srpc_out_queue_pop(srpc, sdp, 0) == SUPLA_RESULT_TRUE &&
+               SUPLA_RESULT_TRUE !=
+                   (result = sproto_out_buffer_append(srpc->proto, sdp)) &&
+               result != SUPLA_RESULT_FALSE) {
+      supla_log(LOG_DEBUG, "sproto_out_buffer_append error: %i", result);
+      return lck_unlock_r(srpc->lck, SUPLA_RESULT_FALSE);
+    }
   }
 
-  data_size = sproto_pop_out_data(srpc->proto, data_buffer, SRPC_BUFFER_SIZE);
-
-  if (data_size != 0) {
-    srpc->params.data_write(data_buffer, data_size, srpc->params.user_params);
-  }
+  srpc_out_buffer_flush(srpc, srpc->params.out_coalesce);
 
 #ifndef __EH_DISABLED
   if (srpc->params.eh != 0 &&
@@ -415,29 +961,25 @@ char SRPC_ICACHE_FLASH srpc_iterate(void *_srpc) {
 #ifndef SRPC_EXCLUDE_DEVICE
 char SRPC_ICACHE_FLASH srpc_iterate_device(void *_srpc) {
   Tsrpc *srpc = (Tsrpc *)_srpc;
-  char data_buffer[SRPC_BUFFER_SIZE];
+  TSuplaDataPacket *sdp = srpc_sdp(srpc);
   char result = SUPLA_RESULT_TRUE;
+  char read_result = SUPLA_RESULT_TRUE;
 
   lck_lock(srpc->lck);
   _supla_int_t data_size = 0;
 
-  while ((data_size = srpc->params.data_read(data_buffer, SRPC_BUFFER_SIZE,
-                                             srpc->params.user_params)) > 0) {
-    if (SUPLA_RESULT_TRUE != (result = sproto_in_buffer_append(
-                                  srpc->proto, data_buffer, data_size))) {
-      supla_log(LOG_DEBUG, "sproto_in_buffer_append: %i, datasize: %i", result,
-                data_size);
-      return lck_unlock_r(srpc->lck, SUPLA_RESULT_FALSE);
-    }
+  while (SUPLA_RESULT_TRUE ==
+             (read_result = srpc_in_buffer_read(srpc, &data_size)) &&
+         data_size > 0) {
 
-    while ((result = sproto_pop_in_sdp(srpc->proto, &srpc->sdp)) ==
+    while ((result = sproto_pop_in_sdp(srpc->proto, sdp)) ==
            SUPLA_RESULT_TRUE) {
       // repeat while there are messages in the input buffer
       if (srpc->params.on_remote_call_received) {
         lck_unlock(srpc->lck);
         srpc->params.on_remote_call_received(
-            srpc, srpc->sdp.rr_id, srpc->sdp.call_id, srpc->params.user_params,
-            srpc->sdp.version);
+            srpc, sdp->rr_id, sdp->call_id, srpc->params.user_params,
+            sdp->version);
         lck_lock(srpc->lck);
       }
     }
@@ -445,7 +987,7 @@ char SRPC_ICACHE_FLASH srpc_iterate_device(void *_srpc) {
     if (result != SUPLA_RESULT_FALSE) {
       if (result == (char)SUPLA_RESULT_VERSION_ERROR) {
         if (srpc->params.on_version_error) {
-          unsigned char version = srpc->sdp.version;
+          unsigned char version = sdp->version;
           lck_unlock(srpc->lck);
 
           srpc->params.on_version_error(srpc, version,
@@ -462,6 +1004,11 @@ char SRPC_ICACHE_FLASH srpc_iterate_device(void *_srpc) {
     }
   }
 
+  if (read_result != SUPLA_RESULT_TRUE) {
+    supla_log(LOG_DEBUG, "sproto_in_buffer_write_span: %i", read_result);
+    return lck_unlock_r(srpc->lck, SUPLA_RESULT_FALSE);
+  }
+
   if (data_size == 0) {
     return lck_unlock_r(srpc->lck, SUPLA_RESULT_FALSE);
   }
@@ -482,7 +1029,8 @@ typedef unsigned _supla_int_t (*_func_srpc_pack_get_caption_size)(
     void *pack, _supla_int_t idx);
 
 void SRPC_ICACHE_FLASH srpc_getpack(
-    Tsrpc *srpc, TsrpcReceivedData *rd, unsigned _supla_int_t pack_sizeof,
+    TSuplaDataPacket *sdp, TsrpcReceivedData *rd,
+    unsigned _supla_int_t pack_sizeof,
     unsigned _supla_int_t item_sizeof, unsigned _supla_int_t pack_max_count,
     unsigned _supla_int_t caption_max_size,
     _func_srpc_pack_get_pack_count pack_get_count,
@@ -494,34 +1042,35 @@ void SRPC_ICACHE_FLASH srpc_getpack(
   _supla_int_t a, count, size, offset, pack_size;
   void *pack = NULL;
 
-  if (srpc->sdp.data_size < header_size || srpc->sdp.data_size > pack_sizeof) {
+  if (sdp->data_size < header_size || sdp->data_size > pack_sizeof) {
     return;
   }
 
-  count = pack_get_count(srpc->sdp.data);
+  count = pack_get_count(sdp->data);
 
   if (count < 0 || count > pack_max_count) {
     return;
   }
 
   pack_size = header_size + (item_sizeof * count);
-  pack = (TSC_SuplaChannelPack *)malloc(pack_size);
+  pack = (TSC_SuplaChannelPack *)salloc_malloc(rd->allocator, pack_size,
+                                                SALLOC_TAG_SRPC);
 
   if (pack == NULL) return;
 
   memset(pack, 0, pack_size);
-  memcpy(pack, srpc->sdp.data, header_size);
+  memcpy(pack, sdp->data, header_size);
 
   offset = header_size;
   pack_set_count(pack, 0, 0);
 
   for (a = 0; a < count; a++)
-    if (srpc->sdp.data_size - offset >= c_header_size) {
-      size = get_item_caption_size(&srpc->sdp.data[offset]);
+    if (sdp->data_size - offset >= c_header_size) {
+      size = get_item_caption_size(&sdp->data[offset]);
 
       if (size >= 0 && size <= caption_max_size &&
-          srpc->sdp.data_size - offset >= c_header_size + size) {
-        memcpy(get_item_ptr(pack, a), &srpc->sdp.data[offset],
+          sdp->data_size - offset >= c_header_size + size) {
+        memcpy(get_item_ptr(pack, a), &sdp->data[offset],
                c_header_size + size);
         offset += c_header_size + size;
         pack_set_count(pack, 1, 1);
@@ -532,12 +1081,12 @@ void SRPC_ICACHE_FLASH srpc_getpack(
     }
 
   if (count == pack_get_count(pack)) {
-    srpc->sdp.data_size = 0;
+    sdp->data_size = 0;
     // dcs_ping is 1st variable in union
     rd->data.dcs_ping = pack;
 
   } else {
-    free(pack);
+    salloc_free(rd->allocator, pack, SALLOC_TAG_SRPC);
   }
 }
 
@@ -564,8 +1113,9 @@ srpc_channelpack_get_item_caption_size(void *item) {
   return ((TSC_SuplaChannel *)item)->CaptionSize;
 }
 
-void SRPC_ICACHE_FLASH srpc_getchannelpack(Tsrpc *srpc, TsrpcReceivedData *rd) {
-  srpc_getpack(srpc, rd, sizeof(TSC_SuplaChannelPack), sizeof(TSC_SuplaChannel),
+void SRPC_ICACHE_FLASH srpc_getchannelpack(TSuplaDataPacket *sdp,
+                                           TsrpcReceivedData *rd) {
+  srpc_getpack(sdp, rd, sizeof(TSC_SuplaChannelPack), sizeof(TSC_SuplaChannel),
                SUPLA_CHANNELPACK_MAXCOUNT, SUPLA_CHANNEL_CAPTION_MAXSIZE,
                &srpc_channelpack_get_pack_count,
                &srpc_channelpack_set_pack_count, &srpc_channelpack_get_item_ptr,
@@ -595,10 +1145,10 @@ srpc_channelpack_get_item_caption_size_b(void *item) {
   return ((TSC_SuplaChannel_B *)item)->CaptionSize;
 }
 
-void SRPC_ICACHE_FLASH srpc_getchannelpack_b(Tsrpc *srpc,
+void SRPC_ICACHE_FLASH srpc_getchannelpack_b(TSuplaDataPacket *sdp,
                                              TsrpcReceivedData *rd) {
   srpc_getpack(
-      srpc, rd, sizeof(TSC_SuplaChannelPack_B), sizeof(TSC_SuplaChannel_B),
+      sdp, rd, sizeof(TSC_SuplaChannelPack_B), sizeof(TSC_SuplaChannel_B),
       SUPLA_CHANNELPACK_MAXCOUNT, SUPLA_CHANNEL_CAPTION_MAXSIZE,
       &srpc_channelpack_get_pack_count_b, &srpc_channelpack_set_pack_count_b,
       &srpc_channelpack_get_item_ptr_b,
@@ -628,10 +1178,10 @@ srpc_channelpack_get_item_caption_size_c(void *item) {
   return ((TSC_SuplaChannel_C *)item)->CaptionSize;
 }
 
-void SRPC_ICACHE_FLASH srpc_getchannelpack_c(Tsrpc *srpc,
+void SRPC_ICACHE_FLASH srpc_getchannelpack_c(TSuplaDataPacket *sdp,
                                              TsrpcReceivedData *rd) {
   srpc_getpack(
-      srpc, rd, sizeof(TSC_SuplaChannelPack_C), sizeof(TSC_SuplaChannel_C),
+      sdp, rd, sizeof(TSC_SuplaChannelPack_C), sizeof(TSC_SuplaChannel_C),
       SUPLA_CHANNELPACK_MAXCOUNT, SUPLA_CHANNEL_CAPTION_MAXSIZE,
       &srpc_channelpack_get_pack_count_c, &srpc_channelpack_set_pack_count_c,
       &srpc_channelpack_get_item_ptr_c,
@@ -661,10 +1211,10 @@ srpc_channelpack_get_item_caption_size_d(void *item) {
   return ((TSC_SuplaChannel_D *)item)->CaptionSize;
 }
 
-void SRPC_ICACHE_FLASH srpc_getchannelpack_d(Tsrpc *srpc,
+void SRPC_ICACHE_FLASH srpc_getchannelpack_d(TSuplaDataPacket *sdp,
                                              TsrpcReceivedData *rd) {
   srpc_getpack(
-      srpc, rd, sizeof(TSC_SuplaChannelPack_D), sizeof(TSC_SuplaChannel_D),
+      sdp, rd, sizeof(TSC_SuplaChannelPack_D), sizeof(TSC_SuplaChannel_D),
       SUPLA_CHANNELPACK_MAXCOUNT, SUPLA_CHANNEL_CAPTION_MAXSIZE,
       &srpc_channelpack_get_pack_count_d, &srpc_channelpack_set_pack_count_d,
       &srpc_channelpack_get_item_ptr_d,
@@ -694,10 +1244,10 @@ srpc_channelpack_get_item_caption_size_e(void *item) {
   return ((TSC_SuplaChannel_E *)item)->CaptionSize;
 }
 
-void SRPC_ICACHE_FLASH srpc_getchannelpack_e(Tsrpc *srpc,
+void SRPC_ICACHE_FLASH srpc_getchannelpack_e(TSuplaDataPacket *sdp,
                                              TsrpcReceivedData *rd) {
   srpc_getpack(
-      srpc, rd, sizeof(TSC_SuplaChannelPack_E), sizeof(TSC_SuplaChannel_E),
+      sdp, rd, sizeof(TSC_SuplaChannelPack_E), sizeof(TSC_SuplaChannel_E),
       SUPLA_CHANNELPACK_MAXCOUNT, SUPLA_CHANNEL_CAPTION_MAXSIZE,
       &srpc_channelpack_get_pack_count_e, &srpc_channelpack_set_pack_count_e,
       &srpc_channelpack_get_item_ptr_e,
@@ -728,9 +1278,9 @@ srpc_channelgroup_pack_get_item_caption_size(void *item) {
   return ((TSC_SuplaChannelGroup *)item)->CaptionSize;
 }
 
-void SRPC_ICACHE_FLASH srpc_getchannelgroup_pack(Tsrpc *srpc,
+void SRPC_ICACHE_FLASH srpc_getchannelgroup_pack(TSuplaDataPacket *sdp,
                                                  TsrpcReceivedData *rd) {
-  srpc_getpack(srpc, rd, sizeof(TSC_SuplaChannelGroupPack),
+  srpc_getpack(sdp, rd, sizeof(TSC_SuplaChannelGroupPack),
                sizeof(TSC_SuplaChannelGroup), SUPLA_CHANNELGROUP_PACK_MAXCOUNT,
                SUPLA_CHANNELGROUP_CAPTION_MAXSIZE,
                &srpc_channelgroup_pack_get_pack_count,
@@ -763,9 +1313,9 @@ srpc_channelgroup_pack_b_get_item_caption_size(void *item) {
   return ((TSC_SuplaChannelGroup_B *)item)->CaptionSize;
 }
 
-void SRPC_ICACHE_FLASH srpc_getchannelgroup_pack_b(Tsrpc *srpc,
+void SRPC_ICACHE_FLASH srpc_getchannelgroup_pack_b(TSuplaDataPacket *sdp,
                                                    TsrpcReceivedData *rd) {
-  srpc_getpack(srpc, rd, sizeof(TSC_SuplaChannelGroupPack_B),
+  srpc_getpack(sdp, rd, sizeof(TSC_SuplaChannelGroupPack_B),
                sizeof(TSC_SuplaChannelGroup_B),
                SUPLA_CHANNELGROUP_PACK_MAXCOUNT,
                SUPLA_CHANNELGROUP_CAPTION_MAXSIZE,
@@ -798,38 +1348,363 @@ srpc_locationpack_get_item_caption_size(void *item) {
   return ((TSC_SuplaLocation *)item)->CaptionSize;
 }
 
-void SRPC_ICACHE_FLASH srpc_getlocationpack(Tsrpc *srpc,
+void SRPC_ICACHE_FLASH srpc_getlocationpack(TSuplaDataPacket *sdp,
                                             TsrpcReceivedData *rd) {
   srpc_getpack(
-      srpc, rd, sizeof(TSC_SuplaLocationPack), sizeof(TSC_SuplaLocation),
+      sdp, rd, sizeof(TSC_SuplaLocationPack), sizeof(TSC_SuplaLocation),
       SUPLA_LOCATIONPACK_MAXCOUNT, SUPLA_LOCATION_CAPTION_MAXSIZE,
       &srpc_locationpack_get_pack_count, &srpc_locationpack_set_pack_count,
       &srpc_locationpack_get_item_ptr,
       &srpc_locationpack_get_item_caption_size);
 }
 
-#define VALID_SIZE(MIAN_TYPE, ITEM_TYPE, SIZE_VAR, MAX)                   \
-  srpc->sdp.data_size >= (sizeof(MIAN_TYPE) - sizeof(ITEM_TYPE) * MAX) && \
-      srpc->sdp.data_size <= sizeof(MIAN_TYPE) &&                         \
-      (((MIAN_TYPE *)srpc->sdp.data)->SIZE_VAR) * sizeof(ITEM_TYPE) ==    \
-          srpc->sdp.data_size - (sizeof(MIAN_TYPE) - sizeof(ITEM_TYPE) * MAX)
+// Every call known to the protocol: call id, minimum protocol version,
+// direction and the largest payload the decoder accepts (0 for calls that
+// carry no payload). Keep in sync with the call ids in proto.h.
+#define SRPC_CALLS(X)                                                         \
+  X(SUPLA_DCS_CALL_GETVERSION, 1, DCS, 0)                                     \
+  X(SUPLA_SDC_CALL_GETVERSION_RESULT, 1, SDC,                                 \
+    sizeof(TSDC_SuplaGetVersionResult))                                       \
+  X(SUPLA_SDC_CALL_VERSIONERROR, 1, SDC, sizeof(TSDC_SuplaVersionError))      \
+  X(SUPLA_DCS_CALL_PING_SERVER, 1, DCS, sizeof(TDCS_SuplaPingServer))         \
+  X(SUPLA_SDC_CALL_PING_SERVER_RESULT, 1, SDC,                                \
+    sizeof(TSDC_SuplaPingServerResult))                                       \
+  X(SUPLA_DS_CALL_REGISTER_DEVICE, 1, DS, sizeof(TDS_SuplaRegisterDevice))    \
+  X(SUPLA_DS_CALL_REGISTER_DEVICE_B, 2, DS,                                   \
+    sizeof(TDS_SuplaRegisterDevice_B))                                        \
+  X(SUPLA_DS_CALL_REGISTER_DEVICE_C, 6, DS,                                   \
+    sizeof(TDS_SuplaRegisterDevice_C))                                        \
+  X(SUPLA_DS_CALL_REGISTER_DEVICE_D, 7, DS,                                   \
+    sizeof(TDS_SuplaRegisterDevice_D))                                        \
+  X(SUPLA_DS_CALL_REGISTER_DEVICE_E, 10, DS,                                  \
+    sizeof(TDS_SuplaRegisterDevice_E))                                        \
+  X(SUPLA_SD_CALL_REGISTER_DEVICE_RESULT, 1, SD,                              \
+    sizeof(TSD_SuplaRegisterDeviceResult))                                    \
+  X(SUPLA_SD_CALL_REGISTER_DEVICE_RESULT_B, 25, SD,                           \
+    sizeof(TSD_SuplaRegisterDeviceResult_B))                                  \
+  X(SUPLA_DS_CALL_REGISTER_DEVICE_F, 23, DS,                                  \
+    sizeof(TDS_SuplaRegisterDevice_F))                                        \
+  X(SUPLA_DS_CALL_REGISTER_DEVICE_G, 25, DS,                                  \
+    sizeof(TDS_SuplaRegisterDevice_G))                                        \
+  X(SUPLA_CS_CALL_REGISTER_CLIENT, 1, CS, sizeof(TCS_SuplaRegisterClient))    \
+  X(SUPLA_CS_CALL_REGISTER_CLIENT_B, 6, CS,                                   \
+    sizeof(TCS_SuplaRegisterClient_B))                                        \
+  X(SUPLA_CS_CALL_REGISTER_CLIENT_C, 7, CS,                                   \
+    sizeof(TCS_SuplaRegisterClient_C))                                        \
+  X(SUPLA_CS_CALL_REGISTER_CLIENT_D, 12, CS,                                  \
+    sizeof(TCS_SuplaRegisterClient_D))                                        \
+  X(SUPLA_SC_CALL_REGISTER_CLIENT_RESULT, 1, SC,                              \
+    sizeof(TSC_SuplaRegisterClientResult))                                    \
+  X(SUPLA_SC_CALL_REGISTER_CLIENT_RESULT_B, 9, SC,                            \
+    sizeof(TSC_SuplaRegisterClientResult_B))                                  \
+  X(SUPLA_SC_CALL_REGISTER_CLIENT_RESULT_C, 17, SC,                           \
+    sizeof(TSC_SuplaRegisterClientResult_C))                                  \
+  X(SUPLA_SC_CALL_REGISTER_CLIENT_RESULT_D, 19, SC,                           \
+    sizeof(TSC_SuplaRegisterClientResult_D))                                  \
+  X(SUPLA_DS_CALL_DEVICE_CHANNEL_VALUE_CHANGED, 1, DS,                        \
+    sizeof(TDS_SuplaDeviceChannelValue))                                      \
+  X(SUPLA_DS_CALL_DEVICE_CHANNEL_VALUE_CHANGED_B, 12, DS,                     \
+    sizeof(TDS_SuplaDeviceChannelValue_B))                                    \
+  X(SUPLA_DS_CALL_DEVICE_CHANNEL_VALUE_CHANGED_C, 12, DS,                     \
+    sizeof(TDS_SuplaDeviceChannelValue_C))                                    \
+  X(SUPLA_DS_CALL_DEVICE_CHANNEL_EXTENDEDVALUE_CHANGED, 10, DS,               \
+    sizeof(TDS_SuplaDeviceChannelExtendedValue))                              \
+  X(SUPLA_SD_CALL_CHANNEL_SET_VALUE, 1, SD, sizeof(TSD_SuplaChannelNewValue)) \
+  X(SUPLA_SD_CALL_CHANNELGROUP_SET_VALUE, 13, SD,                             \
+    sizeof(TSD_SuplaChannelGroupNewValue))                                    \
+  X(SUPLA_DS_CALL_CHANNEL_SET_VALUE_RESULT, 1, DS,                            \
+    sizeof(TDS_SuplaChannelNewValueResult))                                   \
+  X(SUPLA_SC_CALL_LOCATION_UPDATE, 1, SC, sizeof(TSC_SuplaLocation))          \
+  X(SUPLA_SC_CALL_LOCATIONPACK_UPDATE, 1, SC, sizeof(TSC_SuplaLocationPack))  \
+  X(SUPLA_SC_CALL_CHANNELPACK_UPDATE, 1, SC, sizeof(TSC_SuplaChannelPack))    \
+  X(SUPLA_SC_CALL_CHANNEL_VALUE_UPDATE, 1, SC, sizeof(TSC_SuplaChannelValue)) \
+  X(SUPLA_SC_CALL_CHANNEL_VALUE_UPDATE_B, 15, SC,                             \
+    sizeof(TSC_SuplaChannelValue_B))                                          \
+  X(SUPLA_CS_CALL_GET_NEXT, 1, CS, 0)                                         \
+  X(SUPLA_SC_CALL_EVENT, 1, SC, sizeof(TSC_SuplaEvent))                       \
+  X(SUPLA_CS_CALL_CHANNEL_SET_VALUE, 1, CS, sizeof(TCS_SuplaChannelNewValue)) \
+  X(SUPLA_CS_CALL_CHANNEL_SET_VALUE_B, 3, CS,                                 \
+    sizeof(TCS_SuplaChannelNewValue_B))                                       \
+  X(SUPLA_DCS_CALL_SET_ACTIVITY_TIMEOUT, 2, DCS,                              \
+    sizeof(TDCS_SuplaSetActivityTimeout))                                     \
+  X(SUPLA_SDC_CALL_SET_ACTIVITY_TIMEOUT_RESULT, 2, SDC,                       \
+    sizeof(TSDC_SuplaSetActivityTimeoutResult))                               \
+  X(SUPLA_DS_CALL_GET_FIRMWARE_UPDATE_URL, 5, DS,                             \
+    sizeof(TDS_FirmwareUpdateParams))                                         \
+  X(SUPLA_SD_CALL_GET_FIRMWARE_UPDATE_URL_RESULT, 5, SD,                      \
+    sizeof(TSD_FirmwareUpdate_UrlResult))                                     \
+  X(SUPLA_DCS_CALL_GET_REGISTRATION_ENABLED, 7, DCS, 0)                       \
+  X(SUPLA_SDC_CALL_GET_REGISTRATION_ENABLED_RESULT, 7, SDC,                   \
+    sizeof(TSDC_RegistrationEnabled))                                         \
+  X(SUPLA_CS_CALL_OAUTH_TOKEN_REQUEST, 10, CS, 0)                             \
+  X(SUPLA_SC_CALL_OAUTH_TOKEN_REQUEST_RESULT, 10, SC,                         \
+    sizeof(TSC_OAuthTokenRequestResult))                                      \
+  X(SUPLA_SC_CALL_CHANNELPACK_UPDATE_B, 8, SC,                                \
+    sizeof(TSC_SuplaChannelPack_B))                                           \
+  X(SUPLA_SC_CALL_CHANNELPACK_UPDATE_C, 10, SC,                               \
+    sizeof(TSC_SuplaChannelPack_C))                                           \
+  X(SUPLA_SC_CALL_CHANNELPACK_UPDATE_D, 15, SC,                               \
+    sizeof(TSC_SuplaChannelPack_D))                                           \
+  X(SUPLA_SC_CALL_CHANNELPACK_UPDATE_E, 23, SC,                               \
+    sizeof(TSC_SuplaChannelPack_E))                                           \
+  X(SUPLA_SC_CALL_CHANNELGROUP_PACK_UPDATE, 9, SC,                            \
+    sizeof(TSC_SuplaChannelGroupPack))                                        \
+  X(SUPLA_SC_CALL_CHANNELGROUP_PACK_UPDATE_B, 10, SC,                         \
+    sizeof(TSC_SuplaChannelGroupPack_B))                                      \
+  X(SUPLA_SC_CALL_CHANNELGROUP_RELATION_PACK_UPDATE, 9, SC,                   \
+    sizeof(TSC_SuplaChannelGroupRelationPack))                                \
+  X(SUPLA_SC_CALL_CHANNEL_RELATION_PACK_UPDATE, 21, SC,                       \
+    sizeof(TSC_SuplaChannelRelationPack))                                     \
+  X(SUPLA_SC_CALL_CHANNELVALUE_PACK_UPDATE, 9, SC,                            \
+    sizeof(TSC_SuplaChannelValuePack))                                        \
+  X(SUPLA_SC_CALL_CHANNELVALUE_PACK_UPDATE_B, 15, SC,                         \
+    sizeof(TSC_SuplaChannelValuePack_B))                                      \
+  X(SUPLA_SC_CALL_CHANNELEXTENDEDVALUE_PACK_UPDATE, 10, SC,                   \
+    sizeof(TSC_SuplaChannelExtendedValuePack))                                \
+  X(SUPLA_SC_CALL_CHANNEL_STATE_PACK_UPDATE, 26, SC,                          \
+    sizeof(TSC_SuplaChannelStatePack))                                        \
+  X(SUPLA_CS_CALL_SET_VALUE, 9, CS, sizeof(TCS_SuplaNewValue))                \
+  X(SUPLA_CS_CALL_SUPERUSER_AUTHORIZATION_REQUEST, 10, CS,                    \
+    sizeof(TCS_SuperUserAuthorizationRequest))                                \
+  X(SUPLA_CS_CALL_GET_SUPERUSER_AUTHORIZATION_RESULT, 12, CS, 0)              \
+  X(SUPLA_SC_CALL_SUPERUSER_AUTHORIZATION_RESULT, 10, SC,                     \
+    sizeof(TSC_SuperUserAuthorizationResult))                                 \
+  X(SUPLA_CS_CALL_DEVICE_CALCFG_REQUEST, 10, CS,                              \
+    sizeof(TCS_DeviceCalCfgRequest))                                          \
+  X(SUPLA_CS_CALL_DEVICE_CALCFG_REQUEST_B, 11, CS,                            \
+    sizeof(TCS_DeviceCalCfgRequest_B))                                        \
+  X(SUPLA_SC_CALL_DEVICE_CALCFG_RESULT, 10, SC,                               \
+    sizeof(TSC_DeviceCalCfgResult))                                           \
+  X(SUPLA_SD_CALL_DEVICE_CALCFG_REQUEST, 10, SD,                              \
+    sizeof(TSD_DeviceCalCfgRequest))                                          \
+  X(SUPLA_DS_CALL_DEVICE_CALCFG_RESULT, 10, DS,                               \
+    sizeof(TDS_DeviceCalCfgResult))                                           \
+  X(SUPLA_DCS_CALL_GET_USER_LOCALTIME, 11, DCS, 0)                            \
+  X(SUPLA_DCS_CALL_GET_USER_LOCALTIME_RESULT, 11, SDC,                        \
+    sizeof(TSDC_UserLocalTimeResult))                                         \
+  X(SUPLA_CSD_CALL_GET_CHANNEL_STATE, 12, CSD,                                \
+    sizeof(TCSD_ChannelStateRequest))                                         \
+  X(SUPLA_DSC_CALL_CHANNEL_STATE_RESULT, 12, DSC, sizeof(TDSC_ChannelState))  \
+  X(SUPLA_CS_CALL_GET_CHANNEL_BASIC_CFG, 12, CS,                              \
+    sizeof(TCS_ChannelBasicCfgRequest))                                       \
+  X(SUPLA_SC_CALL_CHANNEL_BASIC_CFG_RESULT, 12, SC,                           \
+    sizeof(TSC_ChannelBasicCfg))                                              \
+  X(SUPLA_CS_CALL_SET_CHANNEL_FUNCTION, 12, CS,                               \
+    sizeof(TCS_SetChannelFunction))                                           \
+  X(SUPLA_SC_CALL_SET_CHANNEL_FUNCTION_RESULT, 12, SC,                        \
+    sizeof(TSC_SetChannelFunctionResult))                                     \
+  X(SUPLA_CS_CALL_CLIENTS_RECONNECT_REQUEST, 12, CS, 0)                       \
+  X(SUPLA_SC_CALL_CLIENTS_RECONNECT_REQUEST_RESULT, 12, SC,                   \
+    sizeof(TSC_ClientsReconnectRequestResult))                                \
+  X(SUPLA_CS_CALL_SET_REGISTRATION_ENABLED, 12, CS,                           \
+    sizeof(TCS_SetRegistrationEnabled))                                       \
+  X(SUPLA_SC_CALL_SET_REGISTRATION_ENABLED_RESULT, 12, SC,                    \
+    sizeof(TSC_SetRegistrationEnabledResult))                                 \
+  X(SUPLA_CS_CALL_DEVICE_RECONNECT_REQUEST, 12, CS,                           \
+    sizeof(TCS_DeviceReconnectRequest))                                       \
+  X(SUPLA_SC_CALL_DEVICE_RECONNECT_REQUEST_RESULT, 12, SC,                    \
+    sizeof(TSC_DeviceReconnectRequestResult))                                 \
+  X(SUPLA_DS_CALL_GET_CHANNEL_FUNCTIONS, 12, DS, 0)                           \
+  X(SUPLA_SD_CALL_GET_CHANNEL_FUNCTIONS_RESULT, 12, SD,                       \
+    sizeof(TSD_ChannelFunctions))                                             \
+  X(SUPLA_DCS_CALL_SET_CHANNEL_CAPTION, 12, DCS, sizeof(TDCS_SetCaption))     \
+  X(SUPLA_SCD_CALL_SET_CHANNEL_CAPTION_RESULT, 12, SCD,                       \
+    sizeof(TSCD_SetCaptionResult))                                            \
+  X(SUPLA_CS_CALL_SET_CHANNEL_GROUP_CAPTION, 20, CS, sizeof(TDCS_SetCaption)) \
+  X(SUPLA_SC_CALL_SET_CHANNEL_GROUP_CAPTION_RESULT, 20, SC,                   \
+    sizeof(TSCD_SetCaptionResult))                                            \
+  X(SUPLA_CS_CALL_SET_LOCATION_CAPTION, 14, CS, sizeof(TDCS_SetCaption))      \
+  X(SUPLA_SC_CALL_SET_LOCATION_CAPTION_RESULT, 14, SC,                        \
+    sizeof(TSCD_SetCaptionResult))                                            \
+  X(SUPLA_DS_CALL_GET_CHANNEL_CONFIG, 16, DS,                                 \
+    sizeof(TDS_GetChannelConfigRequest))                                      \
+  X(SUPLA_SD_CALL_GET_CHANNEL_CONFIG_RESULT, 16, SD,                          \
+    sizeof(TSD_ChannelConfig))                                                \
+  X(SUPLA_DS_CALL_SET_CHANNEL_CONFIG, 21, DS, sizeof(TSDS_SetChannelConfig))  \
+  X(SUPLA_SD_CALL_SET_CHANNEL_CONFIG_RESULT, 21, SD,                          \
+    sizeof(TSDS_SetChannelConfigResult))                                      \
+  X(SUPLA_SD_CALL_SET_CHANNEL_CONFIG, 21, SD, sizeof(TSDS_SetChannelConfig))  \
+  X(SUPLA_DS_CALL_SET_CHANNEL_CONFIG_RESULT, 21, DS,                          \
+    sizeof(TSDS_SetChannelConfigResult))                                      \
+  X(SUPLA_SD_CALL_CHANNEL_CONFIG_FINISHED, 21, SD,                            \
+    sizeof(TSD_ChannelConfigFinished))                                        \
+  X(SUPLA_DS_CALL_SET_DEVICE_CONFIG, 21, DS, sizeof(TSDS_SetDeviceConfig))    \
+  X(SUPLA_SD_CALL_SET_DEVICE_CONFIG_RESULT, 21, SD,                           \
+    sizeof(TSDS_SetDeviceConfigResult))                                       \
+  X(SUPLA_SD_CALL_SET_DEVICE_CONFIG, 21, SD, sizeof(TSDS_SetDeviceConfig))    \
+  X(SUPLA_DS_CALL_SET_DEVICE_CONFIG_RESULT, 21, DS,                           \
+    sizeof(TSDS_SetDeviceConfigResult))                                       \
+  X(SUPLA_DS_CALL_ACTIONTRIGGER, 16, DS, sizeof(TDS_ActionTrigger))           \
+  X(SUPLA_CS_CALL_TIMER_ARM, 17, CS, sizeof(TCS_TimerArmRequest))             \
+  X(SUPLA_SC_CALL_SCENE_PACK_UPDATE, 18, SC, sizeof(TSC_SuplaScenePack))      \
+  X(SUPLA_SC_CALL_SCENE_STATE_PACK_UPDATE, 18, SC,                            \
+    sizeof(TSC_SuplaSceneStatePack))                                          \
+  X(SUPLA_CS_CALL_EXECUTE_ACTION, 19, CS, sizeof(TCS_Action))                 \
+  X(SUPLA_CS_CALL_EXECUTE_ACTION_WITH_AUTH, 19, CS,                           \
+    sizeof(TCS_ActionWithAuth))                                               \
+  X(SUPLA_SC_CALL_ACTION_EXECUTION_RESULT, 19, SC,                            \
+    sizeof(TSC_ActionExecutionResult))                                        \
+  X(SUPLA_CS_CALL_GET_CHANNEL_VALUE_WITH_AUTH, 19, CS,                        \
+    sizeof(TCS_GetChannelValueWithAuth))                                      \
+  X(SUPLA_SC_CALL_GET_CHANNEL_VALUE_RESULT, 19, SC,                           \
+    sizeof(TSC_GetChannelValueResult))                                        \
+  X(SUPLA_CS_CALL_SET_SCENE_CAPTION, 19, CS, sizeof(TDCS_SetCaption))         \
+  X(SUPLA_SC_CALL_SET_SCENE_CAPTION_RESULT, 19, SC,                           \
+    sizeof(TSCD_SetCaptionResult))                                            \
+  X(SUPLA_DS_CALL_REGISTER_PUSH_NOTIFICATION, 20, DS,                         \
+    sizeof(TDS_RegisterPushNotification))                                     \
+  X(SUPLA_DS_CALL_SEND_PUSH_NOTIFICATION, 20, DS,                             \
+    sizeof(TDS_PushNotification))                                             \
+  X(SUPLA_CS_CALL_REGISTER_PN_CLIENT_TOKEN, 20, CS,                           \
+    sizeof(TCS_RegisterPnClientToken))                                        \
+  X(SUPLA_SC_CALL_REGISTER_PN_CLIENT_TOKEN_RESULT, 20, SC,                    \
+    sizeof(TSC_RegisterPnClientTokenResult))                                  \
+  X(SUPLA_CS_CALL_GET_CHANNEL_CONFIG, 21, CS,                                 \
+    sizeof(TCS_GetChannelConfigRequest))                                      \
+  X(SUPLA_SC_CALL_CHANNEL_CONFIG_UPDATE_OR_RESULT, 21, SC,                    \
+    sizeof(TSC_ChannelConfigUpdateOrResult))                                  \
+  X(SUPLA_CS_CALL_SET_CHANNEL_CONFIG, 21, CS, sizeof(TSCS_ChannelConfig))     \
+  X(SUPLA_CS_CALL_GET_DEVICE_CONFIG, 21, CS,                                  \
+    sizeof(TCS_GetDeviceConfigRequest))                                       \
+  X(SUPLA_SC_CALL_DEVICE_CONFIG_UPDATE_OR_RESULT, 21, SC,                     \
+    sizeof(TSC_DeviceConfigUpdateOrResult))                                   \
+  X(SUPLA_DS_CALL_SET_SUBDEVICE_DETAILS, 25, DS,                              \
+    sizeof(TDS_SubdeviceDetails))                                            
+
+#define SRPC_DIR_DS SRPC_ROLE_DEVICE, SRPC_ROLE_SERVER
+#define SRPC_DIR_SD SRPC_ROLE_SERVER, SRPC_ROLE_DEVICE
+#define SRPC_DIR_CS SRPC_ROLE_CLIENT, SRPC_ROLE_SERVER
+#define SRPC_DIR_SC SRPC_ROLE_SERVER, SRPC_ROLE_CLIENT
+#define SRPC_DIR_DCS SRPC_ROLE_DEVICE | SRPC_ROLE_CLIENT, SRPC_ROLE_SERVER
+#define SRPC_DIR_SDC SRPC_ROLE_SERVER, SRPC_ROLE_DEVICE | SRPC_ROLE_CLIENT
+#define SRPC_DIR_CSD                   \
+  SRPC_ROLE_CLIENT | SRPC_ROLE_SERVER, \
+      SRPC_ROLE_SERVER | SRPC_ROLE_DEVICE
+#define SRPC_DIR_DSC                   \
+  SRPC_ROLE_DEVICE | SRPC_ROLE_SERVER, \
+      SRPC_ROLE_SERVER | SRPC_ROLE_CLIENT
+#define SRPC_DIR_SCD SRPC_ROLE_SERVER, SRPC_ROLE_CLIENT | SRPC_ROLE_DEVICE
+
+#define SRPC_CALL_DESC(ID, VERSION, DIR, SIZE) \
+  { ID, SIZE, VERSION, SRPC_DIR_##DIR }
+
+#ifdef SRPC_WITHOUT_CALL_TABLE
+// Small targets keep const data in RAM, the same list is compiled into code.
+#define SRPC_CALL_DESC_CASE(ID, VERSION, DIR, SIZE)                     \
+  case ID: {                                                            \
+    const TsrpcCallDesc item = SRPC_CALL_DESC(ID, VERSION, DIR, SIZE); \
+    *desc = item;                                                       \
+    return 1;                                                           \
+  }
+
+char SRPC_ICACHE_FLASH srpc_call_desc(unsigned _supla_int_t call_id,
+                                      TsrpcCallDesc *desc) {
+  switch (call_id) { SRPC_CALLS(SRPC_CALL_DESC_CASE) }
+
+  return 0;
+}
+#else
+#define SRPC_CALL_IDX(ID, VERSION, DIR, SIZE) SRPC_CALL_IDX_##ID,
+#define SRPC_CALL_ID_SLOT(ID, VERSION, DIR, SIZE) char ID##_slot[(ID) + 1];
+#define SRPC_CALL_INDEX(ID, VERSION, DIR, SIZE) [ID] = SRPC_CALL_IDX_##ID + 1,
+#define SRPC_CALL_ITEM(ID, VERSION, DIR, SIZE) \
+  SRPC_CALL_DESC(ID, VERSION, DIR, SIZE),
+
+enum { SRPC_CALLS(SRPC_CALL_IDX) SRPC_CALL_COUNT };
+
+// Its size is the highest call id + 1
+typedef union {
+  SRPC_CALLS(SRPC_CALL_ID_SLOT)
+} Tsrpc_CallIdRange;
+
+#define SRPC_CALL_ID_LIMIT sizeof(Tsrpc_CallIdRange)
+
+_Static_assert(SRPC_CALL_COUNT < 256, "call index must fit unsigned char");
+_Static_assert(SRPC_CALL_ID_LIMIT <= 4096, "call id index grows too large");
+
+static const TsrpcCallDesc srpc_calls[SRPC_CALL_COUNT] = {
+    SRPC_CALLS(SRPC_CALL_ITEM)};
+
+// call id -> position in srpc_calls + 1, 0 for unknown ids
+static const unsigned char srpc_call_index[SRPC_CALL_ID_LIMIT] = {
+    SRPC_CALLS(SRPC_CALL_INDEX)};
+
+char SRPC_ICACHE_FLASH srpc_call_desc(unsigned _supla_int_t call_id,
+                                      TsrpcCallDesc *desc) {
+  if (call_id >= SRPC_CALL_ID_LIMIT || srpc_call_index[call_id] == 0) {
+    return 0;
+  }
+
+  *desc = srpc_calls[srpc_call_index[call_id] - 1];
+  return 1;
+}
+#endif /*SRPC_WITHOUT_CALL_TABLE*/
+
+#define VALID_SIZE(MIAN_TYPE, ITEM_TYPE, SIZE_VAR, MAX)              \
+  sdp->data_size >= (sizeof(MIAN_TYPE) - sizeof(ITEM_TYPE) * MAX) && \
+      sdp->data_size <= sizeof(MIAN_TYPE) &&                         \
+      (((MIAN_TYPE *)sdp->data)->SIZE_VAR) * sizeof(ITEM_TYPE) ==    \
+          sdp->data_size - (sizeof(MIAN_TYPE) - sizeof(ITEM_TYPE) * MAX)
+
+// In view mode a structure whose size matches the packet exactly is not
+// copied, rd points straight into the queued packet instead.
+void *SRPC_ICACHE_FLASH srpc_rd_alloc(TsrpcReceivedData *rd,
+                                      TSuplaDataPacket *sdp, char views,
+                                      unsigned _supla_int_t size) {
+  if (views && sdp->data_size == size) {
+    rd->view = 1;
+    return sdp->data;
+  }
+
+  return salloc_calloc(rd->allocator, 1, size, SALLOC_TAG_SRPC);
+}
+
+#define SRPC_RD_ALLOC(TYPE) \
+  (TYPE *)srpc_rd_alloc(rd, sdp, views, sizeof(TYPE))
 
 char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
                                     unsigned _supla_int_t rr_id) {
   Tsrpc *srpc = (Tsrpc *)_srpc;
+  TSuplaDataPacket *sdp = srpc_sdp(srpc);
+  TsrpcCallDesc desc;
   char call_with_no_data = 0;
+  char views = 0;
+  char result = SUPLA_RESULT_FALSE;
   rd->call_id = 0;
+  rd->view = 0;
+  rd->allocator = srpc->params.allocator;
 
   lck_lock(srpc->lck);
 
-  if (SUPLA_RESULT_TRUE == srpc_in_queue_pop(srpc, &srpc->sdp, rr_id)) {
-    rd->call_id = srpc->sdp.call_id;
-    rd->rr_id = srpc->sdp.rr_id;
+#ifdef SRPC_WITHOUT_IN_QUEUE
+  result = srpc_in_queue_pop(srpc, sdp, rr_id);
+#else
+  srpc_queue_release(&srpc->in_queue);
+
+  if (srpc->params.rd_views) {
+    sdp = srpc_queue_hold(&srpc->in_queue, rr_id);
+    if (sdp != NULL) {
+      views = 1;
+      result = SUPLA_RESULT_TRUE;
+    }
+  } else {
+    result = srpc_in_queue_pop(srpc, sdp, rr_id);
+  }
+#endif /*SRPC_WITHOUT_IN_QUEUE*/
+
+  if (SUPLA_RESULT_TRUE == result) {
+    rd->call_id = sdp->call_id;
+    rd->rr_id = sdp->rr_id;
 
     // first one
     rd->data.dcs_ping = NULL;
 
-    switch (srpc->sdp.call_id) {
+    if (!srpc_call_desc(sdp->call_id, &desc) ||
+        (desc.max_data_size > 0 && sdp->data_size > desc.max_data_size)) {
+      return lck_unlock_r(srpc->lck, SUPLA_RESULT_DATA_ERROR);
+    }
+
+    switch (sdp->call_id) {
       case SUPLA_DCS_CALL_GETVERSION:
       case SUPLA_CS_CALL_GET_NEXT:
       case SUPLA_DCS_CALL_GET_REGISTRATION_ENABLED:
@@ -838,31 +1713,29 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
 
       case SUPLA_SDC_CALL_GETVERSION_RESULT:
 
-        if (srpc->sdp.data_size == sizeof(TSDC_SuplaGetVersionResult))
-          rd->data.sdc_getversion_result = (TSDC_SuplaGetVersionResult *)calloc(
-              1, sizeof(TSDC_SuplaGetVersionResult));
+        if (sdp->data_size == sizeof(TSDC_SuplaGetVersionResult))
+          rd->data.sdc_getversion_result =
+              SRPC_RD_ALLOC(TSDC_SuplaGetVersionResult);
 
         break;
 
       case SUPLA_SDC_CALL_VERSIONERROR:
 
-        if (srpc->sdp.data_size == sizeof(TSDC_SuplaVersionError))
-          rd->data.sdc_version_error = (TSDC_SuplaVersionError *)calloc(
-              1, sizeof(TSDC_SuplaVersionError));
+        if (sdp->data_size == sizeof(TSDC_SuplaVersionError))
+          rd->data.sdc_version_error = SRPC_RD_ALLOC(TSDC_SuplaVersionError);
 
         break;
 
       case SUPLA_DCS_CALL_PING_SERVER:
 
-        if (srpc->sdp.data_size == sizeof(TDCS_SuplaPingServer) ||
-            srpc->sdp.data_size == sizeof(TDCS_SuplaPingServer_COMPAT)) {
-          rd->data.dcs_ping =
-              (TDCS_SuplaPingServer *)calloc(1, sizeof(TDCS_SuplaPingServer));
+        if (sdp->data_size == sizeof(TDCS_SuplaPingServer) ||
+            sdp->data_size == sizeof(TDCS_SuplaPingServer_COMPAT)) {
+          rd->data.dcs_ping = SRPC_RD_ALLOC(TDCS_SuplaPingServer);
 
 #ifndef __AVR__
-          if (srpc->sdp.data_size == sizeof(TDCS_SuplaPingServer_COMPAT)) {
+          if (sdp->data_size == sizeof(TDCS_SuplaPingServer_COMPAT)) {
             TDCS_SuplaPingServer_COMPAT *compat =
-                (TDCS_SuplaPingServer_COMPAT *)srpc->sdp.data;
+                (TDCS_SuplaPingServer_COMPAT *)sdp->data;
 
             rd->data.dcs_ping->now.tv_sec = compat->now.tv_sec;
             rd->data.dcs_ping->now.tv_usec = compat->now.tv_usec;
@@ -874,35 +1747,31 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
 
       case SUPLA_SDC_CALL_PING_SERVER_RESULT:
 
-        if (srpc->sdp.data_size == sizeof(TSDC_SuplaPingServerResult))
-          rd->data.sdc_ping_result = (TSDC_SuplaPingServerResult *)calloc(
-              1, sizeof(TSDC_SuplaPingServerResult));
+        if (sdp->data_size == sizeof(TSDC_SuplaPingServerResult))
+          rd->data.sdc_ping_result = SRPC_RD_ALLOC(TSDC_SuplaPingServerResult);
 
         break;
 
       case SUPLA_DCS_CALL_SET_ACTIVITY_TIMEOUT:
 
-        if (srpc->sdp.data_size == sizeof(TDCS_SuplaSetActivityTimeout))
+        if (sdp->data_size == sizeof(TDCS_SuplaSetActivityTimeout))
           rd->data.dcs_set_activity_timeout =
-              (TDCS_SuplaSetActivityTimeout *)calloc(
-                  1, sizeof(TDCS_SuplaSetActivityTimeout));
+              SRPC_RD_ALLOC(TDCS_SuplaSetActivityTimeout);
 
         break;
 
       case SUPLA_SDC_CALL_SET_ACTIVITY_TIMEOUT_RESULT:
 
-        if (srpc->sdp.data_size == sizeof(TSDC_SuplaSetActivityTimeoutResult))
+        if (sdp->data_size == sizeof(TSDC_SuplaSetActivityTimeoutResult))
           rd->data.sdc_set_activity_timeout_result =
-              (TSDC_SuplaSetActivityTimeoutResult *)calloc(
-                  1, sizeof(TSDC_SuplaSetActivityTimeoutResult));
+              SRPC_RD_ALLOC(TSDC_SuplaSetActivityTimeoutResult);
 
         break;
 
       case SUPLA_SDC_CALL_GET_REGISTRATION_ENABLED_RESULT:
 
-        if (srpc->sdp.data_size == sizeof(TSDC_RegistrationEnabled))
-          rd->data.sdc_reg_enabled = (TSDC_RegistrationEnabled *)calloc(
-              1, sizeof(TSDC_RegistrationEnabled));
+        if (sdp->data_size == sizeof(TSDC_RegistrationEnabled))
+          rd->data.sdc_reg_enabled = SRPC_RD_ALLOC(TSDC_RegistrationEnabled);
 
         break;
       case SUPLA_DCS_CALL_GET_USER_LOCALTIME:
@@ -912,37 +1781,33 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
         if (VALID_SIZE(TSDC_UserLocalTimeResult, char, timezoneSize,
                        SUPLA_TIMEZONE_MAXSIZE)) {
           rd->data.sdc_user_localtime_result =
-              (TSDC_UserLocalTimeResult *)calloc(
-                  1, sizeof(TSDC_UserLocalTimeResult));
+              SRPC_RD_ALLOC(TSDC_UserLocalTimeResult);
         }
 
         break;
 
       case SUPLA_CSD_CALL_GET_CHANNEL_STATE:
-        if (srpc->sdp.data_size == sizeof(TCSD_ChannelStateRequest))
+        if (sdp->data_size == sizeof(TCSD_ChannelStateRequest))
           rd->data.csd_channel_state_request =
-              (TCSD_ChannelStateRequest *)calloc(
-                  1, sizeof(TCSD_ChannelStateRequest));
+              SRPC_RD_ALLOC(TCSD_ChannelStateRequest);
         break;
       case SUPLA_DSC_CALL_CHANNEL_STATE_RESULT:
-        if (srpc->sdp.data_size == sizeof(TDSC_ChannelState))
-          rd->data.dsc_channel_state =
-              (TDSC_ChannelState *)calloc(1, sizeof(TDSC_ChannelState));
+        if (sdp->data_size == sizeof(TDSC_ChannelState))
+          rd->data.dsc_channel_state = SRPC_RD_ALLOC(TDSC_ChannelState);
         break;
 
       case SUPLA_SCD_CALL_SET_CHANNEL_CAPTION_RESULT:
         if (VALID_SIZE(TSCD_SetCaptionResult, char, CaptionSize,
                        SUPLA_CAPTION_MAXSIZE))
           rd->data.scd_set_caption_result =
-              (TSCD_SetCaptionResult *)calloc(1, sizeof(TSCD_SetCaptionResult));
+              SRPC_RD_ALLOC(TSCD_SetCaptionResult);
         break;
 
 #ifndef SRPC_EXCLUDE_DEVICE
       case SUPLA_DS_CALL_REGISTER_DEVICE:
         if (VALID_SIZE(TDS_SuplaRegisterDevice, TDS_SuplaDeviceChannel,
                        channel_count, SUPLA_CHANNELMAXCOUNT)) {
-          rd->data.ds_register_device = (TDS_SuplaRegisterDevice *)calloc(
-              1, sizeof(TDS_SuplaRegisterDevice));
+          rd->data.ds_register_device = SRPC_RD_ALLOC(TDS_SuplaRegisterDevice);
         }
 
         break;
@@ -951,8 +1816,8 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
 
         if (VALID_SIZE(TDS_SuplaRegisterDevice_B, TDS_SuplaDeviceChannel_B,
                        channel_count, SUPLA_CHANNELMAXCOUNT)) {
-          rd->data.ds_register_device_b = (TDS_SuplaRegisterDevice_B *)calloc(
-              1, sizeof(TDS_SuplaRegisterDevice_B));
+          rd->data.ds_register_device_b =
+              SRPC_RD_ALLOC(TDS_SuplaRegisterDevice_B);
         }
 
         break;
@@ -961,8 +1826,8 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
 
         if (VALID_SIZE(TDS_SuplaRegisterDevice_C, TDS_SuplaDeviceChannel_B,
                        channel_count, SUPLA_CHANNELMAXCOUNT)) {
-          rd->data.ds_register_device_c = (TDS_SuplaRegisterDevice_C *)calloc(
-              1, sizeof(TDS_SuplaRegisterDevice_C));
+          rd->data.ds_register_device_c =
+              SRPC_RD_ALLOC(TDS_SuplaRegisterDevice_C);
         }
 
         break;
@@ -971,8 +1836,8 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
 
         if (VALID_SIZE(TDS_SuplaRegisterDevice_D, TDS_SuplaDeviceChannel_B,
                        channel_count, SUPLA_CHANNELMAXCOUNT)) {
-          rd->data.ds_register_device_d = (TDS_SuplaRegisterDevice_D *)calloc(
-              1, sizeof(TDS_SuplaRegisterDevice_D));
+          rd->data.ds_register_device_d =
+              SRPC_RD_ALLOC(TDS_SuplaRegisterDevice_D);
         }
 
         break;
@@ -981,8 +1846,8 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
 
         if (VALID_SIZE(TDS_SuplaRegisterDevice_E, TDS_SuplaDeviceChannel_C,
                        channel_count, SUPLA_CHANNELMAXCOUNT)) {
-          rd->data.ds_register_device_e = (TDS_SuplaRegisterDevice_E *)calloc(
-              1, sizeof(TDS_SuplaRegisterDevice_E));
+          rd->data.ds_register_device_e =
+              SRPC_RD_ALLOC(TDS_SuplaRegisterDevice_E);
         }
 
         break;
@@ -991,8 +1856,8 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
 
         if (VALID_SIZE(TDS_SuplaRegisterDevice_F, TDS_SuplaDeviceChannel_D,
                        channel_count, SUPLA_CHANNELMAXCOUNT)) {
-          rd->data.ds_register_device_f = (TDS_SuplaRegisterDevice_F *)calloc(
-              1, sizeof(TDS_SuplaRegisterDevice_F));
+          rd->data.ds_register_device_f =
+              SRPC_RD_ALLOC(TDS_SuplaRegisterDevice_F);
         }
 
         break;
@@ -1001,18 +1866,17 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
 
         if (VALID_SIZE(TDS_SuplaRegisterDevice_G, TDS_SuplaDeviceChannel_E,
                        channel_count, SUPLA_CHANNELMAXCOUNT)) {
-          rd->data.ds_register_device_g = (TDS_SuplaRegisterDevice_G *)calloc(
-              1, sizeof(TDS_SuplaRegisterDevice_G));
+          rd->data.ds_register_device_g =
+              SRPC_RD_ALLOC(TDS_SuplaRegisterDevice_G);
         }
 
         break;
 
       case SUPLA_SD_CALL_REGISTER_DEVICE_RESULT:
 
-        if (srpc->sdp.data_size == sizeof(TSD_SuplaRegisterDeviceResult))
+        if (sdp->data_size == sizeof(TSD_SuplaRegisterDeviceResult))
           rd->data.sd_register_device_result =
-              (TSD_SuplaRegisterDeviceResult *)calloc(
-                  1, sizeof(TSD_SuplaRegisterDeviceResult));
+              SRPC_RD_ALLOC(TSD_SuplaRegisterDeviceResult);
         break;
 
       case SUPLA_SD_CALL_REGISTER_DEVICE_RESULT_B:
@@ -1020,34 +1884,30 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
         if (VALID_SIZE(TSD_SuplaRegisterDeviceResult_B, unsigned char,
                        channel_report_size, CHANNEL_REPORT_MAXSIZE))
           rd->data.sd_register_device_result_b =
-              (TSD_SuplaRegisterDeviceResult_B *)calloc(
-                  1, sizeof(TSD_SuplaRegisterDeviceResult_B));
+              SRPC_RD_ALLOC(TSD_SuplaRegisterDeviceResult_B);
         break;
 
       case SUPLA_DS_CALL_DEVICE_CHANNEL_VALUE_CHANGED:
 
-        if (srpc->sdp.data_size == sizeof(TDS_SuplaDeviceChannelValue))
+        if (sdp->data_size == sizeof(TDS_SuplaDeviceChannelValue))
           rd->data.ds_device_channel_value =
-              (TDS_SuplaDeviceChannelValue *)calloc(
-                  1, sizeof(TDS_SuplaDeviceChannelValue));
+              SRPC_RD_ALLOC(TDS_SuplaDeviceChannelValue);
 
         break;
 
       case SUPLA_DS_CALL_DEVICE_CHANNEL_VALUE_CHANGED_B:
 
-        if (srpc->sdp.data_size == sizeof(TDS_SuplaDeviceChannelValue_B))
+        if (sdp->data_size == sizeof(TDS_SuplaDeviceChannelValue_B))
           rd->data.ds_device_channel_value_b =
-              (TDS_SuplaDeviceChannelValue_B *)calloc(
-                  1, sizeof(TDS_SuplaDeviceChannelValue_B));
+              SRPC_RD_ALLOC(TDS_SuplaDeviceChannelValue_B);
 
         break;
 
       case SUPLA_DS_CALL_DEVICE_CHANNEL_VALUE_CHANGED_C:
 
-        if (srpc->sdp.data_size == sizeof(TDS_SuplaDeviceChannelValue_C))
+        if (sdp->data_size == sizeof(TDS_SuplaDeviceChannelValue_C))
           rd->data.ds_device_channel_value_c =
-              (TDS_SuplaDeviceChannelValue_C *)calloc(
-                  1, sizeof(TDS_SuplaDeviceChannelValue_C));
+              SRPC_RD_ALLOC(TDS_SuplaDeviceChannelValue_C);
 
         break;
 
@@ -1056,55 +1916,50 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
         if (VALID_SIZE(TDS_SuplaDeviceChannelExtendedValue, char, value.size,
                        SUPLA_CHANNELEXTENDEDVALUE_SIZE))
           rd->data.ds_device_channel_extendedvalue =
-              (TDS_SuplaDeviceChannelExtendedValue *)calloc(
-                  1, sizeof(TDS_SuplaDeviceChannelExtendedValue));
+              SRPC_RD_ALLOC(TDS_SuplaDeviceChannelExtendedValue);
 
         break;
 
       case SUPLA_SD_CALL_CHANNEL_SET_VALUE:
 
-        if (srpc->sdp.data_size == sizeof(TSD_SuplaChannelNewValue))
-          rd->data.sd_channel_new_value = (TSD_SuplaChannelNewValue *)calloc(
-              1, sizeof(TSD_SuplaChannelNewValue));
+        if (sdp->data_size == sizeof(TSD_SuplaChannelNewValue))
+          rd->data.sd_channel_new_value =
+              SRPC_RD_ALLOC(TSD_SuplaChannelNewValue);
 
         break;
 
       case SUPLA_SD_CALL_CHANNELGROUP_SET_VALUE:
 
-        if (srpc->sdp.data_size == sizeof(TSD_SuplaChannelGroupNewValue))
+        if (sdp->data_size == sizeof(TSD_SuplaChannelGroupNewValue))
           rd->data.sd_channelgroup_new_value =
-              (TSD_SuplaChannelGroupNewValue *)calloc(
-                  1, sizeof(TSD_SuplaChannelGroupNewValue));
+              SRPC_RD_ALLOC(TSD_SuplaChannelGroupNewValue);
 
         break;
 
       case SUPLA_DS_CALL_CHANNEL_SET_VALUE_RESULT:
 
-        if (srpc->sdp.data_size == sizeof(TDS_SuplaChannelNewValueResult))
+        if (sdp->data_size == sizeof(TDS_SuplaChannelNewValueResult))
           rd->data.ds_channel_new_value_result =
-              (TDS_SuplaChannelNewValueResult *)calloc(
-                  1, sizeof(TDS_SuplaChannelNewValueResult));
+              SRPC_RD_ALLOC(TDS_SuplaChannelNewValueResult);
 
         break;
 
       case SUPLA_DS_CALL_GET_FIRMWARE_UPDATE_URL:
 
-        if (srpc->sdp.data_size == sizeof(TDS_FirmwareUpdateParams))
+        if (sdp->data_size == sizeof(TDS_FirmwareUpdateParams))
           rd->data.ds_firmware_update_params =
-              (TDS_FirmwareUpdateParams *)calloc(
-                  1, sizeof(TDS_FirmwareUpdateParams));
+              SRPC_RD_ALLOC(TDS_FirmwareUpdateParams);
 
         break;
 
       case SUPLA_SD_CALL_GET_FIRMWARE_UPDATE_URL_RESULT:
 
-        if (srpc->sdp.data_size == sizeof(TSD_FirmwareUpdate_UrlResult) ||
-            srpc->sdp.data_size == sizeof(char)) {
+        if (sdp->data_size == sizeof(TSD_FirmwareUpdate_UrlResult) ||
+            sdp->data_size == sizeof(char)) {
           rd->data.sc_firmware_update_url_result =
-              (TSD_FirmwareUpdate_UrlResult *)calloc(
-                  1, sizeof(TSD_FirmwareUpdate_UrlResult));
+              SRPC_RD_ALLOC(TSD_FirmwareUpdate_UrlResult);
 
-          if (srpc->sdp.data_size == sizeof(char) &&
+          if (sdp->data_size == sizeof(char) &&
               rd->data.sc_firmware_update_url_result != NULL)
             memset(rd->data.sc_firmware_update_url_result, 0,
                    sizeof(TSD_FirmwareUpdate_UrlResult));
@@ -1113,15 +1968,15 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
       case SUPLA_SD_CALL_DEVICE_CALCFG_REQUEST:
         if (VALID_SIZE(TSD_DeviceCalCfgRequest, char, DataSize,
                        SUPLA_CALCFG_DATA_MAXSIZE)) {
-          rd->data.sd_device_calcfg_request = (TSD_DeviceCalCfgRequest *)calloc(
-              1, sizeof(TSD_DeviceCalCfgRequest));
+          rd->data.sd_device_calcfg_request =
+              SRPC_RD_ALLOC(TSD_DeviceCalCfgRequest);
         }
         break;
       case SUPLA_DS_CALL_DEVICE_CALCFG_RESULT:
         if (VALID_SIZE(TDS_DeviceCalCfgResult, char, DataSize,
                        SUPLA_CALCFG_DATA_MAXSIZE)) {
-          rd->data.ds_device_calcfg_result = (TDS_DeviceCalCfgResult *)calloc(
-              1, sizeof(TDS_DeviceCalCfgResult));
+          rd->data.ds_device_calcfg_result =
+              SRPC_RD_ALLOC(TDS_DeviceCalCfgResult);
         }
         break;
       case SUPLA_DS_CALL_GET_CHANNEL_FUNCTIONS:
@@ -1130,44 +1985,38 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
       case SUPLA_SD_CALL_GET_CHANNEL_FUNCTIONS_RESULT:
         if (VALID_SIZE(TSD_ChannelFunctions, _supla_int_t, ChannelCount,
                        SUPLA_CHANNELMAXCOUNT)) {
-          rd->data.sd_channel_functions =
-              (TSD_ChannelFunctions *)calloc(1, sizeof(TSD_ChannelFunctions));
+          rd->data.sd_channel_functions = SRPC_RD_ALLOC(TSD_ChannelFunctions);
         }
         break;
       case SUPLA_DS_CALL_GET_CHANNEL_CONFIG:
-        if (srpc->sdp.data_size == sizeof(TDS_GetChannelConfigRequest)) {
+        if (sdp->data_size == sizeof(TDS_GetChannelConfigRequest)) {
           rd->data.ds_get_channel_config_request =
-              (TDS_GetChannelConfigRequest *)calloc(
-                  1, sizeof(TDS_GetChannelConfigRequest));
+              SRPC_RD_ALLOC(TDS_GetChannelConfigRequest);
         }
         break;
       case SUPLA_SD_CALL_GET_CHANNEL_CONFIG_RESULT:
         if (VALID_SIZE(TSD_ChannelConfig, char, ConfigSize,
                        SUPLA_CHANNEL_CONFIG_MAXSIZE)) {
-          rd->data.sd_channel_config =
-              (TSD_ChannelConfig *)calloc(1, sizeof(TSD_ChannelConfig));
+          rd->data.sd_channel_config = SRPC_RD_ALLOC(TSD_ChannelConfig);
         }
         break;
       case SUPLA_DS_CALL_ACTIONTRIGGER:
-        if (srpc->sdp.data_size == sizeof(TDS_ActionTrigger)) {
-          rd->data.ds_action_trigger =
-              (TDS_ActionTrigger *)calloc(1, sizeof(TDS_ActionTrigger));
+        if (sdp->data_size == sizeof(TDS_ActionTrigger)) {
+          rd->data.ds_action_trigger = SRPC_RD_ALLOC(TDS_ActionTrigger);
         }
         break;
       case SUPLA_DS_CALL_REGISTER_PUSH_NOTIFICATION:
-        if (srpc->sdp.data_size == sizeof(TDS_RegisterPushNotification)) {
+        if (sdp->data_size == sizeof(TDS_RegisterPushNotification)) {
           rd->data.ds_register_push_notification =
-              (TDS_RegisterPushNotification *)calloc(
-                  1, sizeof(TDS_RegisterPushNotification));
+              SRPC_RD_ALLOC(TDS_RegisterPushNotification);
         }
         break;
       case SUPLA_DS_CALL_SEND_PUSH_NOTIFICATION:
         if (VALID_SIZE(
                 TDS_PushNotification, char,
-                TitleSize + ((TDS_PushNotification *)srpc->sdp.data)->BodySize,
+                TitleSize + ((TDS_PushNotification *)sdp->data)->BodySize,
                 (SUPLA_PN_TITLE_MAXSIZE + SUPLA_PN_BODY_MAXSIZE))) {
-          rd->data.ds_push_notification =
-              (TDS_PushNotification *)calloc(1, sizeof(TDS_PushNotification));
+          rd->data.ds_push_notification = SRPC_RD_ALLOC(TDS_PushNotification);
         }
         break;
       case SUPLA_DS_CALL_SET_CHANNEL_CONFIG:
@@ -1175,22 +2024,20 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
         if (VALID_SIZE(TSDS_SetChannelConfig, char, ConfigSize,
                        SUPLA_CHANNEL_CONFIG_MAXSIZE)) {
           rd->data.sds_set_channel_config_request =
-              (TSDS_SetChannelConfig *)malloc(sizeof(TSDS_SetChannelConfig));
+              SRPC_RD_ALLOC(TSDS_SetChannelConfig);
         }
         break;
       case SUPLA_DS_CALL_SET_CHANNEL_CONFIG_RESULT:
       case SUPLA_SD_CALL_SET_CHANNEL_CONFIG_RESULT:
-        if (srpc->sdp.data_size == sizeof(TSDS_SetChannelConfigResult)) {
+        if (sdp->data_size == sizeof(TSDS_SetChannelConfigResult)) {
           rd->data.sds_set_channel_config_result =
-              (TSDS_SetChannelConfigResult *)malloc(
-                  sizeof(TSDS_SetChannelConfigResult));
+              SRPC_RD_ALLOC(TSDS_SetChannelConfigResult);
         }
         break;
       case SUPLA_SD_CALL_CHANNEL_CONFIG_FINISHED:
-        if (srpc->sdp.data_size == sizeof(TSD_ChannelConfigFinished)) {
+        if (sdp->data_size == sizeof(TSD_ChannelConfigFinished)) {
           rd->data.sd_channel_config_finished =
-              (TSD_ChannelConfigFinished *)malloc(
-                  sizeof(TSD_ChannelConfigFinished));
+              SRPC_RD_ALLOC(TSD_ChannelConfigFinished);
         }
         break;
       case SUPLA_DS_CALL_SET_DEVICE_CONFIG:
@@ -1198,21 +2045,19 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
         if (VALID_SIZE(TSDS_SetDeviceConfig, char, ConfigSize,
                        SUPLA_DEVICE_CONFIG_MAXSIZE)) {
           rd->data.sds_set_device_config_request =
-              (TSDS_SetDeviceConfig *)malloc(sizeof(TSDS_SetDeviceConfig));
+              SRPC_RD_ALLOC(TSDS_SetDeviceConfig);
         }
         break;
       case SUPLA_SD_CALL_SET_DEVICE_CONFIG_RESULT:
       case SUPLA_DS_CALL_SET_DEVICE_CONFIG_RESULT:
-        if (srpc->sdp.data_size == sizeof(TSDS_SetDeviceConfigResult)) {
+        if (sdp->data_size == sizeof(TSDS_SetDeviceConfigResult)) {
           rd->data.sds_set_device_config_result =
-              (TSDS_SetDeviceConfigResult *)malloc(
-                  sizeof(TSDS_SetDeviceConfigResult));
+              SRPC_RD_ALLOC(TSDS_SetDeviceConfigResult);
         }
         break;
       case SUPLA_DS_CALL_SET_SUBDEVICE_DETAILS:
-        if (srpc->sdp.data_size == sizeof(TDS_SubdeviceDetails)) {
-          rd->data.ds_subdevice_details =
-              (TDS_SubdeviceDetails *)malloc(sizeof(TDS_SubdeviceDetails));
+        if (sdp->data_size == sizeof(TDS_SubdeviceDetails)) {
+          rd->data.ds_subdevice_details = SRPC_RD_ALLOC(TDS_SubdeviceDetails);
         }
         break;
 #endif /*#ifndef SRPC_EXCLUDE_DEVICE*/
@@ -1220,69 +2065,64 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
 #ifndef SRPC_EXCLUDE_CLIENT
       case SUPLA_CS_CALL_REGISTER_CLIENT:
 
-        if (srpc->sdp.data_size == sizeof(TCS_SuplaRegisterClient))
-          rd->data.cs_register_client = (TCS_SuplaRegisterClient *)calloc(
-              1, sizeof(TCS_SuplaRegisterClient));
+        if (sdp->data_size == sizeof(TCS_SuplaRegisterClient))
+          rd->data.cs_register_client = SRPC_RD_ALLOC(TCS_SuplaRegisterClient);
 
         break;
 
       case SUPLA_CS_CALL_REGISTER_CLIENT_B:  // ver. >= 6
 
-        if (srpc->sdp.data_size == sizeof(TCS_SuplaRegisterClient_B))
-          rd->data.cs_register_client_b = (TCS_SuplaRegisterClient_B *)calloc(
-              1, sizeof(TCS_SuplaRegisterClient_B));
+        if (sdp->data_size == sizeof(TCS_SuplaRegisterClient_B))
+          rd->data.cs_register_client_b =
+              SRPC_RD_ALLOC(TCS_SuplaRegisterClient_B);
 
         break;
 
       case SUPLA_CS_CALL_REGISTER_CLIENT_C:  // ver. >= 7
 
-        if (srpc->sdp.data_size == sizeof(TCS_SuplaRegisterClient_C))
-          rd->data.cs_register_client_c = (TCS_SuplaRegisterClient_C *)calloc(
-              1, sizeof(TCS_SuplaRegisterClient_C));
+        if (sdp->data_size == sizeof(TCS_SuplaRegisterClient_C))
+          rd->data.cs_register_client_c =
+              SRPC_RD_ALLOC(TCS_SuplaRegisterClient_C);
 
         break;
 
       case SUPLA_CS_CALL_REGISTER_CLIENT_D:  // ver. >= 12
 
-        if (srpc->sdp.data_size == sizeof(TCS_SuplaRegisterClient_D))
-          rd->data.cs_register_client_d = (TCS_SuplaRegisterClient_D *)calloc(
-              1, sizeof(TCS_SuplaRegisterClient_D));
+        if (sdp->data_size == sizeof(TCS_SuplaRegisterClient_D))
+          rd->data.cs_register_client_d =
+              SRPC_RD_ALLOC(TCS_SuplaRegisterClient_D);
 
         break;
 
       case SUPLA_SC_CALL_REGISTER_CLIENT_RESULT:
 
-        if (srpc->sdp.data_size == sizeof(TSC_SuplaRegisterClientResult))
+        if (sdp->data_size == sizeof(TSC_SuplaRegisterClientResult))
           rd->data.sc_register_client_result =
-              (TSC_SuplaRegisterClientResult *)calloc(
-                  1, sizeof(TSC_SuplaRegisterClientResult));
+              SRPC_RD_ALLOC(TSC_SuplaRegisterClientResult);
 
         break;
 
       case SUPLA_SC_CALL_REGISTER_CLIENT_RESULT_B:
 
-        if (srpc->sdp.data_size == sizeof(TSC_SuplaRegisterClientResult_B))
+        if (sdp->data_size == sizeof(TSC_SuplaRegisterClientResult_B))
           rd->data.sc_register_client_result_b =
-              (TSC_SuplaRegisterClientResult_B *)calloc(
-                  1, sizeof(TSC_SuplaRegisterClientResult_B));
+              SRPC_RD_ALLOC(TSC_SuplaRegisterClientResult_B);
 
         break;
 
       case SUPLA_SC_CALL_REGISTER_CLIENT_RESULT_C:
 
-        if (srpc->sdp.data_size == sizeof(TSC_SuplaRegisterClientResult_C))
+        if (sdp->data_size == sizeof(TSC_SuplaRegisterClientResult_C))
           rd->data.sc_register_client_result_c =
-              (TSC_SuplaRegisterClientResult_C *)calloc(
-                  1, sizeof(TSC_SuplaRegisterClientResult_C));
+              SRPC_RD_ALLOC(TSC_SuplaRegisterClientResult_C);
 
         break;
 
       case SUPLA_SC_CALL_REGISTER_CLIENT_RESULT_D:
 
-        if (srpc->sdp.data_size == sizeof(TSC_SuplaRegisterClientResult_D))
+        if (sdp->data_size == sizeof(TSC_SuplaRegisterClientResult_D))
           rd->data.sc_register_client_result_d =
-              (TSC_SuplaRegisterClientResult_D *)calloc(
-                  1, sizeof(TSC_SuplaRegisterClientResult_D));
+              SRPC_RD_ALLOC(TSC_SuplaRegisterClientResult_D);
 
         break;
 
@@ -1290,58 +2130,55 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
 
         if (VALID_SIZE(TSC_SuplaLocation, char, CaptionSize,
                        SUPLA_LOCATION_CAPTION_MAXSIZE)) {
-          rd->data.sc_location =
-              (TSC_SuplaLocation *)calloc(1, sizeof(TSC_SuplaLocation));
+          rd->data.sc_location = SRPC_RD_ALLOC(TSC_SuplaLocation);
         }
 
         break;
 
       case SUPLA_SC_CALL_LOCATIONPACK_UPDATE:
-        srpc_getlocationpack(srpc, rd);
+        srpc_getlocationpack(sdp, rd);
         break;
 
       case SUPLA_SC_CALL_CHANNELPACK_UPDATE:
-        srpc_getchannelpack(srpc, rd);
+        srpc_getchannelpack(sdp, rd);
         break;
 
       case SUPLA_SC_CALL_CHANNELPACK_UPDATE_B:
-        srpc_getchannelpack_b(srpc, rd);
+        srpc_getchannelpack_b(sdp, rd);
         break;
 
       case SUPLA_SC_CALL_CHANNELPACK_UPDATE_C:
-        srpc_getchannelpack_c(srpc, rd);
+        srpc_getchannelpack_c(sdp, rd);
         break;
 
       case SUPLA_SC_CALL_CHANNELPACK_UPDATE_D:
-        srpc_getchannelpack_d(srpc, rd);
+        srpc_getchannelpack_d(sdp, rd);
         break;
 
       case SUPLA_SC_CALL_CHANNELPACK_UPDATE_E:
-        srpc_getchannelpack_e(srpc, rd);
+        srpc_getchannelpack_e(sdp, rd);
         break;
 
       case SUPLA_SC_CALL_CHANNEL_VALUE_UPDATE:
 
-        if (srpc->sdp.data_size == sizeof(TSC_SuplaChannelValue))
-          rd->data.sc_channel_value =
-              (TSC_SuplaChannelValue *)calloc(1, sizeof(TSC_SuplaChannelValue));
+        if (sdp->data_size == sizeof(TSC_SuplaChannelValue))
+          rd->data.sc_channel_value = SRPC_RD_ALLOC(TSC_SuplaChannelValue);
 
         break;
 
       case SUPLA_SC_CALL_CHANNEL_VALUE_UPDATE_B:
 
-        if (srpc->sdp.data_size == sizeof(TSC_SuplaChannelValue_B))
-          rd->data.sc_channel_value_b = (TSC_SuplaChannelValue_B *)calloc(
-              1, sizeof(TSC_SuplaChannelValue_B));
+        if (sdp->data_size == sizeof(TSC_SuplaChannelValue_B))
+          rd->data.sc_channel_value_b = SRPC_RD_ALLOC(TSC_SuplaChannelValue_B);
 
         break;
 
       case SUPLA_SC_CALL_CHANNELGROUP_PACK_UPDATE:
-        srpc_getchannelgroup_pack(srpc, rd);
+        srpc_getchannelgroup_pack(sdp, rd);
         break;
 
       case SUPLA_SC_CALL_CHANNELGROUP_PACK_UPDATE_B:
-        srpc_getchannelgroup_pack_b(srpc, rd);
+        srpc_getchannelgroup_pack_b(sdp, rd);
         break;
 
       case SUPLA_SC_CALL_CHANNELGROUP_RELATION_PACK_UPDATE:
@@ -1349,8 +2186,7 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
                        TSC_SuplaChannelGroupRelation, count,
                        SUPLA_CHANNELGROUP_RELATION_PACK_MAXCOUNT)) {
           rd->data.sc_channelgroup_relation_pack =
-              (TSC_SuplaChannelGroupRelationPack *)calloc(
-                  1, sizeof(TSC_SuplaChannelGroupRelationPack));
+              SRPC_RD_ALLOC(TSC_SuplaChannelGroupRelationPack);
         }
         break;
 
@@ -1358,17 +2194,16 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
         if (VALID_SIZE(TSC_SuplaChannelRelationPack, TSC_SuplaChannelRelation,
                        count, SUPLA_CHANNEL_RELATION_PACK_MAXCOUNT)) {
           rd->data.sc_channel_relation_pack =
-              (TSC_SuplaChannelRelationPack *)calloc(
-                  1, sizeof(TSC_SuplaChannelRelationPack));
+              SRPC_RD_ALLOC(TSC_SuplaChannelRelationPack);
         }
         break;
 
       case SUPLA_SC_CALL_CHANNELVALUE_PACK_UPDATE:
         if (VALID_SIZE(TSC_SuplaChannelValuePack, TSC_SuplaChannelValue, count,
                        SUPLA_CHANNELVALUE_PACK_MAXCOUNT) &&
-            srpc->sdp.data_size <= sizeof(TSC_SuplaChannelValuePack)) {
-          rd->data.sc_channelvalue_pack = (TSC_SuplaChannelValuePack *)calloc(
-              1, sizeof(TSC_SuplaChannelValuePack));
+            sdp->data_size <= sizeof(TSC_SuplaChannelValuePack)) {
+          rd->data.sc_channelvalue_pack =
+              SRPC_RD_ALLOC(TSC_SuplaChannelValuePack);
         }
         break;
 
@@ -1376,8 +2211,7 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
         if (VALID_SIZE(TSC_SuplaChannelValuePack_B, TSC_SuplaChannelValue_B,
                        count, SUPLA_CHANNELVALUE_PACK_MAXCOUNT)) {
           rd->data.sc_channelvalue_pack_b =
-              (TSC_SuplaChannelValuePack_B *)calloc(
-                  1, sizeof(TSC_SuplaChannelValuePack_B));
+              SRPC_RD_ALLOC(TSC_SuplaChannelValuePack_B);
         }
         break;
 
@@ -1385,41 +2219,38 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
         if (VALID_SIZE(TSC_SuplaChannelExtendedValuePack, char, pack_size,
                        SUPLA_CHANNELEXTENDEDVALUE_PACK_MAXDATASIZE)) {
           rd->data.sc_channelextendedvalue_pack =
-              (TSC_SuplaChannelExtendedValuePack *)calloc(
-                  1, sizeof(TSC_SuplaChannelExtendedValuePack));
+              SRPC_RD_ALLOC(TSC_SuplaChannelExtendedValuePack);
         }
         break;
 
       case SUPLA_SC_CALL_CHANNEL_STATE_PACK_UPDATE:
         if (VALID_SIZE(TSC_SuplaChannelStatePack, TDSC_ChannelState, count,
                        SUPLA_CHANNEL_STATE_PACK_MAXCOUNT)) {
-          rd->data.sc_channel_state_pack = (TSC_SuplaChannelStatePack *)calloc(
-              1, sizeof(TSC_SuplaChannelStatePack));
+          rd->data.sc_channel_state_pack =
+              SRPC_RD_ALLOC(TSC_SuplaChannelStatePack);
         }
         break;
 
       case SUPLA_CS_CALL_CHANNEL_SET_VALUE:
 
-        if (srpc->sdp.data_size == sizeof(TCS_SuplaChannelNewValue))
-          rd->data.cs_channel_new_value = (TCS_SuplaChannelNewValue *)calloc(
-              1, sizeof(TCS_SuplaChannelNewValue));
+        if (sdp->data_size == sizeof(TCS_SuplaChannelNewValue))
+          rd->data.cs_channel_new_value =
+              SRPC_RD_ALLOC(TCS_SuplaChannelNewValue);
 
         break;
 
       case SUPLA_CS_CALL_SET_VALUE:
 
-        if (srpc->sdp.data_size == sizeof(TCS_SuplaNewValue))
-          rd->data.cs_new_value =
-              (TCS_SuplaNewValue *)calloc(1, sizeof(TCS_SuplaNewValue));
+        if (sdp->data_size == sizeof(TCS_SuplaNewValue))
+          rd->data.cs_new_value = SRPC_RD_ALLOC(TCS_SuplaNewValue);
 
         break;
 
       case SUPLA_CS_CALL_CHANNEL_SET_VALUE_B:
 
-        if (srpc->sdp.data_size == sizeof(TCS_SuplaChannelNewValue_B))
+        if (sdp->data_size == sizeof(TCS_SuplaChannelNewValue_B))
           rd->data.cs_channel_new_value_b =
-              (TCS_SuplaChannelNewValue_B *)calloc(
-                  1, sizeof(TCS_SuplaChannelNewValue_B));
+              SRPC_RD_ALLOC(TCS_SuplaChannelNewValue_B);
 
         break;
 
@@ -1427,8 +2258,7 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
 
         if (VALID_SIZE(TSC_SuplaEvent, char, SenderNameSize,
                        SUPLA_SENDER_NAME_MAXSIZE)) {
-          rd->data.sc_event =
-              (TSC_SuplaEvent *)calloc(1, sizeof(TSC_SuplaEvent));
+          rd->data.sc_event = SRPC_RD_ALLOC(TSC_SuplaEvent);
         }
 
         break;
@@ -1441,72 +2271,65 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
         if (VALID_SIZE(TSC_OAuthTokenRequestResult, char, Token.TokenSize,
                        SUPLA_OAUTH_TOKEN_MAXSIZE)) {
           rd->data.sc_oauth_tokenrequest_result =
-              (TSC_OAuthTokenRequestResult *)calloc(
-                  1, sizeof(TSC_OAuthTokenRequestResult));
+              SRPC_RD_ALLOC(TSC_OAuthTokenRequestResult);
         }
         break;
       case SUPLA_CS_CALL_SUPERUSER_AUTHORIZATION_REQUEST:
-        if (srpc->sdp.data_size == sizeof(TCS_SuperUserAuthorizationRequest))
+        if (sdp->data_size == sizeof(TCS_SuperUserAuthorizationRequest))
           rd->data.cs_superuser_authorization_request =
-              (TCS_SuperUserAuthorizationRequest *)calloc(
-                  1, sizeof(TCS_SuperUserAuthorizationRequest));
+              SRPC_RD_ALLOC(TCS_SuperUserAuthorizationRequest);
         break;
       case SUPLA_CS_CALL_GET_SUPERUSER_AUTHORIZATION_RESULT:
         call_with_no_data = 1;
         break;
       case SUPLA_SC_CALL_SUPERUSER_AUTHORIZATION_RESULT:
-        if (srpc->sdp.data_size == sizeof(TSC_SuperUserAuthorizationResult))
+        if (sdp->data_size == sizeof(TSC_SuperUserAuthorizationResult))
           rd->data.sc_superuser_authorization_result =
-              (TSC_SuperUserAuthorizationResult *)calloc(
-                  1, sizeof(TSC_SuperUserAuthorizationResult));
+              SRPC_RD_ALLOC(TSC_SuperUserAuthorizationResult);
         break;
       case SUPLA_CS_CALL_DEVICE_CALCFG_REQUEST:
         if (VALID_SIZE(TCS_DeviceCalCfgRequest, char, DataSize,
                        SUPLA_CALCFG_DATA_MAXSIZE)) {
-          rd->data.cs_device_calcfg_request = (TCS_DeviceCalCfgRequest *)calloc(
-              1, sizeof(TCS_DeviceCalCfgRequest));
+          rd->data.cs_device_calcfg_request =
+              SRPC_RD_ALLOC(TCS_DeviceCalCfgRequest);
         }
         break;
       case SUPLA_CS_CALL_DEVICE_CALCFG_REQUEST_B:
         if (VALID_SIZE(TCS_DeviceCalCfgRequest_B, char, DataSize,
                        SUPLA_CALCFG_DATA_MAXSIZE)) {
           rd->data.cs_device_calcfg_request_b =
-              (TCS_DeviceCalCfgRequest_B *)calloc(
-                  1, sizeof(TCS_DeviceCalCfgRequest_B));
+              SRPC_RD_ALLOC(TCS_DeviceCalCfgRequest_B);
         }
         break;
       case SUPLA_SC_CALL_DEVICE_CALCFG_RESULT:
         if (VALID_SIZE(TSC_DeviceCalCfgResult, char, DataSize,
                        SUPLA_CALCFG_DATA_MAXSIZE)) {
-          rd->data.sc_device_calcfg_result = (TSC_DeviceCalCfgResult *)calloc(
-              1, sizeof(TSC_DeviceCalCfgResult));
+          rd->data.sc_device_calcfg_result =
+              SRPC_RD_ALLOC(TSC_DeviceCalCfgResult);
         }
         break;
 
       case SUPLA_CS_CALL_GET_CHANNEL_BASIC_CFG:
-        if (srpc->sdp.data_size == sizeof(TCS_ChannelBasicCfgRequest))
+        if (sdp->data_size == sizeof(TCS_ChannelBasicCfgRequest))
           rd->data.cs_channel_basic_cfg_request =
-              (TCS_ChannelBasicCfgRequest *)calloc(
-                  1, sizeof(TCS_ChannelBasicCfgRequest));
+              SRPC_RD_ALLOC(TCS_ChannelBasicCfgRequest);
         break;
       case SUPLA_SC_CALL_CHANNEL_BASIC_CFG_RESULT:
         if (VALID_SIZE(TSC_ChannelBasicCfg, char, CaptionSize,
                        SUPLA_CHANNEL_CAPTION_MAXSIZE))
-          rd->data.sc_channel_basic_cfg =
-              (TSC_ChannelBasicCfg *)calloc(1, sizeof(TSC_ChannelBasicCfg));
+          rd->data.sc_channel_basic_cfg = SRPC_RD_ALLOC(TSC_ChannelBasicCfg);
         break;
 
       case SUPLA_CS_CALL_SET_CHANNEL_FUNCTION:
-        if (srpc->sdp.data_size == sizeof(TCS_SetChannelFunction))
-          rd->data.cs_set_channel_function = (TCS_SetChannelFunction *)calloc(
-              1, sizeof(TCS_SetChannelFunction));
+        if (sdp->data_size == sizeof(TCS_SetChannelFunction))
+          rd->data.cs_set_channel_function =
+              SRPC_RD_ALLOC(TCS_SetChannelFunction);
         break;
 
       case SUPLA_SC_CALL_SET_CHANNEL_FUNCTION_RESULT:
-        if (srpc->sdp.data_size == sizeof(TSC_SetChannelFunctionResult))
+        if (sdp->data_size == sizeof(TSC_SetChannelFunctionResult))
           rd->data.sc_set_channel_function_result =
-              (TSC_SetChannelFunctionResult *)calloc(
-                  1, sizeof(TSC_SetChannelFunctionResult));
+              SRPC_RD_ALLOC(TSC_SetChannelFunctionResult);
         break;
 
       case SUPLA_DCS_CALL_SET_CHANNEL_CAPTION:
@@ -1515,8 +2338,7 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
       case SUPLA_CS_CALL_SET_SCENE_CAPTION:
         if (VALID_SIZE(TDCS_SetCaption, char, CaptionSize,
                        SUPLA_CAPTION_MAXSIZE))
-          rd->data.dcs_set_caption =
-              (TDCS_SetCaption *)calloc(1, sizeof(TDCS_SetCaption));
+          rd->data.dcs_set_caption = SRPC_RD_ALLOC(TDCS_SetCaption);
         break;
 
       case SUPLA_SC_CALL_SET_CHANNEL_GROUP_CAPTION_RESULT:
@@ -1525,7 +2347,7 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
         if (VALID_SIZE(TSCD_SetCaptionResult, char, CaptionSize,
                        SUPLA_CAPTION_MAXSIZE))
           rd->data.scd_set_caption_result =
-              (TSCD_SetCaptionResult *)calloc(1, sizeof(TSCD_SetCaptionResult));
+              SRPC_RD_ALLOC(TSCD_SetCaptionResult);
         break;
 
       case SUPLA_CS_CALL_CLIENTS_RECONNECT_REQUEST:
@@ -1533,140 +2355,124 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
         break;
 
       case SUPLA_SC_CALL_CLIENTS_RECONNECT_REQUEST_RESULT:
-        if (srpc->sdp.data_size == sizeof(TSC_ClientsReconnectRequestResult))
+        if (sdp->data_size == sizeof(TSC_ClientsReconnectRequestResult))
           rd->data.sc_clients_reconnect_result =
-              (TSC_ClientsReconnectRequestResult *)calloc(
-                  1, sizeof(TSC_ClientsReconnectRequestResult));
+              SRPC_RD_ALLOC(TSC_ClientsReconnectRequestResult);
         break;
 
       case SUPLA_CS_CALL_SET_REGISTRATION_ENABLED:
-        if (srpc->sdp.data_size == sizeof(TCS_SetRegistrationEnabled))
+        if (sdp->data_size == sizeof(TCS_SetRegistrationEnabled))
           rd->data.cs_set_registration_enabled =
-              (TCS_SetRegistrationEnabled *)calloc(
-                  1, sizeof(TCS_SetRegistrationEnabled));
+              SRPC_RD_ALLOC(TCS_SetRegistrationEnabled);
         break;
 
       case SUPLA_SC_CALL_SET_REGISTRATION_ENABLED_RESULT:
-        if (srpc->sdp.data_size == sizeof(TSC_SetRegistrationEnabledResult))
+        if (sdp->data_size == sizeof(TSC_SetRegistrationEnabledResult))
           rd->data.sc_set_registration_enabled_result =
-              (TSC_SetRegistrationEnabledResult *)calloc(
-                  1, sizeof(TSC_SetRegistrationEnabledResult));
+              SRPC_RD_ALLOC(TSC_SetRegistrationEnabledResult);
         break;
 
       case SUPLA_CS_CALL_DEVICE_RECONNECT_REQUEST:
-        if (srpc->sdp.data_size == sizeof(TCS_DeviceReconnectRequest))
+        if (sdp->data_size == sizeof(TCS_DeviceReconnectRequest))
           rd->data.cs_device_reconnect_request =
-              (TCS_DeviceReconnectRequest *)calloc(
-                  1, sizeof(TCS_DeviceReconnectRequest));
+              SRPC_RD_ALLOC(TCS_DeviceReconnectRequest);
         break;
       case SUPLA_SC_CALL_DEVICE_RECONNECT_REQUEST_RESULT:
-        if (srpc->sdp.data_size == sizeof(TSC_DeviceReconnectRequestResult))
+        if (sdp->data_size == sizeof(TSC_DeviceReconnectRequestResult))
           rd->data.sc_device_reconnect_request_result =
-              (TSC_DeviceReconnectRequestResult *)calloc(
-                  1, sizeof(TSC_DeviceReconnectRequestResult));
+              SRPC_RD_ALLOC(TSC_DeviceReconnectRequestResult);
         break;
 
       case SUPLA_CS_CALL_TIMER_ARM:
-        if (srpc->sdp.data_size == sizeof(TCS_TimerArmRequest))
-          rd->data.cs_timer_arm_request =
-              (TCS_TimerArmRequest *)calloc(1, sizeof(TCS_TimerArmRequest));
+        if (sdp->data_size == sizeof(TCS_TimerArmRequest))
+          rd->data.cs_timer_arm_request = SRPC_RD_ALLOC(TCS_TimerArmRequest);
         break;
 
       case SUPLA_SC_CALL_SCENE_PACK_UPDATE:
-        srpc_get_scene_pack(srpc, rd);
+        srpc_get_scene_pack(sdp, rd);
         break;
 
       case SUPLA_SC_CALL_SCENE_STATE_PACK_UPDATE:
-        srpc_get_scene_state_pack(srpc, rd);
+        srpc_get_scene_state_pack(sdp, rd);
         break;
 
       case SUPLA_CS_CALL_EXECUTE_ACTION:
         if (VALID_SIZE(TCS_Action, char, ParamSize,
                        SUPLA_ACTION_PARAM_MAXSIZE)) {
-          rd->data.cs_action = (TCS_Action *)calloc(1, sizeof(TCS_Action));
+          rd->data.cs_action = SRPC_RD_ALLOC(TCS_Action);
         }
         break;
 
       case SUPLA_CS_CALL_EXECUTE_ACTION_WITH_AUTH:
         if (VALID_SIZE(TCS_ActionWithAuth, char, Action.ParamSize,
                        SUPLA_ACTION_PARAM_MAXSIZE)) {
-          rd->data.cs_action_with_auth =
-              (TCS_ActionWithAuth *)calloc(1, sizeof(TCS_ActionWithAuth));
+          rd->data.cs_action_with_auth = SRPC_RD_ALLOC(TCS_ActionWithAuth);
         }
         break;
 
       case SUPLA_SC_CALL_ACTION_EXECUTION_RESULT:
-        if (srpc->sdp.data_size == sizeof(TSC_ActionExecutionResult))
+        if (sdp->data_size == sizeof(TSC_ActionExecutionResult))
           rd->data.sc_action_execution_result =
-              (TSC_ActionExecutionResult *)calloc(
-                  1, sizeof(TSC_ActionExecutionResult));
+              SRPC_RD_ALLOC(TSC_ActionExecutionResult);
         break;
 
       case SUPLA_CS_CALL_GET_CHANNEL_VALUE_WITH_AUTH:
-        if (srpc->sdp.data_size == sizeof(TCS_GetChannelValueWithAuth)) {
+        if (sdp->data_size == sizeof(TCS_GetChannelValueWithAuth)) {
           rd->data.cs_get_value_with_auth =
-              (TCS_GetChannelValueWithAuth *)calloc(
-                  1, sizeof(TCS_GetChannelValueWithAuth));
+              SRPC_RD_ALLOC(TCS_GetChannelValueWithAuth);
         }
         break;
 
       case SUPLA_SC_CALL_GET_CHANNEL_VALUE_RESULT:
         if (VALID_SIZE(TSC_GetChannelValueResult, char, ExtendedValue.size,
                        SUPLA_CHANNELEXTENDEDVALUE_SIZE)) {
-          rd->data.sc_get_value_result = (TSC_GetChannelValueResult *)calloc(
-              1, sizeof(TSC_GetChannelValueResult));
+          rd->data.sc_get_value_result =
+              SRPC_RD_ALLOC(TSC_GetChannelValueResult);
         }
         break;
       case SUPLA_CS_CALL_REGISTER_PN_CLIENT_TOKEN:
         if (VALID_SIZE(TCS_RegisterPnClientToken, char, Token.TokenSize,
                        SUPLA_PN_CLIENT_TOKEN_MAXSIZE)) {
           rd->data.cs_register_pn_client_token =
-              (TCS_RegisterPnClientToken *)calloc(
-                  1, sizeof(TCS_RegisterPnClientToken));
+              SRPC_RD_ALLOC(TCS_RegisterPnClientToken);
         }
         break;
       case SUPLA_SC_CALL_REGISTER_PN_CLIENT_TOKEN_RESULT:
-        if (srpc->sdp.data_size == sizeof(TSC_RegisterPnClientTokenResult)) {
+        if (sdp->data_size == sizeof(TSC_RegisterPnClientTokenResult)) {
           rd->data.sc_register_pn_client_token_result =
-              (TSC_RegisterPnClientTokenResult *)calloc(
-                  1, sizeof(TSC_RegisterPnClientTokenResult));
+              SRPC_RD_ALLOC(TSC_RegisterPnClientTokenResult);
         }
         break;
       case SUPLA_CS_CALL_SET_CHANNEL_CONFIG:
         if (VALID_SIZE(TSCS_ChannelConfig, char, ConfigSize,
                        SUPLA_CHANNEL_CONFIG_MAXSIZE)) {
-          rd->data.scs_channel_config =
-              (TSCS_ChannelConfig *)malloc(sizeof(TSCS_ChannelConfig));
+          rd->data.scs_channel_config = SRPC_RD_ALLOC(TSCS_ChannelConfig);
         }
         break;
       case SUPLA_CS_CALL_GET_CHANNEL_CONFIG:
-        if (srpc->sdp.data_size == sizeof(TCS_GetChannelConfigRequest)) {
+        if (sdp->data_size == sizeof(TCS_GetChannelConfigRequest)) {
           rd->data.cs_get_channel_config_request =
-              (TCS_GetChannelConfigRequest *)calloc(
-                  1, sizeof(TCS_GetChannelConfigRequest));
+              SRPC_RD_ALLOC(TCS_GetChannelConfigRequest);
         }
         break;
       case SUPLA_SC_CALL_CHANNEL_CONFIG_UPDATE_OR_RESULT:
         if (VALID_SIZE(TSC_ChannelConfigUpdateOrResult, char, Config.ConfigSize,
                        SUPLA_CHANNEL_CONFIG_MAXSIZE)) {
           rd->data.sc_channel_config_update_or_result =
-              (TSC_ChannelConfigUpdateOrResult *)calloc(
-                  1, sizeof(TSC_ChannelConfigUpdateOrResult));
+              SRPC_RD_ALLOC(TSC_ChannelConfigUpdateOrResult);
         }
         break;
       case SUPLA_CS_CALL_GET_DEVICE_CONFIG:
-        if (srpc->sdp.data_size == sizeof(TCS_GetDeviceConfigRequest)) {
+        if (sdp->data_size == sizeof(TCS_GetDeviceConfigRequest)) {
           rd->data.cs_get_device_config_request =
-              (TCS_GetDeviceConfigRequest *)malloc(
-                  sizeof(TCS_GetDeviceConfigRequest));
+              SRPC_RD_ALLOC(TCS_GetDeviceConfigRequest);
         }
         break;
       case SUPLA_SC_CALL_DEVICE_CONFIG_UPDATE_OR_RESULT:
         if (VALID_SIZE(TSC_DeviceConfigUpdateOrResult, char, Config.ConfigSize,
                        SUPLA_DEVICE_CONFIG_MAXSIZE)) {
           rd->data.sc_device_config_update_or_result =
-              (TSC_DeviceConfigUpdateOrResult *)malloc(
-                  sizeof(TSC_DeviceConfigUpdateOrResult));
+              SRPC_RD_ALLOC(TSC_DeviceConfigUpdateOrResult);
         }
         break;
 #endif /*#ifndef SRPC_EXCLUDE_CLIENT*/
@@ -1677,8 +2483,8 @@ char SRPC_ICACHE_FLASH srpc_getdata(void *_srpc, TsrpcReceivedData *rd,
     }
 
     if (rd->data.dcs_ping != NULL) {
-      if (srpc->sdp.data_size > 0) {
-        memcpy(rd->data.dcs_ping, srpc->sdp.data, srpc->sdp.data_size);
+      if (!rd->view && sdp->data_size > 0) {
+        memcpy(rd->data.dcs_ping, sdp->data, sdp->data_size);
       }
 
       return lck_unlock_r(srpc->lck, SUPLA_RESULT_TRUE);
@@ -1694,168 +2500,21 @@ void SRPC_ICACHE_FLASH srpc_rd_free(TsrpcReceivedData *rd) {
   if (rd->call_id > 0) {
     // first one
 
-    if (rd->data.dcs_ping != NULL) free(rd->data.dcs_ping);
+    if (rd->data.dcs_ping != NULL && !rd->view)
+      salloc_free(rd->allocator, rd->data.dcs_ping, SALLOC_TAG_SRPC);
 
     rd->call_id = 0;
+    rd->view = 0;
   }
 }
 
 unsigned char SRPC_ICACHE_FLASH
 srpc_call_min_version_required(void *_srpc, unsigned _supla_int_t call_id) {
+  TsrpcCallDesc desc;
   (void)(_srpc);
-  switch (call_id) {
-    case SUPLA_DCS_CALL_GETVERSION:
-    case SUPLA_SDC_CALL_GETVERSION_RESULT:
-    case SUPLA_SDC_CALL_VERSIONERROR:
-    case SUPLA_DCS_CALL_PING_SERVER:
-    case SUPLA_SDC_CALL_PING_SERVER_RESULT:
-    case SUPLA_DS_CALL_REGISTER_DEVICE:
-    case SUPLA_SD_CALL_REGISTER_DEVICE_RESULT:
-    case SUPLA_CS_CALL_REGISTER_CLIENT:
-    case SUPLA_SC_CALL_REGISTER_CLIENT_RESULT:
-    case SUPLA_DS_CALL_DEVICE_CHANNEL_VALUE_CHANGED:
-    case SUPLA_SD_CALL_CHANNEL_SET_VALUE:
-    case SUPLA_DS_CALL_CHANNEL_SET_VALUE_RESULT:
-    case SUPLA_SC_CALL_LOCATION_UPDATE:
-    case SUPLA_SC_CALL_LOCATIONPACK_UPDATE:
-    case SUPLA_SC_CALL_CHANNELPACK_UPDATE:
-    case SUPLA_SC_CALL_CHANNEL_VALUE_UPDATE:
-    case SUPLA_CS_CALL_GET_NEXT:
-    case SUPLA_SC_CALL_EVENT:
-    case SUPLA_CS_CALL_CHANNEL_SET_VALUE:
-      return 1;
-
-    case SUPLA_DS_CALL_REGISTER_DEVICE_B:
-    case SUPLA_DCS_CALL_SET_ACTIVITY_TIMEOUT:
-    case SUPLA_SDC_CALL_SET_ACTIVITY_TIMEOUT_RESULT:
-      return 2;
-
-    case SUPLA_CS_CALL_CHANNEL_SET_VALUE_B:
-      return 3;
-
-    case SUPLA_DS_CALL_GET_FIRMWARE_UPDATE_URL:
-    case SUPLA_SD_CALL_GET_FIRMWARE_UPDATE_URL_RESULT:
-      return 5;
-
-    case SUPLA_DS_CALL_REGISTER_DEVICE_C:
-    case SUPLA_CS_CALL_REGISTER_CLIENT_B:
-      return 6;
-
-    case SUPLA_CS_CALL_REGISTER_CLIENT_C:
-    case SUPLA_DS_CALL_REGISTER_DEVICE_D:
-    case SUPLA_DCS_CALL_GET_REGISTRATION_ENABLED:
-    case SUPLA_SDC_CALL_GET_REGISTRATION_ENABLED_RESULT:
-      return 7;
-
-    case SUPLA_SC_CALL_CHANNELPACK_UPDATE_B:
-      return 8;
-
-    case SUPLA_SC_CALL_REGISTER_CLIENT_RESULT_B:
-    case SUPLA_SC_CALL_CHANNELGROUP_PACK_UPDATE:
-    case SUPLA_SC_CALL_CHANNELGROUP_RELATION_PACK_UPDATE:
-    case SUPLA_SC_CALL_CHANNELVALUE_PACK_UPDATE:
-    case SUPLA_CS_CALL_SET_VALUE:
-      return 9;
-
-    case SUPLA_DS_CALL_DEVICE_CHANNEL_EXTENDEDVALUE_CHANGED:
-    case SUPLA_SC_CALL_CHANNELEXTENDEDVALUE_PACK_UPDATE:
-    case SUPLA_CS_CALL_OAUTH_TOKEN_REQUEST:
-    case SUPLA_SC_CALL_OAUTH_TOKEN_REQUEST_RESULT:
-    case SUPLA_DS_CALL_REGISTER_DEVICE_E:
-    case SUPLA_CS_CALL_SUPERUSER_AUTHORIZATION_REQUEST:
-    case SUPLA_SC_CALL_SUPERUSER_AUTHORIZATION_RESULT:
-    case SUPLA_CS_CALL_DEVICE_CALCFG_REQUEST:
-    case SUPLA_SC_CALL_DEVICE_CALCFG_RESULT:
-    case SUPLA_SD_CALL_DEVICE_CALCFG_REQUEST:
-    case SUPLA_DS_CALL_DEVICE_CALCFG_RESULT:
-    case SUPLA_SC_CALL_CHANNELGROUP_PACK_UPDATE_B:
-    case SUPLA_SC_CALL_CHANNELPACK_UPDATE_C:
-      return 10;
-    case SUPLA_DCS_CALL_GET_USER_LOCALTIME:
-    case SUPLA_DCS_CALL_GET_USER_LOCALTIME_RESULT:
-    case SUPLA_CS_CALL_DEVICE_CALCFG_REQUEST_B:
-      return 11;
-    case SUPLA_CS_CALL_REGISTER_CLIENT_D:
-    case SUPLA_CSD_CALL_GET_CHANNEL_STATE:
-    case SUPLA_DSC_CALL_CHANNEL_STATE_RESULT:
-    case SUPLA_CS_CALL_GET_CHANNEL_BASIC_CFG:
-    case SUPLA_SC_CALL_CHANNEL_BASIC_CFG_RESULT:
-    case SUPLA_CS_CALL_SET_CHANNEL_FUNCTION:
-    case SUPLA_SC_CALL_SET_CHANNEL_FUNCTION_RESULT:
-    case SUPLA_DCS_CALL_SET_CHANNEL_CAPTION:
-    case SUPLA_SCD_CALL_SET_CHANNEL_CAPTION_RESULT:
-    case SUPLA_CS_CALL_CLIENTS_RECONNECT_REQUEST:
-    case SUPLA_SC_CALL_CLIENTS_RECONNECT_REQUEST_RESULT:
-    case SUPLA_CS_CALL_SET_REGISTRATION_ENABLED:
-    case SUPLA_SC_CALL_SET_REGISTRATION_ENABLED_RESULT:
-    case SUPLA_CS_CALL_DEVICE_RECONNECT_REQUEST:
-    case SUPLA_SC_CALL_DEVICE_RECONNECT_REQUEST_RESULT:
-    case SUPLA_DS_CALL_DEVICE_CHANNEL_VALUE_CHANGED_B:
-    case SUPLA_DS_CALL_DEVICE_CHANNEL_VALUE_CHANGED_C:
-    case SUPLA_DS_CALL_GET_CHANNEL_FUNCTIONS:
-    case SUPLA_SD_CALL_GET_CHANNEL_FUNCTIONS_RESULT:
-    case SUPLA_CS_CALL_GET_SUPERUSER_AUTHORIZATION_RESULT:
-      return 12;
-    case SUPLA_SD_CALL_CHANNELGROUP_SET_VALUE:
-      return 13;
-    case SUPLA_CS_CALL_SET_LOCATION_CAPTION:
-    case SUPLA_SC_CALL_SET_LOCATION_CAPTION_RESULT:
-      return 14;
-    case SUPLA_SC_CALL_CHANNELPACK_UPDATE_D:
-    case SUPLA_SC_CALL_CHANNEL_VALUE_UPDATE_B:
-    case SUPLA_SC_CALL_CHANNELVALUE_PACK_UPDATE_B:
-      return 15;
-    case SUPLA_DS_CALL_GET_CHANNEL_CONFIG:
-    case SUPLA_SD_CALL_GET_CHANNEL_CONFIG_RESULT:
-    case SUPLA_DS_CALL_ACTIONTRIGGER:
-      return 16;
-    case SUPLA_SC_CALL_REGISTER_CLIENT_RESULT_C:
-    case SUPLA_CS_CALL_TIMER_ARM:
-      return 17;
-    case SUPLA_SC_CALL_SCENE_PACK_UPDATE:
-    case SUPLA_SC_CALL_SCENE_STATE_PACK_UPDATE:
-      return 18;
-    case SUPLA_CS_CALL_EXECUTE_ACTION:
-    case SUPLA_CS_CALL_EXECUTE_ACTION_WITH_AUTH:
-    case SUPLA_SC_CALL_ACTION_EXECUTION_RESULT:
-    case SUPLA_SC_CALL_REGISTER_CLIENT_RESULT_D:
-    case SUPLA_CS_CALL_GET_CHANNEL_VALUE_WITH_AUTH:
-    case SUPLA_SC_CALL_GET_CHANNEL_VALUE_RESULT:
-    case SUPLA_CS_CALL_SET_SCENE_CAPTION:
-    case SUPLA_SC_CALL_SET_SCENE_CAPTION_RESULT:
-      return 19;
-    case SUPLA_DS_CALL_REGISTER_PUSH_NOTIFICATION:
-    case SUPLA_DS_CALL_SEND_PUSH_NOTIFICATION:
-    case SUPLA_CS_CALL_REGISTER_PN_CLIENT_TOKEN:
-    case SUPLA_SC_CALL_REGISTER_PN_CLIENT_TOKEN_RESULT:
-    case SUPLA_CS_CALL_SET_CHANNEL_GROUP_CAPTION:
-    case SUPLA_SC_CALL_SET_CHANNEL_GROUP_CAPTION_RESULT:
-      return 20;
-    case SUPLA_DS_CALL_SET_CHANNEL_CONFIG:
-    case SUPLA_SD_CALL_SET_CHANNEL_CONFIG_RESULT:
-    case SUPLA_SD_CALL_SET_CHANNEL_CONFIG:
-    case SUPLA_DS_CALL_SET_CHANNEL_CONFIG_RESULT:
-    case SUPLA_DS_CALL_SET_DEVICE_CONFIG:
-    case SUPLA_SD_CALL_SET_DEVICE_CONFIG_RESULT:
-    case SUPLA_SD_CALL_SET_DEVICE_CONFIG:
-    case SUPLA_DS_CALL_SET_DEVICE_CONFIG_RESULT:
-    case SUPLA_SC_CALL_CHANNEL_RELATION_PACK_UPDATE:
-    case SUPLA_CS_CALL_GET_CHANNEL_CONFIG:
-    case SUPLA_SC_CALL_CHANNEL_CONFIG_UPDATE_OR_RESULT:
-    case SUPLA_CS_CALL_SET_CHANNEL_CONFIG:
-    case SUPLA_CS_CALL_GET_DEVICE_CONFIG:
-    case SUPLA_SC_CALL_DEVICE_CONFIG_UPDATE_OR_RESULT:
-    case SUPLA_SD_CALL_CHANNEL_CONFIG_FINISHED:
-      return 21;
-    case SUPLA_SC_CALL_CHANNELPACK_UPDATE_E:
-    case SUPLA_DS_CALL_REGISTER_DEVICE_F:
-      return 23;
-    case SUPLA_DS_CALL_REGISTER_DEVICE_G:
-    case SUPLA_SD_CALL_REGISTER_DEVICE_RESULT_B:
-    case SUPLA_DS_CALL_SET_SUBDEVICE_DETAILS:
-      return 25;
-    case SUPLA_SC_CALL_CHANNEL_STATE_PACK_UPDATE:
-      return 26;
+
+  if (srpc_call_desc(call_id, &desc)) {
+    return desc.min_version;
   }
 
   return 255;
@@ -1872,21 +2531,12 @@ srpc_call_allowed(void *_srpc, unsigned _supla_int_t call_id) {
   return 0;
 }
 
-_supla_int_t SRPC_ICACHE_FLASH srpc_async__call(void *_srpc,
-                                                unsigned _supla_int_t call_id,
-                                                char *data,
-                                                unsigned _supla_int_t data_size,
-                                                unsigned char *version) {
-  if (_srpc == NULL) {
-    return SUPLA_RESULT_FALSE;
-  }
-
-  Tsrpc *srpc = (Tsrpc *)_srpc;
-
-  if (!srpc_call_allowed(_srpc, call_id)) {
+char SRPC_ICACHE_FLASH srpc_async_call_begin(Tsrpc *srpc,
+                                            unsigned _supla_int_t call_id) {
+  if (!srpc_call_allowed(srpc, call_id)) {
     if (srpc->params.on_min_version_required != NULL) {
       srpc->params.on_min_version_required(
-          _srpc, call_id, srpc_call_min_version_required(_srpc, call_id),
+          srpc, call_id, srpc_call_min_version_required(srpc, call_id),
           srpc->params.user_params);
     }
 
@@ -1894,28 +2544,141 @@ _supla_int_t SRPC_ICACHE_FLASH srpc_async__call(void *_srpc,
   }
 
   if (srpc->params.before_async_call != NULL) {
-    srpc->params.before_async_call(_srpc, call_id, srpc->params.user_params);
+    srpc->params.before_async_call(srpc, call_id, srpc->params.user_params);
+  }
+
+  return SUPLA_RESULT_TRUE;
+}
+
+char *SRPC_ICACHE_FLASH srpc_async__reserve(Tsrpc *srpc,
+                                            unsigned _supla_int_t call_id,
+                                            unsigned _supla_int_t data_size,
+                                            unsigned char *version,
+                                            unsigned char direct) {
+  TSuplaDataPacket *sdp = NULL;
+  unsigned _supla_int_t size = SRPC_PACKET_HEADER_SIZE + data_size;
+
+  if (data_size > srpc->params.max_data_size ||
+      !srpc_async_call_begin(srpc, call_id)) {
+    return NULL;
   }
 
   lck_lock(srpc->lck);
 
-  sproto_sdp_init(srpc->proto, &srpc->sdp);
+#ifdef SRPC_WITHOUT_OUT_QUEUE
+  (void)(direct);
+  (void)(size);
+  sdp = srpc_sdp(srpc);
+  srpc->reserved_in = SRPC_RESERVED_SDP;
+#else
+  // When the next iteration would move everything queued to the output
+  // buffer anyway, the packet is built there right away.
+  if (direct && srpc->params.out_coalesce && !srpc->out_congested &&
+      srpc->out_queue.item_count == 0) {
+    sdp = (TSuplaDataPacket *)sproto_out_buffer_reserve(
+        srpc->proto, size + SUPLA_TAG_SIZE);
+    srpc->reserved_in = SRPC_RESERVED_OUT_BUFFER;
+  }
+
+  if (sdp == NULL) {
+    sdp = srpc_queue_reserve_item(&srpc->out_queue, size);
+    srpc->reserved_in = SRPC_RESERVED_OUT_QUEUE;
+  }
 
-  if (version != NULL) srpc->sdp.version = *version;
+  if (sdp == NULL) {
+    srpc->reserved_in = SRPC_RESERVED_NONE;
+    lck_unlock(srpc->lck);
+    return NULL;
+  }
+#endif /*SRPC_WITHOUT_OUT_QUEUE*/
+
+  sproto_sdp_init_header(srpc->proto, sdp, call_id, data_size);
+  if (version != NULL) sdp->version = *version;
+
+  srpc->reserved_sdp = sdp;
+  return sdp->data;
+}
+
+char *SRPC_ICACHE_FLASH srpc_async_reserve(void *_srpc,
+                                           unsigned _supla_int_t call_id,
+                                           unsigned _supla_int_t data_size) {
+  if (_srpc == NULL) {
+    return NULL;
+  }
+
+  return srpc_async__reserve((Tsrpc *)_srpc, call_id, data_size, NULL, 1);
+}
+
+_supla_int_t SRPC_ICACHE_FLASH srpc_async_commit(void *_srpc) {
+  Tsrpc *srpc = (Tsrpc *)_srpc;
+  TSuplaDataPacket *sdp = srpc->reserved_sdp;
+  unsigned _supla_int_t size;
+
+  if (srpc->reserved_in == SRPC_RESERVED_NONE) {
+    return SUPLA_RESULT_FALSE;
+  }
+
+  size = SRPC_PACKET_HEADER_SIZE + sdp->data_size;
+
+  switch (srpc->reserved_in) {
+#ifndef SRPC_WITHOUT_OUT_QUEUE
+    case SRPC_RESERVED_OUT_BUFFER:
+      memcpy((char *)sdp + size, sproto_tag, SUPLA_TAG_SIZE);
+      sproto_out_buffer_commit(srpc->proto, size + SUPLA_TAG_SIZE);
+      break;
+    case SRPC_RESERVED_OUT_QUEUE:
+      srpc_queue_commit_item(&srpc->out_queue, size);
+      break;
+#endif /*SRPC_WITHOUT_OUT_QUEUE*/
+    default:
+      srpc_out_queue_push(srpc, sdp);
+      break;
+  }
+
+  srpc->reserved_in = SRPC_RESERVED_NONE;
+  srpc->reserved_sdp = NULL;
 
-  if (SUPLA_RESULT_TRUE ==
-          sproto_set_data(&srpc->sdp, data, data_size, call_id) &&
-      srpc_out_queue_push(srpc, &srpc->sdp)) {
 #ifndef __EH_DISABLED
-    if (srpc->params.eh != 0) {
-      eh_raise_event(srpc->params.eh);
-    }
+  if (srpc->params.eh != 0) {
+    eh_raise_event(srpc->params.eh);
+  }
 #endif
 
-    return lck_unlock_r(srpc->lck, srpc->sdp.rr_id);
+  return lck_unlock_r(srpc->lck, sdp->rr_id);
+}
+
+void SRPC_ICACHE_FLASH srpc_async_cancel(void *_srpc) {
+  Tsrpc *srpc = (Tsrpc *)_srpc;
+
+  if (srpc->reserved_in != SRPC_RESERVED_NONE) {
+    srpc->reserved_in = SRPC_RESERVED_NONE;
+    srpc->reserved_sdp = NULL;
+    lck_unlock(srpc->lck);
   }
+}
 
-  return lck_unlock_r(srpc->lck, SUPLA_RESULT_FALSE);
+_supla_int_t SRPC_ICACHE_FLASH srpc_async__call(void *_srpc,
+                                                unsigned _supla_int_t call_id,
+                                                char *data,
+                                                unsigned _supla_int_t data_size,
+                                                unsigned char *version) {
+  char *payload;
+
+  if (_srpc == NULL || (data_size > 0 && data == NULL)) {
+    return SUPLA_RESULT_FALSE;
+  }
+
+  payload =
+      srpc_async__reserve((Tsrpc *)_srpc, call_id, data_size, version, 0);
+  if (payload == NULL) {
+    return SUPLA_RESULT_FALSE;
+  }
+
+  if (data_size > 0) {
+    memcpy(payload, data, data_size);
+  }
+
+  return srpc_async_commit(_srpc);
 }
 
 _supla_int_t SRPC_ICACHE_FLASH
@@ -1948,6 +2711,17 @@ void SRPC_ICACHE_FLASH srpc_set_proto_version(void *_srpc,
   lck_unlock(srpc->lck);
 }
 
+unsigned _supla_int_t SRPC_ICACHE_FLASH srpc_in_resync_count(void *_srpc) {
+  Tsrpc *srpc = (Tsrpc *)_srpc;
+  unsigned _supla_int_t result;
+
+  lck_lock(srpc->lck);
+  result = sproto_in_resync_count(srpc->proto);
+  lck_unlock(srpc->lck);
+
+  return result;
+}
+
 _supla_int_t SRPC_ICACHE_FLASH srpc_dcs_async_getversion(void *_srpc) {
   return srpc_async_call(_srpc, SUPLA_DCS_CALL_GETVERSION, NULL, 0);
 }
@@ -2068,8 +2842,14 @@ _supla_int_t SRPC_ICACHE_FLASH srpc_csd_async_get_channel_state(
 
 _supla_int_t SRPC_ICACHE_FLASH
 srpc_csd_async_channel_state_result(void *_srpc, TDSC_ChannelState *state) {
-  return srpc_async_call(_srpc, SUPLA_DSC_CALL_CHANNEL_STATE_RESULT,
-                         (char *)state, sizeof(TDSC_ChannelState));
+  char *data = srpc_async_reserve(_srpc, SUPLA_DSC_CALL_CHANNEL_STATE_RESULT,
+                                  sizeof(TDSC_ChannelState));
+  if (data == NULL) {
+    return SUPLA_RESULT_FALSE;
+  }
+
+  memcpy(data, state, sizeof(TDSC_ChannelState));
+  return srpc_async_commit(_srpc);
 }
 
 _supla_int_t SRPC_ICACHE_FLASH srpc_dcs_async_set_caption(
@@ -2205,17 +2985,18 @@ _supla_int_t SRPC_ICACHE_FLASH srpc_ds_async_registerdevice_in_chunks(
 
   lck_lock(srpc->lck);
 
-  sproto_sdp_init(srpc->proto, &srpc->sdp);
+  TSuplaDataPacket *sdp = srpc_sdp(srpc);
+  sproto_sdp_init(srpc->proto, sdp);
 
   if (SUPLA_RESULT_TRUE ==
-      sproto_set_data(&srpc->sdp, (char *)registerdevice,
+      sproto_set_data(sdp, (char *)registerdevice,
                       sizeof(TDS_SuplaRegisterDeviceHeader), call_id)) {
-    srpc->sdp.data_size = full_size;
+    sdp->data_size = full_size;
 
     unsigned _supla_int_t header_size = sizeof(TSuplaDataPacket);
     header_size -= SUPLA_MAX_DATA_SIZE;
     header_size += sizeof(TDS_SuplaRegisterDeviceHeader);
-    srpc->params.data_write((char *)&srpc->sdp, header_size,
+    srpc->params.data_write((char *)sdp, header_size,
                             srpc->params.user_params);
     // send channels here
     const unsigned _supla_int_t channel_size = sizeof(TDS_SuplaDeviceChannel_D);
@@ -2228,7 +3009,7 @@ _supla_int_t SRPC_ICACHE_FLASH srpc_ds_async_registerdevice_in_chunks(
     srpc->params.data_write(sproto_tag, SUPLA_TAG_SIZE,
                             srpc->params.user_params);
 
-    return lck_unlock_r(srpc->lck, srpc->sdp.rr_id);
+    return lck_unlock_r(srpc->lck, sdp->rr_id);
   }
   return lck_unlock_r(srpc->lck, SUPLA_RESULT_FALSE);
 }
@@ -2262,29 +3043,91 @@ _supla_int_t SRPC_ICACHE_FLASH srpc_ds_async_registerdevice_in_chunks_g(
 
   lck_lock(srpc->lck);
 
-  sproto_sdp_init(srpc->proto, &srpc->sdp);
+  TSuplaDataPacket *sdp = srpc_sdp(srpc);
+  sproto_sdp_init(srpc->proto, sdp);
 
   if (SUPLA_RESULT_TRUE ==
-      sproto_set_data(&srpc->sdp, (char *)registerdevice,
+      sproto_set_data(sdp, (char *)registerdevice,
                       sizeof(TDS_SuplaRegisterDeviceHeader), call_id)) {
-    srpc->sdp.data_size = full_size;
+    sdp->data_size = full_size;
 
     unsigned _supla_int_t header_size = sizeof(TSuplaDataPacket);
     header_size -= SUPLA_MAX_DATA_SIZE;
     header_size += sizeof(TDS_SuplaRegisterDeviceHeader);
-    srpc->params.data_write((char *)&srpc->sdp, header_size,
-                            srpc->params.user_params);
-    // send channels here
     const unsigned _supla_int_t channel_size = sizeof(TDS_SuplaDeviceChannel_E);
-    for (int i = 0; i < registerdevice->channel_count; i++) {
-      TDS_SuplaDeviceChannel_E data = get_channel_data_callback(arg,i);
-      srpc->params.data_write((char *)&data, channel_size,
+
+#ifndef SRPC_WITHOUT_OUT_QUEUE
+    // Queued in the output buffer like any other packet, so a short write is
+    // completed by srpc_iterate instead of cutting the stream.
+    char result =
+        sproto_out_buffer_append_data(srpc->proto, (char *)sdp, header_size);
+
+    for (int i = 0;
+         result == SUPLA_RESULT_TRUE && i < registerdevice->channel_count;
+         i++) {
+      TDS_SuplaDeviceChannel_E data = get_channel_data_callback(arg, i);
+      result = sproto_out_buffer_append_data(srpc->proto, (char *)&data,
+                                             channel_size);
+    }
+
+    if (result == SUPLA_RESULT_TRUE) {
+      result = sproto_out_buffer_append_data(srpc->proto, sproto_tag,
+                                             SUPLA_TAG_SIZE);
+    }
+
+    if (result != SUPLA_RESULT_TRUE) {
+      supla_log(LOG_DEBUG, "sproto_out_buffer_append_data error: %i", result);
+      return lck_unlock_r(srpc->lck, SUPLA_RESULT_FALSE);
+    }
+
+#ifndef __EH_DISABLED
+    if (srpc->params.eh) {
+      eh_raise_event(srpc->params.eh);
+    }
+#endif /*__EH_DISABLED*/
+#else
+    if (srpc->params.data_writev) {
+      // header, channels and tag gathered in batches of
+      // SRPC_REGISTER_CHUNK_COUNT channels per write
+      TDS_SuplaDeviceChannel_E chunk[SRPC_REGISTER_CHUNK_COUNT];
+      TsrpcIoVec iov[SRPC_REGISTER_CHUNK_COUNT + 2];
+      int iovcnt = 0;
+      int n = 0;
+
+      iov[iovcnt].buf = sdp;
+      iov[iovcnt++].count = header_size;
+
+      for (int i = 0; i < registerdevice->channel_count; i++) {
+        chunk[n] = get_channel_data_callback(arg, i);
+        iov[iovcnt].buf = &chunk[n++];
+        iov[iovcnt++].count = channel_size;
+
+        if (n == SRPC_REGISTER_CHUNK_COUNT &&
+            i < registerdevice->channel_count - 1) {
+          srpc_data_writev(srpc, iov, iovcnt);
+          iovcnt = 0;
+          n = 0;
+        }
+      }
+
+      iov[iovcnt].buf = sproto_tag;
+      iov[iovcnt++].count = SUPLA_TAG_SIZE;
+      srpc_data_writev(srpc, iov, iovcnt);
+    } else {
+      srpc->params.data_write((char *)sdp, header_size,
+                              srpc->params.user_params);
+      // send channels here
+      for (int i = 0; i < registerdevice->channel_count; i++) {
+        TDS_SuplaDeviceChannel_E data = get_channel_data_callback(arg, i);
+        srpc->params.data_write((char *)&data, channel_size,
+                                srpc->params.user_params);
+      }
+      srpc->params.data_write(sproto_tag, SUPLA_TAG_SIZE,
                               srpc->params.user_params);
     }
-    srpc->params.data_write(sproto_tag, SUPLA_TAG_SIZE,
-                            srpc->params.user_params);
+#endif /*SRPC_WITHOUT_OUT_QUEUE*/
 
-    return lck_unlock_r(srpc->lck, srpc->sdp.rr_id);
+    return lck_unlock_r(srpc->lck, sdp->rr_id);
   }
   return lck_unlock_r(srpc->lck, SUPLA_RESULT_FALSE);
 }
@@ -2371,40 +3214,58 @@ _supla_int_t SRPC_ICACHE_FLASH srpc_sd_async_get_firmware_update_url_result(
 
 _supla_int_t SRPC_ICACHE_FLASH srpc_ds_async_channel_value_changed(
     void *_srpc, unsigned char channel_number, char *value) {
-  TDS_SuplaDeviceChannelValue ncsc;
-  ncsc.ChannelNumber = channel_number;
-  memcpy(ncsc.value, value, SUPLA_CHANNELVALUE_SIZE);
+  TDS_SuplaDeviceChannelValue *ncsc =
+      (TDS_SuplaDeviceChannelValue *)srpc_async_reserve(
+          _srpc, SUPLA_DS_CALL_DEVICE_CHANNEL_VALUE_CHANGED,
+          sizeof(TDS_SuplaDeviceChannelValue));
+  if (ncsc == NULL) {
+    return SUPLA_RESULT_FALSE;
+  }
+
+  ncsc->ChannelNumber = channel_number;
+  memcpy(ncsc->value, value, SUPLA_CHANNELVALUE_SIZE);
 
-  return srpc_async_call(_srpc, SUPLA_DS_CALL_DEVICE_CHANNEL_VALUE_CHANGED,
-                         (char *)&ncsc, sizeof(TDS_SuplaDeviceChannelValue));
+  return srpc_async_commit(_srpc);
 }
 
 _supla_int_t SRPC_ICACHE_FLASH
 srpc_ds_async_channel_value_changed_b(void *_srpc, unsigned char channel_number,
                                       char *value, unsigned char offline) {
-  TDS_SuplaDeviceChannelValue_B ncsc;
-  ncsc.ChannelNumber = channel_number;
-  ncsc.Offline = !!offline;
-  memcpy(ncsc.value, value, SUPLA_CHANNELVALUE_SIZE);
+  TDS_SuplaDeviceChannelValue_B *ncsc =
+      (TDS_SuplaDeviceChannelValue_B *)srpc_async_reserve(
+          _srpc, SUPLA_DS_CALL_DEVICE_CHANNEL_VALUE_CHANGED_B,
+          sizeof(TDS_SuplaDeviceChannelValue_B));
+  if (ncsc == NULL) {
+    return SUPLA_RESULT_FALSE;
+  }
 
-  return srpc_async_call(_srpc, SUPLA_DS_CALL_DEVICE_CHANNEL_VALUE_CHANGED_B,
-                         (char *)&ncsc, sizeof(TDS_SuplaDeviceChannelValue_B));
+  ncsc->ChannelNumber = channel_number;
+  ncsc->Offline = !!offline;
+  memcpy(ncsc->value, value, SUPLA_CHANNELVALUE_SIZE);
+
+  return srpc_async_commit(_srpc);
 }
 
 _supla_int_t SRPC_ICACHE_FLASH srpc_ds_async_channel_value_changed_c(
     void *_srpc, unsigned char channel_number, char *value,
     unsigned char offline, unsigned _supla_int_t validity_time_sec) {
-  TDS_SuplaDeviceChannelValue_C ncsc;
-  ncsc.ChannelNumber = channel_number;
+  TDS_SuplaDeviceChannelValue_C *ncsc =
+      (TDS_SuplaDeviceChannelValue_C *)srpc_async_reserve(
+          _srpc, SUPLA_DS_CALL_DEVICE_CHANNEL_VALUE_CHANGED_C,
+          sizeof(TDS_SuplaDeviceChannelValue_C));
+  if (ncsc == NULL) {
+    return SUPLA_RESULT_FALSE;
+  }
+
+  ncsc->ChannelNumber = channel_number;
   if (offline > SUPLA_CHANNEL_OFFLINE_FLAG_MAX) {
     offline = SUPLA_CHANNEL_OFFLINE_FLAG_OFFLINE;
   }
-  ncsc.Offline = offline;
-  ncsc.ValidityTimeSec = validity_time_sec;
-  memcpy(ncsc.value, value, SUPLA_CHANNELVALUE_SIZE);
+  ncsc->Offline = offline;
+  ncsc->ValidityTimeSec = validity_time_sec;
+  memcpy(ncsc->value, value, SUPLA_CHANNELVALUE_SIZE);
 
-  return srpc_async_call(_srpc, SUPLA_DS_CALL_DEVICE_CHANNEL_VALUE_CHANGED_C,
-                         (char *)&ncsc, sizeof(TDS_SuplaDeviceChannelValue_C));
+  return srpc_async_commit(_srpc);
 }
 
 _supla_int_t SRPC_ICACHE_FLASH srpc_ds_async_channel_extendedvalue_changed(
@@ -2415,14 +3276,24 @@ _supla_int_t SRPC_ICACHE_FLASH srpc_ds_async_channel_extendedvalue_changed(
     return 0;
   }
 
-  TDS_SuplaDeviceChannelExtendedValue ncsc;
-  ncsc.ChannelNumber = channel_number;
-  memcpy(&ncsc.value, value, sizeof(TSuplaChannelExtendedValue));
+  // Only the used part of the value is copied, straight to where it is sent
+  // from.
+  unsigned _supla_int_t value_size = sizeof(TSuplaChannelExtendedValue) -
+                                     SUPLA_CHANNELEXTENDEDVALUE_SIZE +
+                                     value->size;
+  TDS_SuplaDeviceChannelExtendedValue *ncsc =
+      (TDS_SuplaDeviceChannelExtendedValue *)srpc_async_reserve(
+          _srpc, SUPLA_DS_CALL_DEVICE_CHANNEL_EXTENDEDVALUE_CHANGED,
+          sizeof(TDS_SuplaDeviceChannelExtendedValue) -
+              (SUPLA_CHANNELEXTENDEDVALUE_SIZE - value->size));
+  if (ncsc == NULL) {
+    return SUPLA_RESULT_FALSE;
+  }
 
-  return srpc_async_call(
-      _srpc, SUPLA_DS_CALL_DEVICE_CHANNEL_EXTENDEDVALUE_CHANGED, (char *)&ncsc,
-      sizeof(TDS_SuplaDeviceChannelExtendedValue) -
-          (SUPLA_CHANNELEXTENDEDVALUE_SIZE - ncsc.value.size));
+  ncsc->ChannelNumber = channel_number;
+  memcpy(&ncsc->value, value, value_size);
+
+  return srpc_async_commit(_srpc);
 }
 
 _supla_int_t SRPC_ICACHE_FLASH srpc_sd_async_device_calcfg_request(
@@ -2596,8 +3467,14 @@ srpc_ds_async_action_trigger(void *_srpc, TDS_ActionTrigger *action_trigger) {
     return 0;
   }
 
-  return srpc_async_call(_srpc, SUPLA_DS_CALL_ACTIONTRIGGER,
-                         (char *)action_trigger, sizeof(TDS_ActionTrigger));
+  char *data = srpc_async_reserve(_srpc, SUPLA_DS_CALL_ACTIONTRIGGER,
+                                  sizeof(TDS_ActionTrigger));
+  if (data == NULL) {
+    return SUPLA_RESULT_FALSE;
+  }
+
+  memcpy(data, action_trigger, sizeof(TDS_ActionTrigger));
+  return srpc_async_commit(_srpc);
 }
 
 _supla_int_t SRPC_ICACHE_FLASH srpc_ds_async_register_push_notification(
@@ -2723,7 +3600,8 @@ _supla_int_t SRPC_ICACHE_FLASH srpc_set_pack(
   size = pack_sizeof - (item_sizeof * pack_max_count);
   offset = size;
 
-  char *buffer = malloc(size);
+  const TSAllocator *allocator = ((Tsrpc *)_srpc)->params.allocator;
+  char *buffer = salloc_malloc(allocator, size, SALLOC_TAG_SRPC);
 
   if (buffer == NULL) return 0;
 
@@ -2733,10 +3611,11 @@ _supla_int_t SRPC_ICACHE_FLASH srpc_set_pack(
     if (get_caption_size(pack, a) <= caption_max_size) {
       size += item_sizeof - caption_max_size + get_caption_size(pack, a);
 
-      char *new_buffer = (char *)realloc(buffer, size);
+      char *new_buffer =
+          (char *)salloc_realloc(allocator, buffer, size, SALLOC_TAG_SRPC);
 
       if (new_buffer == NULL) {
-        free(buffer);
+        salloc_free(allocator, buffer, SALLOC_TAG_SRPC);
         return 0;
       }
 
@@ -2751,7 +3630,7 @@ _supla_int_t SRPC_ICACHE_FLASH srpc_set_pack(
 
   result = srpc_async_call(_srpc, call_id, buffer, size);
 
-  free(buffer);
+  salloc_free(allocator, buffer, SALLOC_TAG_SRPC);
   return result;
 }
 
@@ -3244,8 +4123,9 @@ srpc_scenepack_get_item_caption_size(void *item) {
   return ((TSC_SuplaScene *)item)->CaptionSize;
 }
 
-void SRPC_ICACHE_FLASH srpc_get_scene_pack(Tsrpc *srpc, TsrpcReceivedData *rd) {
-  srpc_getpack(srpc, rd, sizeof(TSC_SuplaScenePack), sizeof(TSC_SuplaScene),
+void SRPC_ICACHE_FLASH srpc_get_scene_pack(TSuplaDataPacket *sdp,
+                                           TsrpcReceivedData *rd) {
+  srpc_getpack(sdp, rd, sizeof(TSC_SuplaScenePack), sizeof(TSC_SuplaScene),
                SUPLA_SCENE_PACK_MAXCOUNT, SUPLA_SCENE_CAPTION_MAXSIZE,
                &srpc_scenepack_get_pack_count, &srpc_scenepack_set_pack_count,
                &srpc_scenepack_get_item_ptr,
@@ -3291,10 +4171,10 @@ srpc_scenestatepack_get_item_initiatorname_size(void *item) {
   return ((TSC_SuplaSceneState *)item)->InitiatorNameSize;
 }
 
-void SRPC_ICACHE_FLASH srpc_get_scene_state_pack(Tsrpc *srpc,
+void SRPC_ICACHE_FLASH srpc_get_scene_state_pack(TSuplaDataPacket *sdp,
                                                  TsrpcReceivedData *rd) {
   srpc_getpack(
-      srpc, rd, sizeof(TSC_SuplaSceneStatePack), sizeof(TSC_SuplaSceneState),
+      sdp, rd, sizeof(TSC_SuplaSceneStatePack), sizeof(TSC_SuplaSceneState),
       SUPLA_SCENE_STATE_PACK_MAXCOUNT, SUPLA_INITIATOR_NAME_MAXSIZE,
       &srpc_scenestatepack_get_pack_count, &srpc_scenestatepack_set_pack_count,
       &srpc_scenestatepack_get_item_ptr,
@@ -61,8 +61,16 @@
 extern "C" {
 #endif
 
+typedef struct {
+  const void *buf;
+  _supla_int_t count;
+} TsrpcIoVec;
+
 typedef _supla_int_t (*_func_srpc_DataRW)(void *buf, _supla_int_t count,
                                           void *user_params);
+typedef _supla_int_t (*_func_srpc_DataWriteV)(const TsrpcIoVec *iov,
+                                              _supla_int_t iovcnt,
+                                              void *user_params);
 typedef void (*_func_srpc_event_OnRemoteCallReceived)(
     void *_srpc, unsigned _supla_int_t rr_id, unsigned _supla_int_t call_id,
     void *user_params, unsigned char proto_version);
@@ -79,6 +87,9 @@ typedef void (*_func_srpc_event_OnMinVersionRequired)(
 typedef struct {
   _func_srpc_DataRW data_read;
   _func_srpc_DataRW data_write;
+  // Optional. Gather write of several buffers in a single call, used for
+  // output wrapping around the end of the output buffer.
+  _func_srpc_DataWriteV data_writev;
   _func_srpc_event_OnRemoteCallReceived on_remote_call_received;
   _func_srpc_event_OnVersionError on_version_error;
   _func_srpc_event_BeforeCall before_async_call;
@@ -86,6 +97,53 @@ typedef struct {
 
   TEventHandler *eh;
 
+  // When set, srpc_iterate moves every queued outgoing packet to the output
+  // buffer and writes them together instead of one packet per iteration.
+  unsigned char out_coalesce;
+
+  // Maximum number of packets held by the input and output queues.
+  // 0 selects the default (SRPC_QUEUE_SIZE), values above 255 are capped.
+  unsigned short in_queue_size;
+  unsigned short out_queue_size;
+
+  // When set, srpc_getdata returns structures in place, pointing into the
+  // received packet instead of allocating a copy. Such data stays valid only
+  // until the next srpc_getdata or srpc_iterate call. Has no effect when
+  // built without the input queue.
+  unsigned char rd_views;
+
+  // When set, a corrupted incoming packet is skipped up to the next begin
+  // tag and the packets behind it are still delivered. Otherwise the whole
+  // input buffer is dropped.
+  unsigned char in_resync;
+
+  // Memory used by this instance, 0 selects the build default.
+  // buffer_size - most bytes passed to a single data_read or data_write
+  //   (SRPC_BUFFER_SIZE)
+  // proto_buffer_min_size, proto_buffer_max_size - bounds of the input and
+  //   output buffers (BUFFER_MIN_SIZE, BUFFER_MAX_SIZE in proto.c)
+  // queue_slab_size - packet storage each queue keeps allocated
+  //   (SRPC_QUEUE_SLAB_SIZE)
+  // max_data_size - largest packet data sent or accepted, at most
+  //   SUPLA_MAX_DATA_SIZE
+  unsigned _supla_int_t buffer_size;
+  unsigned _supla_int_t proto_buffer_min_size;
+  unsigned _supla_int_t proto_buffer_max_size;
+  unsigned _supla_int_t queue_slab_size;
+  unsigned _supla_int_t max_data_size;
+
+  // For processes holding many connections. With shared_scratch the packet
+  // srpc builds and parses in is one per thread instead of one per instance
+  // (needs compiler thread local storage, ignored otherwise). With
+  // release_idle the input and output buffers and both queues are allocated
+  // on demand and freed as soon as they drain.
+  unsigned char shared_scratch;
+  unsigned char release_idle;
+
+  // Source of the instance, its buffers, queues and received data, NULL
+  // selects the default allocator. Must outlive the instance.
+  const TSAllocator *allocator;
+
   void *user_params;
 } TsrpcParams;
 
@@ -200,9 +258,18 @@ typedef struct {
   unsigned _supla_int_t rr_id;
 
   union TsrpcDataPacketData data;
+  // data points into the input queue of srpc instead of a private copy
+  unsigned char view;
+  // set by srpc_getdata, data copies go back to it
+  const TSAllocator *allocator;
 } TsrpcReceivedData;
 
 void SRPC_ICACHE_FLASH srpc_params_init(TsrpcParams *params);
+// Sets the sizes left at 0 for a device with channel_count channels whose
+// largest extended value has max_extended_value_size bytes (0 if none).
+void SRPC_ICACHE_FLASH srpc_params_autosize(
+    TsrpcParams *params, unsigned short channel_count,
+    unsigned _supla_int_t max_extended_value_size);
 
 void *SRPC_ICACHE_FLASH srpc_init(TsrpcParams *params);
 void SRPC_ICACHE_FLASH srpc_free(void *_srpc);
@@ -213,6 +280,16 @@ void SRPC_ICACHE_FLASH srpc_unlock(void *_srpc);
 char SRPC_ICACHE_FLASH srpc_input_dataexists(void *_srpc);
 char SRPC_ICACHE_FLASH srpc_output_dataexists(void *_srpc);
 unsigned char SRPC_ICACHE_FLASH srpc_out_queue_item_count(void *srpc);
+// TRUE when the transport did not accept all pending output during the last
+// iteration. Callers should hold back new data until it clears.
+char SRPC_ICACHE_FLASH srpc_output_congested(void *_srpc);
+// TRUE when srpc_iterate() can make progress without new transport events:
+// a complete packet waits in the input buffer or queued output can be moved
+// to the output buffer.
+char SRPC_ICACHE_FLASH srpc_iterate_pending(void *_srpc);
+// Drops buffered and queued packets, e.g. before reusing srpc on a new
+// connection.
+void SRPC_ICACHE_FLASH srpc_reset(void *_srpc);
 
 char SRPC_ICACHE_FLASH srpc_iterate(void *_srpc);
 char SRPC_ICACHE_FLASH srpc_iterate_device(void *_srpc);
@@ -225,12 +302,42 @@ void SRPC_ICACHE_FLASH srpc_rd_free(TsrpcReceivedData *rd);
 unsigned char SRPC_ICACHE_FLASH srpc_get_proto_version(void *_srpc);
 void SRPC_ICACHE_FLASH srpc_set_proto_version(void *_srpc,
                                               unsigned char version);
+// Number of times corrupted input was skipped in resync mode
+unsigned _supla_int_t SRPC_ICACHE_FLASH srpc_in_resync_count(void *_srpc);
+
+#define SRPC_ROLE_DEVICE 0x1
+#define SRPC_ROLE_SERVER 0x2
+#define SRPC_ROLE_CLIENT 0x4
+
+typedef struct {
+  unsigned _supla_int_t call_id;
+  // Largest payload accepted by srpc_getdata, 0 if the call carries none
+  unsigned _supla_int_t max_data_size;
+  unsigned char min_version;
+  unsigned char senders;    // SRPC_ROLE_*
+  unsigned char receivers;  // SRPC_ROLE_*
+} TsrpcCallDesc;
+
+// Returns 0 for call ids unknown to this protocol version
+char SRPC_ICACHE_FLASH srpc_call_desc(unsigned _supla_int_t call_id,
+                                      TsrpcCallDesc *desc);
 
 unsigned char SRPC_ICACHE_FLASH
 srpc_call_min_version_required(void *_srpc, unsigned _supla_int_t call_id);
 unsigned char SRPC_ICACHE_FLASH
 srpc_call_allowed(void *_srpc, unsigned _supla_int_t call_id);
 
+// Lets a call be encoded in place instead of being copied from a prepared
+// structure. srpc_async_reserve returns room for data_size bytes of payload
+// (NULL on failure) and keeps srpc locked until srpc_async_commit, which
+// sends the call and returns its rr_id, or srpc_async_cancel. No other srpc
+// function may be called in between.
+char *SRPC_ICACHE_FLASH srpc_async_reserve(void *_srpc,
+                                           unsigned _supla_int_t call_id,
+                                           unsigned _supla_int_t data_size);
+_supla_int_t SRPC_ICACHE_FLASH srpc_async_commit(void *_srpc);
+void SRPC_ICACHE_FLASH srpc_async_cancel(void *_srpc);
+
 // device/client <-> server
 _supla_int_t SRPC_ICACHE_FLASH srpc_dcs_async_getversion(void *_srpc);
 _supla_int_t SRPC_ICACHE_FLASH srpc_sdc_async_getversion_result(
@@ -0,0 +1,624 @@
+/*
+ Copyright (C) AC SOFTWARE SP. Z O.O.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "stpool.h"
+
+#ifndef NOMYSQL
+#include <mariadb/mysql.h>
+#endif /*NOMYSQL*/
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "log.h"
+
+#define STPOOL_MAX_WORKERS 256
+#define STPOOL_MIN_QUEUE_SIZE 64
+
+typedef struct _stpool_task_t {
+  _func_stpool_task func;
+  void *user_data;
+
+  // Set only for delayed and periodic tasks
+  int id;
+  int interval_ms;
+  unsigned long long due_ms;
+  int heap_idx;
+  char cancelled;
+  struct _stpool_task_t *prev;
+  struct _stpool_task_t *next;
+} Tstpool_task;
+
+struct _stpool_t;
+
+typedef struct {
+  struct _stpool_t *pool;
+  pthread_t thread;
+
+  pthread_mutex_t mutex;
+  Tstpool_task **tasks;
+  int head;
+  int count;
+  int size;
+} Tstpool_worker;
+
+typedef struct _stpool_t {
+  Tstpool_worker *workers;
+  int worker_count;
+  int started;
+  unsigned int next_worker;
+
+  // Guards the stop flags, the timer heap and the timed task list. It is
+  // also the mutex of all condition variables.
+  pthread_mutex_t mutex;
+  pthread_cond_t work_cond;
+  pthread_cond_t timer_cond;
+  pthread_cond_t idle_cond;
+  pthread_t timer_thread;
+  char stop;
+  // Set once the timer thread is joined and can't queue anything more
+  char stop_workers;
+
+  int queued;
+  int idle_workers;
+  // Queued and running tasks plus pending delayed ones
+  int active;
+
+  Tstpool_task **heap;
+  int heap_count;
+  int heap_size;
+  Tstpool_task *timed;
+  int last_id;
+} Tstpool;
+
+static __thread Tstpool_worker *stpool_current_worker;
+
+static unsigned long long stpool_now_ms(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (unsigned long long)now.tv_sec * 1000ULL + now.tv_nsec / 1000000;
+}
+
+static char stpool_queue_push(Tstpool_worker *worker, Tstpool_task *task) {
+  int a;
+
+  pthread_mutex_lock(&worker->mutex);
+
+  if (worker->count == worker->size) {
+    int size = worker->size ? worker->size * 2 : STPOOL_MIN_QUEUE_SIZE;
+    Tstpool_task **tasks = malloc(sizeof(Tstpool_task *) * size);
+
+    if (tasks == NULL) {
+      pthread_mutex_unlock(&worker->mutex);
+      return 0;
+    }
+
+    for (a = 0; a < worker->count; a++) {
+      tasks[a] = worker->tasks[(worker->head + a) % worker->size];
+    }
+
+    free(worker->tasks);
+    worker->tasks = tasks;
+    worker->head = 0;
+    worker->size = size;
+  }
+
+  worker->tasks[(worker->head + worker->count) % worker->size] = task;
+  __atomic_store_n(&worker->count, worker->count + 1, __ATOMIC_RELAXED);
+
+  pthread_mutex_unlock(&worker->mutex);
+  return 1;
+}
+
+static Tstpool_task *stpool_queue_pop(Tstpool_worker *worker) {
+  Tstpool_task *task = NULL;
+
+  // Don't take the lock of an empty queue while looking for work to steal
+  if (__atomic_load_n(&worker->count, __ATOMIC_RELAXED) == 0) return NULL;
+
+  pthread_mutex_lock(&worker->mutex);
+
+  if (worker->count > 0) {
+    task = worker->tasks[worker->head];
+    worker->head = (worker->head + 1) % worker->size;
+    __atomic_store_n(&worker->count, worker->count - 1, __ATOMIC_RELAXED);
+  }
+
+  pthread_mutex_unlock(&worker->mutex);
+  return task;
+}
+
+static void stpool_heap_swap(Tstpool *pool, int a, int b) {
+  Tstpool_task *task = pool->heap[a];
+  pool->heap[a] = pool->heap[b];
+  pool->heap[b] = task;
+  pool->heap[a]->heap_idx = a;
+  pool->heap[b]->heap_idx = b;
+}
+
+static void stpool_heap_fix(Tstpool *pool, int idx) {
+  int child;
+
+  while (idx > 0 &&
+         pool->heap[(idx - 1) / 2]->due_ms > pool->heap[idx]->due_ms) {
+    stpool_heap_swap(pool, idx, (idx - 1) / 2);
+    idx = (idx - 1) / 2;
+  }
+
+  while ((child = idx * 2 + 1) < pool->heap_count) {
+    if (child + 1 < pool->heap_count &&
+        pool->heap[child + 1]->due_ms < pool->heap[child]->due_ms) {
+      child++;
+    }
+
+    if (pool->heap[idx]->due_ms <= pool->heap[child]->due_ms) break;
+
+    stpool_heap_swap(pool, idx, child);
+    idx = child;
+  }
+}
+
+static char stpool_heap_push(Tstpool *pool, Tstpool_task *task) {
+  if (pool->heap_count == pool->heap_size) {
+    int size = pool->heap_size ? pool->heap_size * 2 : 16;
+    Tstpool_task **heap = realloc(pool->heap, sizeof(Tstpool_task *) * size);
+
+    if (heap == NULL) return 0;
+
+    pool->heap = heap;
+    pool->heap_size = size;
+  }
+
+  task->heap_idx = pool->heap_count;
+  pool->heap[pool->heap_count++] = task;
+  stpool_heap_fix(pool, task->heap_idx);
+
+  if (task->heap_idx == 0) pthread_cond_signal(&pool->timer_cond);
+
+  return 1;
+}
+
+static void stpool_heap_remove(Tstpool *pool, Tstpool_task *task) {
+  int idx = task->heap_idx;
+
+  pool->heap_count--;
+  if (idx != pool->heap_count) {
+    pool->heap[idx] = pool->heap[pool->heap_count];
+    pool->heap[idx]->heap_idx = idx;
+    stpool_heap_fix(pool, idx);
+  }
+
+  task->heap_idx = -1;
+}
+
+static void stpool_timed_unlink(Tstpool *pool, Tstpool_task *task) {
+  if (task->prev) {
+    task->prev->next = task->next;
+  } else {
+    pool->timed = task->next;
+  }
+
+  if (task->next) task->next->prev = task->prev;
+}
+
+static void stpool_done(Tstpool *pool) {
+  if (__atomic_sub_fetch(&pool->active, 1, __ATOMIC_SEQ_CST) == 0) {
+    pthread_mutex_lock(&pool->mutex);
+    pthread_cond_broadcast(&pool->idle_cond);
+    pthread_mutex_unlock(&pool->mutex);
+  }
+}
+
+static void stpool_execute(Tstpool *pool, Tstpool_task *task) {
+  char cancelled = 0;
+  char one_shot = 0;
+
+  if (task->id == 0) {
+    task->func(task->user_data);
+    free(task);
+    stpool_done(pool);
+    return;
+  }
+
+  pthread_mutex_lock(&pool->mutex);
+  cancelled = task->cancelled;
+  pthread_mutex_unlock(&pool->mutex);
+
+  if (!cancelled) task->func(task->user_data);
+
+  pthread_mutex_lock(&pool->mutex);
+
+  if (task->interval_ms > 0 && !task->cancelled && !pool->stop) {
+    task->due_ms = stpool_now_ms() + task->interval_ms;
+    if (stpool_heap_push(pool, task)) {
+      task = NULL;
+    } else {
+      supla_log(LOG_ERR, "Could not reschedule periodic task %i", task->id);
+    }
+  }
+
+  if (task) {
+    one_shot = task->interval_ms == 0;
+    stpool_timed_unlink(pool, task);
+    free(task);
+  }
+
+  pthread_mutex_unlock(&pool->mutex);
+
+  if (one_shot) stpool_done(pool);
+}
+
+static char stpool_dispatch(Tstpool *pool, Tstpool_task *task) {
+  Tstpool_worker *worker = stpool_current_worker;
+
+  // Tasks submitted from a worker stay on its own queue
+  if (worker == NULL || worker->pool != pool) {
+    worker = &pool->workers[__atomic_fetch_add(&pool->next_worker, 1,
+                                               __ATOMIC_RELAXED) %
+                            pool->worker_count];
+  }
+
+  if (!stpool_queue_push(worker, task)) return 0;
+
+  __atomic_add_fetch(&pool->queued, 1, __ATOMIC_SEQ_CST);
+
+  if (__atomic_load_n(&pool->idle_workers, __ATOMIC_SEQ_CST) > 0) {
+    pthread_mutex_lock(&pool->mutex);
+    pthread_cond_signal(&pool->work_cond);
+    pthread_mutex_unlock(&pool->mutex);
+  }
+
+  return 1;
+}
+
+static void *stpool_worker_run(void *ptr) {
+  Tstpool_worker *worker = (Tstpool_worker *)ptr;
+  Tstpool *pool = worker->pool;
+  Tstpool_task *task;
+  int idx = worker - pool->workers;
+  int a;
+  char stop;
+
+  stpool_current_worker = worker;
+
+#ifndef NOMYSQL
+  mysql_thread_init();
+#endif /*NOMYSQL*/
+
+  while (1) {
+    task = stpool_queue_pop(worker);
+
+    for (a = 1; task == NULL && a < pool->worker_count; a++) {
+      task = stpool_queue_pop(&pool->workers[(idx + a) % pool->worker_count]);
+    }
+
+    if (task) {
+      __atomic_sub_fetch(&pool->queued, 1, __ATOMIC_SEQ_CST);
+      stpool_execute(pool, task);
+      continue;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+
+    __atomic_add_fetch(&pool->idle_workers, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&pool->queued, __ATOMIC_SEQ_CST) == 0 &&
+           !pool->stop_workers) {
+      pthread_cond_wait(&pool->work_cond, &pool->mutex);
+    }
+    __atomic_sub_fetch(&pool->idle_workers, 1, __ATOMIC_SEQ_CST);
+
+    stop = pool->stop_workers &&
+           __atomic_load_n(&pool->queued, __ATOMIC_SEQ_CST) == 0;
+
+    pthread_mutex_unlock(&pool->mutex);
+
+    if (stop) break;
+  }
+
+#ifndef NOMYSQL
+  mysql_thread_end();
+#endif /*NOMYSQL*/
+
+  return NULL;
+}
+
+static void *stpool_timer_run(void *ptr) {
+  Tstpool *pool = (Tstpool *)ptr;
+  Tstpool_task *task;
+  unsigned long long now;
+  struct timespec ts;
+
+  pthread_mutex_lock(&pool->mutex);
+
+  while (!pool->stop) {
+    if (pool->heap_count == 0) {
+      pthread_cond_wait(&pool->timer_cond, &pool->mutex);
+      continue;
+    }
+
+    now = stpool_now_ms();
+    task = pool->heap[0];
+
+    if (task->due_ms > now) {
+      ts.tv_sec = task->due_ms / 1000;
+      ts.tv_nsec = (task->due_ms % 1000) * 1000000;
+      pthread_cond_timedwait(&pool->timer_cond, &pool->mutex, &ts);
+      continue;
+    }
+
+    stpool_heap_remove(pool, task);
+    pthread_mutex_unlock(&pool->mutex);
+
+    // Out of memory for the queue, run it here rather than lose it
+    if (!stpool_dispatch(pool, task)) stpool_execute(pool, task);
+
+    pthread_mutex_lock(&pool->mutex);
+  }
+
+  pthread_mutex_unlock(&pool->mutex);
+  return NULL;
+}
+
+static void stpool_shutdown(Tstpool *pool, char timer_started) {
+  int done = 0;
+  int a;
+
+  pthread_mutex_lock(&pool->mutex);
+
+  pool->stop = 1;
+
+  while (pool->heap_count > 0) {
+    Tstpool_task *task = pool->heap[0];
+    stpool_heap_remove(pool, task);
+    stpool_timed_unlink(pool, task);
+    if (task->interval_ms == 0) done++;
+    free(task);
+  }
+
+  pthread_cond_broadcast(&pool->timer_cond);
+  pthread_mutex_unlock(&pool->mutex);
+
+  for (a = 0; a < done; a++) stpool_done(pool);
+
+  if (timer_started) pthread_join(pool->timer_thread, NULL);
+
+  // Let the workers finish what is already queued and exit
+  pthread_mutex_lock(&pool->mutex);
+  pool->stop_workers = 1;
+  pthread_cond_broadcast(&pool->work_cond);
+  pthread_mutex_unlock(&pool->mutex);
+
+  for (a = 0; a < pool->started; a++) {
+    pthread_join(pool->workers[a].thread, NULL);
+  }
+
+  for (a = 0; a < pool->worker_count; a++) {
+    pthread_mutex_destroy(&pool->workers[a].mutex);
+    free(pool->workers[a].tasks);
+  }
+
+  pthread_cond_destroy(&pool->work_cond);
+  pthread_cond_destroy(&pool->timer_cond);
+  pthread_cond_destroy(&pool->idle_cond);
+  pthread_mutex_destroy(&pool->mutex);
+
+  free(pool->heap);
+  free(pool->workers);
+  free(pool);
+}
+
+void *stpool_init(int worker_count) {
+  Tstpool *pool;
+  pthread_condattr_t attr;
+  int r, a;
+
+  if (worker_count <= 0) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    worker_count = cpus > 0 ? cpus : 1;
+  }
+
+  if (worker_count > STPOOL_MAX_WORKERS) worker_count = STPOOL_MAX_WORKERS;
+
+  pool = calloc(1, sizeof(Tstpool));
+  if (pool == NULL) return NULL;
+
+  pool->workers = calloc(worker_count, sizeof(Tstpool_worker));
+  if (pool->workers == NULL) {
+    free(pool);
+    return NULL;
+  }
+
+  pthread_mutex_init(&pool->mutex, NULL);
+  pthread_cond_init(&pool->work_cond, NULL);
+  pthread_cond_init(&pool->idle_cond, NULL);
+
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&pool->timer_cond, &attr);
+  pthread_condattr_destroy(&attr);
+
+  pool->worker_count = worker_count;
+  for (a = 0; a < worker_count; a++) {
+    pool->workers[a].pool = pool;
+    pthread_mutex_init(&pool->workers[a].mutex, NULL);
+  }
+
+  for (a = 0; a < worker_count; a++) {
+    if ((r = pthread_create(&pool->workers[a].thread, NULL,
+                            &stpool_worker_run, &pool->workers[a])) != 0) {
+      supla_log(LOG_ERR, "Could not create a new thread. Error code: %i", r);
+      stpool_shutdown(pool, 0);
+      return NULL;
+    }
+
+    pool->started++;
+  }
+
+  if ((r = pthread_create(&pool->timer_thread, NULL, &stpool_timer_run,
+                          pool)) != 0) {
+    supla_log(LOG_ERR, "Could not create a new thread. Error code: %i", r);
+    stpool_shutdown(pool, 0);
+    return NULL;
+  }
+
+  return pool;
+}
+
+int stpool_worker_count(void *pool) {
+  return ((Tstpool *)pool)->worker_count;
+}
+
+char stpool_submit(void *_pool, _func_stpool_task task, void *user_data) {
+  Tstpool *pool = (Tstpool *)_pool;
+  Tstpool_task *t;
+
+  if (pool == NULL || task == NULL ||
+      __atomic_load_n(&pool->stop, __ATOMIC_SEQ_CST)) {
+    return 0;
+  }
+
+  t = calloc(1, sizeof(Tstpool_task));
+  if (t == NULL) return 0;
+
+  t->func = task;
+  t->user_data = user_data;
+
+  __atomic_add_fetch(&pool->active, 1, __ATOMIC_SEQ_CST);
+
+  if (!stpool_dispatch(pool, t)) {
+    free(t);
+    stpool_done(pool);
+    return 0;
+  }
+
+  return 1;
+}
+
+static int stpool_submit_timed(Tstpool *pool, _func_stpool_task task,
+                               void *user_data, int delay_ms,
+                               int interval_ms) {
+  Tstpool_task *t;
+  int result = 0;
+
+  if (pool == NULL || task == NULL || delay_ms < 0 || interval_ms < 0) {
+    return 0;
+  }
+
+  t = calloc(1, sizeof(Tstpool_task));
+  if (t == NULL) return 0;
+
+  t->func = task;
+  t->user_data = user_data;
+  t->interval_ms = interval_ms;
+  t->due_ms = stpool_now_ms() + delay_ms;
+
+  pthread_mutex_lock(&pool->mutex);
+
+  if (!pool->stop) {
+    if (++pool->last_id <= 0) pool->last_id = 1;
+    t->id = pool->last_id;
+
+    if (interval_ms == 0) {
+      __atomic_add_fetch(&pool->active, 1, __ATOMIC_SEQ_CST);
+    }
+
+    if (stpool_heap_push(pool, t)) {
+      t->next = pool->timed;
+      if (t->next) t->next->prev = t;
+      pool->timed = t;
+      result = t->id;
+    } else if (interval_ms == 0) {
+      __atomic_sub_fetch(&pool->active, 1, __ATOMIC_SEQ_CST);
+    }
+  }
+
+  pthread_mutex_unlock(&pool->mutex);
+
+  if (result == 0) free(t);
+
+  return result;
+}
+
+int stpool_submit_delayed(void *pool, _func_stpool_task task,
+                          void *user_data, int delay_ms) {
+  return stpool_submit_timed((Tstpool *)pool, task, user_data, delay_ms, 0);
+}
+
+int stpool_submit_periodic(void *pool, _func_stpool_task task,
+                           void *user_data, int delay_ms, int interval_ms) {
+  if (interval_ms <= 0) return 0;
+
+  return stpool_submit_timed((Tstpool *)pool, task, user_data, delay_ms,
+                             interval_ms);
+}
+
+char stpool_cancel(void *_pool, int task_id) {
+  Tstpool *pool = (Tstpool *)_pool;
+  Tstpool_task *task;
+  char result = 0;
+  char one_shot = 0;
+
+  if (pool == NULL || task_id <= 0) return 0;
+
+  pthread_mutex_lock(&pool->mutex);
+
+  for (task = pool->timed; task; task = task->next) {
+    if (task->id != task_id) continue;
+
+    if (task->heap_idx >= 0) {
+      stpool_heap_remove(pool, task);
+      stpool_timed_unlink(pool, task);
+      one_shot = task->interval_ms == 0;
+      free(task);
+      result = 1;
+    } else if (task->interval_ms > 0) {
+      // Queued or running, stpool_execute() frees it
+      task->cancelled = 1;
+      result = 1;
+    }
+
+    break;
+  }
+
+  pthread_mutex_unlock(&pool->mutex);
+
+  if (one_shot) stpool_done(pool);
+
+  return result;
+}
+
+void stpool_drain(void *_pool) {
+  Tstpool *pool = (Tstpool *)_pool;
+
+  if (pool == NULL) return;
+
+  pthread_mutex_lock(&pool->mutex);
+  while (__atomic_load_n(&pool->active, __ATOMIC_SEQ_CST) > 0) {
+    pthread_cond_wait(&pool->idle_cond, &pool->mutex);
+  }
+  pthread_mutex_unlock(&pool->mutex);
+}
+
+void stpool_free(void *pool) {
+  if (pool) stpool_shutdown((Tstpool *)pool, 1);
+}
@@ -56,6 +56,7 @@
 
 #include "lck.h"
 #include "log.h"
+#include "sconnect.h"
 #include "supla-socket.h"
 #include "tools.h"
 
@@ -73,6 +74,8 @@ typedef struct {
 
 typedef struct {
   unsigned char secure;
+  unsigned char ktls;
+  unsigned char lean;
   int port;
   char *host;
 
@@ -204,6 +207,37 @@ SSL_CTX *ssocket_client_initctx(void) {
 
   return ctx;
 }
+
+#ifdef __GNUC__
+// A single reference counted context for all lean clients. It lives until
+// the process exits.
+static SSL_CTX *ssocket_client_sharedctx(void) {
+  static SSL_CTX *shared;
+  SSL_CTX *ctx = __atomic_load_n(&shared, __ATOMIC_ACQUIRE);
+  SSL_CTX *expected = NULL;
+
+  if (ctx == NULL) {
+    ctx = ssocket_client_initctx();
+    if (ctx == NULL) return NULL;
+
+    if (!__atomic_compare_exchange_n(&shared, &expected, ctx, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      SSL_CTX_free(ctx);
+      ctx = expected;
+    }
+  }
+
+  SSL_CTX_up_ref(ctx);
+  return ctx;
+}
+#endif /*ifdef __GNUC__*/
+
+static SSL_CTX *ssocket_client_getctx(TSuplaSocketData *ssd) {
+#ifdef __GNUC__
+  if (ssd->lean) return ssocket_client_sharedctx();
+#endif /*ifdef __GNUC__*/
+  return ssocket_client_initctx();
+}
 #endif /*ifndef NOSSL*/
 
 #ifndef _SERVER_EXCLUDED
@@ -518,27 +552,16 @@ void ssocket_close(void *_ssd) {
 
 int ssocket_client_openconnection(TSuplaSocketData *ssd, const char *state_file,
                                   int *err, int conn_timeout_ms) {
-  struct in6_addr serveraddr;
-  struct addrinfo hints, *res = NULL;
-
-  memset(&hints, 0, sizeof(hints));
-  hints.ai_flags = AI_NUMERICSERV;
-  hints.ai_family = AF_UNSPEC;
-  hints.ai_socktype = SOCK_STREAM;
+  int result = 0;
 
   ssd->supla_socket.sfd = -1;
 
 #ifdef _WIN32
-  // struct addrinfo hints, *res;
-
   if (WSAStartup(MAKEWORD(2, 2), &ssd->supla_socket.wsaData) != 0) {
     return ssd->supla_socket.sfd;
   }
 #endif
 
-  char port[15];
-  snprintf(port, sizeof(port), "%i", ssd->port);
-
   char empty[] = "";
   char *server = empty;
 
@@ -546,85 +569,27 @@ int ssocket_client_openconnection(TSuplaSocketData *ssd, const char *state_file,
     server = ssd->host;
   }
 
-  if (inet_pton(AF_INET, server, &serveraddr) == 1) {
-    hints.ai_family = AF_INET;
-    hints.ai_flags |= AI_NUMERICHOST;
-  } else if (inet_pton(AF_INET6, server, &serveraddr) == 1) {
-    hints.ai_family = AF_INET6;
-    hints.ai_flags |= AI_NUMERICHOST;
-  }
-
-  if (getaddrinfo(server, port, &hints, &res) != 0) {
-    if (err) *err = SUPLA_RESULT_HOST_NOT_FOUND;
-
-    supla_write_state_file(state_file, LOG_ERR, "Host not found %s", server);
-    return -1;
-  }
-
+  // Races IPv6 and IPv4 addresses, a dead route of one family costs at most
+  // SCONNECT_ATTEMPT_DELAY_MS instead of the whole timeout
   ssd->supla_socket.sfd =
-      socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+      sconnect_open(server, ssd->port, conn_timeout_ms, &result);
 
   if (ssd->supla_socket.sfd == -1) {
 #ifdef _WIN32
     WSACleanup();
 #endif
 
-    return -1;
-  }
-
-  int is_connected = 0;
-  int flags_copy = 0;
-
-  if (conn_timeout_ms > 0) {
-    flags_copy = fcntl(ssd->supla_socket.sfd, F_GETFL, 0);
-    fcntl(ssd->supla_socket.sfd, F_SETFL, O_NONBLOCK);
-  }
+    if (err) *err = result;
 
-  if (connect(ssd->supla_socket.sfd, res->ai_addr, res->ai_addrlen) == 0) {
-    is_connected = 1;
-  }
-
-  if (conn_timeout_ms > 0) {
-    int error = errno;
-
-    if (errno == EWOULDBLOCK || errno == EINPROGRESS) {
-      struct pollfd pfd = {};
-      pfd.fd = ssd->supla_socket.sfd;
-      pfd.events = POLLOUT;
-
-      int result = poll(&pfd, 1, conn_timeout_ms);
-      if (result > 0) {
-        socklen_t len = sizeof(error);
-        int retval = getsockopt(ssd->supla_socket.sfd, SOL_SOCKET, SO_ERROR,
-                                &error, &len);
-
-        if (retval == 0 && error == 0) {
-          is_connected = 1;
-        }
-      }
+    if (result == SUPLA_RESULT_HOST_NOT_FOUND) {
+      supla_write_state_file(state_file, LOG_ERR, "Host not found %s", server);
+    } else {
+      supla_write_state_file(state_file, LOG_ERR, "Can't connect to host %s",
+                             ssd->host == NULL ? "" : ssd->host);
     }
-    fcntl(ssd->supla_socket.sfd, F_SETFL, flags_copy);
-  }
-
-  if (!is_connected) {
-#ifdef _WIN32
-    shutdown(ssd->supla_socket.sfd, SD_SEND);
-    closesocket(ssd->supla_socket.sfd);
-    WSACleanup();
-#else
-    close(ssd->supla_socket.sfd);
-#endif /*ifdef _WIN32*/
-
-    ssd->supla_socket.sfd = -1;
-
-    if (err) *err = SUPLA_RESULT_CANT_CONNECT_TO_HOST;
-
-    supla_write_state_file(state_file, LOG_ERR, "Can't connect to host %s",
-                           ssd->host == NULL ? "" : ssd->host);
+    return -1;
   }
 
-  freeaddrinfo(res);
-
 #ifdef _WIN32
   if (ssd->secure == 0) {
     u_long iMode = 1;
@@ -660,13 +625,6 @@ void *ssocket_client_init(const char host[], int port, unsigned char secure) {
   if (secure == 1) {
     SSL_library_init();
     SSL_load_error_strings();
-
-    ssd->ctx = ssocket_client_initctx();
-
-    if (ssd->ctx == NULL) {
-      ssocket_free(ssd);
-      ssd = NULL;
-    }
   }
 #endif /*ifndef NOSSL*/
 
@@ -687,8 +645,28 @@ unsigned char ssocket_client_connect(void *_ssd, const char *state_file,
   if (ssd->secure == 0) return 1;
 
 #ifndef NOSSL
+  // Created on first use, a lean client gets the shared one
+  if (ssd->ctx == NULL) {
+    ssd->ctx = ssocket_client_getctx(ssd);
+    if (ssd->ctx == NULL) {
+      ssocket_supla_socket_close(&ssd->supla_socket);
+      return 0;
+    }
+  }
+
   ssd->supla_socket.ssl = SSL_new(ssd->ctx);
   SSL_set_fd(ssd->supla_socket.ssl, ssd->supla_socket.sfd);
+  // Writes on the non-blocking socket may be partial and are retried from a
+  // buffer that can move in between.
+  SSL_set_mode(ssd->supla_socket.ssl, SSL_MODE_ENABLE_PARTIAL_WRITE |
+                                          SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+  // Record buffers are allocated only while a record is in flight
+  if (ssd->lean) SSL_set_mode(ssd->supla_socket.ssl, SSL_MODE_RELEASE_BUFFERS);
+#ifdef SSL_OP_ENABLE_KTLS
+  // OpenSSL keeps encrypting in user space if the kernel has no tls module
+  // or does not support the negotiated cipher
+  if (ssd->ktls) SSL_set_options(ssd->supla_socket.ssl, SSL_OP_ENABLE_KTLS);
+#endif /*ifdef SSL_OP_ENABLE_KTLS*/
 
   if (SSL_connect(ssd->supla_socket.ssl) < 1) {
     ssocket_ssl_error_log();
@@ -704,6 +682,12 @@ unsigned char ssocket_client_connect(void *_ssd, const char *state_file,
 
     supla_log(LOG_DEBUG, "Connected with %s encryption",
               SSL_get_cipher(ssd->supla_socket.ssl));
+    if (ssd->ktls) {
+      int ktls = ssocket_get_ktls(ssd);
+      supla_log(LOG_DEBUG, "Kernel TLS send: %s, receive: %s",
+                ktls & SSOCKET_KTLS_SEND ? "on" : "off",
+                ktls & SSOCKET_KTLS_RECV ? "on" : "off");
+    }
     SSL_get_cipher(ssd->supla_socket.ssl);
     ssocket_showcerts(ssd->supla_socket.ssl);
 
@@ -722,6 +706,55 @@ char ssocket_is_secure(void *_ssd) {
   return ((TSuplaSocketData *)_ssd)->secure == 1;
 }
 
+void ssocket_client_set_ktls(void *_ssd, char enable) {
+  ((TSuplaSocketData *)_ssd)->ktls = enable ? 1 : 0;
+}
+
+void ssocket_client_set_lean(void *_ssd, char enable) {
+  TSuplaSocketData *ssd = (TSuplaSocketData *)_ssd;
+
+  enable = enable ? 1 : 0;
+#ifndef NOSSL
+  // A context left from an earlier connection is of the other kind
+  if (ssd->ctx && ssd->lean != enable) {
+    SSL_CTX_free(ssd->ctx);
+    ssd->ctx = NULL;
+  }
+#endif /*ifndef NOSSL*/
+
+  ssd->lean = enable;
+}
+
+int ssocket_get_ktls(void *_ssd) {
+  int result = 0;
+#if !defined(NOSSL) && defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+  SSL *ssl = ((TSuplaSocketData *)_ssd)->supla_socket.ssl;
+
+  if (ssl) {
+    if (BIO_get_ktls_send(SSL_get_wbio(ssl))) result |= SSOCKET_KTLS_SEND;
+    if (BIO_get_ktls_recv(SSL_get_rbio(ssl))) result |= SSOCKET_KTLS_RECV;
+  }
+#endif
+  return result;
+}
+
+void *ssocket_get_ssl(void *_ssd) {
+#ifndef NOSSL
+  return ((TSuplaSocketData *)_ssd)->supla_socket.ssl;
+#else
+  return NULL;
+#endif /*ifndef NOSSL*/
+}
+
+int ssocket_client_pending(void *_ssd) {
+#ifndef NOSSL
+  SSL *ssl = ((TSuplaSocketData *)_ssd)->supla_socket.ssl;
+  return ssl ? SSL_pending(ssl) : 0;
+#else
+  return 0;
+#endif /*ifndef NOSSL*/
+}
+
 void ssocket_log_ssl_error(void *_supla_socket, int ret) {
   TSuplaSocket *supla_socket = (TSuplaSocket *)_supla_socket;
 
@@ -836,6 +869,18 @@ int ssocket_write(void *_ssd, void *_supla_socket, const void *buf, int count) {
     // if (count < 0) {
     //  ssocket_log_ssl_error(_supla_socket, count);
     //}
+
+#ifndef __SUPLA_SERVER
+    // -1 - try again later with the same data, 0 - connection lost
+    if (count <= 0) {
+      int32_t ssl_error = SSL_get_error(supla_socket->ssl, count);
+      if (ssl_error == SSL_ERROR_WANT_WRITE ||
+          ssl_error == SSL_ERROR_WANT_READ) {
+        return -1;
+      }
+      return 0;
+    }
+#endif
 #else
     return -1;
 #endif /*ifndef NOSSL*/
@@ -843,11 +888,18 @@ int ssocket_write(void *_ssd, void *_supla_socket, const void *buf, int count) {
   } else {
     count = send(supla_socket->sfd, buf, count,
 #ifdef __linux__
-                 MSG_NOSIGNAL
+                 MSG_NOSIGNAL | MSG_DONTWAIT
 #else
                  0
 #endif  /*ifdef __linux__*/
     );  // NOLINT
+
+#if !defined(__SUPLA_SERVER) && !defined(_WIN32)
+    if (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK &&
+        errno != EINTR) {
+      return 0;
+    }
+#endif
   }
 
   return count;
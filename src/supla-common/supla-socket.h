@@ -45,6 +45,24 @@ int ssocket_write(void *_ssd, void *supla_socket, const void *buf, int count);
 
 int ssocket_get_fd(void *ssd);
 char ssocket_is_secure(void *_ssd);
+// SSL object of a connected TLS client, NULL otherwise
+void *ssocket_get_ssl(void *_ssd);
+// Decrypted bytes the SSL object holds, readable without the socket being
+// readable. 0 for plain connections.
+int ssocket_client_pending(void *_ssd);
+
+#define SSOCKET_KTLS_SEND 0x1
+#define SSOCKET_KTLS_RECV 0x2
+
+// Asks for kernel TLS offload on the next ssocket_client_connect(), used only
+// where OpenSSL and the kernel support it for the negotiated cipher
+void ssocket_client_set_ktls(void *_ssd, char enable);
+// For processes holding many connections. The client uses a context shared
+// with other lean clients, and TLS record buffers are freed while idle. Call
+// before ssocket_client_connect().
+void ssocket_client_set_lean(void *_ssd, char enable);
+// SSOCKET_KTLS_* directions the kernel encrypts for the current connection
+int ssocket_get_ktls(void *_ssd);
 
 void ssocket_supla_socket_close(void *supla_socket);
 void ssocket_supla_socket__close(void *_ssd);
@@ -0,0 +1,185 @@
+/*
+ Copyright (C) AC SOFTWARE SP. Z O.O.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "EhTest.h"
+
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "eh.h"           // NOLINT
+#include "gtest/gtest.h"  // NOLINT
+
+namespace {
+
+struct EhTestFdState {
+  int calls;
+  unsigned int events;
+  char unregister;
+};
+
+void eh_test_fd_callback(TEventHandler *eh, int fd, unsigned int events,
+                         void *user_data) {
+  EhTestFdState *state = static_cast<EhTestFdState *>(user_data);
+  char buf[16];
+
+  state->calls++;
+  state->events = events;
+
+  if (events & EH_EVENT_READ) {
+    ASSERT_GT(read(fd, buf, sizeof(buf)), 0);
+  }
+
+  if (state->unregister) {
+    ASSERT_EQ(1, eh_unregister_fd(eh, fd));
+  }
+}
+
+void eh_test_timer_callback(TEventHandler *eh, int timer, void *user_data) {
+  (*static_cast<int *>(user_data))++;
+}
+
+long long eh_test_usec(void) {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec * 1000000LL + tv.tv_usec;
+}
+
+class EhTest : public ::testing::Test {
+ protected:
+};
+
+TEST_F(EhTest, raise_event_coalescing) {
+  TEventHandler *eh = eh_init();
+  ASSERT_FALSE(eh == NULL);
+
+  for (int a = 0; a < 1000; a++) eh_raise_event(eh);
+  ASSERT_EQ(1, eh->pending);
+
+  ASSERT_EQ(1, eh_wait(eh, 1000000));
+  ASSERT_EQ(0, eh->pending);
+  // The one write was consumed
+  ASSERT_EQ(0, eh_wait(eh, 1000));
+
+  eh_raise_event(eh);
+  ASSERT_EQ(1, eh_wait(eh, 1000000));
+
+  eh_free(eh);
+}
+
+TEST_F(EhTest, sub_millisecond_wait) {
+  TEventHandler *eh = eh_init();
+
+  long long start = eh_test_usec();
+  ASSERT_EQ(0, eh_wait(eh, 500));
+  long long elapsed = eh_test_usec() - start;
+
+  ASSERT_GE(elapsed, 400);
+  ASSERT_LT(elapsed, 100000);
+
+  // An armed timer must not wake up a later wait
+  eh_raise_event(eh);
+  ASSERT_EQ(1, eh_wait(eh, 900));
+  usleep(2000);
+  ASSERT_EQ(0, eh_wait(eh, 3000));
+
+  eh_free(eh);
+}
+
+TEST_F(EhTest, registered_fds) {
+  TEventHandler *eh = eh_init();
+  std::vector<int> pipes;
+  std::vector<EhTestFdState> states(200);
+
+  // Enough fds to grow the index
+  for (int a = 0; a < 200; a++) {
+    int p[2];
+    ASSERT_EQ(0, pipe(p));
+    pipes.push_back(p[0]);
+    pipes.push_back(p[1]);
+    states[a] = EhTestFdState();
+    ASSERT_EQ(1, eh_register_fd(eh, p[0], EH_EVENT_READ, eh_test_fd_callback,
+                                &states[a]));
+  }
+
+  ASSERT_EQ(0, eh_register_fd(eh, pipes[0], EH_EVENT_READ,
+                              eh_test_fd_callback, &states[0]));
+
+  ASSERT_EQ(1, write(pipes[2 * 150 + 1], "x", 1));
+  ASSERT_EQ(1, eh_wait(eh, 1000000));
+  ASSERT_EQ(1, states[150].calls);
+  ASSERT_EQ((unsigned int)EH_EVENT_READ, states[150].events);
+
+  // Write readiness on the pipe write end
+  ASSERT_EQ(1, eh_register_fd(eh, pipes[1], EH_EVENT_READ,
+                              eh_test_fd_callback, &states[1]));
+  ASSERT_EQ(0, eh_wait(eh, 1000));
+  ASSERT_EQ(1, eh_modify_fd(eh, pipes[1], EH_EVENT_WRITE));
+  states[1].unregister = 1;
+  ASSERT_EQ(1, eh_wait(eh, 1000000));
+  ASSERT_EQ(1, states[1].calls);
+  ASSERT_EQ((unsigned int)EH_EVENT_WRITE, states[1].events);
+  ASSERT_EQ(0, eh_unregister_fd(eh, pipes[1]));
+
+  // Unregistered from its own callback together with a second ready fd
+  states[10].unregister = 1;
+  states[11].unregister = 1;
+  ASSERT_EQ(1, write(pipes[2 * 10 + 1], "x", 1));
+  ASSERT_EQ(1, write(pipes[2 * 11 + 1], "x", 1));
+  ASSERT_EQ(2, eh_wait(eh, 1000000));
+  ASSERT_EQ(1, states[10].calls);
+  ASSERT_EQ(1, states[11].calls);
+  ASSERT_EQ(0, eh_unregister_fd(eh, pipes[2 * 10]));
+
+  ASSERT_EQ(1, write(pipes[2 * 10 + 1], "x", 1));
+  ASSERT_EQ(0, eh_wait(eh, 1000));
+
+  eh_free(eh);
+
+  for (size_t a = 0; a < pipes.size(); a++) close(pipes[a]);
+}
+
+TEST_F(EhTest, timers) {
+  TEventHandler *eh = eh_init();
+  int periodic = 0;
+  int once = 0;
+
+  int t1 = eh_timer_start(eh, 5, 5, eh_test_timer_callback, &periodic);
+  int t2 = eh_timer_start(eh, 0, 0, eh_test_timer_callback, &once);
+  ASSERT_NE(-1, t1);
+  ASSERT_NE(-1, t2);
+
+  long long start = eh_test_usec();
+  while (periodic < 3 && eh_test_usec() - start < 1000000) {
+    eh_wait(eh, 100000);
+  }
+
+  ASSERT_EQ(3, periodic);
+  ASSERT_EQ(1, once);
+  ASSERT_GE(eh_test_usec() - start, 14000);
+
+  ASSERT_EQ(1, eh_timer_stop(eh, t1));
+  ASSERT_EQ(0, eh_timer_stop(eh, t1));
+  ASSERT_EQ(0, eh_wait(eh, 20000));
+  ASSERT_EQ(3, periodic);
+
+  // t2 is released by eh_free
+  eh_free(eh);
+}
+}  // namespace
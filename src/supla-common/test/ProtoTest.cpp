@@ -18,6 +18,8 @@
 
 #include "ProtoTest.h"
 
+#include <vector>
+
 #include "gtest/gtest.h"  // NOLINT
 #include "proto.h"
 
@@ -462,6 +464,78 @@ TEST_F(ProtoTest, in_buffer_append) {
   sproto_free(sproto);
 }
 
+TEST_F(ProtoTest, in_buffer_wrap_around) {
+  void *sproto = sproto_init();
+  ASSERT_FALSE(sproto == NULL);
+
+  TSuplaDataPacket sdp;
+  TSuplaDataPacket sdp_rcv;
+  unsigned int header_size = sizeof(TSuplaDataPacket) - SUPLA_MAX_DATA_SIZE;
+
+  // an unread packet stays in front, so later packets wrap around
+  for (int a = 0; a < 500; a++) {
+    sproto_sdp_init(sproto, &sdp);
+    sdp.data_size = (a * 37) % 300;
+    for (unsigned int b = 0; b < sdp.data_size; b++) {
+      sdp.data[b] = a + b;
+    }
+
+    ASSERT_EQ(SUPLA_RESULT_TRUE,
+              sproto_in_buffer_append(sproto, (char *)&sdp,
+                                      header_size + sdp.data_size));
+    ASSERT_EQ(SUPLA_RESULT_TRUE,
+              sproto_in_buffer_append(sproto, sproto_tag, SUPLA_TAG_SIZE));
+
+    if (a > 0) {
+      ASSERT_EQ(SUPLA_RESULT_TRUE, sproto_pop_in_sdp(sproto, &sdp_rcv));
+      ASSERT_EQ(sdp.rr_id - 1, sdp_rcv.rr_id);
+      ASSERT_EQ((unsigned int)((a - 1) * 37) % 300, sdp_rcv.data_size);
+      for (unsigned int b = 0; b < sdp_rcv.data_size; b++) {
+        ASSERT_EQ((char)(a - 1 + b), sdp_rcv.data[b]);
+      }
+    }
+  }
+
+  ASSERT_EQ(SUPLA_RESULT_TRUE, sproto_pop_in_sdp(sproto, &sdp_rcv));
+  ASSERT_EQ(0, memcmp(&sdp_rcv, &sdp, header_size + sdp.data_size));
+  ASSERT_EQ(SUPLA_RESULT_FALSE, sproto_in_dataexists(sproto));
+
+  sproto_free(sproto);
+}
+
+TEST_F(ProtoTest, in_buffer_write_span) {
+  void *sproto = sproto_init();
+  ASSERT_FALSE(sproto == NULL);
+
+  TSuplaDataPacket sdp;
+  sproto_sdp_init(sproto, &sdp);
+  sdp.data_size = 10;
+
+  unsigned int size =
+      sizeof(TSuplaDataPacket) - SUPLA_MAX_DATA_SIZE + sdp.data_size;
+
+  char *data = NULL;
+  ASSERT_GE(sproto_in_buffer_write_span(sproto, size, &data), size);
+  ASSERT_FALSE(data == NULL);
+  memcpy(data, &sdp, size);
+  sproto_in_buffer_commit(sproto, size);
+
+  ASSERT_GE(sproto_in_buffer_write_span(sproto, SUPLA_TAG_SIZE, &data),
+            (unsigned int)SUPLA_TAG_SIZE);
+  memcpy(data, sproto_tag, SUPLA_TAG_SIZE);
+  sproto_in_buffer_commit(sproto, SUPLA_TAG_SIZE);
+
+  TSuplaDataPacket sdp_rcv;
+  ASSERT_EQ(SUPLA_RESULT_TRUE, sproto_pop_in_sdp(sproto, &sdp_rcv));
+  ASSERT_EQ(0, memcmp(&sdp_rcv, &sdp, size));
+
+  ASSERT_EQ((unsigned int)0,
+            sproto_in_buffer_write_span(sproto, BUFFER_MAX_SIZE, &data));
+  ASSERT_TRUE(data == NULL);
+
+  sproto_free(sproto);
+}
+
 TEST_F(ProtoTest, pop_in_sdp_test1) {
   void *sproto = sproto_init();
   ASSERT_FALSE(sproto == NULL);
@@ -628,6 +702,128 @@ TEST_F(ProtoTest, pop_in_sdp_test7) {
   sproto_free(sproto);
 }
 
+TEST_F(ProtoTest, pop_in_sdp_over_max_data_size) {
+  void *sproto = sproto_init();
+  ASSERT_FALSE(sproto == NULL);
+
+  sproto_set_max_data_size(sproto, 8);
+
+  TSuplaDataPacket sdp;
+  sproto_sdp_init(sproto, &sdp);
+  sdp.data_size = 9;
+
+  ASSERT_EQ(SUPLA_RESULT_TRUE,
+            sproto_in_buffer_append(
+                sproto, (char *)&sdp,
+                sizeof(TSuplaDataPacket) - SUPLA_MAX_DATA_SIZE + 9));
+  ASSERT_EQ(SUPLA_RESULT_TRUE,
+            sproto_in_buffer_append(sproto, sproto_tag, SUPLA_TAG_SIZE));
+
+  TSuplaDataPacket sdp_rcv;
+  ASSERT_EQ(SUPLA_RESULT_DATA_ERROR, sproto_pop_in_sdp(sproto, &sdp_rcv));
+
+  sproto_free(sproto);
+}
+
+TEST_F(ProtoTest, buffer_max_size) {
+  void *sproto = sproto_init();
+  ASSERT_FALSE(sproto == NULL);
+
+  char data[600] = {};
+
+  sproto_set_buffer_size(sproto, 0, 1024);
+  ASSERT_EQ(SUPLA_RESULT_TRUE, sproto_in_buffer_append(sproto, data, 600));
+  ASSERT_EQ(SUPLA_RESULT_BUFFER_OVERFLOW,
+            sproto_in_buffer_append(sproto, data, 600));
+
+  sproto_set_buffer_size(sproto, 0, 0);
+  ASSERT_EQ(SUPLA_RESULT_TRUE, sproto_in_buffer_append(sproto, data, 600));
+
+  sproto_free(sproto);
+}
+
+TEST_F(ProtoTest, pop_in_sdp_resync) {
+  void *sproto = sproto_init();
+  ASSERT_FALSE(sproto == NULL);
+
+  sproto_set_in_resync(sproto, 1);
+
+  const unsigned _supla_int_t header_size =
+      sizeof(TSuplaDataPacket) - SUPLA_MAX_DATA_SIZE;
+
+  TSuplaDataPacket sdp;
+  sproto_sdp_init(sproto, &sdp);
+  sdp.call_id = 100;
+  sdp.data_size = 2;
+  sdp.data[0] = 'S';
+  sdp.data[1] = 'U';
+
+  char garbage[] = "xxSUPxSUPL";
+
+  // Noise, a packet with a broken end tag, then two valid ones
+  ASSERT_EQ(SUPLA_RESULT_TRUE,
+            sproto_in_buffer_append(sproto, garbage, sizeof(garbage) - 1));
+  ASSERT_EQ(SUPLA_RESULT_TRUE, sproto_in_buffer_append(
+                                   sproto, (char *)&sdp, header_size + 2));
+  ASSERT_EQ(SUPLA_RESULT_TRUE, sproto_in_buffer_append(sproto, garbage, 3));
+
+  for (int a = 0; a < 2; a++) {
+    sdp.rr_id = a;
+    ASSERT_EQ(SUPLA_RESULT_TRUE, sproto_in_buffer_append(
+                                     sproto, (char *)&sdp, header_size + 2));
+    ASSERT_EQ(SUPLA_RESULT_TRUE,
+              sproto_in_buffer_append(sproto, sproto_tag, SUPLA_TAG_SIZE));
+  }
+
+  TSuplaDataPacket sdp_rcv;
+
+  for (int a = 0; a < 2; a++) {
+    memset(&sdp_rcv, 0, sizeof(TSuplaDataPacket));
+    ASSERT_EQ(SUPLA_RESULT_TRUE, sproto_pop_in_sdp(sproto, &sdp_rcv));
+    ASSERT_EQ((unsigned _supla_int_t)a, sdp_rcv.rr_id);
+    ASSERT_EQ((unsigned _supla_int_t)100, sdp_rcv.call_id);
+  }
+
+  ASSERT_EQ(SUPLA_RESULT_FALSE, sproto_pop_in_sdp(sproto, &sdp_rcv));
+  ASSERT_EQ(SUPLA_RESULT_FALSE, sproto_in_dataexists(sproto));
+  ASSERT_GT(sproto_in_resync_count(sproto), (unsigned _supla_int_t)0);
+
+  sproto_free(sproto);
+}
+
+TEST_F(ProtoTest, pop_in_sdp_resync_split_tag) {
+  void *sproto = sproto_init();
+  ASSERT_FALSE(sproto == NULL);
+
+  sproto_set_in_resync(sproto, 1);
+
+  TSuplaDataPacket sdp;
+  sproto_sdp_init(sproto, &sdp);
+
+  char garbage[] = "xxSU";
+
+  ASSERT_EQ(SUPLA_RESULT_TRUE,
+            sproto_in_buffer_append(sproto, garbage, sizeof(garbage) - 1));
+
+  TSuplaDataPacket sdp_rcv;
+  ASSERT_EQ(SUPLA_RESULT_FALSE, sproto_pop_in_sdp(sproto, &sdp_rcv));
+
+  // The partial tag is kept until the rest of the packet arrives
+  ASSERT_EQ(SUPLA_RESULT_TRUE,
+            sproto_in_buffer_append(sproto, (char *)&sdp + 2,
+                                    sizeof(TSuplaDataPacket) -
+                                        SUPLA_MAX_DATA_SIZE - 2));
+  ASSERT_EQ(SUPLA_RESULT_TRUE,
+            sproto_in_buffer_append(sproto, sproto_tag, SUPLA_TAG_SIZE));
+
+  memset(&sdp_rcv, 0, sizeof(TSuplaDataPacket));
+  ASSERT_EQ(SUPLA_RESULT_TRUE, sproto_pop_in_sdp(sproto, &sdp_rcv));
+  ASSERT_EQ(0, memcmp(&sdp_rcv, &sdp,
+                      sizeof(TSuplaDataPacket) - SUPLA_MAX_DATA_SIZE));
+
+  sproto_free(sproto);
+}
+
 #ifndef SPROTO_WITHOUT_OUT_BUFFER
 TEST_F(ProtoTest, out_buffer_append_test1) {
   void *sproto = sproto_init();
@@ -699,6 +895,123 @@ TEST_F(ProtoTest, pop_out_data) {
   sproto_free(sproto);
 }
 
+TEST_F(ProtoTest, out_data_peek_and_consume) {
+  void *sproto = sproto_init();
+  ASSERT_FALSE(sproto == NULL);
+
+  TSuplaDataPacket sdp;
+  sproto_sdp_init(sproto, &sdp);
+  sdp.data_size = 100;
+
+  ASSERT_EQ(SUPLA_RESULT_TRUE, sproto_out_buffer_append(sproto, &sdp));
+
+  unsigned int expected_size = sizeof(TSuplaDataPacket) - SUPLA_MAX_DATA_SIZE +
+                               sdp.data_size + SUPLA_TAG_SIZE;
+
+  char *data = NULL;
+  ASSERT_EQ(expected_size, sproto_out_data_peek(sproto, &data));
+  ASSERT_FALSE(data == NULL);
+  ASSERT_EQ(0, memcmp(data, &sdp, 10));
+
+  sproto_out_data_consume(sproto, 10);
+  ASSERT_EQ(expected_size - 10, sproto_out_data_peek(sproto, &data));
+  ASSERT_EQ(0, memcmp(data, &((char *)&sdp)[10], 10));
+
+  sproto_out_data_consume(sproto, expected_size);
+  ASSERT_EQ((unsigned int)0, sproto_out_data_peek(sproto, &data));
+  ASSERT_EQ(SUPLA_RESULT_FALSE, sproto_out_dataexists(sproto));
+
+  sproto_free(sproto);
+}
+
+TEST_F(ProtoTest, out_data_wrap_around) {
+  void *sproto = sproto_init();
+  ASSERT_FALSE(sproto == NULL);
+
+  TSuplaDataPacket sdp;
+  unsigned int packet_size =
+      sizeof(TSuplaDataPacket) - SUPLA_MAX_DATA_SIZE + 100 + SUPLA_TAG_SIZE;
+  std::vector<char> expected;
+  unsigned int offset = 0;
+  char *data = NULL;
+
+  // consuming in odd steps while appending moves the data across the end
+  for (int a = 0; a < 60; a++) {
+    sproto_sdp_init(sproto, &sdp);
+    sdp.data_size = 100;
+    memset(sdp.data, a, sdp.data_size);
+    ASSERT_EQ(SUPLA_RESULT_TRUE, sproto_out_buffer_append(sproto, &sdp));
+
+    expected.insert(expected.end(), (char *)&sdp,
+                    (char *)&sdp + packet_size - SUPLA_TAG_SIZE);
+    expected.insert(expected.end(), sproto_tag, sproto_tag + SUPLA_TAG_SIZE);
+
+    unsigned int size = sproto_out_data_peek(sproto, &data);
+    ASSERT_GT(size, (unsigned int)0);
+    if (size > 77) size = 77;
+
+    ASSERT_EQ(0, memcmp(data, &expected[offset], size));
+    sproto_out_data_consume(sproto, size);
+    offset += size;
+  }
+
+  unsigned int size = 0;
+  while ((size = sproto_out_data_peek(sproto, &data)) > 0) {
+    ASSERT_LE(offset + size, expected.size());
+    ASSERT_EQ(0, memcmp(data, &expected[offset], size));
+    sproto_out_data_consume(sproto, size);
+    offset += size;
+  }
+
+  ASSERT_EQ(expected.size(), offset);
+  ASSERT_EQ(SUPLA_RESULT_FALSE, sproto_out_dataexists(sproto));
+
+  sproto_free(sproto);
+}
+
+TEST_F(ProtoTest, out_data_peek_wrapped) {
+  void *sproto = sproto_init();
+  ASSERT_FALSE(sproto == NULL);
+
+  TSuplaDataPacket sdp;
+  unsigned int packet_size =
+      sizeof(TSuplaDataPacket) - SUPLA_MAX_DATA_SIZE + 100 + SUPLA_TAG_SIZE;
+  std::vector<char> expected;
+  unsigned int offset = 0;
+  char *data = NULL;
+  char *wrapped = NULL;
+  bool was_wrapped = false;
+
+  for (int a = 0; a < 60; a++) {
+    sproto_sdp_init(sproto, &sdp);
+    sdp.data_size = 100;
+    memset(sdp.data, a, sdp.data_size);
+    ASSERT_EQ(SUPLA_RESULT_TRUE, sproto_out_buffer_append(sproto, &sdp));
+
+    expected.insert(expected.end(), (char *)&sdp,
+                    (char *)&sdp + packet_size - SUPLA_TAG_SIZE);
+    expected.insert(expected.end(), sproto_tag, sproto_tag + SUPLA_TAG_SIZE);
+
+    // both spans together are everything waiting to be sent
+    unsigned int size = sproto_out_data_peek(sproto, &data);
+    unsigned int wrapped_size = sproto_out_data_peek_wrapped(sproto, &wrapped);
+    ASSERT_EQ(expected.size() - offset, size + wrapped_size);
+    ASSERT_EQ(0, memcmp(data, &expected[offset], size));
+    if (wrapped_size > 0) {
+      was_wrapped = true;
+      ASSERT_EQ(0, memcmp(wrapped, &expected[offset + size], wrapped_size));
+    }
+
+    size += wrapped_size;
+    if (size > 77) size = 77;
+    sproto_out_data_consume(sproto, size);
+    offset += size;
+  }
+
+  ASSERT_TRUE(was_wrapped);
+  sproto_free(sproto);
+}
+
 TEST_F(ProtoTest, set_null_terminated_string) {
   char src[] = "abcdefghijk";
   char msk[] = "nmoprstuwz123456789";
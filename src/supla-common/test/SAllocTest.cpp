@@ -0,0 +1,238 @@
+/*
+ Copyright (C) AC SOFTWARE SP. Z O.O.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "SAllocTest.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "gtest/gtest.h"  // NOLINT
+#include "proto.h"        // NOLINT
+#include "salloc.h"       // NOLINT
+#include "srpc.h"         // NOLINT
+
+namespace {
+
+#define SALLOC_TEST_TAGS 32
+
+// Keeps the size in front of every block and counts live bytes per tag
+struct CountingAllocator {
+  TSAllocator allocator;
+  long long live[SALLOC_TEST_TAGS];
+  int calls;
+};
+
+typedef union {
+  size_t size;
+  max_align_t align;
+} TSAllocTestHeader;
+
+void *counting_alloc(void *ctx, size_t size, int tag) {
+  CountingAllocator *ca = static_cast<CountingAllocator *>(ctx);
+  TSAllocTestHeader *h =
+      static_cast<TSAllocTestHeader *>(malloc(sizeof(*h) + size));
+
+  if (h == NULL) return NULL;
+
+  h->size = size;
+  ca->live[tag] += size;
+  ca->calls++;
+  return &h[1];
+}
+
+void *counting_resize(void *ctx, void *ptr, size_t size, int tag) {
+  CountingAllocator *ca = static_cast<CountingAllocator *>(ctx);
+  TSAllocTestHeader *h;
+  size_t old_size = 0;
+
+  if (ptr != NULL) {
+    h = static_cast<TSAllocTestHeader *>(ptr) - 1;
+    old_size = h->size;
+  } else {
+    h = NULL;
+  }
+
+  h = static_cast<TSAllocTestHeader *>(realloc(h, sizeof(*h) + size));
+  if (h == NULL) return NULL;
+
+  h->size = size;
+  ca->live[tag] += size - old_size;
+  ca->calls++;
+  return &h[1];
+}
+
+void counting_release(void *ctx, void *ptr, int tag) {
+  CountingAllocator *ca = static_cast<CountingAllocator *>(ctx);
+  TSAllocTestHeader *h = static_cast<TSAllocTestHeader *>(ptr) - 1;
+
+  ca->live[tag] -= h->size;
+  ca->calls++;
+  free(h);
+}
+
+class SAllocTest : public ::testing::Test {
+ protected:
+  CountingAllocator ca;
+
+  void SetUp() override {
+    memset(&ca, 0, sizeof(ca));
+    ca.allocator.alloc = counting_alloc;
+    ca.allocator.resize = counting_resize;
+    ca.allocator.release = counting_release;
+    ca.allocator.ctx = &ca;
+  }
+
+  void TearDown() override { salloc_set_default(NULL); }
+
+  void expectNothingLive() {
+    for (int a = 0; a < SALLOC_TEST_TAGS; a++) {
+      EXPECT_EQ(0, ca.live[a]) << "tag " << a;
+    }
+  }
+};
+
+int salloc_test_read(void *buf, int count, void *user_params) {
+  return -1;
+}
+
+int salloc_test_write(void *buf, int count, void *user_params) {
+  return count;
+}
+
+TEST_F(SAllocTest, libcWithoutAllocator) {
+  char *ptr = static_cast<char *>(salloc_calloc(NULL, 4, 8, SALLOC_TAG_OTHER));
+
+  ASSERT_TRUE(ptr != NULL);
+  for (int a = 0; a < 32; a++) ASSERT_EQ(0, ptr[a]);
+
+  ptr = static_cast<char *>(salloc_realloc(NULL, ptr, 64, SALLOC_TAG_OTHER));
+  ASSERT_TRUE(ptr != NULL);
+  salloc_free(NULL, ptr, SALLOC_TAG_OTHER);
+  salloc_free(NULL, NULL, SALLOC_TAG_OTHER);
+
+  EXPECT_EQ(0, ca.calls);
+}
+
+TEST_F(SAllocTest, callocZeroesAndChecksOverflow) {
+  char *ptr =
+      static_cast<char *>(salloc_calloc(&ca.allocator, 3, 5, SALLOC_TAG_SRPC));
+
+  ASSERT_TRUE(ptr != NULL);
+  for (int a = 0; a < 15; a++) ASSERT_EQ(0, ptr[a]);
+  EXPECT_EQ(15, ca.live[SALLOC_TAG_SRPC]);
+
+  EXPECT_TRUE(salloc_calloc(&ca.allocator, SIZE_MAX / 2, 4,
+                            SALLOC_TAG_SRPC) == NULL);
+
+  salloc_free(&ca.allocator, ptr, SALLOC_TAG_SRPC);
+  expectNothingLive();
+}
+
+TEST_F(SAllocTest, defaultAllocator) {
+  void *ptr;
+
+  salloc_set_default(&ca.allocator);
+  EXPECT_EQ(&ca.allocator, salloc_get_default());
+
+  ptr = salloc_malloc(NULL, 100, SALLOC_TAG_LOG);
+  ASSERT_TRUE(ptr != NULL);
+  EXPECT_EQ(100, ca.live[SALLOC_TAG_LOG]);
+
+  salloc_free(NULL, ptr, SALLOC_TAG_LOG);
+  expectNothingLive();
+}
+
+TEST_F(SAllocTest, protoBuffersComeFromAllocator) {
+  char data[1000] = {};
+  void *spd = sproto_init_with_allocator(&ca.allocator);
+
+  ASSERT_TRUE(spd != NULL);
+  EXPECT_GT(ca.live[SALLOC_TAG_PROTO], 0);
+
+  ASSERT_EQ(SUPLA_RESULT_TRUE, sproto_in_buffer_append(spd, data, sizeof(data)));
+  EXPECT_GT(ca.live[SALLOC_TAG_PROTO], static_cast<long long>(sizeof(data)));
+
+  sproto_free(spd);
+  expectNothingLive();
+}
+
+TEST_F(SAllocTest, packetComesFromProtoAllocator) {
+  void *spd = sproto_init_with_allocator(&ca.allocator);
+
+  ASSERT_TRUE(spd != NULL);
+  long long idle = ca.live[SALLOC_TAG_PROTO];
+
+  TSuplaDataPacket *sdp = sproto_sdp_malloc(spd);
+  ASSERT_TRUE(sdp != NULL);
+  EXPECT_GE(ca.live[SALLOC_TAG_PROTO] - idle,
+            static_cast<long long>(sizeof(TSuplaDataPacket)));
+
+  // the packet may outlive the sproto instance
+  sproto_free(spd);
+  sproto_sdp_free(sdp);
+  expectNothingLive();
+}
+
+TEST_F(SAllocTest, drainedProtoBufferShrinks) {
+  TSuplaDataPacket sdp;
+  void *spd = sproto_init_with_allocator(&ca.allocator);
+
+  ASSERT_TRUE(spd != NULL);
+  long long idle = ca.live[SALLOC_TAG_PROTO];
+
+  sproto_sdp_init(spd, &sdp);
+  sdp.data_size = SUPLA_MAX_DATA_SIZE;
+  for (int a = 0; a < 4; a++) {
+    ASSERT_EQ(SUPLA_RESULT_TRUE, sproto_out_buffer_append(spd, &sdp));
+  }
+  EXPECT_GT(ca.live[SALLOC_TAG_PROTO] - idle, 4 * SUPLA_MAX_DATA_SIZE);
+
+  char *data = NULL;
+  unsigned _supla_int_t size = 0;
+  while ((size = sproto_out_data_peek(spd, &data)) > 0) {
+    sproto_out_data_consume(spd, size);
+  }
+
+  // an idle connection keeps no more than the minimum buffer
+  EXPECT_LE(ca.live[SALLOC_TAG_PROTO] - idle, 512);
+
+  sproto_free(spd);
+  expectNothingLive();
+}
+
+TEST_F(SAllocTest, srpcInstanceComesFromAllocator) {
+  TsrpcParams params;
+
+  srpc_params_init(&params);
+  params.data_read = salloc_test_read;
+  params.data_write = salloc_test_write;
+  params.allocator = &ca.allocator;
+
+  void *srpc = srpc_init(&params);
+  ASSERT_TRUE(srpc != NULL);
+  EXPECT_GT(ca.live[SALLOC_TAG_SRPC], 0);
+  EXPECT_GT(ca.live[SALLOC_TAG_PROTO], 0);
+
+  ASSERT_GT(srpc_dcs_async_ping_server(srpc), 0);
+  srpc_iterate(srpc);
+
+  srpc_free(srpc);
+  expectNothingLive();
+}
+
+}  // namespace
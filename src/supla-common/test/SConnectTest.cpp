@@ -0,0 +1,192 @@
+/*
+ Copyright (C) AC SOFTWARE SP. Z O.O.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "SConnectTest.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"  // NOLINT
+#include "proto.h"        // NOLINT
+#include "sconnect.h"     // NOLINT
+
+namespace {
+
+long long sconnect_test_msec(void) {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec * 1000LL + tv.tv_usec / 1000;
+}
+
+class SConnectTest : public ::testing::Test {
+ protected:
+  std::vector<int> fds;
+  struct sockaddr_in6 addr6;
+  struct sockaddr_in addr4;
+  struct addrinfo ai6;
+  struct addrinfo ai4;
+
+  void SetUp() override {
+    memset(&addr6, 0, sizeof(addr6));
+    addr6.sin6_family = AF_INET6;
+    addr6.sin6_addr = in6addr_loopback;
+
+    memset(&addr4, 0, sizeof(addr4));
+    addr4.sin_family = AF_INET;
+    addr4.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    memset(&ai6, 0, sizeof(ai6));
+    ai6.ai_family = AF_INET6;
+    ai6.ai_socktype = SOCK_STREAM;
+    ai6.ai_addr = reinterpret_cast<struct sockaddr *>(&addr6);
+    ai6.ai_addrlen = sizeof(addr6);
+
+    ai4 = ai6;
+    ai4.ai_family = AF_INET;
+    ai4.ai_addr = reinterpret_cast<struct sockaddr *>(&addr4);
+    ai4.ai_addrlen = sizeof(addr4);
+  }
+
+  void TearDown() override {
+    for (size_t a = 0; a < fds.size(); a++) close(fds[a]);
+  }
+
+  // Listening socket on a free loopback port of the address' family
+  int listen_on(struct sockaddr *addr, socklen_t len, int backlog) {
+    int fd = socket(addr->sa_family, SOCK_STREAM, 0);
+    EXPECT_NE(-1, fd);
+    fds.push_back(fd);
+    EXPECT_EQ(0, bind(fd, addr, len));
+    EXPECT_EQ(0, listen(fd, backlog));
+    EXPECT_EQ(0, getsockname(fd, addr, &len));
+    return fd;
+  }
+
+  // Fills the accept queue, further SYNs are dropped like on a dead route
+  void blackhole(struct sockaddr *addr, socklen_t len) {
+    listen_on(addr, len, 0);
+    for (int a = 0; a < 2; a++) {
+      int fd = socket(addr->sa_family, SOCK_STREAM, 0);
+      fds.push_back(fd);
+      fcntl(fd, F_SETFL, O_NONBLOCK);
+      connect(fd, addr, len);
+    }
+    usleep(10000);
+  }
+};
+
+TEST_F(SConnectTest, connects_preferred_family) {
+  listen_on(ai6.ai_addr, ai6.ai_addrlen, 8);
+  addr4.sin_port = addr6.sin6_port;
+  ai6.ai_next = &ai4;
+
+  int family = AF_UNSPEC;
+  int fd = sconnect_race(&ai6, AF_INET6, 1000, &family);
+  ASSERT_NE(-1, fd);
+  ASSERT_EQ(AF_INET6, family);
+  // The winner is handed over in blocking mode
+  ASSERT_EQ(0, fcntl(fd, F_GETFL, 0) & O_NONBLOCK);
+  close(fd);
+}
+
+TEST_F(SConnectTest, refused_candidate_falls_back_at_once) {
+  listen_on(ai4.ai_addr, ai4.ai_addrlen, 8);
+  // Nothing listens on this IPv6 port
+  int closed = listen_on(ai6.ai_addr, ai6.ai_addrlen, 8);
+  close(closed);
+  fds.pop_back();
+  ai6.ai_next = &ai4;
+
+  int family = AF_UNSPEC;
+  long long start = sconnect_test_msec();
+  int fd = sconnect_race(&ai6, AF_UNSPEC, 5000, &family);
+  ASSERT_NE(-1, fd);
+  ASSERT_EQ(AF_INET, family);
+  ASSERT_LT(sconnect_test_msec() - start, SCONNECT_ATTEMPT_DELAY_MS);
+  close(fd);
+}
+
+TEST_F(SConnectTest, races_past_blackholed_candidate) {
+  blackhole(ai6.ai_addr, ai6.ai_addrlen);
+  listen_on(ai4.ai_addr, ai4.ai_addrlen, 8);
+  ai6.ai_next = &ai4;
+
+  int family = AF_UNSPEC;
+  long long start = sconnect_test_msec();
+  int fd = sconnect_race(&ai6, AF_INET6, 5000, &family);
+  long long elapsed = sconnect_test_msec() - start;
+
+  ASSERT_NE(-1, fd);
+  ASSERT_EQ(AF_INET, family);
+  // Second attempt started after the delay, not after the 5 s timeout
+  ASSERT_GE(elapsed, SCONNECT_ATTEMPT_DELAY_MS - 10);
+  ASSERT_LT(elapsed, 2000);
+  close(fd);
+}
+
+TEST_F(SConnectTest, attempt_timeout) {
+  blackhole(ai4.ai_addr, ai4.ai_addrlen);
+
+  long long start = sconnect_test_msec();
+  ASSERT_EQ(-1, sconnect_race(&ai4, AF_UNSPEC, 300, NULL));
+  long long elapsed = sconnect_test_msec() - start;
+
+  ASSERT_GE(elapsed, 290);
+  ASSERT_LT(elapsed, 2000);
+}
+
+TEST_F(SConnectTest, remembers_winning_family) {
+  listen_on(ai4.ai_addr, ai4.ai_addrlen, 8);
+  int port = ntohs(addr4.sin_port);
+
+  ASSERT_EQ(AF_UNSPEC, sconnect_get_family("127.0.0.1", port));
+
+  int err = 0;
+  int fd = sconnect_open("127.0.0.1", port, 1000, &err);
+  ASSERT_NE(-1, fd);
+  close(fd);
+
+  ASSERT_EQ(AF_INET, sconnect_get_family("127.0.0.1", port));
+  ASSERT_EQ(AF_UNSPEC, sconnect_get_family("127.0.0.2", port));
+
+  sconnect_set_family("127.0.0.1", port, AF_INET6);
+  ASSERT_EQ(AF_INET6, sconnect_get_family("127.0.0.1", port));
+}
+
+TEST_F(SConnectTest, errors) {
+  int err = 0;
+
+  ASSERT_EQ(-1, sconnect_open("host.invalid", 2016, 100, &err));
+  ASSERT_EQ(SUPLA_RESULT_HOST_NOT_FOUND, err);
+
+  int closed = listen_on(ai4.ai_addr, ai4.ai_addrlen, 8);
+  close(closed);
+  fds.pop_back();
+
+  err = 0;
+  ASSERT_EQ(-1, sconnect_open("127.0.0.1", ntohs(addr4.sin_port), 100, &err));
+  ASSERT_EQ(SUPLA_RESULT_CANT_CONNECT_TO_HOST, err);
+}
+
+}  // namespace
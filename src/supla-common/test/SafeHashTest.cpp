@@ -0,0 +1,164 @@
+/*
+ Copyright (C) AC SOFTWARE SP. Z O.O.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "SafeHashTest.h"
+
+#include <stdlib.h>
+
+#include <map>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"  // NOLINT
+#include "safehash.h"     // NOLINT
+
+char safe_hash_test_find_cnd(void *ptr, void *user_param) {
+  return ptr == user_param ? 1 : 0;
+}
+
+char safe_hash_test_del_even(void *ptr) {
+  return ((long long)ptr) % 2 == 0 ? 1 : 0;
+}
+
+namespace {
+
+class SafeHashTest : public ::testing::Test {
+ protected:
+};
+
+TEST_F(SafeHashTest, all) {
+  void *hash = safe_hash_init(0);
+  ASSERT_FALSE(hash == NULL);
+
+  ASSERT_EQ(1, safe_hash_add(hash, 1, (void *)10));
+  ASSERT_EQ(1, safe_hash_add(hash, 2, (void *)20));
+  ASSERT_EQ(1, safe_hash_add(hash, 3, (void *)30));
+  ASSERT_EQ(1, safe_hash_add(hash, 4, (void *)40));
+  ASSERT_EQ(0, safe_hash_add(hash, 4, (void *)41));
+  ASSERT_EQ(-1, safe_hash_add(hash, 5, NULL));
+
+  ASSERT_EQ(4, safe_hash_count(hash));
+  ASSERT_EQ(30, (long long)safe_hash_find(hash, 3));
+  ASSERT_EQ(40, (long long)safe_hash_find(hash, 4));
+  ASSERT_TRUE(safe_hash_find(hash, 5) == NULL);
+
+  ASSERT_EQ(20, (long long)safe_hash_remove(hash, 2));
+  ASSERT_TRUE(safe_hash_remove(hash, 2) == NULL);
+  ASSERT_EQ(3, safe_hash_count(hash));
+  ASSERT_TRUE(safe_hash_find(hash, 2) == NULL);
+
+  ASSERT_TRUE(safe_hash_findcnd(hash, &safe_hash_test_find_cnd, (void *)30));
+  ASSERT_FALSE(safe_hash_findcnd(hash, &safe_hash_test_find_cnd, (void *)20));
+
+  long long sum = 0;
+  void *ptr = NULL;
+  int a = 0;
+
+  safe_hash_lock(hash);
+  while ((ptr = safe_hash_get(hash, a)) != 0) {
+    sum += (long long)ptr;
+    a++;
+  }
+  safe_hash_unlock(hash);
+
+  ASSERT_EQ(3, a);
+  ASSERT_EQ(80, sum);
+
+  safe_hash_clean(hash, &safe_hash_test_del_even);
+  ASSERT_EQ(0, safe_hash_count(hash));
+
+  safe_hash_free(hash);
+}
+
+TEST_F(SafeHashTest, ptr_keys) {
+  void *hash = safe_hash_init(1);
+  int items[3];
+
+  ASSERT_EQ(1, safe_hash_add_ptr(hash, &items[0]));
+  ASSERT_EQ(1, safe_hash_add_ptr(hash, &items[1]));
+  ASSERT_EQ(0, safe_hash_add_ptr(hash, &items[1]));
+
+  ASSERT_TRUE(&items[1] == safe_hash_find_ptr(hash, &items[1]));
+  ASSERT_TRUE(safe_hash_find_ptr(hash, &items[2]) == NULL);
+  ASSERT_TRUE(&items[0] == safe_hash_remove_ptr(hash, &items[0]));
+  ASSERT_EQ(1, safe_hash_count(hash));
+
+  safe_hash_free(hash);
+}
+
+TEST_F(SafeHashTest, random_against_map) {
+  void *hash = safe_hash_init(4);
+  std::map<uint64_t, long long> expected;
+
+  srand(11);
+  for (int a = 0; a < 200000; a++) {
+    // A small key range keeps collisions and removals frequent
+    uint64_t key = rand() % 3000;
+    long long value = (rand() % 1000000) + 1;
+
+    switch (rand() % 3) {
+      case 0:
+        ASSERT_EQ(expected.count(key) ? 0 : 1,
+                  safe_hash_add(hash, key, (void *)value));
+        expected.insert(std::make_pair(key, value));
+        break;
+      case 1:
+        ASSERT_EQ(expected.count(key) ? expected[key] : 0,
+                  (long long)safe_hash_remove(hash, key));
+        expected.erase(key);
+        break;
+      default:
+        ASSERT_EQ(expected.count(key) ? expected[key] : 0,
+                  (long long)safe_hash_find(hash, key));
+        break;
+    }
+  }
+
+  ASSERT_EQ((int)expected.size(), safe_hash_count(hash));
+
+  for (auto it = expected.begin(); it != expected.end(); ++it) {
+    ASSERT_EQ(it->second, (long long)safe_hash_find(hash, it->first));
+  }
+
+  safe_hash_free(hash);
+}
+
+TEST_F(SafeHashTest, threads) {
+  void *hash = safe_hash_init(8);
+  std::vector<std::thread> threads;
+  const int per_thread = 5000;
+
+  for (int t = 0; t < 4; t++) {
+    threads.push_back(std::thread([hash, t]() {
+      for (int a = 0; a < per_thread; a++) {
+        uint64_t key = t * per_thread + a;
+        safe_hash_add(hash, key, (void *)(key + 1));
+        if (a % 2) safe_hash_remove(hash, key - 1);
+      }
+    }));
+  }
+
+  for (auto &thread : threads) thread.join();
+
+  ASSERT_EQ(4 * per_thread / 2, safe_hash_count(hash));
+  ASSERT_EQ(2, (long long)safe_hash_find(hash, 1));
+  ASSERT_TRUE(safe_hash_find(hash, 0) == NULL);
+
+  safe_hash_free(hash);
+}
+}  // namespace
@@ -265,6 +265,8 @@ class SrpcTest : public ::testing::Test {
   char *data_read;
   char *data_write;
   _supla_int_t data_write_size;
+  _supla_int_t writev_max_iovcnt;
+  vector<char> write_stream;
   void *srpcInit(void);
   void srpcCallAllowed(int min_version, vector<int> call_ids);
 
@@ -281,6 +283,7 @@ class SrpcTest : public ::testing::Test {
   virtual void TearDown();
   _supla_int_t DataRead(void *buf, _supla_int_t count);
   _supla_int_t DataWrite(void *buf, _supla_int_t count);
+  _supla_int_t DataWriteV(const TsrpcIoVec *iov, _supla_int_t iovcnt);
   void SendAndReceive(unsigned int ExpectedCallType, int ExpectedSize);
   void OnVersionError(unsigned char remote_version);
   void OnRemoteCallReceived(unsigned _supla_int_t rr_id,
@@ -296,6 +299,17 @@ _supla_int_t srpc_data_write(void *buf, _supla_int_t count, void *user_params) {
   return static_cast<SrpcTest *>(user_params)->DataWrite(buf, count);
 }
 
+_supla_int_t srpc_data_writev(const TsrpcIoVec *iov, _supla_int_t iovcnt,
+                              void *user_params) {
+  return static_cast<SrpcTest *>(user_params)->DataWriteV(iov, iovcnt);
+}
+
+_supla_int_t srpc_data_write_stream(void *buf, _supla_int_t count,
+                                    void *user_params) {
+  TsrpcIoVec iov = {buf, count};
+  return srpc_data_writev(&iov, 1, user_params);
+}
+
 void srpc_event_OnVersionError(void *_srpc, unsigned char remote_version,
                                void *user_params) {
   return static_cast<SrpcTest *>(user_params)->OnVersionError(remote_version);
@@ -313,6 +327,8 @@ void SrpcTest::SetUp() {
   data_read = NULL;
   data_write = NULL;
   data_write_size = 0;
+  writev_max_iovcnt = 0;
+  write_stream.clear();
   srpc = NULL;
   remote_version = 0;
   data_read_result = 0;
@@ -640,6 +656,37 @@ TEST_F(SrpcTest, call_not_allowed) {
   srpc = NULL;
 }
 
+TEST_F(SrpcTest, call_desc) {
+  TsrpcCallDesc desc;
+  int count = 0;
+
+  for (int a = 1; a <= SUPLA_PROTO_VERSION; a++) {
+    vector<int> calls = get_call_ids(a);
+    for (auto it = calls.begin(); it != calls.end(); it++) {
+      ASSERT_EQ(1, srpc_call_desc(*it, &desc));
+      ASSERT_EQ((unsigned _supla_int_t)*it, desc.call_id);
+      ASSERT_EQ(a, desc.min_version);
+      ASSERT_NE(0, desc.senders & ~desc.receivers);
+    }
+    count += calls.size();
+  }
+
+  for (int a = 0; a <= MAX_CALL_ID; a++) {
+    count -= srpc_call_desc(a, &desc);
+  }
+
+  ASSERT_EQ(0, count);
+  ASSERT_EQ(0, srpc_call_desc(MAX_CALL_ID + 100000, &desc));
+
+  ASSERT_EQ(1, srpc_call_desc(SUPLA_SD_CALL_CHANNEL_SET_VALUE, &desc));
+  ASSERT_EQ(sizeof(TSD_SuplaChannelNewValue), desc.max_data_size);
+  ASSERT_EQ(SRPC_ROLE_SERVER, desc.senders);
+  ASSERT_EQ(SRPC_ROLE_DEVICE, desc.receivers);
+
+  ASSERT_EQ(1, srpc_call_desc(SUPLA_DCS_CALL_GETVERSION, &desc));
+  ASSERT_EQ((unsigned _supla_int_t)0, desc.max_data_size);
+}
+
 _supla_int_t SrpcTest::DataRead(void *buf, _supla_int_t count) {
   if (data_read_result > 0 && data_read != NULL) {
     int size = data_read_result > count ? count : data_read_result;
@@ -662,6 +709,22 @@ _supla_int_t SrpcTest::DataWrite(void *buf, _supla_int_t count) {
   return data_write_result == 0 ? count : data_write_result;
 }
 
+_supla_int_t SrpcTest::DataWriteV(const TsrpcIoVec *iov, _supla_int_t iovcnt) {
+  _supla_int_t result = 0;
+
+  if (iovcnt > writev_max_iovcnt) {
+    writev_max_iovcnt = iovcnt;
+  }
+
+  for (_supla_int_t a = 0; a < iovcnt; a++) {
+    write_stream.insert(write_stream.end(), (const char *)iov[a].buf,
+                        (const char *)iov[a].buf + iov[a].count);
+    result += iov[a].count;
+  }
+
+  return result;
+}
+
 void SrpcTest::OnVersionError(unsigned char remote_version) {
   this->remote_version = remote_version;
 }
@@ -757,6 +820,330 @@ TEST_F(SrpcTest, iterate_input_queue_size) {
   srpc = NULL;
 }
 
+TEST_F(SrpcTest, iterate_input_queue_custom_size) {
+  const int queue_size = 40;
+  // 8 bytes of payload, the queue keeps only the used part of each packet
+  unsigned _supla_int_t packet_size = sizeof(TSuplaDataPacket) -
+                                      SUPLA_MAX_DATA_SIZE + 8;
+
+  data_read_result = packet_size + sizeof(sproto_tag);
+  data_write_result = 0;
+
+  data_read = (char *)malloc(data_read_result);
+  memset(data_read, 0, data_read_result);
+  ((TSuplaDataPacket *)data_read)->version = SUPLA_PROTO_VERSION;
+  ((TSuplaDataPacket *)data_read)->data_size = 8;
+
+  memcpy(((TSuplaDataPacket *)data_read)->tag, sproto_tag, SUPLA_TAG_SIZE);
+  memcpy(&data_read[packet_size], sproto_tag, SUPLA_TAG_SIZE);
+
+  TsrpcParams params;
+  srpc_params_init(&params);
+  params.user_params = this;
+  params.data_read = &srpc_data_read;
+  params.data_write = &srpc_data_write;
+  params.in_queue_size = queue_size;
+
+  srpc = srpc_init(&params);
+  ASSERT_FALSE(srpc == NULL);
+
+  for (int a = 0; a < queue_size; a++) {
+    ((TSuplaDataPacket *)data_read)->rr_id = a + 1;
+    ASSERT_EQ(SUPLA_RESULT_TRUE, srpc_iterate(srpc));
+  }
+
+  ASSERT_EQ(SUPLA_RESULT_FALSE, srpc_iterate(srpc));
+
+  srpc_free(srpc);
+  srpc = NULL;
+}
+
+TEST_F(SrpcTest, max_data_size_limits_outgoing_packets) {
+  data_read_result = -1;
+
+  TsrpcParams params;
+  srpc_params_init(&params);
+  params.user_params = this;
+  params.data_read = &srpc_data_read;
+  params.data_write = &srpc_data_write;
+  params.max_data_size = 64;
+
+  srpc = srpc_init(&params);
+  ASSERT_FALSE(srpc == NULL);
+
+  DECLARE_WITH_RANDOM(TSuplaChannelExtendedValue, ev);
+
+  ev.size = 1;
+  ASSERT_GT(srpc_ds_async_channel_extendedvalue_changed(srpc, 1, &ev), 0);
+
+  ev.size = 64;
+  ASSERT_EQ(0, srpc_ds_async_channel_extendedvalue_changed(srpc, 1, &ev));
+
+  srpc_free(srpc);
+  srpc = NULL;
+}
+
+TEST_F(SrpcTest, params_autosize) {
+  TsrpcParams params;
+  srpc_params_init(&params);
+  params.in_queue_size = 3;
+
+  srpc_params_autosize(&params, 40, 0);
+
+  ASSERT_EQ(3, params.in_queue_size);
+  ASSERT_EQ(42, params.out_queue_size);
+  ASSERT_GE(params.max_data_size, sizeof(TSDS_SetDeviceConfig));
+  ASSERT_LE(params.max_data_size, SUPLA_MAX_DATA_SIZE);
+  ASSERT_GE(params.buffer_size,
+            sizeof(TSuplaDataPacket) - SUPLA_MAX_DATA_SIZE +
+                params.max_data_size);
+  // the whole registration fits the output buffer
+  ASSERT_GT(params.proto_buffer_max_size,
+            sizeof(TDS_SuplaRegisterDeviceHeader) +
+                40 * sizeof(TDS_SuplaDeviceChannel_E));
+  ASSERT_GT(params.queue_slab_size, 0);
+
+  // an extended value raises the packet size, set fields stay as they are
+  srpc_params_init(&params);
+  params.buffer_size = 100;
+  srpc_params_autosize(&params, 2, SUPLA_CHANNELEXTENDEDVALUE_SIZE);
+
+  ASSERT_EQ(100, params.buffer_size);
+  ASSERT_EQ(sizeof(TDS_SuplaDeviceChannelExtendedValue),
+            params.max_data_size);
+  ASSERT_EQ(SRPC_QUEUE_SIZE, params.out_queue_size);
+}
+
+TEST_F(SrpcTest, getdata_views) {
+  data_read_result = -1;
+
+  TsrpcParams params;
+  srpc_params_init(&params);
+  params.user_params = this;
+  params.data_read = &srpc_data_read;
+  params.data_write = &srpc_data_write;
+  params.on_remote_call_received = &srpc_on_remote_call_received;
+  params.rd_views = 1;
+
+  srpc = srpc_init(&params);
+  ASSERT_FALSE(srpc == NULL);
+
+  DECLARE_WITH_RANDOM(TSD_SuplaChannelNewValue, param);
+  ASSERT_GT(srpc_sd_async_set_channel_value(srpc, &param), 0);
+  SendAndReceive(SUPLA_SD_CALL_CHANNEL_SET_VALUE, 40);
+
+  ASSERT_EQ(1, cr_rd.view);
+  ASSERT_FALSE(cr_rd.data.sd_channel_new_value == NULL);
+  ASSERT_EQ(0, memcmp(cr_rd.data.sd_channel_new_value, &param,
+                      sizeof(TSD_SuplaChannelNewValue)));
+
+  // A held packet is handed out once and released by the next call
+  ASSERT_EQ(SUPLA_RESULT_FALSE, srpc_getdata(srpc, &cr_rd, 0));
+
+  srpc_rd_free(&cr_rd);
+  srpc_free(srpc);
+  srpc = NULL;
+}
+
+TEST_F(SrpcTest, shared_scratch_release_idle) {
+  data_read_result = -1;
+
+  TsrpcParams params;
+  srpc_params_init(&params);
+  params.user_params = this;
+  params.data_read = &srpc_data_read;
+  params.data_write = &srpc_data_write;
+  params.on_remote_call_received = &srpc_on_remote_call_received;
+  params.shared_scratch = 1;
+  params.release_idle = 1;
+
+  srpc = srpc_init(&params);
+  ASSERT_FALSE(srpc == NULL);
+
+  DECLARE_WITH_RANDOM(TSD_SuplaChannelNewValue, param);
+  ASSERT_GT(srpc_sd_async_set_channel_value(srpc, &param), 0);
+  SendAndReceive(SUPLA_SD_CALL_CHANNEL_SET_VALUE, 40);
+
+  ASSERT_FALSE(cr_rd.data.sd_channel_new_value == NULL);
+  ASSERT_EQ(0, memcmp(cr_rd.data.sd_channel_new_value, &param,
+                      sizeof(TSD_SuplaChannelNewValue)));
+  srpc_rd_free(&cr_rd);
+
+  // The drained queues are allocated again on demand
+  free(data_write);
+  data_write = NULL;
+  data_write_size = 0;
+  ASSERT_GT(srpc_dcs_async_ping_server(srpc), 0);
+  ASSERT_EQ(1, srpc_out_queue_item_count(srpc));
+  ASSERT_EQ(SUPLA_RESULT_TRUE, srpc_iterate(srpc));
+  ASSERT_EQ(0, srpc_out_queue_item_count(srpc));
+  ASSERT_GT(data_write_size, 0);
+
+  srpc_free(srpc);
+  srpc = NULL;
+}
+
+TEST_F(SrpcTest, iterate_out_coalesce) {
+  data_read_result = -1;
+
+  TsrpcParams params;
+  srpc_params_init(&params);
+  params.user_params = this;
+  params.data_read = &srpc_data_read;
+  params.data_write = &srpc_data_write;
+  params.out_coalesce = 1;
+
+  srpc = srpc_init(&params);
+  ASSERT_FALSE(srpc == NULL);
+
+  for (int a = 0; a < 3; a++) {
+    ASSERT_GT(srpc_dcs_async_ping_server(srpc), 0);
+  }
+
+  ASSERT_EQ(3, srpc_out_queue_item_count(srpc));
+  ASSERT_EQ(SUPLA_RESULT_TRUE, srpc_iterate(srpc));
+  ASSERT_EQ(0, srpc_out_queue_item_count(srpc));
+
+  _supla_int_t packet_size = sizeof(TSuplaDataPacket) - SUPLA_MAX_DATA_SIZE +
+                             sizeof(TDCS_SuplaPingServer) + SUPLA_TAG_SIZE;
+  ASSERT_EQ(packet_size * 3, data_write_size);
+
+  srpc_free(srpc);
+  srpc = NULL;
+}
+
+TEST_F(SrpcTest, async_reserve_writes_to_output_buffer) {
+  data_read_result = -1;
+
+  TsrpcParams params;
+  srpc_params_init(&params);
+  params.user_params = this;
+  params.data_read = &srpc_data_read;
+  params.data_write = &srpc_data_write;
+  params.out_coalesce = 1;
+
+  srpc = srpc_init(&params);
+  ASSERT_FALSE(srpc == NULL);
+
+  char value[SUPLA_CHANNELVALUE_SIZE] = {1, 2, 3, 4, 5, 6, 7, 8};
+  ASSERT_GT(srpc_ds_async_channel_value_changed_c(srpc, 3, value, 0, 10), 0);
+
+  // a cancelled reservation leaves nothing behind
+  ASSERT_FALSE(srpc_async_reserve(srpc, SUPLA_DCS_CALL_PING_SERVER,
+                                  sizeof(TDCS_SuplaPingServer)) == NULL);
+  srpc_async_cancel(srpc);
+
+  ASSERT_EQ(0, srpc_out_queue_item_count(srpc));
+  ASSERT_EQ(SUPLA_RESULT_TRUE, srpc_output_dataexists(srpc));
+
+  ASSERT_EQ(SUPLA_RESULT_TRUE, srpc_iterate(srpc));
+  ASSERT_EQ(SUPLA_RESULT_FALSE, srpc_output_dataexists(srpc));
+
+  _supla_int_t packet_size = sizeof(TSuplaDataPacket) - SUPLA_MAX_DATA_SIZE +
+                             sizeof(TDS_SuplaDeviceChannelValue_C);
+  ASSERT_EQ(packet_size + SUPLA_TAG_SIZE, data_write_size);
+
+  TSuplaDataPacket *sdp = (TSuplaDataPacket *)data_write;
+  ASSERT_EQ(SUPLA_DS_CALL_DEVICE_CHANNEL_VALUE_CHANGED_C, sdp->call_id);
+  ASSERT_EQ(sizeof(TDS_SuplaDeviceChannelValue_C), sdp->data_size);
+  ASSERT_EQ(0, memcmp(&data_write[packet_size], sproto_tag, SUPLA_TAG_SIZE));
+
+  TDS_SuplaDeviceChannelValue_C *ncsc =
+      (TDS_SuplaDeviceChannelValue_C *)sdp->data;
+  ASSERT_EQ(3, ncsc->ChannelNumber);
+  ASSERT_EQ(10, ncsc->ValidityTimeSec);
+  ASSERT_EQ(0, memcmp(ncsc->value, value, SUPLA_CHANNELVALUE_SIZE));
+
+  srpc_free(srpc);
+  srpc = NULL;
+}
+
+TEST_F(SrpcTest, iterate_writev_wrapped_output) {
+  data_read_result = -1;
+
+  TsrpcParams params;
+  srpc_params_init(&params);
+  params.user_params = this;
+  params.data_read = &srpc_data_read;
+  params.data_write = &srpc_data_write_stream;
+  params.data_writev = &srpc_data_writev;
+  // writes smaller than a packet keep a backlog that moves across the end of
+  // the output buffer
+  params.buffer_size = 20;
+
+  srpc = srpc_init(&params);
+  ASSERT_FALSE(srpc == NULL);
+
+  const int count = 100;
+  for (int a = 0; a < count; a++) {
+    ASSERT_GT(srpc_dcs_async_ping_server(srpc), 0);
+    ASSERT_EQ(SUPLA_RESULT_TRUE, srpc_iterate(srpc));
+  }
+
+  while (srpc_output_dataexists(srpc) == SUPLA_RESULT_TRUE) {
+    ASSERT_EQ(SUPLA_RESULT_TRUE, srpc_iterate(srpc));
+  }
+
+  ASSERT_EQ(2, writev_max_iovcnt);
+
+  _supla_int_t packet_size = sizeof(TSuplaDataPacket) - SUPLA_MAX_DATA_SIZE +
+                             sizeof(TDCS_SuplaPingServer) + SUPLA_TAG_SIZE;
+  ASSERT_EQ((size_t)(packet_size * count), write_stream.size());
+
+  // the stream is a sequence of intact packets
+  void *sproto = sproto_init();
+  ASSERT_FALSE(sproto == NULL);
+  TSuplaDataPacket sdp;
+  for (int a = 0; a < count; a++) {
+    ASSERT_EQ(SUPLA_RESULT_TRUE,
+              sproto_in_buffer_append(sproto, &write_stream[a * packet_size],
+                                      packet_size));
+    ASSERT_EQ(SUPLA_RESULT_TRUE, sproto_pop_in_sdp(sproto, &sdp));
+    ASSERT_EQ(SUPLA_DCS_CALL_PING_SERVER, sdp.call_id);
+    ASSERT_EQ((unsigned _supla_int_t)a + 1, sdp.rr_id);
+  }
+  sproto_free(sproto);
+
+  srpc_free(srpc);
+  srpc = NULL;
+}
+
+TEST_F(SrpcTest, iterate_partial_write) {
+  data_read_result = -1;
+  data_write_result = 10;
+
+  srpc = srpcInit();
+  ASSERT_FALSE(srpc == NULL);
+
+  ASSERT_GT(srpc_dcs_async_ping_server(srpc), 0);
+  ASSERT_GT(srpc_dcs_async_ping_server(srpc), 0);
+
+  ASSERT_EQ(SUPLA_RESULT_TRUE, srpc_iterate(srpc));
+  ASSERT_EQ(SUPLA_RESULT_TRUE, srpc_output_congested(srpc));
+  ASSERT_EQ(SUPLA_RESULT_TRUE, srpc_output_dataexists(srpc));
+
+  // nothing new is moved to the output buffer while congested
+  data_write_result = -1;
+  ASSERT_EQ(SUPLA_RESULT_TRUE, srpc_iterate(srpc));
+  ASSERT_EQ(1, srpc_out_queue_item_count(srpc));
+
+  _supla_int_t packet_size = sizeof(TSuplaDataPacket) - SUPLA_MAX_DATA_SIZE +
+                             sizeof(TDCS_SuplaPingServer) + SUPLA_TAG_SIZE;
+
+  data_write_result = 0;
+  ASSERT_EQ(SUPLA_RESULT_TRUE, srpc_iterate(srpc));
+  ASSERT_EQ(packet_size - 10, data_write_size);
+  ASSERT_EQ(SUPLA_RESULT_FALSE, srpc_output_congested(srpc));
+  ASSERT_EQ(SUPLA_RESULT_FALSE, srpc_output_dataexists(srpc));
+
+  ASSERT_EQ(SUPLA_RESULT_TRUE, srpc_iterate(srpc));
+  ASSERT_EQ(0, srpc_out_queue_item_count(srpc));
+  ASSERT_EQ(packet_size, data_write_size);
+
+  srpc_free(srpc);
+  srpc = NULL;
+}
+
 TEST_F(SrpcTest, iterate_buffer_overflow) {
   data_read_result = sizeof(TSuplaDataPacket) + sizeof(sproto_tag);
   data_write_result = 0;
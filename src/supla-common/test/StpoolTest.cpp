@@ -0,0 +1,148 @@
+/*
+ Copyright (C) AC SOFTWARE SP. Z O.O.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "StpoolTest.h"
+
+#include <unistd.h>
+
+#include <atomic>
+
+#include "gtest/gtest.h"  // NOLINT
+#include "stpool.h"       // NOLINT
+
+namespace {
+
+class StpoolTest : public ::testing::Test {
+ protected:
+};
+
+struct TestCtx {
+  void *pool;
+  std::atomic<int> counter;
+  std::atomic<int> order;
+  int first;
+};
+
+void stpool_test_inc(void *user_data) { ((TestCtx *)user_data)->counter++; }
+
+void stpool_test_spawn(void *user_data) {
+  TestCtx *ctx = (TestCtx *)user_data;
+  for (int a = 0; a < 10; a++) {
+    stpool_submit(ctx->pool, &stpool_test_inc, ctx);
+  }
+}
+
+void stpool_test_first(void *user_data) {
+  TestCtx *ctx = (TestCtx *)user_data;
+  ctx->first = ctx->order++;
+}
+
+void stpool_test_second(void *user_data) {
+  ((TestCtx *)user_data)->order++;
+}
+
+TEST_F(StpoolTest, submit_and_drain) {
+  TestCtx ctx;
+  ctx.counter = 0;
+  ctx.pool = stpool_init(4);
+  ASSERT_FALSE(ctx.pool == NULL);
+  ASSERT_EQ(4, stpool_worker_count(ctx.pool));
+
+  for (int a = 0; a < 10000; a++) {
+    ASSERT_EQ(1, stpool_submit(ctx.pool, &stpool_test_inc, &ctx));
+  }
+
+  stpool_drain(ctx.pool);
+  ASSERT_EQ(10000, ctx.counter.load());
+
+  for (int a = 0; a < 100; a++) {
+    ASSERT_EQ(1, stpool_submit(ctx.pool, &stpool_test_spawn, &ctx));
+  }
+
+  stpool_drain(ctx.pool);
+  ASSERT_EQ(11000, ctx.counter.load());
+
+  stpool_free(ctx.pool);
+}
+
+TEST_F(StpoolTest, delayed) {
+  TestCtx ctx;
+  ctx.counter = 0;
+  ctx.order = 0;
+  ctx.first = -1;
+  ctx.pool = stpool_init(2);
+
+  ASSERT_GT(stpool_submit_delayed(ctx.pool, &stpool_test_second, &ctx, 60),
+            0);
+  ASSERT_GT(stpool_submit_delayed(ctx.pool, &stpool_test_first, &ctx, 10), 0);
+
+  int id = stpool_submit_delayed(ctx.pool, &stpool_test_inc, &ctx, 10000);
+  ASSERT_GT(id, 0);
+  ASSERT_EQ(1, stpool_cancel(ctx.pool, id));
+  ASSERT_EQ(0, stpool_cancel(ctx.pool, id));
+
+  stpool_drain(ctx.pool);
+
+  ASSERT_EQ(0, ctx.first);
+  ASSERT_EQ(2, ctx.order.load());
+  ASSERT_EQ(0, ctx.counter.load());
+
+  stpool_free(ctx.pool);
+}
+
+TEST_F(StpoolTest, periodic) {
+  TestCtx ctx;
+  ctx.counter = 0;
+  ctx.pool = stpool_init(2);
+
+  int id = stpool_submit_periodic(ctx.pool, &stpool_test_inc, &ctx, 0, 5);
+  ASSERT_GT(id, 0);
+  ASSERT_EQ(0, stpool_submit_periodic(ctx.pool, &stpool_test_inc, &ctx, 0, 0));
+
+  for (int a = 0; a < 200 && ctx.counter < 3; a++) {
+    usleep(5000);
+  }
+
+  ASSERT_GE(ctx.counter.load(), 3);
+  ASSERT_EQ(1, stpool_cancel(ctx.pool, id));
+
+  usleep(20000);
+  int counter = ctx.counter;
+  usleep(30000);
+  ASSERT_EQ(counter, ctx.counter.load());
+
+  stpool_free(ctx.pool);
+}
+
+TEST_F(StpoolTest, free_with_pending_tasks) {
+  TestCtx ctx;
+  ctx.counter = 0;
+  ctx.pool = stpool_init(0);
+  ASSERT_GT(stpool_worker_count(ctx.pool), 0);
+
+  stpool_submit_delayed(ctx.pool, &stpool_test_inc, &ctx, 10000);
+  stpool_submit_periodic(ctx.pool, &stpool_test_inc, &ctx, 10000, 10000);
+
+  for (int a = 0; a < 1000; a++) {
+    stpool_submit(ctx.pool, &stpool_test_inc, &ctx);
+  }
+
+  stpool_free(ctx.pool);
+  ASSERT_EQ(1000, ctx.counter.load());
+}
+}  // namespace
@@ -0,0 +1,253 @@
+/*
+ Copyright (C) AC SOFTWARE SP. Z O.O.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "TWheelTest.h"
+
+#include <stdlib.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"  // NOLINT
+#include "twheel.h"       // NOLINT
+
+namespace {
+
+struct TWheelTestState {
+  uint64_t now;
+  std::vector<int> fired;
+};
+
+void twheel_test_expired(TWheelTimer *timer, void *user_data) {
+  TWheelTestState *state = static_cast<TWheelTestState *>(user_data);
+  // Never early
+  EXPECT_LE(timer->expires, state->now);
+  state->fired.push_back((int)(long long)timer->user_data);
+}
+
+class TWheelTest : public ::testing::Test {
+ protected:
+};
+
+TEST_F(TWheelTest, schedule_cancel) {
+  void *wheel = twheel_init(1000);
+  TWheelTestState state;
+  TWheelTimer timers[4];
+
+  ASSERT_FALSE(wheel == NULL);
+  ASSERT_EQ(-1, twheel_next_timeout(wheel, 1000));
+
+  for (int a = 0; a < 4; a++) twheel_timer_init(&timers[a], (void *)(long long)a);
+
+  twheel_schedule(wheel, &timers[0], 1010);
+  twheel_schedule(wheel, &timers[1], 1005);
+  twheel_schedule(wheel, &timers[2], 1000 + 70000);
+  twheel_schedule(wheel, &timers[3], 1020);
+  ASSERT_EQ(4, twheel_count(wheel));
+  ASSERT_TRUE(twheel_timer_pending(&timers[0]));
+  ASSERT_EQ(5, twheel_next_timeout(wheel, 1000));
+
+  twheel_cancel(wheel, &timers[1]);
+  twheel_cancel(wheel, &timers[1]);
+  ASSERT_FALSE(twheel_timer_pending(&timers[1]));
+  ASSERT_EQ(3, twheel_count(wheel));
+  ASSERT_EQ(10, twheel_next_timeout(wheel, 1000));
+
+  // Rescheduling a pending timer moves it
+  twheel_schedule(wheel, &timers[3], 1002);
+  ASSERT_EQ(3, twheel_count(wheel));
+
+  state.now = 1009;
+  ASSERT_EQ(1, twheel_advance(wheel, state.now, twheel_test_expired, &state));
+  ASSERT_EQ(1U, state.fired.size());
+  ASSERT_EQ(3, state.fired[0]);
+  ASSERT_EQ(1, twheel_next_timeout(wheel, state.now));
+
+  state.now = 1010;
+  ASSERT_EQ(1, twheel_advance(wheel, state.now, twheel_test_expired, &state));
+  ASSERT_EQ(0, state.fired[1]);
+
+  // Far deadlines may be reported early, never late
+  int timeout = twheel_next_timeout(wheel, state.now);
+  ASSERT_GT(timeout, 0);
+  ASSERT_LE(timeout, 70000 - 10);
+
+  state.now = 1000 + 69999;
+  ASSERT_EQ(0, twheel_advance(wheel, state.now, twheel_test_expired, &state));
+  ASSERT_EQ(1, twheel_next_timeout(wheel, state.now));
+  state.now++;
+  ASSERT_EQ(1, twheel_advance(wheel, state.now, twheel_test_expired, &state));
+  ASSERT_EQ(2, state.fired[2]);
+  ASSERT_EQ(0, twheel_count(wheel));
+
+  twheel_free(wheel);
+}
+
+TEST_F(TWheelTest, past_and_beyond_range) {
+  void *wheel = twheel_init(50);
+  TWheelTestState state;
+  TWheelTimer past, far;
+  // Beyond the 2^24 ms reach of the wheel
+  const uint64_t far_expires = 50 + 3 * (1ULL << 24) + 123;
+
+  twheel_timer_init(&past, (void *)1);
+  twheel_timer_init(&far, (void *)2);
+
+  twheel_schedule(wheel, &past, 10);
+  twheel_schedule(wheel, &far, far_expires);
+  ASSERT_EQ(0, twheel_next_timeout(wheel, 50));
+
+  state.now = 50;
+  ASSERT_EQ(1, twheel_advance(wheel, state.now, twheel_test_expired, &state));
+
+  // Advance in large steps, as a loop sleeping on next_timeout would
+  while (state.now < far_expires - 1) {
+    int timeout = twheel_next_timeout(wheel, state.now);
+    ASSERT_GT(timeout, 0);
+    state.now += timeout;
+    ASSERT_LE(state.now, far_expires);
+    if (state.now == far_expires) state.now--;
+    ASSERT_EQ(0, twheel_advance(wheel, state.now, twheel_test_expired, &state));
+  }
+
+  state.now = far_expires;
+  ASSERT_EQ(1, twheel_advance(wheel, state.now, twheel_test_expired, &state));
+  ASSERT_EQ(2, state.fired[1]);
+
+  twheel_free(wheel);
+}
+
+struct TWheelTestResched {
+  void *wheel;
+  uint64_t now;
+  int runs;
+};
+
+void twheel_test_resched(TWheelTimer *timer, void *user_data) {
+  TWheelTestResched *r = static_cast<TWheelTestResched *>(user_data);
+  r->runs++;
+  // Due again right away, runs again in the next millisecond
+  twheel_schedule(r->wheel, timer, timer->expires);
+}
+
+TEST_F(TWheelTest, reschedule_from_callback) {
+  TWheelTestResched r = {};
+  TWheelTimer timer;
+
+  r.wheel = twheel_init(0);
+  twheel_timer_init(&timer, NULL);
+  twheel_schedule(r.wheel, &timer, 5);
+
+  r.now = 5;
+  ASSERT_EQ(1, twheel_advance(r.wheel, r.now, twheel_test_resched, &r));
+  ASSERT_EQ(0, twheel_advance(r.wheel, r.now, twheel_test_resched, &r));
+  r.now = 100;
+  // Runs once per millisecond
+  ASSERT_EQ(95, twheel_advance(r.wheel, r.now, twheel_test_resched, &r));
+  ASSERT_EQ(96, r.runs);
+  ASSERT_TRUE(twheel_timer_pending(&timer));
+
+  twheel_free(r.wheel);
+}
+
+TEST_F(TWheelTest, random_against_reference) {
+  const int count = 2000;
+  void *wheel = twheel_init(7);
+  TWheelTestState state;
+  std::vector<TWheelTimer> timers(count);
+  std::vector<uint64_t> expected(count, 0);
+
+  uint64_t processed = 6;
+
+  state.now = 7;
+  for (int a = 0; a < count; a++) {
+    twheel_timer_init(&timers[a], (void *)(long long)a);
+  }
+
+  srand(5);
+  for (int step = 0; step < 20000; step++) {
+    int a = rand() % count;
+    uint64_t delay;
+
+    switch (rand() % 8) {
+      case 0:
+        twheel_cancel(wheel, &timers[a]);
+        expected[a] = 0;
+        break;
+      case 1:
+      case 2:
+      case 3:
+        // Mix near, far and very far deadlines
+        delay = rand() % 3 == 0 ? rand() % 100 : rand() % 300000;
+        if (rand() % 50 == 0) delay += 1ULL << 24;
+        twheel_schedule(wheel, &timers[a], state.now + delay);
+        expected[a] = state.now + delay;
+        break;
+      default: {
+        // Deadlines already processed move to the next millisecond
+        uint64_t min = UINT64_MAX;
+        for (int b = 0; b < count; b++) {
+          uint64_t at = expected[b] > processed ? expected[b] : processed + 1;
+          if (expected[b] && at < min) min = at;
+        }
+
+        int timeout = twheel_next_timeout(wheel, state.now);
+        if (min == UINT64_MAX) {
+          ASSERT_EQ(-1, timeout);
+        } else {
+          ASSERT_LE(state.now + timeout, min < state.now ? state.now : min);
+        }
+
+        state.now += rand() % 2 ? rand() % 64 : rand() % 20000;
+        state.fired.clear();
+        twheel_advance(wheel, state.now, twheel_test_expired, &state);
+
+        for (size_t f = 0; f < state.fired.size(); f++) {
+          ASSERT_NE(0U, expected[state.fired[f]]);
+          expected[state.fired[f]] = 0;
+        }
+        for (int b = 0; b < count; b++) {
+          uint64_t at = expected[b] > processed ? expected[b] : processed + 1;
+          ASSERT_TRUE(expected[b] == 0 || at > state.now);
+          ASSERT_EQ(expected[b] != 0, (bool)twheel_timer_pending(&timers[b]));
+        }
+        if (state.now > processed) processed = state.now;
+        break;
+      }
+    }
+  }
+
+  twheel_free(wheel);
+}
+
+TEST_F(TWheelTest, expire_in_order) {
+  void *wheel = twheel_init(0);
+  TWheelTestState state;
+  TWheelTimer timers[100];
+
+  for (int a = 0; a < 100; a++) {
+    twheel_timer_init(&timers[a], (void *)(long long)a);
+    twheel_schedule(wheel, &timers[a], 10000 - a * 97);
+  }
+
+  state.now = 20000;
+  ASSERT_EQ(100, twheel_advance(wheel, state.now, twheel_test_expired, &state));
+  for (int a = 0; a < 100; a++) ASSERT_EQ(99 - a, state.fired[a]);
+
+  twheel_free(wheel);
+}
+}  // namespace
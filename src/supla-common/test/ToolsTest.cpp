@@ -19,8 +19,13 @@
 #include "ToolsTest.h"
 
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 
 #include "gtest/gtest.h"  // NOLINT
+#include "openssl/evp.h"  // NOLINT
 #include "tools.h"        // NOLINT
 
 namespace {
@@ -236,6 +241,116 @@ TEST_F(ToolsTest, st_base64_longer_text) {
   free(decoded);
 }
 
+TEST_F(ToolsTest, st_base64_codec) {
+  char src[] = "Lorem ipsum dolor sit amet, consectetur adipiscing elit";
+  char encoded[ST_BASE64_ENCODED_SIZE(sizeof(src))];
+  char decoded[sizeof(src)];
+
+  ASSERT_EQ(76, st_base64_encode(encoded, sizeof(encoded), src,
+                                 strlen(src)));
+  ASSERT_EQ(0, strcmp(encoded,
+                      "TG9yZW0gaXBzdW0gZG9sb3Igc2l0IGFtZXQsIGNvbnNlY3RldHVyIG"
+                      "FkaXBpc2NpbmcgZWxpdA=="));
+
+  ASSERT_EQ((int)strlen(src),
+            st_base64_decode(decoded, sizeof(decoded), encoded, 76));
+  ASSERT_EQ(0, memcmp(src, decoded, strlen(src)));
+
+  // Padding is optional
+  ASSERT_EQ((int)strlen(src),
+            st_base64_decode(decoded, sizeof(decoded), encoded, 74));
+
+  ASSERT_EQ(-1, st_base64_encode(encoded, 76, src, strlen(src)));
+  ASSERT_EQ(-1, st_base64_decode(decoded, strlen(src) - 1, encoded, 76));
+
+  encoded[40] = '*';
+  ASSERT_EQ(-1, st_base64_decode(decoded, sizeof(decoded), encoded, 76));
+  ASSERT_EQ(-1, st_base64_decode(decoded, sizeof(decoded), "QUJD=", 5));
+
+  ASSERT_EQ(0, st_base64_encode(encoded, sizeof(encoded), NULL, 0));
+  ASSERT_EQ(0, encoded[0]);
+}
+
+TEST_F(ToolsTest, st_base64_codec_random_round_trip) {
+  unsigned char data[600 + 16];
+  char encoded[ST_BASE64_ENCODED_SIZE(600) + 16];
+  unsigned char expected[ST_BASE64_ENCODED_SIZE(600)];
+  char decoded[600 + 16];
+  unsigned int seed = 1;
+
+  for (size_t a = 0; a < sizeof(data); a++) {
+    data[a] = rand_r(&seed);
+  }
+
+  // Both dispatch paths must give what OpenSSL gives for every length and
+  // start address, including the tails the SIMD loops hand over.
+  for (int simd = 1; simd >= 0; simd--) {
+    st_codec_simd_enable(simd);
+
+    for (size_t offset = 0; offset < 16; offset++) {
+      for (size_t length = 0; length <= 600; length++) {
+        int size = EVP_EncodeBlock(expected, &data[offset], length);
+
+        ASSERT_EQ(size, st_base64_encode(&encoded[offset], sizeof(encoded) - 16,
+                                         (const char *)&data[offset], length))
+            << "simd " << simd << ", offset " << offset << ", length "
+            << length;
+        ASSERT_EQ(0, strcmp((const char *)expected, &encoded[offset]))
+            << "simd " << simd << ", offset " << offset << ", length "
+            << length;
+
+        ASSERT_EQ((int)length,
+                  st_base64_decode(&decoded[offset], length, &encoded[offset],
+                                   size))
+            << "simd " << simd << ", offset " << offset << ", length "
+            << length;
+        ASSERT_EQ(0, memcmp(&data[offset], &decoded[offset], length))
+            << "simd " << simd << ", offset " << offset << ", length "
+            << length;
+      }
+    }
+
+    // The OpenSSL wrappers share the codec
+    char *wrapped = st_openssl_base64_encode((const char *)data, 600);
+    ASSERT_TRUE(NULL != wrapped);
+    EVP_EncodeBlock(expected, data, 600);
+    ASSERT_EQ(0, strcmp((const char *)expected, wrapped));
+
+    int wrapped_len = 0;
+    char *unwrapped =
+        st_openssl_base64_decode(wrapped, strlen(wrapped), &wrapped_len);
+    ASSERT_TRUE(NULL != unwrapped);
+    ASSERT_EQ(600, wrapped_len);
+    ASSERT_EQ(0, memcmp(data, unwrapped, 600));
+
+    free(wrapped);
+    free(unwrapped);
+  }
+
+  st_codec_simd_enable(1);
+}
+
+TEST_F(ToolsTest, st_hex_codec) {
+  char bin[] = {0x01, 0x23, 0x45, 0x67, (char)0x89, (char)0xab,
+                (char)0xcd, (char)0xef, 0x00, (char)0xff};
+  char hex[sizeof(bin) * 2 + 1];
+  char decoded[sizeof(bin)];
+
+  ASSERT_EQ(20, st_hex_encode(hex, sizeof(hex), bin, sizeof(bin)));
+  ASSERT_EQ(0, strcmp(hex, "0123456789ABCDEF00FF"));
+  ASSERT_EQ(-1, st_hex_encode(hex, sizeof(hex) - 1, bin, sizeof(bin)));
+
+  ASSERT_EQ(10, st_hex2bin(decoded, sizeof(decoded), "0123456789abcdef00FF",
+                           20));
+  ASSERT_EQ(0, memcmp(bin, decoded, sizeof(bin)));
+
+  ASSERT_EQ(-1, st_hex2bin(decoded, sizeof(decoded), "012", 3));
+  ASSERT_EQ(-1, st_hex2bin(decoded, sizeof(decoded), "0G", 2));
+  ASSERT_EQ(-1, st_hex2bin(decoded, 1, "0102", 4));
+
+  ASSERT_EQ(0, strcmp(st_bin2hex(hex, bin, 2), "0123"));
+}
+
 TEST_F(ToolsTest, st_hsv2rgb) {
   _color_hsv_t hsv;
   hsv.h = 154;
@@ -269,12 +384,103 @@ TEST_F(ToolsTest, st_rgb2hsv) {
   ASSERT_EQ(49, (int)(hsv.v * 100));
 }
 
+TEST_F(ToolsTest, st_color_batch) {
+  const size_t count = 1031;
+  int rgb[count], rgb_out[count];
+  _color_hsv_t hsv[count], hsv_out[count];
+
+  srand(7);
+  for (size_t a = 0; a < count; a++) {
+    rgb[a] = rand() & 0xFFFFFF;
+  }
+  rgb[0] = 0x000000;
+  rgb[1] = 0xFFFFFF;
+  rgb[2] = 0x808080;
+  rgb[3] = 0xFF0000;
+
+  for (size_t n = 0; n <= 9; n++) {
+    st_rgb2hsv_batch(rgb, hsv_out, n);
+  }
+
+  st_rgb2hsv_batch(rgb, hsv_out, count);
+  for (size_t a = 0; a < count; a++) {
+    hsv[a] = st_rgb2hsv(rgb[a]);
+    ASSERT_NEAR(hsv[a].h, hsv_out[a].h, 0.001) << a;
+    ASSERT_NEAR(hsv[a].s, hsv_out[a].s, 0.001) << a;
+    ASSERT_NEAR(hsv[a].v, hsv_out[a].v, 0.001) << a;
+  }
+
+  hsv[4].h = 360;
+  hsv[5].s = 0;
+
+  for (size_t n = 1; n <= 9; n++) {
+    memset(rgb_out, 0xAA, sizeof(rgb_out));
+    st_hsv2rgb_batch(hsv, rgb_out, n);
+    ASSERT_EQ(rgb_out[n], (int)0xAAAAAAAA);
+  }
+
+  st_hsv2rgb_batch(hsv, rgb_out, count);
+  for (size_t a = 0; a < count; a++) {
+    int expected = st_hsv2rgb(hsv[a]);
+    for (int shift = 0; shift <= 16; shift += 8) {
+      ASSERT_NEAR((expected >> shift) & 0xFF, (rgb_out[a] >> shift) & 0xFF, 1)
+          << a;
+    }
+  }
+}
+
 TEST_F(ToolsTest, st_crc32) {
   char str[] = "1234";
   EXPECT_EQ(st_crc32_checksum((const uint8_t *)str, 4), 2615402659);
   EXPECT_EQ(st_crc32_checksum((const uint8_t *)str, 0), 0);
 }
 
+TEST_F(ToolsTest, st_crc32_lengths_and_alignment) {
+  unsigned char data[1024 + 16];
+  unsigned int seed = 1;
+
+  for (size_t a = 0; a < sizeof(data); a++) {
+    data[a] = rand_r(&seed);
+  }
+
+  // The accelerated paths must match the plain byte loop for every length
+  // and start address, including the tails they hand over to it.
+  for (size_t offset = 0; offset < 16; offset++) {
+    for (size_t length = 0; length <= 1024; length++) {
+      unsigned int crc = 0xffffffff;
+      for (size_t a = 0; a < length; a++) {
+        crc ^= data[offset + a];
+        for (int b = 0; b < 8; b++) {
+          crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+        }
+      }
+
+      ASSERT_EQ(crc ^ 0xffffffff, st_crc32_checksum(&data[offset], length))
+          << "offset " << offset << ", length " << length;
+    }
+  }
+}
+
+// Run with --gtest_also_run_disabled_tests
+TEST_F(ToolsTest, DISABLED_st_crc32_benchmark) {
+  const size_t size = 256 * 1024 * 1024;
+  unsigned char *data = (unsigned char *)malloc(size);
+  ASSERT_TRUE(data != NULL);
+  memset(data, 0x5a, size);
+
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  unsigned int crc = st_crc32_checksum(data, size);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  double sec =
+      (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+  printf("st_crc32_checksum: %.0f MB/s (%08x)\n",
+         size / sec / (1024 * 1024), crc);
+
+  free(data);
+}
+
 TEST_F(ToolsTest, formatDecimal84Truncate) {
   // Convert to DECIMAL(8,4)
   char buff[50] = {};
@@ -25,6 +25,7 @@
 #ifndef __ANDROID_API__
 #include <execinfo.h>
 #endif /*__ANDROID_API__*/
+#include <ctype.h>
 #include <grp.h>
 #include <inttypes.h>
 #include <limits.h>
@@ -46,6 +47,20 @@
 #include <openssl/evp.h>
 #endif /*__OPENSSL_TOOLS*/
 
+// SIMD variants are picked at run time, see st_crc32_init and
+// st_ssse3_enabled
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ST_CRC32_PCLMUL
+#define ST_SSSE3
+#include <cpuid.h>
+#include <immintrin.h>
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__linux__)
+#define ST_CRC32_ARMV8
+#include <arm_acle.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
 #ifdef __BCRYPT
 #include "crypt_blowfish/ow-crypt.h"
 #define BCRYPT_RABD_SIZE 16
@@ -255,20 +270,283 @@ void st_mainloop_free(void) { eh_free(st_eh); }
 
 void st_mainloop_wait(int usec) { eh_wait(st_eh, usec); }
 
-char *st_bin2hex(char *buffer, const char *src, size_t len) {
-  size_t a, b;
+static const char st_hex_digits[] = "0123456789ABCDEF";
 
-  if (src == 0 || buffer == 0) return buffer;
+static const char st_base64_chars[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Character value + 1 for hex and base64 decoding, 0 marks invalid input
+static unsigned char st_hex_values[256];
+static unsigned char st_base64_values[256];
+static pthread_once_t st_codec_once = PTHREAD_ONCE_INIT;
+
+static void st_codec_init(void) {
+  int a;
+
+  for (a = 0; a < 16; a++) {
+    st_hex_values[(unsigned char)st_hex_digits[a]] = a + 1;
+    st_hex_values[(unsigned char)tolower(st_hex_digits[a])] = a + 1;
+  }
+
+  for (a = 0; a < 64; a++) {
+    st_base64_values[(unsigned char)st_base64_chars[a]] = a + 1;
+  }
+}
+
+#ifdef ST_SSSE3
+// 8 bytes -> 16 hex digits
+__attribute__((target("ssse3"))) static void st_hex_encode8_ssse3(
+    char *dst, const unsigned char *src) {
+  const __m128i digits = _mm_loadu_si128((const __m128i *)st_hex_digits);
+  const __m128i mask = _mm_set1_epi8(0x0f);
+  __m128i in = _mm_loadl_epi64((const __m128i *)src);
+  __m128i hi = _mm_and_si128(_mm_srli_epi16(in, 4), mask);
+  __m128i lo = _mm_and_si128(in, mask);
+
+  _mm_storeu_si128((__m128i *)dst,
+                   _mm_shuffle_epi8(digits, _mm_unpacklo_epi8(hi, lo)));
+}
+
+// 12 bytes (16 readable) -> 16 characters. W. Muła, D. Lemire, "Faster
+// Base64 Encoding and Decoding Using AVX2 Instructions", SSE variant.
+__attribute__((target("ssse3"))) static void st_base64_encode12_ssse3(
+    char *dst, const unsigned char *src) {
+  const __m128i shift_lut =
+      _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                    '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                    '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+  __m128i in, t0, t1, t2, t3, idx, result;
+
+  in = _mm_loadu_si128((const __m128i *)src);
+  in = _mm_shuffle_epi8(
+      in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+  t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+  t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+  t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+  t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+  idx = _mm_or_si128(t1, t3);
+
+  result = _mm_subs_epu8(idx, _mm_set1_epi8(51));
+  result = _mm_or_si128(
+      result, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), idx),
+                            _mm_set1_epi8(13)));
+  result = _mm_add_epi8(_mm_shuffle_epi8(shift_lut, result), idx);
+
+  _mm_storeu_si128((__m128i *)dst, result);
+}
+
+// 16 characters -> 12 bytes (16 written). Returns 0 on a character outside
+// the base64 alphabet, padding included.
+__attribute__((target("ssse3"))) static int st_base64_decode16_ssse3(
+    unsigned char *dst, const char *src) {
+  const __m128i lut_lo =
+      _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                    0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+  const __m128i lut_hi =
+      _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10,
+                    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+  const __m128i lut_roll =
+      _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m128i mask = _mm_set1_epi8(0x0f);
+  __m128i in, hi, lo, roll, values;
+
+  in = _mm_loadu_si128((const __m128i *)src);
+  hi = _mm_and_si128(_mm_srli_epi32(in, 4), mask);
+  lo = _mm_and_si128(in, mask);
+
+  if (_mm_movemask_epi8(_mm_cmpeq_epi8(
+          _mm_and_si128(_mm_shuffle_epi8(lut_lo, lo),
+                        _mm_shuffle_epi8(lut_hi, hi)),
+          _mm_setzero_si128())) != 0xffff) {
+    return 0;
+  }
 
-  buffer[0] = 0;
+  roll = _mm_shuffle_epi8(
+      lut_roll, _mm_add_epi8(_mm_cmpeq_epi8(in, _mm_set1_epi8('/')), hi));
+  values = _mm_add_epi8(in, roll);
+
+  values = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+  values = _mm_madd_epi16(values, _mm_set1_epi32(0x00011000));
+  values = _mm_shuffle_epi8(values, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8,
+                                                  14, 13, 12, -1, -1, -1, -1));
+
+  _mm_storeu_si128((__m128i *)dst, values);
+  return 1;
+}
+#endif /*ST_SSSE3*/
+
+static volatile char st_codec_simd = 1;
+
+void st_codec_simd_enable(char enable) { st_codec_simd = enable ? 1 : 0; }
+
+static char st_ssse3_enabled(void) {
+#ifdef ST_SSSE3
+  return st_codec_simd && __builtin_cpu_supports("ssse3") ? 1 : 0;
+#else
+  return 0;
+#endif /*ST_SSSE3*/
+}
+
+int st_hex_encode(char *dst, size_t dst_size, const char *src,
+                  size_t src_len) {
+  const unsigned char *in = (const unsigned char *)src;
+  size_t a = 0;
+
+  if (dst == NULL || (src == NULL && src_len > 0) || src_len > INT_MAX / 2 ||
+      dst_size < src_len * 2 + 1) {
+    return -1;
+  }
+
+#ifdef ST_SSSE3
+  if (src_len >= 8 && st_ssse3_enabled()) {
+    for (; a + 8 <= src_len; a += 8) {
+      st_hex_encode8_ssse3(&dst[a * 2], &in[a]);
+    }
+  }
+#endif /*ST_SSSE3*/
+
+  for (; a < src_len; a++) {
+    dst[a * 2] = st_hex_digits[in[a] >> 4];
+    dst[a * 2 + 1] = st_hex_digits[in[a] & 0x0f];
+  }
+
+  dst[src_len * 2] = 0;
+  return src_len * 2;
+}
 
-  b = 0;
+int st_hex2bin(char *dst, size_t dst_size, const char *src, size_t src_len) {
+  const unsigned char *in = (const unsigned char *)src;
+  unsigned char hi, lo;
+  size_t a;
 
-  for (a = 0; a < len; a++) {
-    snprintf(&buffer[b], 3, "%02X", (unsigned char)src[a]);  // NOLINT
-    b += 2;
+  if (dst == NULL || (src == NULL && src_len > 0) || src_len % 2 ||
+      src_len > INT_MAX || dst_size < src_len / 2) {
+    return -1;
   }
 
+  pthread_once(&st_codec_once, st_codec_init);
+
+  for (a = 0; a < src_len; a += 2) {
+    hi = st_hex_values[in[a]];
+    lo = st_hex_values[in[a + 1]];
+
+    if (hi == 0 || lo == 0) return -1;
+
+    dst[a / 2] = ((hi - 1) << 4) | (lo - 1);
+  }
+
+  return src_len / 2;
+}
+
+int st_base64_encode(char *dst, size_t dst_size, const char *src,
+                     size_t src_len) {
+  const unsigned char *in = (const unsigned char *)src;
+  char *out = dst;
+  unsigned _supla_int_t v;
+
+  if (dst == NULL || (src == NULL && src_len > 0) ||
+      src_len > (INT_MAX / 4 - 1) * 3 ||
+      dst_size < ST_BASE64_ENCODED_SIZE(src_len)) {
+    return -1;
+  }
+
+#ifdef ST_SSSE3
+  if (src_len >= 16 && st_ssse3_enabled()) {
+    while (src_len >= 16) {
+      st_base64_encode12_ssse3(out, in);
+      in += 12;
+      out += 16;
+      src_len -= 12;
+    }
+  }
+#endif /*ST_SSSE3*/
+
+  for (; src_len >= 3; src_len -= 3, in += 3, out += 4) {
+    v = (in[0] << 16) | (in[1] << 8) | in[2];
+    out[0] = st_base64_chars[v >> 18];
+    out[1] = st_base64_chars[(v >> 12) & 0x3f];
+    out[2] = st_base64_chars[(v >> 6) & 0x3f];
+    out[3] = st_base64_chars[v & 0x3f];
+  }
+
+  if (src_len > 0) {
+    v = in[0] << 16;
+    if (src_len == 2) v |= in[1] << 8;
+
+    out[0] = st_base64_chars[v >> 18];
+    out[1] = st_base64_chars[(v >> 12) & 0x3f];
+    out[2] = src_len == 2 ? st_base64_chars[(v >> 6) & 0x3f] : '=';
+    out[3] = '=';
+    out += 4;
+  }
+
+  *out = 0;
+  return out - dst;
+}
+
+// Padding is optional, characters outside the alphabet are rejected.
+int st_base64_decode(char *dst, size_t dst_size, const char *src,
+                     size_t src_len) {
+  const unsigned char *in = (const unsigned char *)src;
+  unsigned char *out = (unsigned char *)dst;
+  unsigned char c[4];
+  size_t size, a;
+
+  if (dst == NULL || (src == NULL && src_len > 0) || src_len > INT_MAX) {
+    return -1;
+  }
+
+  if (src_len >= 4 && src_len % 4 == 0) {
+    if (in[src_len - 1] == '=') src_len--;
+    if (in[src_len - 1] == '=') src_len--;
+  }
+
+  if (src_len % 4 == 1) return -1;
+
+  size = src_len / 4 * 3 + (src_len % 4 ? src_len % 4 - 1 : 0);
+  if (dst_size < size) return -1;
+
+  pthread_once(&st_codec_once, st_codec_init);
+
+#ifdef ST_SSSE3
+  if (src_len >= 16 && st_ssse3_enabled()) {
+    // Each block writes 16 bytes, 4 beyond the 12 it decodes
+    while (src_len >= 16 && (size_t)(out - (unsigned char *)dst) + 16 <= size &&
+           st_base64_decode16_ssse3(out, (const char *)in)) {
+      in += 16;
+      out += 12;
+      src_len -= 16;
+    }
+  }
+#endif /*ST_SSSE3*/
+
+  while (src_len > 0) {
+    size_t n = src_len < 4 ? src_len : 4;
+
+    for (a = 0; a < 4; a++) {
+      c[a] = a < n ? st_base64_values[in[a]] : 1;
+      if (c[a] == 0) return -1;
+      c[a]--;
+    }
+
+    out[0] = (c[0] << 2) | (c[1] >> 4);
+    if (n > 2) out[1] = (c[1] << 4) | (c[2] >> 2);
+    if (n > 3) out[2] = (c[2] << 6) | c[3];
+
+    in += n;
+    out += n - 1;
+    src_len -= n;
+  }
+
+  return size;
+}
+
+char *st_bin2hex(char *buffer, const char *src, size_t len) {
+  if (src == 0 || buffer == 0) return buffer;
+
+  st_hex_encode(buffer, len * 2 + 1, src, len);
+
   return buffer;
 }
 
@@ -517,6 +795,149 @@ int st_hue2rgb(double hue) {
   return st_hsv2rgb(hsv);
 }
 
+// Batch color conversions process ST_COLOR_LANES colors at a time using
+// vector extensions, compiled to SSE on x86 and NEON on ARM.
+#if defined(__GNUC__) && (__GNUC__ >= 9 || defined(__clang__))
+#define ST_COLOR_VECTORS
+#define ST_COLOR_LANES 4
+
+typedef float _st_v4f_t __attribute__((vector_size(16)));
+typedef int _st_v4i_t __attribute__((vector_size(16)));
+
+#define ST_V4F_SELECT(MASK, A, B) \
+  ((_st_v4f_t)(((MASK) & (_st_v4i_t)(A)) | (~(MASK) & (_st_v4i_t)(B))))
+
+static void st_rgb2hsv_vec(const int *rgb, _color_hsv_t *hsv, size_t count) {
+  const _st_v4f_t zero = {0};
+  _st_v4f_t r, g, b, min, max, delta, h, s;
+  _st_v4i_t c, gray;
+  int in[ST_COLOR_LANES];
+  float out[3][ST_COLOR_LANES];
+  size_t a, n;
+
+  for (; count > 0; count -= n, rgb += n, hsv += n) {
+    n = count < ST_COLOR_LANES ? count : ST_COLOR_LANES;
+
+    if (n == ST_COLOR_LANES) {
+      memcpy(&c, rgb, sizeof(c));
+    } else {
+      memset(in, 0, sizeof(in));
+      memcpy(in, rgb, n * sizeof(int));
+      memcpy(&c, in, sizeof(c));
+    }
+
+    r = __builtin_convertvector((c >> 16) & 0xff, _st_v4f_t);
+    g = __builtin_convertvector((c >> 8) & 0xff, _st_v4f_t);
+    b = __builtin_convertvector(c & 0xff, _st_v4f_t);
+
+    min = ST_V4F_SELECT(r < g, r, g);
+    min = ST_V4F_SELECT(min < b, min, b);
+    max = ST_V4F_SELECT(r > g, r, g);
+    max = ST_V4F_SELECT(max > b, max, b);
+
+    // Gray lanes divide by 1 and are zeroed below
+    gray = max - min < 0.5f;
+    delta = ST_V4F_SELECT(gray, zero + 1.0f, max - min);
+
+    h = ST_V4F_SELECT(r >= max, g - b,
+                      ST_V4F_SELECT(g >= max, b - r + 2.0f * delta,
+                                    r - g + 4.0f * delta));
+    h *= 60.0f / delta;
+    h = ST_V4F_SELECT(h < 0.0f, h + 360.0f, h);
+    h = ST_V4F_SELECT(gray, zero, h);
+    s = ST_V4F_SELECT(gray, zero, delta / max);
+    max /= 255.0f;
+
+    memcpy(out[0], &h, sizeof(h));
+    memcpy(out[1], &s, sizeof(s));
+    memcpy(out[2], &max, sizeof(max));
+
+    for (a = 0; a < n; a++) {
+      hsv[a].h = out[0][a];
+      hsv[a].s = out[1][a];
+      hsv[a].v = out[2][a];
+    }
+  }
+}
+
+static void st_hsv2rgb_vec(const _color_hsv_t *hsv, int *rgb, size_t count) {
+  const _st_v4f_t zero = {0};
+  _st_v4f_t h, s, v, f, p, q, t, r, g, b;
+  _st_v4i_t i, c;
+  float in[3][ST_COLOR_LANES];
+  int out[ST_COLOR_LANES];
+  size_t a, n;
+
+  for (; count > 0; count -= n, hsv += n, rgb += n) {
+    n = count < ST_COLOR_LANES ? count : ST_COLOR_LANES;
+
+    for (a = 0; a < ST_COLOR_LANES; a++) {
+      in[0][a] = a < n ? hsv[a].h : 0;
+      in[1][a] = a < n ? hsv[a].s : 0;
+      in[2][a] = a < n ? hsv[a].v : 0;
+    }
+
+    memcpy(&h, in[0], sizeof(h));
+    memcpy(&s, in[1], sizeof(s));
+    memcpy(&v, in[2], sizeof(v));
+
+    h = ST_V4F_SELECT(h >= 360.0f, zero, h / 60.0f);
+    i = __builtin_convertvector(h, _st_v4i_t);
+    f = h - __builtin_convertvector(i, _st_v4f_t);
+    p = v * (1.0f - s);
+    q = v * (1.0f - s * f);
+    t = v * (1.0f - s * (1.0f - f));
+
+    // Sectors outside 0..5 are black, as in st_hsv2rgb
+    r = ST_V4F_SELECT((i == 0) | (i == 5), v, zero);
+    r = ST_V4F_SELECT(i == 1, q, r);
+    r = ST_V4F_SELECT((i == 2) | (i == 3), p, r);
+    r = ST_V4F_SELECT(i == 4, t, r);
+
+    g = ST_V4F_SELECT(i == 0, t, zero);
+    g = ST_V4F_SELECT((i == 1) | (i == 2), v, g);
+    g = ST_V4F_SELECT(i == 3, q, g);
+    g = ST_V4F_SELECT((i == 4) | (i == 5), p, g);
+
+    b = ST_V4F_SELECT((i == 0) | (i == 1), p, zero);
+    b = ST_V4F_SELECT(i == 2, t, b);
+    b = ST_V4F_SELECT((i == 3) | (i == 4), v, b);
+    b = ST_V4F_SELECT(i == 5, q, b);
+
+    r = ST_V4F_SELECT(s <= 0.0f, v, r);
+    g = ST_V4F_SELECT(s <= 0.0f, v, g);
+    b = ST_V4F_SELECT(s <= 0.0f, v, b);
+
+    c = (__builtin_convertvector(r * 255.0f, _st_v4i_t) & 0xff) << 16;
+    c |= (__builtin_convertvector(g * 255.0f, _st_v4i_t) & 0xff) << 8;
+    c |= __builtin_convertvector(b * 255.0f, _st_v4i_t) & 0xff;
+
+    if (n == ST_COLOR_LANES) {
+      memcpy(rgb, &c, sizeof(c));
+    } else {
+      memcpy(out, &c, sizeof(out));
+      memcpy(rgb, out, n * sizeof(int));
+    }
+  }
+}
+#endif /*ST_COLOR_VECTORS*/
+
+void st_rgb2hsv_batch(const int *rgb, _color_hsv_t *hsv, size_t count) {
+#ifdef ST_COLOR_VECTORS
+  st_rgb2hsv_vec(rgb, hsv, count);
+#else
+  while (count--) *hsv++ = st_rgb2hsv(*rgb++);
+#endif /*ST_COLOR_VECTORS*/
+}
+
+void st_hsv2rgb_batch(const _color_hsv_t *hsv, int *rgb, size_t count) {
+#ifdef ST_COLOR_VECTORS
+  st_hsv2rgb_vec(hsv, rgb, count);
+#else
+  while (count--) *rgb++ = st_hsv2rgb(*hsv++);
+#endif /*ST_COLOR_VECTORS*/
+}
+
 void st_random_alpha_string(char *buffer, int buffer_size) {
   int a;
 
@@ -706,65 +1127,231 @@ int format_decimal_trunc(double x, int precision, int scale, char *out,
 
 #endif /* __BCRYPT*/
 
+// Tables 1..7 for slicing by 8, derived from st_crc32_tab (table 0).
+static unsigned _supla_int_t st_crc32_slice_tab[7][256];
+static pthread_once_t st_crc32_once = PTHREAD_ONCE_INIT;
+
+typedef unsigned _supla_int_t (*_func_st_crc32_update)(
+    unsigned _supla_int_t crc, const unsigned char *data, size_t length);
+
+static _func_st_crc32_update st_crc32_update = NULL;
+
+static inline unsigned _supla_int_t st_crc32_le32(const unsigned char *data) {
+  return (unsigned _supla_int_t)data[0] |
+         ((unsigned _supla_int_t)data[1] << 8) |
+         ((unsigned _supla_int_t)data[2] << 16) |
+         ((unsigned _supla_int_t)data[3] << 24);
+}
+
+static unsigned _supla_int_t st_crc32_bytes(unsigned _supla_int_t crc,
+                                            const unsigned char *data,
+                                            size_t length) {
+  while (length--) crc = (crc >> 8) ^ st_crc32_tab[(crc ^ *data++) & 0xff];
+
+  return crc;
+}
+
+static unsigned _supla_int_t st_crc32_slice8(unsigned _supla_int_t crc,
+                                             const unsigned char *data,
+                                             size_t length) {
+  const unsigned _supla_int_t(*t)[256] = st_crc32_slice_tab;
+  unsigned _supla_int_t hi;
+
+  while (length >= 8) {
+    crc ^= st_crc32_le32(data);
+    hi = st_crc32_le32(data + 4);
+
+    crc = t[6][crc & 0xff] ^ t[5][(crc >> 8) & 0xff] ^
+          t[4][(crc >> 16) & 0xff] ^ t[3][crc >> 24] ^ t[2][hi & 0xff] ^
+          t[1][(hi >> 8) & 0xff] ^ t[0][(hi >> 16) & 0xff] ^
+          st_crc32_tab[hi >> 24];
+
+    data += 8;
+    length -= 8;
+  }
+
+  return st_crc32_bytes(crc, data, length);
+}
+
+#if defined(ST_CRC32_PCLMUL)
+// Folds 64 bytes per iteration with carry-less multiplication, then reduces
+// to 32 bits (Intel, "Fast CRC Computation for Generic Polynomials Using
+// PCLMULQDQ Instruction"). Constants are for the reflected 0xEDB88320.
+__attribute__((target("pclmul,sse4.1"))) static unsigned _supla_int_t
+st_crc32_pclmul(unsigned _supla_int_t crc, const unsigned char *data,
+                size_t length) {
+  const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+  const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+  const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124);
+  const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+  const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+  __m128i x1, x2, x3, x4, x5, x6, x7, x8;
+
+  if (length < 64) return st_crc32_slice8(crc, data, length);
+
+  x1 = _mm_loadu_si128((const __m128i *)(data + 0x00));
+  x2 = _mm_loadu_si128((const __m128i *)(data + 0x10));
+  x3 = _mm_loadu_si128((const __m128i *)(data + 0x20));
+  x4 = _mm_loadu_si128((const __m128i *)(data + 0x30));
+  x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(crc));
+
+  data += 64;
+  length -= 64;
+
+  while (length >= 64) {
+    x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+    x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+    x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+    x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+
+    x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+    x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+    x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+    x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+                       _mm_loadu_si128((const __m128i *)(data + 0x00)));
+    x2 = _mm_xor_si128(_mm_xor_si128(x2, x6),
+                       _mm_loadu_si128((const __m128i *)(data + 0x10)));
+    x3 = _mm_xor_si128(_mm_xor_si128(x3, x7),
+                       _mm_loadu_si128((const __m128i *)(data + 0x20)));
+    x4 = _mm_xor_si128(_mm_xor_si128(x4, x8),
+                       _mm_loadu_si128((const __m128i *)(data + 0x30)));
+
+    data += 64;
+    length -= 64;
+  }
+
+  // Fold the four lanes and any remaining 16 byte blocks into one
+  x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+  x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+  x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+  while (length >= 16) {
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(
+        _mm_xor_si128(x1, _mm_loadu_si128((const __m128i *)data)), x5);
+
+    data += 16;
+    length -= 16;
+  }
+
+  // 128 -> 64 bits
+  x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_and_si128(x1, mask32);
+  x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  // Barrett reduction to 32 bits
+  x2 = _mm_and_si128(x1, mask32);
+  x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+  x2 = _mm_and_si128(x2, mask32);
+  x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  crc = _mm_extract_epi32(x1, 1);
+
+  return st_crc32_slice8(crc, data, length);
+}
+#elif defined(ST_CRC32_ARMV8)
+__attribute__((target("+crc"))) static unsigned _supla_int_t st_crc32_armv8(
+    unsigned _supla_int_t crc, const unsigned char *data, size_t length) {
+  uint64_t v;
+
+  while (length >= 8) {
+    memcpy(&v, data, sizeof(v));
+    crc = __crc32d(crc, v);
+    data += 8;
+    length -= 8;
+  }
+
+  while (length--) crc = __crc32b(crc, *data++);
+
+  return crc;
+}
+#endif /*ST_CRC32_PCLMUL*/
+
+static void st_crc32_init(void) {
+  unsigned _supla_int_t crc;
+  int a, b;
+
+  for (a = 0; a < 256; a++) {
+    crc = st_crc32_tab[a];
+    for (b = 0; b < 7; b++) {
+      crc = (crc >> 8) ^ st_crc32_tab[crc & 0xff];
+      st_crc32_slice_tab[b][a] = crc;
+    }
+  }
+
+  st_crc32_update = st_crc32_slice8;
+
+#if defined(ST_CRC32_PCLMUL)
+  unsigned int eax, ebx, ecx, edx;
+  if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_PCLMUL) &&
+      (ecx & bit_SSE4_1)) {
+    st_crc32_update = st_crc32_pclmul;
+  }
+#elif defined(ST_CRC32_ARMV8)
+  if (getauxval(AT_HWCAP) & HWCAP_CRC32) {
+    st_crc32_update = st_crc32_armv8;
+  }
+#endif /*ST_CRC32_PCLMUL*/
+}
+
 unsigned _supla_int_t st_crc32_checksum(const unsigned char *data,
                                         size_t length) {
-  unsigned _supla_int_t crc32 = 0xffffffff;
+  pthread_once(&st_crc32_once, st_crc32_init);
 
-  while (length--)
-    crc32 = (crc32 >> 8) ^ st_crc32_tab[((crc32 ^ *data++) & 0xff)];
-
-  return crc32 ^ 0xffffffff;
+  return st_crc32_update(0xffffffff, data, length) ^ 0xffffffff;
 }
 
 #ifdef __OPENSSL_TOOLS
 
 char *st_openssl_base64_encode(const char *src, int src_len) {
-  BIO *bio, *b64;
-  BUF_MEM *bufferPtr;
   char *result = NULL;
 
   if (src_len <= 0 || src == NULL) {
     return NULL;
   }
 
-  b64 = BIO_new(BIO_f_base64());
-  bio = BIO_new(BIO_s_mem());
-  bio = BIO_push(b64, bio);
-  BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
-
-  BIO_write(bio, src, src_len);
-  (void)BIO_flush(bio);
-
-  BIO_get_mem_ptr(bio, &bufferPtr);
-
-  result = malloc(bufferPtr->length + 1);
-  memcpy(result, bufferPtr->data, bufferPtr->length);
-  result[bufferPtr->length] = 0;
-
-  BIO_free_all(bio);
+  result = malloc(ST_BASE64_ENCODED_SIZE(src_len));
+  if (result != NULL &&
+      st_base64_encode(result, ST_BASE64_ENCODED_SIZE(src_len), src,
+                       src_len) < 0) {
+    free(result);
+    result = NULL;
+  }
 
   return result;
 }
 
 char *st_openssl_base64_decode(const char *src, int src_len, int *dst_len) {
-  BIO *bio, *b64;
-
   char *buffer = (char *)malloc(src_len + 1);
-  memset(buffer, 0, src_len + 1);
+  int r;
 
-  b64 = BIO_new(BIO_f_base64());
-  bio = BIO_new_mem_buf(src, src_len);
-  bio = BIO_push(b64, bio);
-  BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
+  if (buffer == NULL) {
+    return NULL;
+  }
 
-  int r = BIO_read(bio, buffer, src_len);
-  BIO_free_all(bio);
+  r = st_base64_decode(buffer, src_len, src, src_len);
 
   if (r < 0) {
     r = 0;
   }
 
-  buffer = realloc(buffer, r + 1);
+  buffer[r] = 0;
 
   if (dst_len) {
     *dst_len = r;
@@ -58,6 +58,23 @@ void st_authkey2hex(char AuthKeyHEX[SUPLA_AUTHKEY_HEXSIZE],
 char *st_str2hex(char *buffer, const char *str, size_t maxlen);
 char *st_bin2hex(char *buffer, const char *src, size_t len);
 
+// Buffer size including the terminating NUL
+#define ST_BASE64_ENCODED_SIZE(len) (((len) + 2) / 3 * 4 + 1)
+
+// The codecs write into caller supplied buffers and return the number of
+// bytes produced, or -1 when dst is too small or the input is invalid.
+// Encoders also write a terminating NUL which is not counted.
+int st_hex_encode(char *dst, size_t dst_size, const char *src,
+                  size_t src_len);
+int st_hex2bin(char *dst, size_t dst_size, const char *src, size_t src_len);
+int st_base64_encode(char *dst, size_t dst_size, const char *src,
+                     size_t src_len);
+int st_base64_decode(char *dst, size_t dst_size, const char *src,
+                     size_t src_len);
+// Turns the SIMD variants of the hex and base64 codecs off and on, so both
+// paths can be tested on the same machine. On by default.
+void st_codec_simd_enable(char enable);
+
 char st_read_randkey_from_file(char *file, char *KEY, int size, char create);
 char st_read_guid_from_file(char *file, char *GUID, char create);
 char st_read_authkey_from_file(char *file, char *AuthKey, char create);
@@ -71,6 +88,12 @@ _color_hsv_t st_rgb2hsv(int rgb);
 int st_hsv2rgb(_color_hsv_t in);
 int st_hue2rgb(double hue);
 
+// Convert arrays of packed 0xRRGGBB colors. Single precision is used, so h
+// and s may differ from st_rgb2hsv by up to 0.001 and each rgb channel from
+// st_hsv2rgb by 1.
+void st_rgb2hsv_batch(const int *rgb, _color_hsv_t *hsv, size_t count);
+void st_hsv2rgb_batch(const _color_hsv_t *hsv, int *rgb, size_t count);
+
 void st_random_alpha_string(char *buffer, int buffer_size);
 void st_uuid_v4(char buffer[37]);
 
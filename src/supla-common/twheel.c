@@ -0,0 +1,257 @@
+/*
+ Copyright (C) AC SOFTWARE SP. Z O.O.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "twheel.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+
+#define TWHEEL_LEVELS 4
+#define TWHEEL_BITS 6
+#define TWHEEL_SLOTS (1 << TWHEEL_BITS)
+#define TWHEEL_MASK (TWHEEL_SLOTS - 1)
+#define TWHEEL_RANGE (1ULL << (TWHEEL_BITS * TWHEEL_LEVELS))
+
+typedef struct {
+  // Next tick to process, every deadline before it has expired
+  uint64_t base;
+  int count;
+  uint64_t occupied[TWHEEL_LEVELS];
+  TWheelTimer *slots[TWHEEL_LEVELS][TWHEEL_SLOTS];
+} TWheel;
+
+void *twheel_init(uint64_t now_ms) {
+  TWheel *wheel = calloc(1, sizeof(TWheel));
+  if (wheel == NULL) return NULL;
+
+  wheel->base = now_ms;
+  return wheel;
+}
+
+void twheel_free(void *wheel) {
+  assert(wheel != 0);
+  free(wheel);
+}
+
+int twheel_count(void *wheel) {
+  assert(wheel != 0);
+  return ((TWheel *)wheel)->count;
+}
+
+void twheel_timer_init(TWheelTimer *timer, void *user_data) {
+  timer->next = NULL;
+  timer->prev = NULL;
+  timer->expires = 0;
+  timer->user_data = user_data;
+}
+
+char twheel_timer_pending(const TWheelTimer *timer) {
+  return timer->prev != NULL;
+}
+
+// prev of the first timer in a slot points back to the slot head, so unlink
+// does not need to know the slot
+static void twheel_link(TWheel *wheel, TWheelTimer *timer) {
+  uint64_t expires = timer->expires;
+  uint64_t delta;
+  TWheelTimer **head;
+  int level, slot;
+
+  if (expires < wheel->base) expires = wheel->base;
+
+  delta = expires - wheel->base;
+  if (delta >= TWHEEL_RANGE) {
+    delta = TWHEEL_RANGE - 1;
+    expires = wheel->base + delta;
+  }
+
+  for (level = 0; level < TWHEEL_LEVELS - 1; level++) {
+    if (delta < (1ULL << (TWHEEL_BITS * (level + 1)))) break;
+  }
+
+  slot = (expires >> (TWHEEL_BITS * level)) & TWHEEL_MASK;
+  head = &wheel->slots[level][slot];
+
+  timer->next = *head;
+  timer->prev = (TWheelTimer *)head;
+  if (*head) (*head)->prev = timer;
+  *head = timer;
+  wheel->occupied[level] |= 1ULL << slot;
+}
+
+static void twheel_unlink(TWheel *wheel, TWheelTimer *timer) {
+  TWheelTimer **first = &wheel->slots[0][0];
+  uintptr_t prev = (uintptr_t)timer->prev;
+  int idx;
+
+  // prev is either the previous timer or a slot head, both start with next
+  timer->prev->next = timer->next;
+  if (timer->next) timer->next->prev = timer->prev;
+
+  if (timer->next == NULL && prev >= (uintptr_t)first &&
+      prev < (uintptr_t)(first + TWHEEL_LEVELS * TWHEEL_SLOTS)) {
+    // It was the only timer in its slot
+    idx = (TWheelTimer **)timer->prev - first;
+    wheel->occupied[idx / TWHEEL_SLOTS] &= ~(1ULL << (idx % TWHEEL_SLOTS));
+  }
+
+  timer->next = NULL;
+  timer->prev = NULL;
+}
+
+void twheel_schedule(void *_wheel, TWheelTimer *timer, uint64_t expires_ms) {
+  TWheel *wheel = (TWheel *)_wheel;
+  assert(_wheel != 0);
+
+  if (twheel_timer_pending(timer)) {
+    twheel_unlink(wheel, timer);
+  } else {
+    wheel->count++;
+  }
+
+  timer->expires = expires_ms;
+  twheel_link(wheel, timer);
+}
+
+void twheel_cancel(void *_wheel, TWheelTimer *timer) {
+  TWheel *wheel = (TWheel *)_wheel;
+  assert(_wheel != 0);
+
+  if (twheel_timer_pending(timer)) {
+    twheel_unlink(wheel, timer);
+    wheel->count--;
+  }
+}
+
+// Distance from slot to the first occupied slot at or after it, cyclically
+static int twheel_distance(uint64_t occupied, int slot) {
+  if (slot) {
+    occupied = (occupied >> slot) | (occupied << (TWHEEL_SLOTS - slot));
+  }
+  return __builtin_ctzll(occupied);
+}
+
+// Earliest time a timer may expire, exact for level 0 and the start of the
+// first occupied slot for the higher levels
+static uint64_t twheel_next_expiry(TWheel *wheel) {
+  uint64_t result = UINT64_MAX;
+  uint64_t idx, at;
+  int level, d;
+
+  for (level = 0; level < TWHEEL_LEVELS; level++) {
+    if (wheel->occupied[level] == 0) continue;
+
+    idx = wheel->base >> (TWHEEL_BITS * level);
+
+    if (level == 0) {
+      at = wheel->base + twheel_distance(wheel->occupied[0], idx & TWHEEL_MASK);
+    } else if ((wheel->base & ((1ULL << (TWHEEL_BITS * level)) - 1)) == 0) {
+      // Aligned base, the current slot cascades on the next step
+      d = twheel_distance(wheel->occupied[level], idx & TWHEEL_MASK);
+      at = (idx + d) << (TWHEEL_BITS * level);
+    } else {
+      // The current slot already cascaded, if occupied it belongs to the
+      // next rotation. Search after it.
+      d = twheel_distance(wheel->occupied[level], (idx + 1) & TWHEEL_MASK) + 1;
+      at = (idx + d) << (TWHEEL_BITS * level);
+    }
+
+    if (at < result) result = at;
+  }
+
+  return result;
+}
+
+// Moves the timers of a higher level slot to the lower levels
+static void twheel_cascade(TWheel *wheel, int level, int slot) {
+  TWheelTimer *timer = wheel->slots[level][slot];
+  TWheelTimer *next;
+
+  wheel->slots[level][slot] = NULL;
+  wheel->occupied[level] &= ~(1ULL << slot);
+
+  for (; timer; timer = next) {
+    next = timer->next;
+    twheel_link(wheel, timer);
+  }
+}
+
+int twheel_advance(void *_wheel, uint64_t now_ms, _func_twheel_expired expired,
+                   void *user_data) {
+  TWheel *wheel = (TWheel *)_wheel;
+  TWheelTimer **head;
+  TWheelTimer *timer;
+  uint64_t cur, next;
+  int result = 0;
+  int level, slot;
+
+  assert(_wheel != 0);
+
+  while (wheel->base <= now_ms) {
+    cur = wheel->base;
+
+    if ((cur & TWHEEL_MASK) == 0) {
+      // Highest level first, its timers may land in the lower slots due now
+      for (level = TWHEEL_LEVELS - 1; level > 0; level--) {
+        if ((cur & ((1ULL << (TWHEEL_BITS * level)) - 1)) == 0) {
+          twheel_cascade(wheel, level,
+                         (cur >> (TWHEEL_BITS * level)) & TWHEEL_MASK);
+        }
+      }
+    }
+
+    slot = cur & TWHEEL_MASK;
+    if ((wheel->occupied[0] >> slot) == 0) {
+      // Nothing left in this rotation of level 0. Skip to the next cascade,
+      // or further when level 0 is empty, as cascades of empty slots are
+      // no-ops.
+      next = wheel->occupied[0] ? (cur | TWHEEL_MASK) + 1
+                                : twheel_next_expiry(wheel);
+      wheel->base = next <= now_ms ? next : now_ms + 1;
+      continue;
+    }
+
+    // Timers scheduled from the callback for cur or earlier go to cur + 1
+    wheel->base = cur + 1;
+
+    head = &wheel->slots[0][slot];
+    while ((timer = *head) != NULL) {
+      twheel_unlink(wheel, timer);
+      wheel->count--;
+      result++;
+      expired(timer, user_data);
+    }
+  }
+
+  return result;
+}
+
+int twheel_next_timeout(void *_wheel, uint64_t now_ms) {
+  TWheel *wheel = (TWheel *)_wheel;
+  uint64_t next;
+
+  assert(_wheel != 0);
+
+  if (wheel->count == 0) return -1;
+
+  next = twheel_next_expiry(wheel);
+  if (next <= now_ms) return 0;
+  if (next - now_ms > INT_MAX) return INT_MAX;
+  return next - now_ms;
+}
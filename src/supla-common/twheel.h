@@ -0,0 +1,75 @@
+/*
+ Copyright (C) AC SOFTWARE SP. Z O.O.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef TWHEEL_H_
+#define TWHEEL_H_
+
+#include <stdint.h>
+
+// Hierarchical timer wheel with millisecond resolution. Four levels of 64
+// slots cover 2^24 ms (about 4.6 hours), later deadlines wait in the top
+// level and are placed again when it cascades. Scheduling and cancelling are
+// O(1), twheel_advance() costs the number of expired timers plus one step per
+// 64 ms of elapsed time.
+//
+// Timers are embedded in the caller's structures, the wheel does not allocate
+// them. The wheel is not thread safe.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _TWheelTimer {
+  struct _TWheelTimer *next;
+  struct _TWheelTimer *prev;
+  uint64_t expires;
+  void *user_data;
+} TWheelTimer;
+
+typedef void (*_func_twheel_expired)(TWheelTimer *timer, void *user_data);
+
+// now_ms is the current time in the caller's clock, usually monotonic
+void *twheel_init(uint64_t now_ms);
+void twheel_free(void *wheel);
+int twheel_count(void *wheel);
+
+void twheel_timer_init(TWheelTimer *timer, void *user_data);
+char twheel_timer_pending(const TWheelTimer *timer);
+
+// Moves a pending timer. Deadlines not later than the last twheel_advance()
+// time expire one millisecond after it.
+void twheel_schedule(void *wheel, TWheelTimer *timer, uint64_t expires_ms);
+void twheel_cancel(void *wheel, TWheelTimer *timer);
+
+// Calls expired for every timer with a deadline <= now_ms, in deadline order.
+// The callback may schedule and cancel timers. A timer scheduled for the
+// millisecond being processed or earlier expires in the next millisecond.
+// Returns the number of expired timers.
+int twheel_advance(void *wheel, uint64_t now_ms, _func_twheel_expired expired,
+                   void *user_data);
+
+// Milliseconds from now_ms to the next deadline, -1 if there are no timers.
+// Never late, but may be early when a higher level slot has to be cascaded
+// first. The caller then wakes up only to call twheel_advance().
+int twheel_next_timeout(void *wheel, uint64_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TWHEEL_H_ */
@@ -16,18 +16,39 @@ void supla_extval_init(supla_extended_value_t *supla_extval, char sync_onchange)
 
 void supla_extval_free(supla_extended_value_t *supla_extval)
 {
+    if (!supla_extval)
+        return;
+
+    salloc_free(NULL, supla_extval->extval, SUPLA_ALLOC_TAG_CHANNEL);
+    supla_extval->extval = NULL;
+    supla_extval->alloc_size = 0;
 }
 
 int supla_extval_set(supla_extended_value_t *supla_extval, TSuplaChannelExtendedValue *extval)
 {
+    TSuplaChannelExtendedValue *buf;
+    unsigned int size;
+    int changed = 0;
+
     if (!supla_extval || !extval || extval->size > SUPLA_CHANNELEXTENDEDVALUE_SIZE)
         return SUPLA_RESULT_FALSE;
 
+    size = sizeof(TSuplaChannelExtendedValue) - SUPLA_CHANNELEXTENDEDVALUE_SIZE + extval->size;
+    if (size > supla_extval->alloc_size) {
+        buf = salloc_realloc(NULL, supla_extval->extval, size, SUPLA_ALLOC_TAG_CHANNEL);
+        if (!buf)
+            return SUPLA_RESULT_FALSE;
+
+        supla_extval->extval = buf;
+        supla_extval->alloc_size = size;
+        changed = 1;
+    }
+
     if (!supla_extval->sync_onchange)
         supla_extval->sync = 0;
 
-    if (memcmp(&supla_extval->extval, extval, SUPLA_CHANNELEXTENDEDVALUE_SIZE) != 0) {
-        supla_extval->extval = *extval;
+    if (changed || memcmp(supla_extval->extval, extval, size) != 0) {
+        memcpy(supla_extval->extval, extval, size);
         supla_extval->sync = 0;
     }
     return SUPLA_RESULT_TRUE;
@@ -16,7 +16,8 @@ extern "C" {
 typedef struct {
     char sync;
     char sync_onchange;
-    TSuplaChannelExtendedValue extval;
+    unsigned int alloc_size;
+    TSuplaChannelExtendedValue *extval; //allocated by the first set, only as large as the value
 } supla_extended_value_t;
 
 void supla_extval_init(supla_extended_value_t *supla_extval, char sync_onchange);
@@ -36,4 +36,27 @@ void test_channel_get_active_function(void)
 	TEST_ASSERT_EQUAL_INT(SUPLA_RESULT_TRUE,supla_channel_get_active_function(temp_channel,&active_functions));
 }
 
+void test_channel_set_extval(void)
+{
+	supla_channel_config_t relay_channel_config = {
+		.type = SUPLA_CHANNELTYPE_RELAY,
+		.supported_functions = SUPLA_BIT_FUNC_POWERSWITCH,
+		.default_function = SUPLA_CHANNELFNC_POWERSWITCH,
+	};
+	supla_channel_t *relay_channel = supla_channel_create(&relay_channel_config);
+	TSuplaChannelExtendedValue extval = { .type = EV_TYPE_TIMER_STATE_V1, .size = 8 };
+
+	TEST_ASSERT_NOT_NULL(relay_channel);
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_FALSE,supla_channel_set_extval(temp_channel,&extval));
+
+	/* storage follows the value size */
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_channel_set_extval(relay_channel,&extval));
+	extval.size = SUPLA_CHANNELEXTENDEDVALUE_SIZE;
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_channel_set_extval(relay_channel,&extval));
+	extval.size = 8;
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_channel_set_extval(relay_channel,&extval));
+
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_channel_free(relay_channel));
+}
+
 #endif // TEST
@@ -2,8 +2,13 @@
 
 #include "unity.h"
 
+#include <stdlib.h>
+#include <string.h>
 #include <libsupla/device.h>
 
+#include "device-priv.h"
+#include "channel-priv.h"
+
 
 #define DEV_NAME "TEST device"
 #define SOFT_VER "ver test"
@@ -46,4 +51,306 @@ void test_device_config(void)
 	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_dev_set_config(dev,&supla_config));
 }
 
+void test_device_fallback_servers(void)
+{
+	char buf[SUPLA_SERVER_NAME_MAXSIZE] = {};
+	const struct supla_config supla_config = {
+		.email = "user@example.com",
+		.auth_key = {0xFF,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+		.guid = {0xFF,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+		.server = "svr1.supla.org",
+		.fallback = {{ .name = "svr2.supla.org" }, { .name = "svr3.supla.org", .port = 2017 }},
+		.failover_after = 2,
+		.standby = 1,
+	};
+	struct supla_config config;
+
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_dev_set_config(dev,&supla_config));
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_dev_get_config(dev,&config));
+	TEST_ASSERT_EQUAL_STRING("svr3.supla.org",config.fallback[1].name);
+	TEST_ASSERT_EQUAL(2017,config.fallback[1].port);
+
+	/* the config server is used until a connection says otherwise */
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_dev_get_server(dev,buf,sizeof(buf)));
+	TEST_ASSERT_EQUAL_STRING("svr1.supla.org",buf);
+
+	/* a short buffer gets a terminated prefix */
+	memset(buf,'x',sizeof(buf));
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_dev_get_server(dev,buf,5));
+	TEST_ASSERT_EQUAL_STRING("svr1",buf);
+}
+
+static void set_fallback_config(void)
+{
+	const struct supla_config supla_config = {
+		.email = "user@example.com",
+		.auth_key = {0xFF,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+		.guid = {0xFF,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+		.server = "svr1.supla.org",
+		.fallback = {{ .name = "svr2.supla.org" }, { .name = "svr3.supla.org" }},
+		.failover_after = 2,
+	};
+
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_dev_set_config(dev,&supla_config));
+}
+
+void test_device_server_failover(void)
+{
+	const uint64_t now = 1000;
+
+	set_fallback_config();
+	TEST_ASSERT_EQUAL(0,supla_dev_server_select(dev,now));
+
+	/* one failure is not enough with failover_after 2 */
+	supla_dev_server_failed(dev,0,now);
+	TEST_ASSERT_EQUAL(0,supla_dev_server_select(dev,now));
+
+	supla_dev_server_failed(dev,0,now);
+	TEST_ASSERT_EQUAL(1,supla_dev_server_select(dev,now));
+	TEST_ASSERT_EQUAL(1,supla_dev_server_select(dev,now));
+
+	/* all degraded, the one waiting longest goes first */
+	supla_dev_server_failed(dev,1,now + 10);
+	supla_dev_server_failed(dev,1,now + 10);
+	supla_dev_server_failed(dev,2,now + 20);
+	supla_dev_server_failed(dev,2,now + 20);
+	TEST_ASSERT_EQUAL(-1,supla_dev_server_best(dev,-1,now + 30));
+	TEST_ASSERT_EQUAL(0,supla_dev_server_select(dev,now + 30));
+}
+
+void test_device_server_backoff(void)
+{
+	const uint64_t now = 1000;
+
+	set_fallback_config();
+	supla_dev_server_failed(dev,0,now);
+	supla_dev_server_failed(dev,0,now);
+	TEST_ASSERT_EQUAL(1,supla_dev_server_best(dev,-1,now));
+	TEST_ASSERT_EQUAL(2,supla_dev_server_best(dev,1,now + SUPLA_DEV_SERVER_BACKOFF_MSEC - 1));
+
+	/* usable again once the backoff expires */
+	TEST_ASSERT_EQUAL(0,supla_dev_server_best(dev,1,now + SUPLA_DEV_SERVER_BACKOFF_MSEC));
+	TEST_ASSERT_EQUAL(0,supla_dev_server_select(dev,now + SUPLA_DEV_SERVER_BACKOFF_MSEC));
+
+	/* a new failure starts a new backoff */
+	supla_dev_server_failed(dev,0,now + SUPLA_DEV_SERVER_BACKOFF_MSEC);
+	TEST_ASSERT_EQUAL(2,supla_dev_server_best(dev,1,now + SUPLA_DEV_SERVER_BACKOFF_MSEC));
+}
+
+void test_device_server_latency(void)
+{
+	const uint64_t now = 1000;
+
+	set_fallback_config();
+
+	/* unknown connect times keep the config order */
+	TEST_ASSERT_EQUAL(0,supla_dev_server_best(dev,-1,now));
+	TEST_ASSERT_EQUAL(1,supla_dev_server_best(dev,0,now));
+
+	/* a known connect time beats an unknown one */
+	dev->servers[2].connect_msec = 80;
+	TEST_ASSERT_EQUAL(2,supla_dev_server_best(dev,-1,now));
+
+	dev->servers[0].connect_msec = 120;
+	dev->servers[1].connect_msec = 40;
+	TEST_ASSERT_EQUAL(1,supla_dev_server_best(dev,-1,now));
+	TEST_ASSERT_EQUAL(2,supla_dev_server_best(dev,1,now));
+
+	/* the current server stays while it is usable, even if slower */
+	TEST_ASSERT_EQUAL(0,supla_dev_server_select(dev,now));
+	supla_dev_server_failed(dev,0,now);
+	supla_dev_server_failed(dev,0,now);
+	TEST_ASSERT_EQUAL(1,supla_dev_server_select(dev,now));
+}
+/* fake connection, takes everything written unless congested */
+static char test_congested;
+static char test_stream[4096];
+static int test_stream_len;
+
+static _supla_int_t test_data_read(void *buf,_supla_int_t count,void *user_params)
+{
+	return -1;
+}
+
+static _supla_int_t test_data_write(void *buf,_supla_int_t count,void *user_params)
+{
+	if (test_congested || test_stream_len + count > (int)sizeof(test_stream))
+		return 0;
+	memcpy(test_stream + test_stream_len,buf,count);
+	test_stream_len += count;
+	return count;
+}
+
+/* registered device on the fake connection */
+static void test_dev_online(void)
+{
+	TsrpcParams params;
+
+	srpc_params_init(&params);
+	params.data_read = test_data_read;
+	params.data_write = test_data_write;
+
+	srpc_free(dev->srpc);
+	dev->srpc = srpc_init(&params);
+	dev->state = SUPLA_DEV_STATE_ONLINE;
+	dev->activity_timeout = 0;
+	test_congested = 0;
+	test_stream_len = 0;
+}
+
+/* value changes written to the fake connection for channel number */
+static int test_sent_values(int number,char *value)
+{
+	void *sproto = sproto_init();
+	TSuplaDataPacket sdp;
+	TDS_SuplaDeviceChannelValue_C *cv;
+	int count = 0;
+
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,sproto_in_buffer_append(sproto,test_stream,test_stream_len));
+	while (sproto_pop_in_sdp(sproto,&sdp) == SUPLA_RESULT_TRUE) {
+		cv = (TDS_SuplaDeviceChannelValue_C *)sdp.data;
+		if (sdp.call_id != SUPLA_DS_CALL_DEVICE_CHANNEL_VALUE_CHANGED_C || cv->ChannelNumber != number)
+			continue;
+		memcpy(value,cv->value,SUPLA_CHANNELVALUE_SIZE);
+		count++;
+	}
+	sproto_free(sproto);
+	return count;
+}
+
+static int test_channel_marked(int number)
+{
+	return (dev->pending[number / 64] >> (number % 64)) & 1;
+}
+
+static const supla_channel_config_t relay_config = {
+	.type = SUPLA_CHANNELTYPE_RELAY,
+	.supported_functions = SUPLA_BIT_FUNC_POWERSWITCH,
+	.default_function = SUPLA_CHANNELFNC_POWERSWITCH,
+};
+
+void test_device_sync_value_set_before_add(void)
+{
+	supla_channel_t *ch = supla_channel_create(&relay_config);
+	char value[SUPLA_CHANNELVALUE_SIZE] = {1};
+	char sent[SUPLA_CHANNELVALUE_SIZE] = {};
+
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_channel_set_value(ch,value,sizeof(value)));
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_dev_add_channel(dev,ch));
+	TEST_ASSERT_TRUE(test_channel_marked(0));
+
+	test_dev_online();
+	supla_dev_iterate(dev);
+	TEST_ASSERT_EQUAL(SUPLA_DEV_STATE_ONLINE,dev->state);
+	TEST_ASSERT_FALSE(test_channel_marked(0));
+	TEST_ASSERT_EQUAL(1,test_sent_values(0,sent));
+	TEST_ASSERT_EQUAL_MEMORY(value,sent,sizeof(value));
+}
+
+void test_device_sync_keeps_congested_channel_marked(void)
+{
+	supla_channel_t *ch = supla_channel_create(&relay_config);
+	char value[SUPLA_CHANNELVALUE_SIZE] = {1};
+	char sent[SUPLA_CHANNELVALUE_SIZE] = {};
+
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_dev_add_channel(dev,ch));
+	test_dev_online();
+
+	/* the first value is queued and gets stuck in the connection */
+	test_congested = 1;
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_channel_set_value(ch,value,sizeof(value)));
+	supla_dev_iterate(dev);
+	TEST_ASSERT_FALSE(test_channel_marked(0));
+	TEST_ASSERT_TRUE(srpc_output_congested(dev->srpc));
+
+	/* supla_channel_sync() refuses the next one, it stays marked */
+	value[0] = 0;
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_channel_set_value(ch,value,sizeof(value)));
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_FALSE,supla_channel_sync(dev->srpc,ch));
+	supla_dev_iterate(dev);
+	TEST_ASSERT_TRUE(test_channel_marked(0));
+	TEST_ASSERT_EQUAL(0,test_sent_values(0,sent));
+
+	/* the connection drains, then the value goes out */
+	test_congested = 0;
+	supla_dev_iterate(dev);
+	supla_dev_iterate(dev);
+	TEST_ASSERT_EQUAL(SUPLA_DEV_STATE_ONLINE,dev->state);
+	TEST_ASSERT_FALSE(test_channel_marked(0));
+	TEST_ASSERT_EQUAL(2,test_sent_values(0,sent));
+	TEST_ASSERT_EQUAL_MEMORY(value,sent,sizeof(value));
+}
+
+
+void test_device_channels(void)
+{
+	static const supla_channel_config_t config = {
+		.type = SUPLA_CHANNELTYPE_THERMOMETER,
+		.supported_functions = SUPLA_CHANNELFNC_THERMOMETER,
+		.default_function = SUPLA_CHANNELFNC_THERMOMETER,
+	};
+	supla_channel_t *ch[10];
+	int i;
+
+	/* more than fit the initial channel table */
+	for(i = 0; i < 10; i++){
+		ch[i] = supla_channel_create(&config);
+		TEST_ASSERT_NOT_NULL(ch[i]);
+		if(i == 3)
+			supla_channel_set_double_value(ch[i],21.5);
+		TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_dev_add_channel(dev,ch[i]));
+	}
+
+	TEST_ASSERT_EQUAL(10,supla_dev_get_channel_count(dev));
+	for(i = 0; i < 10; i++){
+		TEST_ASSERT_EQUAL_PTR(ch[i],supla_dev_get_channel_by_num(dev,i));
+		TEST_ASSERT_EQUAL(i,supla_channel_get_assigned_number(ch[i]));
+	}
+	TEST_ASSERT_NULL(supla_dev_get_channel_by_num(dev,10));
+	TEST_ASSERT_NULL(supla_dev_get_channel_by_num(dev,-1));
+}
+
+static long dev_alloc_count;
+
+static void *count_alloc(void *ctx,size_t size,int tag)
+{
+	dev_alloc_count++;
+	return malloc(size);
+}
+
+static void *count_resize(void *ctx,void *ptr,size_t size,int tag)
+{
+	if(!ptr)
+		dev_alloc_count++;
+	return realloc(ptr,size);
+}
+
+static void count_release(void *ctx,void *ptr,int tag)
+{
+	dev_alloc_count--;
+	free(ptr);
+}
+
+void test_device_allocator(void)
+{
+	static const supla_allocator_t allocator = {
+		.alloc = count_alloc,
+		.resize = count_resize,
+		.release = count_release,
+	};
+	static const supla_channel_config_t config = {
+		.type = SUPLA_CHANNELTYPE_RELAY,
+		.supported_functions = SUPLA_BIT_FUNC_POWERSWITCH,
+		.default_function = SUPLA_CHANNELFNC_POWERSWITCH,
+	};
+	supla_dev_t *adev = supla_dev_create_with_allocator(DEV_NAME,SOFT_VER,&allocator);
+
+	TEST_ASSERT_NOT_NULL(adev);
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_dev_add_channel(adev,supla_channel_create(&config)));
+	TEST_ASSERT_TRUE(dev_alloc_count > 0);
+
+	supla_dev_free(adev);
+	TEST_ASSERT_EQUAL(0,dev_alloc_count);
+}
+
 #endif // TEST
@@ -0,0 +1,323 @@
+#ifdef TEST
+
+#include "unity.h"
+
+#include <string.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
+#include <libsupla/hub.h>
+#include <libsupla/channel.h>
+
+#include "device-priv.h"
+
+
+static supla_hub_t *hub;
+static supla_dev_t *dev;
+
+void setUp(void)
+{
+	hub = supla_hub_create(2);
+	dev = supla_dev_create("TEST device",NULL);
+}
+
+void tearDown(void)
+{
+	supla_hub_free(hub);
+	supla_dev_free(dev);
+}
+
+void test_hub_add_remove_device(void)
+{
+	struct supla_hub_stats stats;
+
+	TEST_ASSERT_NOT_NULL(hub);
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_hub_add_device(hub,dev));
+	TEST_ASSERT_EQUAL_MESSAGE(SUPLA_RESULT_FALSE,supla_hub_add_device(hub,dev),"device added twice");
+
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_hub_get_stats(hub,&stats));
+	TEST_ASSERT_EQUAL(2,stats.loops);
+	TEST_ASSERT_EQUAL(1,stats.devices);
+	TEST_ASSERT_EQUAL(0,stats.online_devices);
+
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_hub_remove_device(hub,dev));
+	TEST_ASSERT_EQUAL_MESSAGE(SUPLA_RESULT_FALSE,supla_hub_remove_device(hub,dev),"device removed twice");
+
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_hub_get_stats(hub,&stats));
+	TEST_ASSERT_EQUAL(0,stats.devices);
+}
+
+void test_hub_free_detaches_devices(void)
+{
+	supla_hub_t *other = supla_hub_create(1);
+
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_hub_add_device(other,dev));
+	TEST_ASSERT_EQUAL_MESSAGE(SUPLA_RESULT_FALSE,supla_hub_add_device(hub,dev),"device added to two hubs");
+
+	supla_hub_free(other);
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_hub_add_device(hub,dev));
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_hub_remove_device(hub,dev));
+}
+
+void test_hub_io_uring_flag(void)
+{
+	supla_hub_t *other = supla_hub_create_with_flags(1,SUPLA_HUB_FLAG_IO_URING);
+	struct supla_hub_stats stats;
+
+	/* falls back to plain sockets where io_uring is not available */
+	TEST_ASSERT_NOT_NULL(other);
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_hub_add_device(other,dev));
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_hub_get_stats(other,&stats));
+	TEST_ASSERT_EQUAL(1,stats.devices);
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_hub_remove_device(other,dev));
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_hub_free(other));
+}
+
+/* listening socket on a free loopback port */
+static int test_listen(int *port)
+{
+	struct sockaddr_in addr = {.sin_family = AF_INET,.sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+	socklen_t len = sizeof(addr);
+	int fd = socket(AF_INET,SOCK_STREAM,0);
+
+	TEST_ASSERT_TRUE(fd >= 0);
+	TEST_ASSERT_EQUAL(0,bind(fd,(struct sockaddr *)&addr,sizeof(addr)));
+	TEST_ASSERT_EQUAL(0,listen(fd,1));
+	TEST_ASSERT_EQUAL(0,getsockname(fd,(struct sockaddr *)&addr,&len));
+	*port = ntohs(addr.sin_port);
+	return fd;
+}
+
+static SSL_CTX *test_server_ctx(void)
+{
+	SSL_CTX *ctx = SSL_CTX_new(TLS_server_method());
+	EVP_PKEY *key = EVP_EC_gen("P-256");
+	X509 *cert = X509_new();
+
+	ASN1_INTEGER_set(X509_get_serialNumber(cert),1);
+	X509_gmtime_adj(X509_getm_notBefore(cert),0);
+	X509_gmtime_adj(X509_getm_notAfter(cert),3600);
+	X509_set_pubkey(cert,key);
+	X509_set_issuer_name(cert,X509_get_subject_name(cert));
+	X509_sign(cert,key,EVP_sha256());
+	TEST_ASSERT_EQUAL(1,SSL_CTX_use_certificate(ctx,cert));
+	TEST_ASSERT_EQUAL(1,SSL_CTX_use_PrivateKey(ctx,key));
+
+	X509_free(cert);
+	EVP_PKEY_free(key);
+	return ctx;
+}
+
+/* ping results followed by the register result, all written at once */
+static int test_register_burst(char *buf,int size)
+{
+	void *sproto = sproto_init();
+	TSuplaDataPacket sdp;
+	TSD_SuplaRegisterDeviceResult result = {.result_code = SUPLA_RESULTCODE_TRUE,.activity_timeout = 120,
+		.version = SUPLA_PROTO_VERSION,.version_min = SUPLA_PROTO_VERSION_MIN};
+	int len;
+
+	for (int i = 0; i < 10; i++) {
+		sproto_sdp_init(sproto,&sdp);
+		sdp.call_id = SUPLA_SDC_CALL_PING_SERVER_RESULT;
+		sdp.data_size = sizeof(TSDC_SuplaPingServerResult);
+		memset(sdp.data,0,sdp.data_size);
+		TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,sproto_out_buffer_append(sproto,&sdp));
+	}
+
+	sproto_sdp_init(sproto,&sdp);
+	sdp.call_id = SUPLA_SD_CALL_REGISTER_DEVICE_RESULT;
+	sdp.data_size = sizeof(result);
+	memcpy(sdp.data,&result,sizeof(result));
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,sproto_out_buffer_append(sproto,&sdp));
+
+	len = sproto_pop_out_data(sproto,buf,size);
+	sproto_free(sproto);
+	return len;
+}
+
+static int test_wait_online(supla_hub_t *h,int msec)
+{
+	struct supla_hub_stats stats;
+
+	for (; msec > 0; msec -= 10) {
+		supla_hub_get_stats(h,&stats);
+		if (stats.online_devices)
+			return 1;
+		usleep(10000);
+	}
+	return 0;
+}
+
+/*
+ * The device reads 64 bytes at a time, the rest of the burst stays where no
+ * socket event reports it: decrypted in the SSL object, or in the receive
+ * buffer of a ring link. TLS bursts go out in records of record_size bytes.
+ */
+static void test_hub_register_burst(supla_hub_t *h,char use_ssl,int record_size)
+{
+	struct supla_config config = {.email = "test@test.test",.server = "127.0.0.1",.ssl = use_ssl};
+	struct supla_dev_buffers buffers = {.io_size = 64};
+	supla_channel_config_t ch_config = {.type = SUPLA_CHANNELTYPE_THERMOMETER,
+		.default_function = SUPLA_CHANNELFNC_THERMOMETER};
+	struct pollfd pfd;
+	SSL_CTX *ctx = NULL;
+	SSL *ssl = NULL;
+	char buf[1024];
+	int lfd, fd, len, n;
+
+	lfd = test_listen(&config.port);
+	config.guid[0] = 1;
+	config.auth_key[0] = 1;
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_dev_add_channel(dev,supla_channel_create(&ch_config)));
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_dev_set_config(dev,&config));
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_dev_set_buffers(dev,&buffers));
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_hub_add_device(h,dev));
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_dev_start(dev));
+
+	pfd.fd = lfd;
+	pfd.events = POLLIN;
+	TEST_ASSERT_EQUAL(1,poll(&pfd,1,3000));
+	fd = accept(lfd,NULL,NULL);
+	TEST_ASSERT_TRUE(fd >= 0);
+
+	if (use_ssl) {
+		ctx = test_server_ctx();
+		ssl = SSL_new(ctx);
+		SSL_set_fd(ssl,fd);
+		TEST_ASSERT_EQUAL(1,SSL_accept(ssl));
+	}
+
+	/* registration */
+	TEST_ASSERT_TRUE((ssl ? SSL_read(ssl,buf,sizeof(buf)) : read(fd,buf,sizeof(buf))) > 0);
+
+	len = test_register_burst(buf,sizeof(buf));
+	TEST_ASSERT_TRUE(len > 64);
+	for (int off = 0; off < len; off += n) {
+		n = ssl ? SSL_write(ssl,buf + off,len - off < record_size ? len - off : record_size) :
+			write(fd,buf + off,len - off);
+		TEST_ASSERT_TRUE(n > 0);
+	}
+
+	/* the register timeout would be the next iteration otherwise */
+	TEST_ASSERT_EQUAL_MESSAGE(1,test_wait_online(h,3000),"buffered data not read");
+
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_hub_remove_device(h,dev));
+	SSL_free(ssl);
+	SSL_CTX_free(ctx);
+	close(fd);
+	close(lfd);
+}
+
+void test_hub_iterates_on_buffered_tls_data(void)
+{
+	test_hub_register_burst(hub,1,1024);
+}
+
+void test_hub_iterates_on_buffered_uring_data(void)
+{
+	supla_hub_t *other = supla_hub_create_with_flags(1,SUPLA_HUB_FLAG_IO_URING);
+
+	test_hub_register_burst(other,0,0);
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_hub_free(other));
+}
+
+void test_hub_iterates_on_buffered_uring_tls_data(void)
+{
+	supla_hub_t *other = supla_hub_create_with_flags(1,SUPLA_HUB_FLAG_IO_URING);
+
+	/* several records arrive in one completion and wait in the rbio */
+	test_hub_register_burst(other,1,50);
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_hub_free(other));
+}
+
+/* value changes for channel 0 in what the server has read so far, the last one in value */
+static int test_read_values(void *sproto,int fd,char *value)
+{
+	TSuplaDataPacket sdp;
+	TDS_SuplaDeviceChannelValue_C *cv;
+	char buf[1024];
+	int count = 0;
+	int n;
+
+	while ((n = recv(fd,buf,sizeof(buf),MSG_DONTWAIT)) > 0) {
+		TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,sproto_in_buffer_append(sproto,buf,n));
+		while (sproto_pop_in_sdp(sproto,&sdp) == SUPLA_RESULT_TRUE) {
+			cv = (TDS_SuplaDeviceChannelValue_C *)sdp.data;
+			if (sdp.call_id != SUPLA_DS_CALL_DEVICE_CHANNEL_VALUE_CHANGED_C || cv->ChannelNumber != 0)
+				continue;
+			memcpy(value,cv->value,SUPLA_CHANNELVALUE_SIZE);
+			count++;
+		}
+	}
+	return count;
+}
+
+void test_hub_syncs_value_set_while_congested(void)
+{
+	struct supla_config config = {.email = "test@test.test",.server = "127.0.0.1"};
+	supla_channel_config_t ch_config = {.type = SUPLA_CHANNELTYPE_RELAY,
+		.supported_functions = SUPLA_BIT_FUNC_POWERSWITCH,.default_function = SUPLA_CHANNELFNC_POWERSWITCH};
+	supla_channel_t *ch = supla_channel_create(&ch_config);
+	char value[SUPLA_CHANNELVALUE_SIZE] = {};
+	char sent[SUPLA_CHANNELVALUE_SIZE] = {};
+	void *sproto = sproto_init();
+	struct pollfd pfd;
+	int small = 1024;
+	char buf[1024];
+	int lfd, fd, len, i;
+
+	lfd = test_listen(&config.port);
+	TEST_ASSERT_EQUAL(0,setsockopt(lfd,SOL_SOCKET,SO_RCVBUF,&small,sizeof(small)));
+	config.guid[0] = 1;
+	config.auth_key[0] = 1;
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_dev_add_channel(dev,ch));
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_dev_set_config(dev,&config));
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_hub_add_device(hub,dev));
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_dev_start(dev));
+
+	pfd.fd = lfd;
+	pfd.events = POLLIN;
+	TEST_ASSERT_EQUAL(1,poll(&pfd,1,3000));
+	fd = accept(lfd,NULL,NULL);
+	TEST_ASSERT_TRUE(fd >= 0);
+
+	/* registration, the ping deadline is two minutes away */
+	TEST_ASSERT_TRUE(read(fd,buf,sizeof(buf)) > 0);
+	len = test_register_burst(buf,sizeof(buf));
+	TEST_ASSERT_EQUAL(len,write(fd,buf,len));
+	TEST_ASSERT_EQUAL(1,test_wait_online(hub,3000));
+	TEST_ASSERT_EQUAL(0,setsockopt(supla_dev_get_fd(dev),SOL_SOCKET,SO_SNDBUF,&small,sizeof(small)));
+
+	/* the server stops reading until the device output backs up */
+	for (i = 0; i < 10000 && !supla_dev_output_pending(dev); i++) {
+		value[1] = i;
+		value[2] = i >> 8;
+		supla_channel_set_value(ch,value,sizeof(value));
+		usleep(200);
+	}
+	TEST_ASSERT_TRUE_MESSAGE(supla_dev_output_pending(dev),"output not congested");
+
+	/* set while congested, sent once the server drains the connection */
+	value[0] = 0x5A;
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_channel_set_value(ch,value,sizeof(value)));
+	usleep(50000);
+
+	for (i = 0; i < 300 && memcmp(sent,value,sizeof(value)); i++) {
+		test_read_values(sproto,fd,sent);
+		usleep(10000);
+	}
+	TEST_ASSERT_EQUAL_MEMORY_MESSAGE(value,sent,sizeof(value),"value set while congested not sent");
+
+	TEST_ASSERT_EQUAL(SUPLA_RESULT_TRUE,supla_hub_remove_device(hub,dev));
+	sproto_free(sproto);
+	close(fd);
+	close(lfd);
+}
+
+#endif // TEST